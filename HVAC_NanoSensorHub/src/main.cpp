@@ -13,6 +13,10 @@
 #include <sps30.h>
 #include <SensirionI2cScd30.h>
 #include <SensirionI2CSgp41.h>
+#include "protocol/Commands.h"
+#include "protocol/Crc.h"
+#include "protocol/Frames.h"
+#include "protocol/Schema.h"
 
 #ifndef MINICORE
 #error "This project requires the Minicore AVR core for Arduino."
@@ -23,75 +27,28 @@
 // ======================================================================
 
 // --- Firmware & Protocol ---
-const char NANO_FIRMWARE_VERSION[] PROGMEM = "1.3.0";
-#define CMD_GET_SENSORS       'S' // Request sensor data
-#define RSP_SENSORS           's' // Response with sensor data
-#define CMD_GET_VERSION       'V'
-#define CMD_GET_HEALTH        'H'
-#define RSP_HEALTH            'h' // Overall health status response
-#define CMD_ACK_HEALTH        'A' // Acknowledge Health Status
-#define RSP_VERSION           'v'
-#define CMD_REBOOT            'R' // Request Nano Reboot
-#define CMD_GET_SPS30_INFO    'P' // Request SPS30 info
-#define RSP_SPS30_INFO        'p' // Response with SPS30 info
-#define CMD_SPS30_CLEAN       'C' // Request manual SPS30 fan cleaning
-#define RSP_SPS30_CLEAN       'c' // ACK for fan cleaning command
-#define CMD_SGP41_TEST        'G' // Request SGP41 test
-#define RSP_SGP41_TEST        'g' // Response with SGP41 test result
-#define CMD_GET_SCD30_INFO    'D' // Request SCD30 info
-#define RSP_SCD30_INFO        'd' // Response with SCD30 info
-#define CMD_SET_SCD30_AUTOCAL 'T' // Set SCD30 AutoCalibration
-#define RSP_SCD30_AUTOCAL     't' // Response with SCD30 AutoCalibration result
-#define CMD_SET_SCD30_FORCECAL 'F' // Set SCD30 Forced Recalibration
-#define RSP_SCD30_FORCECAL     'f' // Response with SCD30 Forced Recalibration result
-
-// --- I2C Bridge Commands ---
-#define CMD_I2C_READ          'I' // Request I2C read operation
-#define RSP_I2C_READ          'i' // Response with I2C read result
-#define CMD_I2C_WRITE         'W' // Request I2C write operation
-#define RSP_I2C_WRITE         'w' // Response with I2C write result
-
-// I2C Error Codes
-#define I2C_ERROR_NONE        0x00 // No error
-#define I2C_ERROR_ADDR_NACK   0x01 // Address not acknowledged
-#define I2C_ERROR_DATA_NACK   0x02 // Data not acknowledged
-#define I2C_ERROR_OTHER       0x03 // Other error
-#define I2C_ERROR_TIMEOUT     0x04 // Timeout
-#define I2C_ERROR_BUF_LEN     0x05 // Buffer length exceeded
-
-// --- PROGMEM Error Strings ---
-const char E_I2C_RECOVER_START_1[] PROGMEM = "E,I2C_RECOVER,1";
-const char E_I2C_RECOVER_DONE_1[] PROGMEM = "E,I2C_RECOVER,0";
-const char E_I2C_RECOVER_STUCK_2[] PROGMEM = "E,I2C_RECOVER,2";
-const char E_I2C_BUS_STUCK_0[] PROGMEM = "E,I2C_RECOVER,BUS_STUCK,0";
-const char E_I2C_BUS_STUCK_1[] PROGMEM = "E,I2C_RECOVER,BUS_STUCK,1";
-const char E_I2C_RECOVER_FAIL_SDA_LOW_1[] PROGMEM = "E,I2C_RECOVER,FAIL_SDA_LOW";
-const char E_I2C_RECOVER_FAIL_BUS_BUSY_1[] PROGMEM = "E,I2C_RECOVER,FAIL_BUS_BUSY";
-const char E_I2C_TIMEOUT_1[] PROGMEM = "E,I2C_RECOVER,TIMEOUT";
-const char E_SPS30_DATA_READY_ERROR_1[] PROGMEM = "E,SPS30_DATA_READY_ERROR,1";
-const char E_SPS30_MEASUREMENT_ERROR_1[] PROGMEM = "E,SPS30_MEASUREMENT_ERROR,1";
-const char E_SCD30_DATA_READY_ERROR_1[] PROGMEM = "E,SCD30_DATA_READY_ERROR,1";
-const char E_SCD30_MEASUREMENT_ERROR_1[] PROGMEM = "E,SCD30_MEASUREMENT_ERROR,1";
-const char E_SGP41_CONDITIONING_ERROR_1[] PROGMEM = "E,SGP41_CONDITIONING_ERROR,1";
-const char E_SGP41_MEASUREMENT_ERROR_1[] PROGMEM = "E,SGP41_MEASUREMENT_ERROR,1";
+const char NANO_FIRMWARE_VERSION[] PROGMEM = "1.18.0";
+#define PROTOCOL_CAPABILITIES (PROTOCOL_CAP_BINARY_FRAMES | PROTOCOL_CAP_SENSOR_STREAM | PROTOCOL_CAP_REQUEST_IDS | PROTOCOL_CAP_BAUD_SWITCH | PROTOCOL_CAP_DELTA_FRAMES | PROTOCOL_CAP_CHUNKED_WRITES | PROTOCOL_CAP_TIME_SYNC | PROTOCOL_CAP_I2C_SCRIPTS | PROTOCOL_CAP_I2C_WATCH | PROTOCOL_CAP_I2C_TRANSFERS | PROTOCOL_CAP_BINARY_I2C) // Capabilities of this firmware
 
 // --- PROGMEM Format Strings ---
-const char FMT_DATA_PACKET[] PROGMEM = "%c%lu,%u,%u,%ld,%ld,%ld,%u,%u,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%u,%u";
-const char FMT_GET_VERSION[] PROGMEM = "%c%s";
-const char FMT_GET_HEALTH[] PROGMEM = "%c%d,%d,%d";
-const char FMT_SPS30_FW[] PROGMEM = "%d,%u,%u,";
-const char FMT_SPS30_INTERVAL[] PROGMEM = "%d,%lu,";
-const char FMT_SPS30_INTERVAL_DAYS[] PROGMEM = "%d,%u,";
-const char FMT_SPS30_STATUS[] PROGMEM = "%d,%lu";
+const char FMT_GET_VERSION[] PROGMEM = "%c%S,%02X";
+const char FMT_SENSOR_STREAM[] PROGMEM = "%c%u";
+const char FMT_BAUD_RATE[] PROGMEM = "%c%lu";
+const char FMT_GET_HEALTH[] PROGMEM = "%c%d,%d,%d,%u";
 const char FMT_SPS30_CLEAN[] PROGMEM = "%c%d";
 const char FMT_SGP41_TEST[] PROGMEM = "%c%d,0x%04X";
-const char FMT_SCD30_READ[] PROGMEM = "%X,%X,";
-const char FMT_SCD30_FW[] PROGMEM = ",%X,%X,%X";
 const char FMT_SCD30_AUTOCAL[] PROGMEM = "%c%X,%X,%X";
 const char FMT_SCD30_FORCECAL[] PROGMEM = "%c%X,%X,%X";
 const char FMT_I2C_READ[] PROGMEM = "%c%02X,%02X";
 const char FMT_I2C_READ_DATA[] PROGMEM = ",%02X";
 const char FMT_I2C_WRITE[] PROGMEM = "%c%02X";
+const char FMT_I2C_SCRIPT_REJECTED[] PROGMEM = "%c%X,";
+const char FMT_I2C_SCRIPT_DATA[] PROGMEM = "%02X";
+const char FMT_I2C_PUSH[] PROGMEM = "%c%X,%X,";
+const char FMT_I2C_READ_BLOCK[] PROGMEM = "%c%X,%X,%X";
+const char FMT_REQUEST_ID[] PROGMEM = "%c%02X";
+const char FMT_EVENT[] PROGMEM = "%c%X,%X";
+const char FMT_TIME_SYNC[] PROGMEM = "%c%lX,%lX,%lX";
 
 #define I2C_TIMEOUT_US 30000 // 30ms timeout for I2C operations
 #define I2C_NORMAL_SPEED 100000 // Normal I2C speed (100 kHz)
@@ -113,7 +70,8 @@ const unsigned long SCD30_INVALIDATE_TIMEOUT_MS = 60000;
 
 // --- Sensor Calculation Constants ---
 #define SHUNT_RESISTOR 150.0f
-#define NUM_SAMPLES    1000
+#define NUM_SAMPLES    1000  // Per channel and window, one second at ADC_SAMPLE_RATE_HZ
+#define ADC_SAMPLE_RATE_HZ 5000 // All channels together, 1 kHz each
 #define FAN_CT_VOLTS_PER_AMP         (1.0f / 10.0f)   // 0.1 V/A, e.g. 1V at 10A
 #define COMPRESSOR_CT_VOLTS_PER_AMP (1.0f / 30.0f)   // 0.0333 V/A, SCT-013-030: 1V at 30A
 #define GEOTHERMAL_PUMP_CT_VOLTS_PER_AMP (1.0f / 5.0f)    // 0.2 V/A, 5A CT clamp: 1V at 5A
@@ -123,12 +81,22 @@ const unsigned long SCD30_INVALIDATE_TIMEOUT_MS = 60000;
 #define MAX_RESPONSE_LEN 200
 
 // --- Hardware & Behavior Constants ---
-#define SERIAL_BAUD_RATE            19200
+#define SERIAL_BAUD_RATE            LINK_DEFAULT_BAUD // Raised at runtime through CMD_SET_BAUD_RATE
 #define I2C_PAYLOAD_BUFFER_SIZE     40      // Max bytes for an I2C data payload
 #define I2C_WIRE_LIB_MAX_READ       32      // Max bytes the AVR Wire library can read at once
 #define I2C_CMD_MAX_WRITE_IN_READ   16      // Max write bytes within a read-write command
 #define I2C_WRITE_READ_DELAY_MS     2       // Brief delay between an I2C write and read
 #define STARTUP_BLINK_DELAY_MS      500     // Delay for the startup LED blink
+#define SENSOR_JOB_MAX_DEFER_MS     50      // Longest a due sensor job yields to incoming commands
+
+// --- SGP41, driven without the library so its measurement time does not hold the bus ---
+#define SGP41_I2C_ADDR              0x59
+#define SGP41_CMD_CONDITIONING      0x2612  // Answers one word, SRAW_VOC
+#define SGP41_CMD_MEASURE_RAW       0x2619  // Answers two words, SRAW_VOC and SRAW_NOX
+#define SGP41_MEASURE_TIME_MS       50      // Both commands, from the command write to the read
+#define SGP41_ERROR_WRITE           0x0100  // | Wire.endTransmission() status
+#define SGP41_ERROR_READ            0x0200  // Fewer bytes than requested
+#define SGP41_ERROR_CRC             0x0300
 
 // ======================================================================
 //  GLOBAL VARIABLES & OBJECTS
@@ -152,48 +120,130 @@ SensirionI2cScd30 scd30_sensor;
 SensirionI2CSgp41 sgp41_sensor;
 uint8_t conditioning_s = 10;
 char tx_command_buffer[MAX_RESPONSE_LEN];
-
-// --- Round-robin ADC reading variables ---
+bool binary_frames_enabled = false; // Set once the ESP32 advertised PROTOCOL_CAP_BINARY_FRAMES
+uint16_t sensor_stream_period_ms = 0; // 0: RSP_SENSORS only on CMD_GET_SENSORS
+unsigned long last_sensor_stream_time = 0;
+uint16_t sensor_frame_sequence = 0; // Sent with every RSP_SENSORS so the ESP32 can spot gaps
+bool delta_frames_enabled = false; // Set once the ESP32 advertised PROTOCOL_CAP_DELTA_FRAMES
+bool binary_i2c_enabled = false; // Set once the ESP32 advertised PROTOCOL_CAP_BINARY_I2C
+NanoSensorFrame last_sensor_frame; // Reference for the next RSP_SENSORS_DELTA
+uint8_t i2c_write_staging[I2C_WRITE_MAX_LEN]; // CMD_I2C_WRITE_CHUNK data until the last chunk
+uint8_t i2c_write_staged = 0;
+uint8_t frames_since_keyframe = SENSOR_KEYFRAME_INTERVAL; // Starts with a keyframe
+
+// --- I2C register watches, see I2C_WATCH_* in protocol/Commands.h ---
+#define I2C_WATCH_CONDITION_MET 0x01 // BITS_* modes: the condition held at the last read
+#define I2C_WATCH_FAILED        0x02 // The last read failed and was pushed
+#define I2C_WATCH_RESYNC        0x04 // CHANGED mode: push the next good read whatever it holds
+#define I2C_WATCH_FIELDS        8    // Fields of a CMD_I2C_WATCH that sets a job
+
+struct I2cWatch {
+  uint8_t address;    // 0: slot unused
+  uint8_t mode;
+  uint8_t mask;
+  uint8_t cond_reg;
+  uint8_t reg;
+  uint8_t len;
+  uint16_t period_ms;
+  uint16_t last_run;  // Low 16 bits of millis(), periods stay below 65.5 s
+  uint8_t flags;      // I2C_WATCH_CONDITION_MET, I2C_WATCH_FAILED, I2C_WATCH_RESYNC
+  uint8_t last_crc;   // I2C_WATCH_CHANGED: CRC-8 of the last pushed data
+};
+I2cWatch i2c_watches[I2C_WATCH_SLOTS];
+
+// --- Segmented I2C transfers, see I2C_TRANSFER_* in protocol/Commands.h ---
+#define I2C_READ_BLOCK_FIELDS   5    // xfer, addr, reg, total, flags
+#define I2C_WRITE_BLOCK_FIELDS  6    // xfer, addr, reg, offset, total, flags
+uint8_t i2c_transfer_id = 0;         // CMD_I2C_WRITE_BLOCK transfer being written
+uint16_t i2c_transfer_next = 0;      // Offset its next segment has to start at
+
+// --- Native sensor reads, one job per loop() pass, see run_sensor_job() ---
+enum SensorJob : uint8_t {
+  SENSOR_JOB_IDLE = 0,      // No read cycle running
+  SENSOR_JOB_SPS30_READY,
+  SENSOR_JOB_SPS30_READ,
+  SENSOR_JOB_SCD30_READY,
+  SENSOR_JOB_SCD30_READ,
+  SENSOR_JOB_SGP41_START,   // Writes the command, the result is read SGP41_MEASURE_TIME_MS later
+  SENSOR_JOB_SGP41_READ     // The SGP41 is busy measuring until the job runs, see sgp41_defer_measurement()
+};
+uint8_t sensor_job = SENSOR_JOB_IDLE;
+unsigned long sensor_job_time = 0;  // When the current job was queued
+uint16_t sensor_job_wait_ms = 0;    // It is due this long after sensor_job_time
+uint16_t sensor_data_ready = 0;     // Data-ready flag of a *_READY job for the *_READ job after it
+bool sensor_reply_pending = false;  // CMD_GET_SENSORS is answered when the cycle ends
+uint8_t sensor_reply_id = REQUEST_ID_NONE;
+uint16_t max_bus_hold_ms = 0;       // Longest sensor job or SGP41 deferral since the last RSP_HEALTH, what a bridge command can wait
+
+// --- Link speed, see LINK_* in protocol/Commands.h ---
+uint32_t serial_baud_rate = SERIAL_BAUD_RATE;
+bool serial_baud_verified = true;   // CMD_PING received since the last switch
+unsigned long serial_baud_switch_time = 0;
+unsigned long last_valid_command_time = 0;
+unsigned long link_error_window_start = 0;
+uint8_t link_error_count = 0;       // Corrupted commands in the current window
+
+// --- Timer-triggered ADC sampling, see start_adc_sampling() ---
+// The CT clamps come first, only they need the sum of squares
 enum ADC_CHANNEL {
-  ADC_PRESSURE = 0,
-  ADC_FAN_CT,
+  ADC_FAN_CT = 0,
   ADC_COMPRESSOR_CT,
   ADC_GEOTHERMAL_PUMP_CT,
+  ADC_PRESSURE,
   ADC_CO_SENSOR,
   ADC_CHANNEL_COUNT
 };
+#define ADC_CT_CHANNEL_COUNT 3
 
-uint8_t current_adc_channel = ADC_PRESSURE;
-unsigned long last_adc_read_time = 0;
-const unsigned long ADC_READ_INTERVAL_MS = 10; // 10ms between ADC reads
-
-// --- RMS calculation variables ---
-long fan_ct_sum_of_squares = 0;
-long fan_ct_sum_of_samples = 0;
-uint16_t fan_ct_sample_count = 0;
-long compressor_ct_sum_of_squares = 0;
-long compressor_ct_sum_of_samples = 0;
-uint16_t compressor_ct_sample_count = 0;
-long geothermal_pump_ct_sum_of_squares = 0;
-long geothermal_pump_ct_sum_of_samples = 0;
-uint16_t geothermal_pump_ct_sample_count = 0;
-const uint16_t RMS_SAMPLE_COUNT = NUM_SAMPLES;
+const uint8_t adc_channel_pins[ADC_CHANNEL_COUNT] = {
+  FAN_CT_CLAMP_PIN, COMPRESSOR_CT_CLAMP_PIN, GEOTHERMAL_PUMP_CT_CLAMP_PIN, PRESSURE_SENSOR_PIN, CO_SENSOR_PIN
+};
 
-// --- Rolling average variables for CO sensor ---
-const float CO_EMA_ALPHA = 0.1f; // Smoothing factor (0.1 = 10% new data, 90% old average)
-float co_adc_ema = 0.0f; // Exponential moving average
-bool co_adc_ema_initialized = false;
+// One window of RMS_SAMPLE_COUNT samples per channel. 1023^2 * 1000 fits 32 bits.
+struct AdcWindow {
+  uint32_t sum[ADC_CHANNEL_COUNT];
+  uint32_t sum_of_squares[ADC_CT_CHANNEL_COUNT];
+};
+volatile AdcWindow adc_windows[2];          // The ISR fills adc_windows[adc_fill], loop() reads the other
+volatile uint8_t adc_fill = 0;
+volatile uint8_t adc_channel = 0;           // Channel of the conversion in progress
+volatile uint16_t adc_window_samples = 0;   // Samples per channel in the window being filled
+volatile bool adc_window_ready = false;     // The other window is complete and not read yet
+const uint16_t RMS_SAMPLE_COUNT = NUM_SAMPLES;
 
 // --- Forward Declarations ---
-unsigned long read_all_sensors();
-void send_data_packet(unsigned long timestamp);
+void start_sensor_cycle();
+void queue_sensor_job(uint8_t job, uint16_t wait_ms);
+bool run_sensor_job();
+uint16_t sgp41_send_command(uint16_t command, uint16_t rh, uint16_t temp);
+uint16_t sgp41_read_words(uint16_t* words, uint8_t count);
+void sgp41_defer_measurement();
+void send_data_packet(unsigned long timestamp, uint8_t request_id);
+void send_binary_frame(uint8_t type, uint8_t request_id, const void* payload, uint8_t payload_len);
+void send_ascii_packet(const char* data, uint8_t request_id);
 void process_command(const char* buffer);
+void process_binary_command(uint8_t* frame, uint8_t encoded_len);
 int freeRam();
 bool recoverI2Cbus();
 bool checkAndRecoverI2C();
 void checkAndReportI2cTimeout();
-void send_error_response(const char* error_msg PROGMEM);
-void read_single_adc_channel();
+void send_event(uint8_t code, uint16_t param);
+uint8_t i2c_write_transaction(uint8_t address, const uint8_t* data, uint8_t len);
+uint8_t i2c_write_read_transaction(uint8_t address, const uint8_t* write_data, uint8_t write_len, uint8_t* read_data, uint8_t& read_len);
+void send_i2c_read_response(uint8_t status, const uint8_t* data, uint8_t len, uint8_t request_id);
+void send_i2c_write_response(uint8_t status, uint8_t request_id);
+void send_i2c_push(char type, uint8_t id, uint16_t value, const uint8_t* data, uint8_t len);
+void run_i2c_script(const char* script, uint8_t request_id);
+uint8_t set_i2c_watch(const uint16_t* fields, uint8_t field_count);
+uint8_t parse_hex_fields(const char*& p, uint16_t* fields, uint8_t max_fields);
+int8_t parse_i2c_script_step(const char*& p, uint8_t* out, uint8_t max_len);
+void run_i2c_read_block(const uint16_t* fields, uint8_t request_id);
+uint8_t write_i2c_block_segment(const uint16_t* fields, uint8_t* segment, int8_t len);
+void run_i2c_watches();
+void start_adc_sampling();
+void update_adc_readings();
+void set_serial_baud_rate(uint32_t baud);
+void count_link_error();
 
 // ======================================================================
 
@@ -207,23 +257,6 @@ int freeRam () {
   return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
 }
 
-uint8_t calculate_checksum(const char* data_str) {
-  uint8_t crc = 0x00;
-  uint8_t polynomial = 0x07;
-  size_t length = strlen(data_str);
-  for (size_t i = 0; i < length; i++) {
-    crc ^= data_str[i];
-    for (int j = 0; j < 8; j++) {
-      if (crc & 0x80) {
-        crc = (crc << 1) ^ polynomial;
-      } else {
-        crc <<= 1;
-      }
-    }
-  }
-  return crc;
-}
-
 void blink_error_code(uint8_t blinks) {
   for (uint8_t i = 0; i < blinks; ++i) {
     digitalWrite(DEBUG_LED_PIN, HIGH);
@@ -234,108 +267,83 @@ void blink_error_code(uint8_t blinks) {
 }
 
 // ======================================================================
-//  ROUND-ROBIN ADC READING
+//  ADC SAMPLING
 // ======================================================================
 
-void read_single_adc_channel() {
-  unsigned long current_time = millis();
-  
-  // Only read ADC if enough time has passed
-  if (current_time - last_adc_read_time < ADC_READ_INTERVAL_MS) {
-    return;
+// Timer1 compare match B starts every conversion, ADC_SAMPLE_RATE_HZ in
+// total. The ISR accumulates the result and points the multiplexer at the
+// next channel before the next trigger, so each channel gets evenly spaced
+// samples and a window covers exactly 60 (or 50) mains cycles.
+void start_adc_sampling() {
+  DIDR0 = (1 << ADC0D) | (1 << ADC1D) | (1 << ADC2D) | (1 << ADC3D); // A0..A3 are analog only
+  ADMUX = (1 << REFS0) | (adc_channel_pins[0] - A0);                 // AVcc reference, as analogRead()
+
+  // Timer1 CTC at F_CPU / 8, TOP in OCR1A; compare B at TOP is the trigger
+  TCCR1A = 0;
+  TCCR1B = (1 << WGM12) | (1 << CS11);
+  OCR1A = F_CPU / 8 / ADC_SAMPLE_RATE_HZ - 1;
+  OCR1B = OCR1A;
+  TCNT1 = 0;
+
+  ADCSRB = (1 << ADTS2) | (1 << ADTS0);                              // Trigger: Timer1 compare match B
+  ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIE) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0); // 125 kHz, 104 us per conversion
+}
+
+ISR(ADC_vect) {
+  uint16_t reading = ADC;
+  uint8_t channel = adc_channel;
+  volatile AdcWindow& window = adc_windows[adc_fill];
+
+  // The trigger fires on the flag's rising edge, clear it for the next one
+  TIFR1 = (1 << OCF1B);
+
+  window.sum[channel] += reading;
+  if (channel < ADC_CT_CHANNEL_COUNT) {
+    window.sum_of_squares[channel] += (uint32_t)reading * reading;
   }
-  
-  last_adc_read_time = current_time;
-  
-  switch (current_adc_channel) {
-    case ADC_PRESSURE:
-      pressure_adc_raw = analogRead(PRESSURE_SENSOR_PIN);
-      break;
-      
-    case ADC_FAN_CT: {
-      int reading = analogRead(FAN_CT_CLAMP_PIN);
-      fan_ct_sum_of_samples += reading;
-      fan_ct_sum_of_squares += (long)reading * reading;
-      fan_ct_sample_count++;
-      
-      if (fan_ct_sample_count >= RMS_SAMPLE_COUNT) {
-        float mean_of_samples = (float)fan_ct_sum_of_samples / RMS_SAMPLE_COUNT;
-        float mean_of_squares = (float)fan_ct_sum_of_squares / RMS_SAMPLE_COUNT;
-        float variance = mean_of_squares - (mean_of_samples * mean_of_samples);
-        float rms_adc = sqrt(variance);
-        float voltage = rms_adc * (5.0 / 1023.0);
-        fan_amps = voltage / FAN_CT_VOLTS_PER_AMP;
-        
-        // Reset for next calculation
-        fan_ct_sum_of_squares = 0;
-        fan_ct_sum_of_samples = 0;
-        fan_ct_sample_count = 0;
-      }
-      break;
-    }
-    
-    case ADC_COMPRESSOR_CT: {
-      int reading = analogRead(COMPRESSOR_CT_CLAMP_PIN);
-      compressor_ct_sum_of_samples += reading;
-      compressor_ct_sum_of_squares += (long)reading * reading;
-      compressor_ct_sample_count++;
-      
-      if (compressor_ct_sample_count >= RMS_SAMPLE_COUNT) {
-        float mean_of_samples = (float)compressor_ct_sum_of_samples / RMS_SAMPLE_COUNT;
-        float mean_of_squares = (float)compressor_ct_sum_of_squares / RMS_SAMPLE_COUNT;
-        float variance = mean_of_squares - (mean_of_samples * mean_of_samples);
-        float rms_adc = sqrt(variance);
-        float voltage = rms_adc * (5.0 / 1023.0);
-        compressor_amps = voltage / COMPRESSOR_CT_VOLTS_PER_AMP;
-        
-        // Reset for next calculation
-        compressor_ct_sum_of_squares = 0;
-        compressor_ct_sum_of_samples = 0;
-        compressor_ct_sample_count = 0;
-      }
-      break;
-    }
-    
-    case ADC_GEOTHERMAL_PUMP_CT: {
-      int reading = analogRead(GEOTHERMAL_PUMP_CT_CLAMP_PIN);
-      geothermal_pump_ct_sum_of_samples += reading;
-      geothermal_pump_ct_sum_of_squares += (long)reading * reading;
-      geothermal_pump_ct_sample_count++;
-      
-      if (geothermal_pump_ct_sample_count >= RMS_SAMPLE_COUNT) {
-        float mean_of_samples = (float)geothermal_pump_ct_sum_of_samples / RMS_SAMPLE_COUNT;
-        float mean_of_squares = (float)geothermal_pump_ct_sum_of_squares / RMS_SAMPLE_COUNT;
-        float variance = mean_of_squares - (mean_of_samples * mean_of_samples);
-        float rms_adc = sqrt(variance);
-        float voltage = rms_adc * (5.0 / 1023.0);
-        geothermal_pump_amps = voltage / GEOTHERMAL_PUMP_CT_VOLTS_PER_AMP;
-        
-        // Reset for next calculation
-        geothermal_pump_ct_sum_of_squares = 0;
-        geothermal_pump_ct_sum_of_samples = 0;
-        geothermal_pump_ct_sample_count = 0;
-      }
-      break;
-    }
-    
-    case ADC_CO_SENSOR: {
-      uint16_t reading = analogRead(CO_SENSOR_PIN);
-      
-      // Update EMA (floating-point version)
-      if (!co_adc_ema_initialized) {
-        co_adc_ema = (float)reading;
-        co_adc_ema_initialized = true;
-      } else {
-        co_adc_ema = (float)reading * CO_EMA_ALPHA + co_adc_ema * (1.0f - CO_EMA_ALPHA);
-      }
-      co_adc_raw = (uint16_t)co_adc_ema;
-      
-      break;
+
+  if (++channel == ADC_CHANNEL_COUNT) {
+    channel = 0;
+    if (++adc_window_samples == RMS_SAMPLE_COUNT) {
+      // Swap windows, the new one starts from zero
+      adc_window_samples = 0;
+      adc_fill ^= 1;
+      volatile AdcWindow& next = adc_windows[adc_fill];
+      for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) next.sum[i] = 0;
+      for (uint8_t i = 0; i < ADC_CT_CHANNEL_COUNT; i++) next.sum_of_squares[i] = 0;
+      adc_window_ready = true;
     }
   }
-  
-  // Move to next channel
-  current_adc_channel = (current_adc_channel + 1) % ADC_CHANNEL_COUNT;
+  ADMUX = (1 << REFS0) | (adc_channel_pins[channel] - A0);
+  adc_channel = channel;
+}
+
+// RMS of a CT clamp's AC signal over one window, the DC bias removed
+float ct_rms_amps(const AdcWindow& window, uint8_t channel, float volts_per_amp) {
+  float mean_of_samples = (float)window.sum[channel] / RMS_SAMPLE_COUNT;
+  float mean_of_squares = (float)window.sum_of_squares[channel] / RMS_SAMPLE_COUNT;
+  float variance = mean_of_squares - (mean_of_samples * mean_of_samples);
+  float rms_adc = variance > 0 ? sqrt(variance) : 0;
+  float voltage = rms_adc * (5.0 / 1023.0);
+  return voltage / volts_per_amp;
+}
+
+// Picks up a completed window, once a second
+void update_adc_readings() {
+  if (!adc_window_ready) return;
+
+  AdcWindow window;
+  noInterrupts();
+  memcpy(&window, (const void*)&adc_windows[adc_fill ^ 1], sizeof(window));
+  adc_window_ready = false;
+  interrupts();
+
+  fan_amps = ct_rms_amps(window, ADC_FAN_CT, FAN_CT_VOLTS_PER_AMP);
+  compressor_amps = ct_rms_amps(window, ADC_COMPRESSOR_CT, COMPRESSOR_CT_VOLTS_PER_AMP);
+  geothermal_pump_amps = ct_rms_amps(window, ADC_GEOTHERMAL_PUMP_CT, GEOTHERMAL_PUMP_CT_VOLTS_PER_AMP);
+  // Window means, 1000 samples smooth the pressure loop and the CO sensor
+  pressure_adc_raw = window.sum[ADC_PRESSURE] / RMS_SAMPLE_COUNT;
+  co_adc_raw = window.sum[ADC_CO_SENSOR] / RMS_SAMPLE_COUNT;
 }
 
 // ======================================================================
@@ -398,6 +406,7 @@ void setup() {
     pinMode(COMPRESSOR_CT_CLAMP_PIN, INPUT);
     pinMode(GEOTHERMAL_PUMP_CT_CLAMP_PIN, INPUT);
     pinMode(CO_SENSOR_PIN, INPUT);
+    start_adc_sampling();
 }
 
 // ======================================================================
@@ -409,6 +418,7 @@ void loop() {
   static char command_buffer[MAX_COMMAND_LEN];
   static uint8_t command_len = 0;
   static bool in_command = false;
+  static bool in_binary = false;
   static unsigned long command_start_time = 0;
   static unsigned long last_i2c_check_time = 0;
 
@@ -418,22 +428,53 @@ void loop() {
   if (current_time - last_i2c_check_time >= 10000) {
     last_i2c_check_time = current_time;
     if (checkAndRecoverI2C()) {
-        send_error_response(E_I2C_BUS_STUCK_0);
+        send_event(NANO_EVENT_I2C_BUS_STUCK, 0);
     }
   }
 
-  // Read one ADC channel per loop iteration (round-robin)
-  read_single_adc_channel();
+  // Currents, pressure and CO from the last complete ADC window
+  update_adc_readings();
 
-  if (in_command && (current_time - command_start_time > COMMAND_TIMEOUT_MS)) {
+  // Drop back to the default speed when the ESP32 cannot be heard at the fast one
+  if (serial_baud_rate != SERIAL_BAUD_RATE &&
+      ((!serial_baud_verified && current_time - serial_baud_switch_time > LINK_BAUD_VERIFY_TIMEOUT_MS) ||
+       current_time - last_valid_command_time > LINK_SILENCE_TIMEOUT_MS ||
+       link_error_count > LINK_MAX_CRC_ERRORS)) {
+    set_serial_baud_rate(SERIAL_BAUD_RATE);
     in_command = false;
+    in_binary = false;
     command_len = 0;
   }
 
-  if (Serial.available() > 0) {
+  if ((in_command || in_binary) && (current_time - command_start_time > COMMAND_TIMEOUT_MS)) {
+    in_command = false;
+    in_binary = false;
+    command_len = 0;
+  }
+
+  // Drain everything buffered, at 500 kbaud a byte arrives every 20 us
+  while (Serial.available() > 0) {
     char c = Serial.read();
 
-    if (c == '<') {
+    // Binary frames are delimited by zeros on both ends, see protocol/Frames.h
+    if (c == BINARY_FRAME_DELIMITER) {
+      if (in_binary && command_len > 0) {
+        process_binary_command(reinterpret_cast<uint8_t*>(command_buffer), command_len);
+        in_binary = false;
+      } else {
+        in_binary = true;
+        command_start_time = current_time;
+      }
+      in_command = false;
+      command_len = 0;
+    } else if (in_binary) {
+      if (command_len < BINARY_FRAME_MAX_ENCODED_LEN) {
+        command_buffer[command_len++] = c;
+      } else {
+        in_binary = false;
+        command_len = 0;
+      }
+    } else if (c == '<') {
       in_command = true;
       command_len = 0;
       command_start_time = current_time;
@@ -452,83 +493,200 @@ void loop() {
       }
     }
   }
+
+  // Register watches go out on the bridge channel, ahead of telemetry
+  run_i2c_watches();
+
+  // Native sensor reads run one job per pass, so a bridge command waits for
+  // one job instead of a whole SPS30, SCD30 and SGP41 cycle. A due job
+  // yields while a command is coming in, for up to SENSOR_JOB_MAX_DEFER_MS.
+  if (sensor_job != SENSOR_JOB_IDLE && current_time - sensor_job_time >= sensor_job_wait_ms) {
+    bool link_busy = in_command || in_binary || Serial.available() > 0;
+    if (!link_busy || current_time - sensor_job_time >= sensor_job_wait_ms + SENSOR_JOB_MAX_DEFER_MS) {
+      unsigned long job_start = millis();
+      bool cycle_done = run_sensor_job();
+      unsigned long hold_ms = millis() - job_start;
+      if (hold_ms > max_bus_hold_ms) max_bus_hold_ms = hold_ms;
+      if (cycle_done) {
+        // One frame answers a pending CMD_GET_SENSORS and feeds the stream
+        send_data_packet(millis(), sensor_reply_pending ? sensor_reply_id : REQUEST_ID_NONE);
+        sensor_reply_pending = false;
+      }
+    }
+  }
+
+  // Push sensor data on our own clock once the ESP32 subscribed. Telemetry is
+  // the lowest priority channel: a due frame waits while a command is coming
+  // in or earlier responses are still in the TX buffer, so bridge and event
+  // traffic never queue up behind it, see protocol_telemetry_may_start().
+  if (sensor_stream_period_ms && (current_time - last_sensor_stream_time >= sensor_stream_period_ms)) {
+    bool rx_busy = in_command || in_binary || Serial.available() > 0;
+    bool tx_pending = Serial.availableForWrite() < SERIAL_TX_BUFFER_SIZE - 1;
+    if (protocol_telemetry_may_start(rx_busy, tx_pending, current_time - last_sensor_stream_time - sensor_stream_period_ms)) {
+      last_sensor_stream_time = current_time;
+      start_sensor_cycle();
+    }
+  }
 }
 
 // ======================================================================
 //  SENSOR & DATA FUNCTIONS
 // ======================================================================
-unsigned long read_all_sensors() {
-  int temp_val;
-  uint16_t temp_uval;
+// Starts a read cycle unless one is running, loop() runs its jobs
+void start_sensor_cycle() {
+  if (sensor_job != SENSOR_JOB_IDLE) return;
   digitalWrite(DEBUG_LED_PIN, !digitalRead(DEBUG_LED_PIN));
-  
-  // If the bus is stuck (and recovery fails), abort the entire sensor read cycle.
-  if (checkAndRecoverI2C()) {
-      send_error_response(E_I2C_BUS_STUCK_1);
-      return millis(); // Return early
-  }
-  
-  Wire.setClock(I2C_NORMAL_SPEED);
-  int16_t ret_sps_read = sps30_read_data_ready(&temp_uval);
-  if (ret_sps_read != 0) {
-    send_error_response(E_SPS30_DATA_READY_ERROR_1);
-  }
-  if (ret_sps_read == 0 && temp_uval) {
-    int16_t ret_sps_measurement = sps30_read_measurement(&current_sps_data);
-    if (ret_sps_measurement != 0) {
-      send_error_response(E_SPS30_MEASUREMENT_ERROR_1);
+  queue_sensor_job(SENSOR_JOB_SPS30_READY, 0);
+}
+
+void queue_sensor_job(uint8_t job, uint16_t wait_ms) {
+  sensor_job = job;
+  sensor_job_time = millis();
+  sensor_job_wait_ms = wait_ms;
+}
+
+// Runs the current job, one or two transactions with one sensor. Returns
+// true once the cycle ended and the readings are ready to send.
+bool run_sensor_job() {
+  int16_t ret;
+  uint16_t words[2];
+  switch (sensor_job) {
+    case SENSOR_JOB_SPS30_READY:
+      // If the bus is stuck (and recovery fails), abort the entire sensor read cycle.
+      if (checkAndRecoverI2C()) {
+        send_event(NANO_EVENT_I2C_BUS_STUCK, 1);
+        sensor_job = SENSOR_JOB_IDLE;
+        return true;
+      }
+      Wire.setClock(I2C_NORMAL_SPEED);
+      ret = sps30_read_data_ready(&sensor_data_ready);
+      if (ret != 0) {
+        send_event(NANO_EVENT_SPS30_DATA_READY, ret);
+      }
+      queue_sensor_job((ret == 0 && sensor_data_ready) ? SENSOR_JOB_SPS30_READ : SENSOR_JOB_SCD30_READY, 0);
+      return false;
+
+    case SENSOR_JOB_SPS30_READ:
+      ret = sps30_read_measurement(&current_sps_data);
+      if (ret != 0) {
+        send_event(NANO_EVENT_SPS30_MEASUREMENT, ret);
+      }
+      queue_sensor_job(SENSOR_JOB_SCD30_READY, 0);
+      return false;
+
+    case SENSOR_JOB_SCD30_READY:
+      ret = scd30_sensor.getDataReady(sensor_data_ready);
+      if (ret != 0) {
+        send_event(NANO_EVENT_SCD30_DATA_READY, ret);
+      }
+      queue_sensor_job((ret == 0 && sensor_data_ready) ? SENSOR_JOB_SCD30_READ : SENSOR_JOB_SGP41_START, 0);
+      return false;
+
+    case SENSOR_JOB_SCD30_READ:
+      ret = scd30_sensor.readMeasurementData(current_co2, current_temp_c, current_humi);
+      if (ret != 0) {
+        send_event(NANO_EVENT_SCD30_MEASUREMENT, ret);
+      } else {
+        last_scd30_update = millis();
+      }
+      queue_sensor_job(SENSOR_JOB_SGP41_START, 0);
+      return false;
+
+    case SENSOR_JOB_SGP41_START: {
+      if (millis() - last_scd30_update > SCD30_INVALIDATE_TIMEOUT_MS) {
+        current_co2 = NAN;
+        current_temp_c = NAN;
+        current_humi = NAN;
+      }
+      uint16_t rh = static_cast<uint16_t>(current_humi * 65535.0f / 100.0f);
+      uint16_t temp = static_cast<uint16_t>((current_temp_c + 45.0f) * 65535.0f / 175.0f);
+      ret = sgp41_send_command(conditioning_s > 0 ? SGP41_CMD_CONDITIONING : SGP41_CMD_MEASURE_RAW, rh, temp);
+      if (ret == 0) {
+        // The bus is free for bridge commands while the SGP41 measures
+        queue_sensor_job(SENSOR_JOB_SGP41_READ, SGP41_MEASURE_TIME_MS);
+        return false;
+      }
+      break;
     }
-  }
 
-  temp_val = scd30_sensor.getDataReady(temp_uval);
-  if (temp_val != 0) {
-    send_error_response(E_SCD30_DATA_READY_ERROR_1);
+    case SENSOR_JOB_SGP41_READ:
+      ret = sgp41_read_words(words, conditioning_s > 0 ? 1 : 2);
+      if (ret == 0) {
+        current_voc_raw = words[0];
+        if (conditioning_s == 0) current_nox_raw = words[1];
+      }
+      break;
+
+    default:
+      sensor_job = SENSOR_JOB_IDLE;
+      return false;
   }
-  if (temp_val == 0 && temp_uval) {
-    temp_val = scd30_sensor.readMeasurementData(current_co2, current_temp_c, current_humi);
-    if (temp_val != 0) {
-      send_error_response(E_SCD30_MEASUREMENT_ERROR_1);
-    }
-    if (temp_val == 0) {
-      last_scd30_update = millis();
-    }
+
+  // The SGP41 ends the cycle, whichever of its jobs failed
+  if (ret != 0) {
+    send_event(conditioning_s > 0 ? NANO_EVENT_SGP41_CONDITIONING : NANO_EVENT_SGP41_MEASUREMENT, ret);
+    current_voc_raw = 0;
+    current_nox_raw = 0;
   }
-  
-  if (millis() - last_scd30_update > SCD30_INVALIDATE_TIMEOUT_MS) {
-    current_co2 = NAN;
-    current_temp_c = NAN;
-    current_humi = NAN;
+  if (conditioning_s > 0) conditioning_s--;
+  checkAndReportI2cTimeout();
+  sensor_job = SENSOR_JOB_IDLE;
+  return true;
+}
+
+// The SGP41 NACKs every command while it measures, and a command sent after
+// the measurement replaces its result. Direct access waits out the rest of
+// the measurement, and the cycle measures again once it is done.
+void sgp41_defer_measurement() {
+  if (sensor_job != SENSOR_JOB_SGP41_READ) return;
+  unsigned long elapsed_ms = millis() - sensor_job_time;
+  if (elapsed_ms < SGP41_MEASURE_TIME_MS) {
+    // The command waits like it would behind a sensor job
+    uint16_t wait_ms = SGP41_MEASURE_TIME_MS - elapsed_ms;
+    delay(wait_ms);
+    if (wait_ms > max_bus_hold_ms) max_bus_hold_ms = wait_ms;
   }
-  
-  uint16_t rh = static_cast<uint16_t>(current_humi * 65535.0f / 100.0f);
-  uint16_t temp = static_cast<uint16_t>((current_temp_c + 45.0f) * 65535.0f / 175.0f);
+  queue_sensor_job(SENSOR_JOB_SGP41_START, 0);
+}
 
-  if (conditioning_s > 0) {
-    Wire.setClock(I2C_FAST_SPEED);
-    temp_uval = sgp41_sensor.executeConditioning(rh, temp, current_voc_raw);
-    if (temp_uval != 0) {
-      send_error_response(E_SGP41_CONDITIONING_ERROR_1);
-    }
-    conditioning_s--;
-  } else {
-    temp_uval = sgp41_sensor.measureRawSignals(rh, temp, current_voc_raw, current_nox_raw);
-    if (temp_uval != 0) {
-      send_error_response(E_SGP41_MEASUREMENT_ERROR_1);
+// Sensirion word CRC: polynomial 0x31, init 0xFF
+uint8_t sensirion_crc8(uint8_t msb, uint8_t lsb) {
+  uint8_t crc = 0xFF;
+  uint8_t bytes[2] = { msb, lsb };
+  for (uint8_t i = 0; i < 2; i++) {
+    crc ^= bytes[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
     }
   }
-  Wire.setClock(I2C_NORMAL_SPEED);
-  
-  if (temp_uval) {
-    current_voc_raw = 0;
-    current_nox_raw = 0;
-  }
+  return crc;
+}
 
-  checkAndReportI2cTimeout();
-  
-  return millis(); // Return the timestamp
+// Command with the humidity and temperature compensation words, 0 or SGP41_ERROR_WRITE | status
+uint16_t sgp41_send_command(uint16_t command, uint16_t rh, uint16_t temp) {
+  uint8_t frame[8] = { (uint8_t)(command >> 8), (uint8_t)command,
+                       (uint8_t)(rh >> 8), (uint8_t)rh, sensirion_crc8(rh >> 8, rh),
+                       (uint8_t)(temp >> 8), (uint8_t)temp, sensirion_crc8(temp >> 8, temp) };
+  Wire.beginTransmission(SGP41_I2C_ADDR);
+  Wire.write(frame, sizeof(frame));
+  uint8_t status = Wire.endTransmission();
+  return status ? (SGP41_ERROR_WRITE | status) : 0;
+}
+
+// Reads count words, each followed by its CRC
+uint16_t sgp41_read_words(uint16_t* words, uint8_t count) {
+  uint8_t len = count * 3;
+  if (Wire.requestFrom((uint8_t)SGP41_I2C_ADDR, len) != len) return SGP41_ERROR_READ;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t msb = Wire.read();
+    uint8_t lsb = Wire.read();
+    if (Wire.read() != sensirion_crc8(msb, lsb)) return SGP41_ERROR_CRC;
+    words[i] = ((uint16_t)msb << 8) | lsb;
+  }
+  return 0;
 }
 
-void send_data_packet(unsigned long timestamp) {
+void send_data_packet(unsigned long timestamp, uint8_t request_id) {
   digitalWrite(DEBUG_LED_PIN, !digitalRead(DEBUG_LED_PIN));
 
   uint16_t pulse_count;
@@ -537,32 +695,73 @@ void send_data_packet(unsigned long timestamp) {
   geiger_pulse_count = 0;
   interrupts();
 
-  bool liquid_level_sensor_state = digitalRead(LIQUID_LEVEL_SENSOR_PIN);
-  
-  long t_val = (long)(current_temp_c * 10);
-  long h_val = (long)(current_humi * 10);
-  long co2_val = (long)current_co2;
-  long amps_val = (long)(fan_amps * 100);
-  long pm1_val = (long)(current_sps_data.mc_1p0 * 10);
-  long pm25_val = (long)(current_sps_data.mc_2p5 * 10);
-  long pm4_val = (long)(current_sps_data.mc_4p0 * 10);
-  long pm10_val = (long)(current_sps_data.mc_10p0 * 10);
-  
-  snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), 
-           FMT_DATA_PACKET,
-           RSP_SENSORS, timestamp, pressure_adc_raw, pulse_count, t_val, h_val, co2_val, current_voc_raw, current_nox_raw,
-           amps_val, pm1_val, pm25_val, pm4_val, pm10_val,
-           (long)(compressor_amps * 100), (long)(geothermal_pump_amps * 100), liquid_level_sensor_state,
-           co_adc_raw
-           );
+  // Same struct for both formats, the ASCII layout comes from protocol/Schema.h
+  NanoSensorFrame frame;
+  frame.timestamp = timestamp;
+  frame.pressure_adc_raw = pressure_adc_raw;
+  frame.pulse_count = pulse_count;
+  frame.temperature_x10 = (int16_t)(current_temp_c * 10);
+  frame.humidity_x10 = (int16_t)(current_humi * 10);
+  frame.co2_ppm = (uint16_t)current_co2;
+  frame.voc_raw = current_voc_raw;
+  frame.nox_raw = current_nox_raw;
+  frame.fan_amps_x100 = (uint16_t)(fan_amps * 100);
+  frame.pm1_x10 = (uint16_t)(current_sps_data.mc_1p0 * 10);
+  frame.pm25_x10 = (uint16_t)(current_sps_data.mc_2p5 * 10);
+  frame.pm4_x10 = (uint16_t)(current_sps_data.mc_4p0 * 10);
+  frame.pm10_x10 = (uint16_t)(current_sps_data.mc_10p0 * 10);
+  frame.compressor_amps_x100 = (uint16_t)(compressor_amps * 100);
+  frame.geothermal_pump_amps_x100 = (uint16_t)(geothermal_pump_amps * 100);
+  frame.liquid_level_raw = digitalRead(LIQUID_LEVEL_SENSOR_PIN);
+  frame.co_adc_raw = co_adc_raw;
+  frame.sequence = sensor_frame_sequence++;
+
+  if (binary_frames_enabled) {
+    // Streamed frames only carry the changed fields between keyframes
+    uint8_t delta[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+    size_t delta_len = 0;
+    if (delta_frames_enabled && request_id == REQUEST_ID_NONE && frames_since_keyframe < SENSOR_KEYFRAME_INTERVAL - 1) {
+      delta_len = sensor_delta_encode(last_sensor_frame, frame, delta, sizeof(delta));
+    }
+    if (delta_len > 0) {
+      send_binary_frame(RSP_SENSORS_DELTA, REQUEST_ID_NONE, delta, delta_len);
+      frames_since_keyframe++;
+    } else {
+      send_binary_frame(RSP_SENSORS, request_id, &frame, sizeof(frame));
+      frames_since_keyframe = 0;
+    }
+    last_sensor_frame = frame;
+    return;
+  }
+
+  if (protocol_ascii_encode(frame, tx_command_buffer, sizeof(tx_command_buffer)) > 0) {
+    send_ascii_packet(tx_command_buffer, request_id);
+  }
+}
+
+// Encoded in place in tx_command_buffer, see binary_frame_encode()
+void send_binary_frame(uint8_t type, uint8_t request_id, const void* payload, uint8_t payload_len) {
+  uint8_t* frame = reinterpret_cast<uint8_t*>(tx_command_buffer);
+  const size_t encoded_len = binary_frame_encode(type, request_id, payload, payload_len, frame, sizeof(tx_command_buffer));
+  if (encoded_len == 0) return;
+
+  Serial.write(BINARY_FRAME_DELIMITER);
+  Serial.write(frame, encoded_len);
+  Serial.write(BINARY_FRAME_DELIMITER);
+}
 
-  const uint8_t checksum = calculate_checksum(tx_command_buffer);
+// Sends "<DATA,CRC8>", prefixed with the "#XX" tag of the command it answers.
+// The tag is covered by the checksum.
+void send_ascii_packet(const char* data, uint8_t request_id) {
+  char tag[ASCII_REQUEST_ID_LEN + 1] = "";
+  if (request_id != REQUEST_ID_NONE) {
+    snprintf_P(tag, sizeof(tag), FMT_REQUEST_ID, ASCII_REQUEST_ID_PREFIX, request_id);
+  }
+  uint8_t checksum = 0;
+  for (const char* c = tag; *c; c++) checksum = crc8_update(checksum, (uint8_t)*c);
+  for (const char* c = data; *c; c++) checksum = crc8_update(checksum, (uint8_t)*c);
 
-  Serial.print('<');
-  Serial.print(tx_command_buffer);
-  Serial.print(',');
-  Serial.print(checksum);
-  Serial.println('>');
+  Serial.print('<'); Serial.print(tag); Serial.print(data); Serial.print(','); Serial.print(checksum); Serial.println('>');
 }
 
 void process_command(const char* buffer) {
@@ -573,14 +772,23 @@ void process_command(const char* buffer) {
     const uint8_t received_checksum = atoi(comma + 1);
     char temp_char = buffer[data_len];
     const_cast<char*>(buffer)[data_len] = '\0';
-    const uint8_t calculated_checksum = calculate_checksum(buffer);
+    const uint8_t calculated_checksum = crc8_calculate(buffer);
     const_cast<char*>(buffer)[data_len] = temp_char;
-  if (received_checksum != calculated_checksum) return;
+  if (received_checksum != calculated_checksum) {
+    count_link_error();
+    return;
+  }
+  last_valid_command_time = millis();
+
+  // Tagged commands are answered with the same request ID
+  uint8_t request_id;
+  const char* untagged = ascii_packet_split_request_id(buffer, &request_id);
+  data_len -= untagged - buffer;
+  buffer = untagged;
+  if (data_len <= 0) return;
 
   char command = buffer[0];
-  uint8_t checksum;
   uint32_t uint32_val = 0;
-  uint8_t uint8_val1 = 0, uint8_val2 = 0;
   int16_t int_val = 0;
   uint16_t uint_val = 0, uint_val2 = 0;
   
@@ -591,15 +799,28 @@ void process_command(const char* buffer) {
 
   switch (command) {
     case CMD_GET_VERSION:
-      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_GET_VERSION, RSP_VERSION, NANO_FIRMWARE_VERSION);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      // Optional payload: ESP32 capabilities in hex. A bare 'V' keeps ASCII frames.
+      uint_val = (data_len > 1) ? (uint16_t)strtoul(buffer + 1, nullptr, 16) : 0;
+      binary_frames_enabled = (uint_val & PROTOCOL_CAP_BINARY_FRAMES) != 0;
+      delta_frames_enabled = binary_frames_enabled && (uint_val & PROTOCOL_CAP_DELTA_FRAMES) != 0;
+      binary_i2c_enabled = binary_frames_enabled && (uint_val & PROTOCOL_CAP_BINARY_I2C) != 0;
+      frames_since_keyframe = SENSOR_KEYFRAME_INTERVAL;
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_GET_VERSION, RSP_VERSION, NANO_FIRMWARE_VERSION, PROTOCOL_CAPABILITIES);
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
 
     case CMD_GET_HEALTH:
-      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_GET_HEALTH, RSP_HEALTH, first_health_status_sent ? 0 : 1, freeRam(), last_reset_cause);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_GET_HEALTH, RSP_HEALTH, first_health_status_sent ? 0 : 1, freeRam(), last_reset_cause, max_bus_hold_ms);
+      send_ascii_packet(tx_command_buffer, request_id);
+      max_bus_hold_ms = 0;
+      break;
+
+    case CMD_TIME_SYNC:
+      // t2 before the payload is parsed, t3 right before the response is built
+      uint32_val = millis();
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_TIME_SYNC, RSP_TIME_SYNC,
+                 strtoul(buffer + 1, nullptr, 16), uint32_val, millis());
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
 
     case CMD_ACK_HEALTH:
@@ -611,65 +832,86 @@ void process_command(const char* buffer) {
       while(1);
       break;
 
-    case CMD_GET_SENSORS: {
-      unsigned long timestamp = read_all_sensors();
-      send_data_packet(timestamp);
+    case CMD_GET_SENSORS:
+      // Answered by loop() when the read cycle ends
+      sensor_reply_pending = true;
+      sensor_reply_id = request_id;
+      start_sensor_cycle();
+      break;
+
+    case CMD_SENSOR_STREAM: {
+      uint32_val = (data_len > 1) ? strtoul(buffer + 1, nullptr, 10) : 0;
+      if (uint32_val > 0 && uint32_val < SENSOR_STREAM_MIN_PERIOD_MS) uint32_val = SENSOR_STREAM_MIN_PERIOD_MS;
+      if (uint32_val > 0xFFFF) uint32_val = 0xFFFF;
+      sensor_stream_period_ms = uint32_val;
+      last_sensor_stream_time = millis();
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_SENSOR_STREAM, RSP_SENSOR_STREAM, sensor_stream_period_ms);
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
     }
 
-    case CMD_GET_SPS30_INFO: {
-      tx_command_buffer[0] = RSP_SPS30_INFO;
+    case CMD_SET_BAUD_RATE: {
+      // Only rates the UART hits exactly with U2X (F_CPU / 8 / n), anything else keeps the current rate
+      uint32_val = (data_len > 1) ? strtoul(buffer + 1, nullptr, 10) : 0;
+      if (uint32_val != SERIAL_BAUD_RATE &&
+          (uint32_val == 0 || uint32_val > LINK_FAST_BAUD || (F_CPU / 8) % uint32_val != 0)) {
+        uint32_val = serial_baud_rate;
+      }
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_BAUD_RATE, RSP_BAUD_RATE, uint32_val);
+      send_ascii_packet(tx_command_buffer, request_id);
+      if (uint32_val != serial_baud_rate) {
+        set_serial_baud_rate(uint32_val);
+      }
+      break;
+    }
+
+    case CMD_PING:
+      serial_baud_verified = true;
+      tx_command_buffer[0] = RSP_PING;
       tx_command_buffer[1] = '\0';
-      char* pos = tx_command_buffer + 1;
+      send_ascii_packet(tx_command_buffer, request_id);
+      break;
+
+    case CMD_GET_SPS30_INFO: {
+      Sps30InfoFrame info;
       Wire.setClock(I2C_NORMAL_SPEED);
-      int_val = sps30_read_firmware_version(&uint8_val1, &uint8_val2);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SPS30_FW, int_val, uint8_val1, uint8_val2);
-      int_val = sps30_get_fan_auto_cleaning_interval(&uint32_val);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SPS30_INTERVAL, int_val, uint32_val);
-      int_val = sps30_get_fan_auto_cleaning_interval_days(&uint8_val1);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SPS30_INTERVAL_DAYS, int_val, uint8_val1);
-      int_val = sps30_read_device_status_register(&uint32_val);
-      snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SPS30_STATUS, int_val, uint32_val);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      info.ret_fw = sps30_read_firmware_version(&info.fw_major, &info.fw_minor);
+      info.ret_fan_interval = sps30_get_fan_auto_cleaning_interval(&info.fan_interval);
+      info.ret_fan_days = sps30_get_fan_auto_cleaning_interval_days(&info.fan_days);
+      info.ret_status = sps30_read_device_status_register(&info.status_reg);
+      if (protocol_ascii_encode(info, tx_command_buffer, sizeof(tx_command_buffer)) > 0) {
+        send_ascii_packet(tx_command_buffer, request_id);
+      }
       break;
     }
     case CMD_SPS30_CLEAN: {
       Wire.setClock(I2C_NORMAL_SPEED);
       int_val = sps30_start_manual_fan_cleaning();
       snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_SPS30_CLEAN, RSP_SPS30_CLEAN, int_val);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
     }
     case CMD_SGP41_TEST: {
+      sgp41_defer_measurement();
       Wire.setClock(I2C_FAST_SPEED);
       uint16_t sgp41_ret = sgp41_sensor.executeSelfTest(uint_val);
       Wire.setClock(I2C_NORMAL_SPEED);
       snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_SGP41_TEST, RSP_SGP41_TEST, sgp41_ret, uint_val);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
     }
     case CMD_GET_SCD30_INFO: {
-      tx_command_buffer[0] = RSP_SCD30_INFO;
-      tx_command_buffer[1] = '\0';
-      char* pos = tx_command_buffer + 1;
+      Scd30InfoFrame info;
       Wire.setClock(I2C_NORMAL_SPEED);
-      int_val = scd30_sensor.getMeasurementInterval(uint_val);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SCD30_READ, int_val, uint_val);
-      int_val = scd30_sensor.getAutoCalibrationStatus(uint_val);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SCD30_READ, int_val, uint_val);
-      int_val = scd30_sensor.getForceRecalibrationStatus(uint_val);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SCD30_READ, int_val, uint_val);
-      int_val = scd30_sensor.getTemperatureOffset(uint_val);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SCD30_READ, int_val, uint_val);
-      int_val = scd30_sensor.getAltitudeCompensation(uint_val);
-      pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SCD30_READ, int_val, uint_val);
-      int_val = scd30_sensor.readFirmwareVersion(uint8_val1, uint8_val2);
-      snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_SCD30_FW, int_val, uint8_val1, uint8_val2);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      info.ret_interval = scd30_sensor.getMeasurementInterval(info.measurement_interval);
+      info.ret_auto_cal = scd30_sensor.getAutoCalibrationStatus(info.auto_calibration);
+      info.ret_forced_cal = scd30_sensor.getForceRecalibrationStatus(info.forced_recalibration);
+      info.ret_temp_offset = scd30_sensor.getTemperatureOffset(info.temperature_offset);
+      info.ret_altitude = scd30_sensor.getAltitudeCompensation(info.altitude_compensation);
+      info.ret_firmware = scd30_sensor.readFirmwareVersion(info.fw_major, info.fw_minor);
+      if (protocol_ascii_encode(info, tx_command_buffer, sizeof(tx_command_buffer)) > 0) {
+        send_ascii_packet(tx_command_buffer, request_id);
+      }
       break;
     }
     case CMD_SET_SCD30_AUTOCAL: {
@@ -678,8 +920,7 @@ void process_command(const char* buffer) {
       int_val = scd30_sensor.activateAutoCalibration(uint_val);
       uint_val2 = scd30_sensor.getAutoCalibrationStatus(uint_val);
       snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_SCD30_AUTOCAL, RSP_SCD30_AUTOCAL, int_val, uint_val2, uint_val);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
     }
     case CMD_SET_SCD30_FORCECAL: {
@@ -691,8 +932,7 @@ void process_command(const char* buffer) {
       int_val = scd30_sensor.forceRecalibration(uint_val);
       uint_val2 = scd30_sensor.getForceRecalibrationStatus(uint_val);
       snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_SCD30_FORCECAL, RSP_SCD30_FORCECAL, int_val, uint_val2, uint_val);
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      send_ascii_packet(tx_command_buffer, request_id);
       break;
     }
     
@@ -714,7 +954,6 @@ void process_command(const char* buffer) {
       if (p == endptr) { i2c_status = I2C_ERROR_OTHER; break; }
       p = endptr;
 
-      if (i2c_num_bytes > I2C_WIRE_LIB_MAX_READ) i2c_num_bytes = I2C_WIRE_LIB_MAX_READ;
       if (write_len > I2C_CMD_MAX_WRITE_IN_READ) { i2c_status = I2C_ERROR_BUF_LEN; break; }
 
       uint8_t write_data[I2C_CMD_MAX_WRITE_IN_READ];
@@ -728,49 +967,8 @@ void process_command(const char* buffer) {
           if (i2c_status != I2C_ERROR_NONE) break;
       }
 
-      Wire.setClock(I2C_FAST_SPEED);
-      if (write_len > 0) {
-          Wire.beginTransmission(i2c_address);
-          Wire.write(write_data, write_len);
-          uint8_t i2c_result = Wire.endTransmission(false);
-
-          if (i2c_result != 0) {
-              i2c_status = (i2c_result == 2) ? I2C_ERROR_ADDR_NACK : I2C_ERROR_OTHER;
-              recoverI2Cbus();
-          } else {
-              delay(I2C_WRITE_READ_DELAY_MS);
-          }
-      }
-
-      if (i2c_status == I2C_ERROR_NONE && i2c_num_bytes > 0) {
-          uint8_t bytes_read = Wire.requestFrom(i2c_address, i2c_num_bytes);
-          if (bytes_read != i2c_num_bytes) {
-              i2c_status = I2C_ERROR_DATA_NACK;
-              i2c_num_bytes = bytes_read;
-              recoverI2Cbus();
-          }
-          for (uint8_t i = 0; i < bytes_read; i++) {
-              i2c_data[i] = Wire.read();
-          }
-      }
-      Wire.setClock(I2C_NORMAL_SPEED);
-
-      checkAndReportI2cTimeout();
-      
-      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_READ, RSP_I2C_READ, i2c_status, i2c_num_bytes);
-      if (i2c_status == I2C_ERROR_NONE && i2c_num_bytes > 0) {
-          char* pos = tx_command_buffer + strlen(tx_command_buffer);
-          for (uint8_t i = 0; i < i2c_num_bytes; i++) {
-              int written = snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_I2C_READ_DATA, i2c_data[i]);
-              if (written <= 0) {
-                  break;
-              }
-              pos += written;
-          }
-      }
-      
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+      i2c_status = i2c_write_read_transaction(i2c_address, write_data, write_len, i2c_data, i2c_num_bytes);
+      send_i2c_read_response(i2c_status, i2c_data, i2c_num_bytes, request_id);
       break;
     }
     
@@ -803,38 +1001,657 @@ void process_command(const char* buffer) {
           p = endptr;
       }
       if (i2c_status != I2C_ERROR_NONE) break;
-      Wire.setClock(I2C_FAST_SPEED);
-      Wire.beginTransmission(i2c_address);
-      Wire.write(i2c_data, i2c_num_bytes);
-      uint8_t i2c_result = Wire.endTransmission();
+      i2c_status = i2c_write_transaction(i2c_address, i2c_data, i2c_num_bytes);
+      if (i2c_status != I2C_ERROR_NONE) break;
 
-      if (i2c_result != 0) {
-          i2c_status = (i2c_result == 2) ? I2C_ERROR_ADDR_NACK : I2C_ERROR_OTHER;
-          recoverI2Cbus();
-          break;
+      send_i2c_write_response(i2c_status, request_id);
+      break;
+    }
+
+    case CMD_I2C_WRITE_CHUNK: {
+      // Every chunk is answered, the ESP32 only sends more once it got its credit back
+      const_cast<char*>(buffer)[data_len] = '\0'; // The checksum would parse as one more data byte
+      char* p = const_cast<char*>(buffer + 1);
+      char* endptr;
+
+      i2c_address = strtol(p, &endptr, 16);
+      if (p == endptr) i2c_status = I2C_ERROR_OTHER;
+      p = endptr; if (*p == ',') p++;
+
+      uint8_t offset = strtol(p, &endptr, 16);
+      if (p == endptr) i2c_status = I2C_ERROR_OTHER;
+      p = endptr; if (*p == ',') p++;
+
+      uint8_t total = strtol(p, &endptr, 16);
+      if (p == endptr || total > sizeof(i2c_write_staging)) i2c_status = I2C_ERROR_BUF_LEN;
+      p = endptr;
+
+      if (offset == 0) i2c_write_staged = 0;
+      if (offset != i2c_write_staged) i2c_status = I2C_ERROR_OTHER; // A chunk went missing
+
+      while (i2c_status == I2C_ERROR_NONE && *p == ',') {
+          p++;
+          if (i2c_write_staged >= total) { i2c_status = I2C_ERROR_BUF_LEN; break; }
+          i2c_write_staging[i2c_write_staged++] = strtol(p, &endptr, 16);
+          if (p == endptr) { i2c_status = I2C_ERROR_OTHER; break; }
+          p = endptr;
       }
-      Wire.setClock(I2C_NORMAL_SPEED);
+      if (i2c_status == I2C_ERROR_NONE && *p != '\0') i2c_status = I2C_ERROR_OTHER;
+
+      if (i2c_status != I2C_ERROR_NONE) {
+          i2c_write_staged = 0;
+      } else if (i2c_write_staged < total) {
+          i2c_status = I2C_ERROR_PENDING;
+      } else {
+          checkAndRecoverI2C();
+          i2c_status = i2c_write_transaction(i2c_address, i2c_write_staging, total);
+          i2c_write_staged = 0;
+      }
+
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_WRITE, RSP_I2C_WRITE_CHUNK, i2c_status);
+      send_ascii_packet(tx_command_buffer, request_id);
+      break;
+    }
+
+    case CMD_I2C_SCRIPT:
+      const_cast<char*>(buffer)[data_len] = '\0'; // Cut the checksum off, the script runs to the end
+      run_i2c_script(buffer + 1, request_id);
+      break;
+
+    case CMD_I2C_WATCH: {
+      uint16_t fields[I2C_WATCH_FIELDS];
+      const_cast<char*>(buffer)[data_len] = '\0'; // The checksum would parse as one more field
+      const char* p = buffer + 1;
+      const uint8_t field_count = parse_hex_fields(p, fields, I2C_WATCH_FIELDS);
+      i2c_status = (*p == '\0') ? set_i2c_watch(fields, field_count) : I2C_ERROR_OTHER;
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_WRITE, RSP_I2C_WATCH, i2c_status);
+      send_ascii_packet(tx_command_buffer, request_id);
+      break;
+    }
+
+    case CMD_I2C_READ_BLOCK: {
+      uint16_t fields[I2C_READ_BLOCK_FIELDS] = {0};
+      const_cast<char*>(buffer)[data_len] = '\0';
+      const char* p = buffer + 1;
+      if (parse_hex_fields(p, fields, I2C_READ_BLOCK_FIELDS) == I2C_READ_BLOCK_FIELDS && *p == '\0') {
+        run_i2c_read_block(fields, request_id);
+      } else {
+        snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_READ_BLOCK, RSP_I2C_READ_BLOCK, fields[0], I2C_ERROR_OTHER, 0);
+        send_ascii_packet(tx_command_buffer, request_id);
+      }
+      break;
+    }
+
+    case CMD_I2C_WRITE_BLOCK: {
+      uint16_t fields[I2C_WRITE_BLOCK_FIELDS];
+      uint8_t segment[I2C_TRANSFER_WRITE_SEGMENT + 1]; // Register first
+      const_cast<char*>(buffer)[data_len] = '\0';
+      const char* p = buffer + 1;
+      if (parse_hex_fields(p, fields, I2C_WRITE_BLOCK_FIELDS) == I2C_WRITE_BLOCK_FIELDS) {
+        const int8_t len = parse_i2c_script_step(p, segment + 1, I2C_TRANSFER_WRITE_SEGMENT);
+        i2c_status = write_i2c_block_segment(fields, segment, (*p == '\0') ? len : -1);
+      } else {
+        i2c_status = I2C_ERROR_OTHER;
+      }
+      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_WRITE, RSP_I2C_WRITE_BLOCK, i2c_status);
+      send_ascii_packet(tx_command_buffer, request_id);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+// One write transaction, returns an I2C_ERROR_* code
+uint8_t i2c_write_transaction(uint8_t address, const uint8_t* data, uint8_t len) {
+  if (address == SGP41_I2C_ADDR) sgp41_defer_measurement();
+  Wire.setClock(I2C_FAST_SPEED);
+  Wire.beginTransmission(address);
+  Wire.write(data, len);
+  uint8_t i2c_result = Wire.endTransmission();
+
+  if (i2c_result != 0) {
+    recoverI2Cbus();
+    return (i2c_result == 2) ? I2C_ERROR_ADDR_NACK : I2C_ERROR_OTHER;
+  }
+  Wire.setClock(I2C_NORMAL_SPEED);
+
+  checkAndReportI2cTimeout();
+  return I2C_ERROR_NONE;
+}
 
-      checkAndReportI2cTimeout();
+// Optional write, then a read after a repeated START. read_len is cut to the
+// Wire buffer and to the bytes actually read. Returns an I2C_ERROR_* code.
+uint8_t i2c_write_read_transaction(uint8_t address, const uint8_t* write_data, uint8_t write_len, uint8_t* read_data, uint8_t& read_len) {
+  uint8_t status = I2C_ERROR_NONE;
+  if (read_len > I2C_WIRE_LIB_MAX_READ) read_len = I2C_WIRE_LIB_MAX_READ;
+  if (address == SGP41_I2C_ADDR) sgp41_defer_measurement();
+
+  Wire.setClock(I2C_FAST_SPEED);
+  if (write_len > 0) {
+    Wire.beginTransmission(address);
+    Wire.write(write_data, write_len);
+    uint8_t i2c_result = Wire.endTransmission(false);
+
+    if (i2c_result != 0) {
+      status = (i2c_result == 2) ? I2C_ERROR_ADDR_NACK : I2C_ERROR_OTHER;
+      recoverI2Cbus();
+    } else {
+      delay(I2C_WRITE_READ_DELAY_MS);
+    }
+  }
 
-      snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_WRITE, RSP_I2C_WRITE, i2c_status);
+  if (status == I2C_ERROR_NONE && read_len > 0) {
+    uint8_t bytes_read = Wire.requestFrom(address, read_len);
+    if (bytes_read != read_len) {
+      status = I2C_ERROR_DATA_NACK;
+      read_len = bytes_read;
+      recoverI2Cbus();
+    }
+    for (uint8_t i = 0; i < bytes_read; i++) {
+      read_data[i] = Wire.read();
+    }
+  }
+  Wire.setClock(I2C_NORMAL_SPEED);
 
-      checksum = calculate_checksum(tx_command_buffer);
-      Serial.print('<'); Serial.print(tx_command_buffer); Serial.print(','); Serial.print(checksum); Serial.println('>');
+  checkAndReportI2cTimeout();
+  return status;
+}
+
+// ======================================================================
+//  BINARY BRIDGE FRAMES
+// ======================================================================
+
+// Binary bridge payloads are built here, send_binary_frame() then encodes
+// them in place without a copy
+uint8_t* bridge_payload() {
+  return reinterpret_cast<uint8_t*>(tx_command_buffer) + BINARY_FRAME_PAYLOAD_OFFSET;
+}
+
+// Binary frames from the ESP32, only bridge reads and writes use them. See
+// "Binary Bridge Frames" in protocol/Frames.h for the payloads.
+void process_binary_command(uint8_t* frame, uint8_t encoded_len) {
+  const uint8_t len = binary_frame_decode(frame, encoded_len);
+  if (len == 0) {
+    count_link_error();
+    return;
+  }
+  last_valid_command_time = millis();
+  // Only an ESP32 that reads binary bridge frames sends them, also after a
+  // Nano reboot wiped the capability exchange
+  binary_i2c_enabled = true;
+
+  const char type = frame[0];
+  const uint8_t request_id = frame[1];
+  const uint8_t* payload = frame + BINARY_FRAME_HEADER_LEN;
+  const uint8_t payload_len = len - BINARY_FRAME_HEADER_LEN;
+  uint8_t status = I2C_ERROR_OTHER;
+
+  switch (type) {
+    case CMD_I2C_READ: {
+      // Read straight into the response payload
+      uint8_t* data = bridge_payload() + 1;
+      uint8_t read_len = 0;
+      if (payload_len >= 2 && payload_len - 2 <= BRIDGE_FRAME_MAX_WRITE_READ) {
+        read_len = payload[1];
+        checkAndRecoverI2C();
+        status = i2c_write_read_transaction(payload[0], payload + 2, payload_len - 2, data, read_len);
+      }
+      send_i2c_read_response(status, data, read_len, request_id);
       break;
     }
 
+    case CMD_I2C_WRITE:
+      if (payload_len >= 1 && payload_len - 1 <= I2C_WRITE_MAX_LEN) {
+        checkAndRecoverI2C();
+        status = i2c_write_transaction(payload[0], payload + 1, payload_len - 1);
+      }
+      send_i2c_write_response(status, request_id);
+      break;
+
     default:
       break;
   }
 }
 
+// RSP_I2C_READ, the data only goes out when the read succeeded
+void send_i2c_read_response(uint8_t status, const uint8_t* data, uint8_t len, uint8_t request_id) {
+  if (binary_i2c_enabled) {
+    uint8_t* payload = bridge_payload();
+    if (status != I2C_ERROR_NONE) len = 0;
+    memmove(payload + 1, data, len);
+    payload[0] = status;
+    send_binary_frame(RSP_I2C_READ, request_id, payload, len + 1);
+    return;
+  }
+
+  snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_READ, RSP_I2C_READ, status, len);
+  if (status == I2C_ERROR_NONE) {
+    char* pos = tx_command_buffer + strlen(tx_command_buffer);
+    for (uint8_t i = 0; i < len; i++) {
+      int written = snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_I2C_READ_DATA, data[i]);
+      if (written <= 0) {
+        break;
+      }
+      pos += written;
+    }
+  }
+  send_ascii_packet(tx_command_buffer, request_id);
+}
+
+void send_i2c_write_response(uint8_t status, uint8_t request_id) {
+  if (binary_i2c_enabled) {
+    send_binary_frame(RSP_I2C_WRITE, request_id, &status, 1);
+    return;
+  }
+  snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_WRITE, RSP_I2C_WRITE, status);
+  send_ascii_packet(tx_command_buffer, request_id);
+}
+
+// RSP_I2C_WATCH_DATA and RSP_I2C_SEGMENT: an ID, the status or offset in
+// value, then the read data
+void send_i2c_push(char type, uint8_t id, uint16_t value, const uint8_t* data, uint8_t len) {
+  if (binary_i2c_enabled) {
+    uint8_t* payload = bridge_payload();
+    uint8_t header_len = 0;
+    payload[header_len++] = id;
+    payload[header_len++] = value & 0xFF;
+    if (type == RSP_I2C_SEGMENT) payload[header_len++] = value >> 8;
+    memcpy(payload + header_len, data, len);
+    send_binary_frame(type, REQUEST_ID_NONE, payload, header_len + len);
+    return;
+  }
+
+  char* pos = tx_command_buffer + snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_PUSH, type, id, value);
+  for (uint8_t i = 0; i < len; i++) {
+    pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_I2C_SCRIPT_DATA, data[i]);
+  }
+  send_ascii_packet(tx_command_buffer, REQUEST_ID_NONE);
+}
+
+// ======================================================================
+//  I2C TRANSACTION SCRIPTS
+// ======================================================================
+
+// Comma separated hex numbers, p is left on the first character not taken.
+// Returns the number of fields read.
+uint8_t parse_hex_fields(const char*& p, uint16_t* fields, uint8_t max_fields) {
+  uint8_t count = 0;
+  char* endptr;
+  while (count < max_fields) {
+    fields[count] = strtoul(p, &endptr, 16);
+    if (p == endptr) break;
+    count++;
+    p = endptr;
+    if (*p != ',') break;
+    p++;
+  }
+  return count;
+}
+
+// Value of a hex digit, 0xFF for anything else
+uint8_t hex_digit_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return 0xFF;
+}
+
+// Reads the hex byte pairs of one step up to the next ',' or the end of the
+// script. Returns the byte count, -1 if malformed or longer than max_len.
+int8_t parse_i2c_script_step(const char*& p, uint8_t* out, uint8_t max_len) {
+  uint8_t len = 0;
+  while (*p && *p != ',') {
+    const uint8_t high = hex_digit_value(p[0]);
+    const uint8_t low = (high == 0xFF) ? 0xFF : hex_digit_value(p[1]);
+    if (low == 0xFF || len >= max_len) return -1;
+    out[len++] = (high << 4) | low;
+    p += 2;
+  }
+  return len;
+}
+
+// Bytes a step reads, -1 if the step is invalid
+int8_t i2c_script_step_read_len(char op, const uint8_t* data, int8_t len) {
+  switch (op) {
+    case I2C_SCRIPT_OP_WRITE:
+      return (len >= 1 && len <= I2C_SCRIPT_MAX_WRITE) ? 0 : -1;
+    case I2C_SCRIPT_OP_DELAY:
+      return (len == 1) ? 0 : -1;
+    case I2C_SCRIPT_OP_READ:
+      return (len == 1 && data[0] >= 1 && data[0] <= I2C_SCRIPT_MAX_STEP_READ) ? data[0] : -1;
+    case I2C_SCRIPT_OP_WRITE_READ:
+      return (len >= 2 && len <= I2C_SCRIPT_MAX_WRITE + 1 && data[0] >= 1 && data[0] <= I2C_SCRIPT_MAX_STEP_READ) ? data[0] : -1;
+    default:
+      return -1;
+  }
+}
+
+// Runs one validated step, the bytes read replace the step's bytes in data
+uint8_t run_i2c_script_step(uint8_t address, char op, uint8_t* data, uint8_t len) {
+  if (op == I2C_SCRIPT_OP_DELAY) {
+    delay(data[0]);
+    return I2C_ERROR_NONE;
+  }
+  if (address == SGP41_I2C_ADDR) sgp41_defer_measurement();
+
+  if (op == I2C_SCRIPT_OP_WRITE || op == I2C_SCRIPT_OP_WRITE_READ) {
+    const uint8_t skip = (op == I2C_SCRIPT_OP_WRITE_READ) ? 1 : 0; // Read length
+    Wire.beginTransmission(address);
+    Wire.write(data + skip, len - skip);
+    const uint8_t i2c_result = Wire.endTransmission(op == I2C_SCRIPT_OP_WRITE);
+    if (i2c_result != 0) {
+      recoverI2Cbus();
+      return (i2c_result == 2) ? I2C_ERROR_ADDR_NACK : I2C_ERROR_OTHER;
+    }
+    if (op == I2C_SCRIPT_OP_WRITE) return I2C_ERROR_NONE;
+    delay(I2C_WRITE_READ_DELAY_MS);
+  }
+
+  const uint8_t read_len = data[0];
+  if (Wire.requestFrom(address, read_len) != read_len) {
+    recoverI2Cbus();
+    return I2C_ERROR_DATA_NACK;
+  }
+  for (uint8_t i = 0; i < read_len; i++) {
+    data[i] = Wire.read();
+  }
+  return I2C_ERROR_NONE;
+}
+
+// CMD_I2C_SCRIPT: the whole script is checked before the first step runs,
+// the response is built in tx_command_buffer as the steps complete
+void run_i2c_script(const char* script, uint8_t request_id) {
+  uint8_t step_data[I2C_SCRIPT_MAX_STEP_READ];
+  char* endptr;
+  const uint8_t address = strtol(script, &endptr, 16);
+  const char* steps = endptr;
+  uint8_t status = (endptr == script) ? I2C_ERROR_OTHER : I2C_ERROR_NONE;
+
+  uint8_t step_count = 0;
+  uint16_t total_read = 0;
+  for (const char* p = steps; status == I2C_ERROR_NONE && *p; ) {
+    if (*p != ',' || !p[1]) { status = I2C_ERROR_OTHER; break; }
+    const char op = p[1];
+    p += 2;
+    const int8_t len = parse_i2c_script_step(p, step_data, I2C_SCRIPT_MAX_WRITE + 1);
+    const int8_t read_len = (len < 0) ? -1 : i2c_script_step_read_len(op, step_data, len);
+    if (read_len < 0) {
+      status = I2C_ERROR_OTHER;
+    } else if (++step_count > I2C_SCRIPT_MAX_STEPS || (total_read += read_len) > I2C_SCRIPT_MAX_READ) {
+      status = I2C_ERROR_BUF_LEN;
+    }
+  }
+  if (step_count == 0 && status == I2C_ERROR_NONE) status = I2C_ERROR_OTHER;
+
+  // Rejected scripts get a single status digit
+  uint8_t* payload = bridge_payload();
+  if (status != I2C_ERROR_NONE) {
+    if (binary_i2c_enabled) {
+      payload[0] = 1;
+      payload[1] = status;
+      send_binary_frame(RSP_I2C_SCRIPT, request_id, payload, 2);
+      return;
+    }
+    snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_SCRIPT_REJECTED, RSP_I2C_SCRIPT, status);
+    send_ascii_packet(tx_command_buffer, request_id);
+    return;
+  }
+
+  // Binary: step count, raw statuses, raw data. ASCII: status digits, ',', hex data.
+  char* step_status;
+  char* pos;
+  if (binary_i2c_enabled) {
+    payload[0] = step_count;
+    step_status = reinterpret_cast<char*>(payload + 1);
+    memset(step_status, I2C_ERROR_PENDING, step_count);
+    pos = step_status + step_count;
+  } else {
+    tx_command_buffer[0] = RSP_I2C_SCRIPT;
+    step_status = tx_command_buffer + 1;
+    memset(step_status, '0' + I2C_ERROR_PENDING, step_count);
+    pos = step_status + step_count;
+    *pos++ = ',';
+    *pos = '\0';
+  }
+
+  checkAndRecoverI2C();
+  Wire.setClock(I2C_FAST_SPEED);
+  const char* p = steps;
+  for (uint8_t step = 0; step < step_count; step++) {
+    const char op = p[1];
+    p += 2;
+    const uint8_t len = parse_i2c_script_step(p, step_data, sizeof(step_data));
+    const uint8_t read_len = i2c_script_step_read_len(op, step_data, len);
+
+    status = run_i2c_script_step(address, op, step_data, len);
+    step_status[step] = binary_i2c_enabled ? status : '0' + status;
+    if (status != I2C_ERROR_NONE) break;
+    for (uint8_t i = 0; i < read_len; i++) {
+      if (binary_i2c_enabled) {
+        *pos++ = step_data[i];
+      } else {
+        pos += snprintf_P(pos, sizeof(tx_command_buffer) - (pos - tx_command_buffer), FMT_I2C_SCRIPT_DATA, step_data[i]);
+      }
+    }
+  }
+  Wire.setClock(I2C_NORMAL_SPEED);
+
+  checkAndReportI2cTimeout();
+  if (binary_i2c_enabled) {
+    send_binary_frame(RSP_I2C_SCRIPT, request_id, payload, reinterpret_cast<uint8_t*>(pos) - payload);
+  } else {
+    send_ascii_packet(tx_command_buffer, request_id);
+  }
+}
+
+// ======================================================================
+//  I2C REGISTER WATCHES
+// ======================================================================
+
+// CMD_I2C_WATCH: no fields clears every job, the slot alone clears one job.
+// Returns an I2C_ERROR_* code.
+uint8_t set_i2c_watch(const uint16_t* fields, uint8_t field_count) {
+  if (field_count == 0) {
+    memset(i2c_watches, 0, sizeof(i2c_watches));
+    return I2C_ERROR_NONE;
+  }
+  if (fields[0] >= I2C_WATCH_SLOTS) return I2C_ERROR_BUF_LEN;
+  I2cWatch& watch = i2c_watches[fields[0]];
+  if (field_count == 1) {
+    watch.address = 0;
+    return I2C_ERROR_NONE;
+  }
+
+  const uint8_t mode = fields[2];
+  const bool bits_mode = (mode == I2C_WATCH_BITS_CLEAR || mode == I2C_WATCH_BITS_SET);
+  if (field_count != I2C_WATCH_FIELDS || fields[1] == 0 || fields[1] > 0x7F || mode > I2C_WATCH_BITS_SET ||
+      fields[3] > 0xFF || fields[4] > 0xFF || fields[5] > 0xFF ||
+      (fields[6] == 0 && !bits_mode) || fields[7] < I2C_WATCH_MIN_PERIOD_MS) {
+    return I2C_ERROR_OTHER;
+  }
+  if (fields[6] > I2C_WATCH_MAX_LEN) return I2C_ERROR_BUF_LEN;
+
+  watch.address = fields[1];
+  watch.mode = mode;
+  watch.mask = fields[3];
+  watch.cond_reg = fields[4];
+  watch.reg = fields[5];
+  watch.len = fields[6];
+  watch.period_ms = fields[7];
+  watch.last_run = millis();
+  // Edge triggered: a condition that already holds has to go away first
+  watch.flags = bits_mode ? I2C_WATCH_CONDITION_MET : I2C_WATCH_RESYNC;
+  watch.last_crc = 0;
+  return I2C_ERROR_NONE;
+}
+
+// One due job: reads, evaluates the condition and pushes RSP_I2C_WATCH_DATA
+void run_i2c_watch(uint8_t slot) {
+  I2cWatch& watch = i2c_watches[slot];
+  uint8_t data[I2C_WATCH_MAX_LEN + 1];
+  uint8_t len = 0;
+  uint8_t status = I2C_ERROR_NONE;
+  bool push = true;
+
+  Wire.setClock(I2C_FAST_SPEED);
+  if (watch.mode == I2C_WATCH_BITS_CLEAR || watch.mode == I2C_WATCH_BITS_SET) {
+    data[0] = 1;
+    data[1] = watch.cond_reg;
+    status = run_i2c_script_step(watch.address, I2C_SCRIPT_OP_WRITE_READ, data, 2);
+    if (status == I2C_ERROR_NONE) {
+      const uint8_t bits = data[0] & watch.mask;
+      const bool met = (watch.mode == I2C_WATCH_BITS_SET) ? (bits == watch.mask) : (bits == 0);
+      push = met && !(watch.flags & I2C_WATCH_CONDITION_MET);
+      watch.flags = met ? (watch.flags | I2C_WATCH_CONDITION_MET) : (watch.flags & ~I2C_WATCH_CONDITION_MET);
+      len = 1;
+    }
+  }
+  if (status == I2C_ERROR_NONE && push && watch.len > 0) {
+    data[len] = watch.len;
+    data[len + 1] = watch.reg;
+    status = run_i2c_script_step(watch.address, I2C_SCRIPT_OP_WRITE_READ, data + len, 2);
+    if (status == I2C_ERROR_NONE && watch.mode == I2C_WATCH_CHANGED) {
+      uint8_t crc = crc8_update(0, data[0] & ~watch.mask);
+      for (uint8_t i = 1; i < watch.len; i++) {
+        crc = crc8_update(crc, data[i]);
+      }
+      push = crc != watch.last_crc || (watch.flags & I2C_WATCH_RESYNC);
+      watch.last_crc = crc;
+    }
+    len += watch.len;
+  }
+  Wire.setClock(I2C_NORMAL_SPEED);
+  checkAndReportI2cTimeout();
+
+  if (status != I2C_ERROR_NONE) {
+    push = !(watch.flags & I2C_WATCH_FAILED);
+    watch.flags |= I2C_WATCH_FAILED | I2C_WATCH_RESYNC;
+    len = 0;
+  } else if (push) {
+    watch.flags &= ~(I2C_WATCH_FAILED | I2C_WATCH_RESYNC);
+  }
+  if (!push) return;
+
+  send_i2c_push(RSP_I2C_WATCH_DATA, slot, status, data, len);
+}
+
+void run_i2c_watches() {
+  const uint16_t now = millis();
+  for (uint8_t slot = 0; slot < I2C_WATCH_SLOTS; slot++) {
+    I2cWatch& watch = i2c_watches[slot];
+    if (watch.address == 0 || (uint16_t)(now - watch.last_run) < watch.period_ms) continue;
+    watch.last_run = now;
+    run_i2c_watch(slot);
+  }
+}
+
+// ======================================================================
+//  SEGMENTED I2C TRANSFERS
+// ======================================================================
+
+// I2C_ERROR_* for the address, register, length and flags of a transfer
+uint8_t check_i2c_transfer(uint16_t address, uint16_t reg, uint16_t total, uint16_t flags) {
+  if (address == 0 || address > 0x7F || reg > 0xFF || total == 0) return I2C_ERROR_OTHER;
+  if (total > I2C_TRANSFER_MAX_LEN) return I2C_ERROR_BUF_LEN;
+  if (!(flags & I2C_TRANSFER_FIXED_REG) && reg + total > 0x100) return I2C_ERROR_BUF_LEN;
+  return I2C_ERROR_NONE;
+}
+
+// CMD_I2C_READ_BLOCK: every segment goes out as RSP_I2C_SEGMENT as soon as
+// it is read, so nothing larger than one segment is buffered here
+void run_i2c_read_block(const uint16_t* fields, uint8_t request_id) {
+  const uint8_t xfer = fields[0];
+  const uint8_t address = fields[1];
+  const uint8_t reg = fields[2];
+  const uint16_t total = fields[3];
+  const bool fixed_reg = fields[4] & I2C_TRANSFER_FIXED_REG;
+  uint8_t status = check_i2c_transfer(address, reg, total, fields[4]);
+  uint16_t sent = 0;
+
+  if (status == I2C_ERROR_NONE) {
+    uint8_t data[I2C_TRANSFER_READ_SEGMENT];
+    checkAndRecoverI2C();
+    Wire.setClock(I2C_FAST_SPEED);
+    while (sent < total) {
+      const uint8_t len = (total - sent > I2C_TRANSFER_READ_SEGMENT) ? I2C_TRANSFER_READ_SEGMENT : total - sent;
+      data[0] = len;
+      data[1] = fixed_reg ? reg : reg + sent;
+      status = run_i2c_script_step(address, I2C_SCRIPT_OP_WRITE_READ, data, 2);
+      if (status != I2C_ERROR_NONE) break;
+
+      send_i2c_push(RSP_I2C_SEGMENT, xfer, sent, data, len);
+      sent += len;
+    }
+    Wire.setClock(I2C_NORMAL_SPEED);
+    checkAndReportI2cTimeout();
+  }
+
+  snprintf_P(tx_command_buffer, sizeof(tx_command_buffer), FMT_I2C_READ_BLOCK, RSP_I2C_READ_BLOCK, xfer, status, sent);
+  send_ascii_packet(tx_command_buffer, request_id);
+}
+
+// CMD_I2C_WRITE_BLOCK: writes one segment, len bytes after the register
+// byte in segment or -1 if malformed. Offset 0 starts a transfer, every
+// other segment has to continue it. Returns I2C_ERROR_PENDING until the
+// last segment is written.
+uint8_t write_i2c_block_segment(const uint16_t* fields, uint8_t* segment, int8_t len) {
+  const uint8_t xfer = fields[0];
+  const uint8_t address = fields[1];
+  const uint8_t reg = fields[2];
+  const uint16_t offset = fields[3];
+  const uint16_t total = fields[4];
+  const uint8_t status = check_i2c_transfer(address, reg, total, fields[5]);
+  if (status != I2C_ERROR_NONE) return status;
+  if (len <= 0) return I2C_ERROR_OTHER;
+
+  if (offset == 0) {
+    i2c_transfer_id = xfer;
+    i2c_transfer_next = 0;
+  }
+  // A lost or failed segment leaves i2c_transfer_next behind, so the rest of the transfer is refused
+  if (xfer != i2c_transfer_id || offset != i2c_transfer_next || offset + len > total) return I2C_ERROR_OTHER;
+
+  segment[0] = (fields[5] & I2C_TRANSFER_FIXED_REG) ? reg : reg + offset;
+  checkAndRecoverI2C();
+  const uint8_t write_status = i2c_write_transaction(address, segment, len + 1);
+  if (write_status != I2C_ERROR_NONE) return write_status;
+  i2c_transfer_next += len;
+  return (i2c_transfer_next < total) ? I2C_ERROR_PENDING : I2C_ERROR_NONE;
+}
+
+// ======================================================================
+//  LINK SPEED
+// ======================================================================
+
+// Our response has to leave at the old rate, so flush before switching.
+// A new rate stays unverified until CMD_PING arrives at it.
+void set_serial_baud_rate(uint32_t baud) {
+  Serial.flush();
+  Serial.begin(baud);
+  serial_baud_rate = baud;
+  serial_baud_verified = (baud == SERIAL_BAUD_RATE);
+  serial_baud_switch_time = millis();
+  last_valid_command_time = serial_baud_switch_time;
+  link_error_count = 0;
+  link_error_window_start = serial_baud_switch_time;
+}
+
+void count_link_error() {
+  if (millis() - link_error_window_start > LINK_CRC_ERROR_WINDOW_MS) {
+    link_error_window_start = millis();
+    link_error_count = 0;
+  }
+  if (link_error_count < 0xFF) link_error_count++;
+}
+
 // ======================================================================
 //  I2C RECOVERY
 // ======================================================================
 
 bool recoverI2Cbus() {
-    send_error_response(E_I2C_RECOVER_START_1);
+    send_event(NANO_EVENT_I2C_RECOVER_START, 0);
 
     const uint8_t sda_pin = SDA;
     const uint8_t scl_pin = SCL;
@@ -849,11 +1666,11 @@ bool recoverI2Cbus() {
         Wire.begin();
         Wire.setWireTimeout(I2C_TIMEOUT_US, true);
         Wire.setClock(I2C_NORMAL_SPEED);
-        send_error_response(E_I2C_RECOVER_DONE_1);
+        send_event(NANO_EVENT_I2C_RECOVER_DONE, 0);
         return true;
     }
 
-    send_error_response(E_I2C_RECOVER_STUCK_2);
+    send_event(NANO_EVENT_I2C_RECOVER_MANUAL, 0);
 
     pinMode(scl_pin, OUTPUT);
     pinMode(sda_pin, INPUT);
@@ -868,7 +1685,7 @@ bool recoverI2Cbus() {
     }
 
     if (digitalRead(sda_pin) == LOW) {
-        send_error_response(E_I2C_RECOVER_FAIL_SDA_LOW_1);
+        send_event(NANO_EVENT_I2C_RECOVER_SDA_LOW, 0);
         return false;
     }
 
@@ -885,7 +1702,7 @@ bool recoverI2Cbus() {
     delay(1);
 
     if (digitalRead(sda_pin) == LOW || digitalRead(scl_pin) == LOW) {
-      send_error_response(E_I2C_RECOVER_FAIL_BUS_BUSY_1);
+      send_event(NANO_EVENT_I2C_RECOVER_BUS_BUSY, 0);
         return false;
     }
 
@@ -894,7 +1711,7 @@ bool recoverI2Cbus() {
     Wire.setClock(I2C_NORMAL_SPEED);
     delay(1);
 
-    send_error_response(E_I2C_RECOVER_DONE_1);
+    send_event(NANO_EVENT_I2C_RECOVER_DONE, 0);
     return true;
 }
 
@@ -912,16 +1729,15 @@ bool checkAndRecoverI2C() {
 
 void checkAndReportI2cTimeout() {
   if (Wire.getWireTimeoutFlag()) {
-    send_error_response(E_I2C_TIMEOUT_1);
+    send_event(NANO_EVENT_I2C_TIMEOUT, 0);
     Wire.clearWireTimeoutFlag();
     recoverI2Cbus();
   }
 }
 
-void send_error_response(const char* error_msg PROGMEM) {
-  char szBuf[40];
-  strncpy_P(szBuf, error_msg, sizeof(szBuf));
-  szBuf[sizeof(szBuf) - 1] = '\0';
-  const uint8_t cs = calculate_checksum(szBuf);
-  Serial.print('<'); Serial.print(szBuf); Serial.print(','); Serial.print(cs); Serial.println('>');
+// Own buffer, events can be raised while a response is built in tx_command_buffer
+void send_event(uint8_t code, uint16_t param) {
+  char szBuf[12];
+  snprintf_P(szBuf, sizeof(szBuf), FMT_EVENT, RSP_EVENT, code, param);
+  send_ascii_packet(szBuf, REQUEST_ID_NONE);
 }
\ No newline at end of file
@@ -3,10 +3,10 @@
 /****************************************************************
  * AHT20.h
  * AHT20 Temperature and Humidity Sensor Library Header File
- * Adapted to use I2CBridge for ESP32-Nano communication
+ * Adapted to use I2CBus, the ESP32-Nano bridge or the ESP32's own I2C
  * 
  * This file defines the AHT20 class for interfacing with the
- * AHT20 temperature and humidity sensor via I2CBridge.
+ * AHT20 temperature and humidity sensor via an I2CBus.
  * 
  * Distributed as-is; no warranty is given.
  ***************************************************************/
@@ -15,7 +15,7 @@
 #define AHT20_H
 
 #include <Arduino.h>
-#include "I2CBridge.h"
+#include "I2CBus.h"
 
 // AHT20 I2C Address
 #define AHT20_DEFAULT_ADDRESS 0x38
@@ -43,7 +43,7 @@
 class AHT20 {
 public:
     // Constructor
-    AHT20(uint8_t address = AHT20_DEFAULT_ADDRESS);
+    AHT20(I2CBus& bus, uint8_t address = AHT20_DEFAULT_ADDRESS);
     
     // Destructor
     ~AHT20();
@@ -72,8 +72,9 @@ public:
     // Check if sensor is ready for new measurement
     bool isReadyForMeasurement() const;
     
-    // Check if sensor is busy (for state machine)
-    bool isBusy() const;
+    // Check if sensor is busy (for state machine), statusByte receives the
+    // status byte read, 0 on a communication error
+    bool isBusy(uint8_t* statusByte = nullptr) const;
     
     // Trigger a new measurement (for state machine)
     bool triggerMeasurement();
@@ -82,6 +83,8 @@ public:
     void getDetailedStatus(uint8_t& status, bool& busy, bool& calibrated) const;
 
 private:
+    I2CBus& _bus;
+
     // I2C address
     uint8_t _deviceAddress;
     
@@ -2,14 +2,26 @@
 
 #include <Arduino.h>
 #include <BMx280MI.h>
-#include "I2CBridge.h"
+#include "I2CBus.h"
 #include "Logger.h"
 
-// BMP280 sensor class that uses I2CBridge for communication
+// Register windows fetched with one I2C script, see BMP280Sensor::prefetch()
+#define BMP280_REG_ID          0xD0
+#define BMP280_REG_CALIB       0x88 // dig_T1 .. dig_P9 and the reserved 0xA0/0xA1
+#define BMP280_CALIB_LEN       26
+#define BMP280_REG_DATA        0xF3 // status, ctrl_meas, config, press and temp
+#define BMP280_DATA_LEN        10
+#define BMP280_STATUS_BUSY     0x09 // measuring and im_update in the status register
+
+// The Nano pushes the data window whenever a conversion changed it
+#define BMP280_WATCH_PERIOD_MS  250
+#define BMP280_WATCH_TIMEOUT_MS 10000 // Polls again when no push arrived for this long
+
+// BMP280 sensor class that talks to the chip through an I2CBus
 class BMP280Sensor : public BMx280MI {
 public:
     // Constructor
-    BMP280Sensor(uint8_t i2c_address = 0x77); // Could also be 0x76 depending on SDO pin state
+    BMP280Sensor(I2CBus& bus, uint8_t i2c_address = 0x77); // Could also be 0x76 depending on SDO pin state
     ~BMP280Sensor();
 
     // Sensor data structure
@@ -39,9 +51,33 @@ public:
     float getTemperature();
 
 private:
+    // Index into cache_, the ID and calibration windows are read-only and stay cached
+    enum CacheWindow : uint8_t {
+        CACHE_ID,
+        CACHE_CALIB,
+        CACHE_DATA,
+        CACHE_WINDOW_COUNT
+    };
+
+    struct RegisterCache {
+        bool valid;
+        uint8_t data[BMP280_CALIB_LEN];
+    };
+
+    I2CBus& bus_;
     uint8_t address_;
     SensorData latest_data_;
     bool data_valid_;
+    RegisterCache cache_[CACHE_WINDOW_COUNT];
+    int8_t watch_id_;                   // -1 while polled, always off the bridge
+    unsigned long last_watch_time_;     // Last push or registration
+
+    // Reads windows first .. first + count - 1 in one script, one bridge round trip
+    void prefetch(CacheWindow first, uint8_t count);
+    // Copies reg .. reg + length - 1 from a cached window, false if none holds it
+    bool readCached(uint8_t reg, uint8_t length, uint8_t* out) const;
+    // Fills the data window from a push or, without a watch, with prefetch()
+    bool updateDataWindow();
     
     // Override virtual functions from BMx280MI
     bool beginInterface() override;
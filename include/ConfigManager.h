@@ -38,6 +38,7 @@ public:
     float getHumiAcceptableLow();
     float getHumiAcceptableHigh();
     int getInactivityTimerDelay();
+    int getI2cDirectDevices();
     const char* getMqttHost();
     int getMqttPort();
     const char* getMqttUser();
@@ -93,6 +94,7 @@ public:
     void setHumiAcceptableLow(float value);
     void setHumiAcceptableHigh(float value);
     void setInactivityTimerDelay(int value);
+    void setI2cDirectDevices(int value);
     void setMqttHost(const char* value);
     void setMqttPort(int value);
     void setMqttUser(const char* value);
@@ -138,6 +140,7 @@ private:
     float tempComfortableLow, tempComfortableHigh, tempAcceptableLow, tempAcceptableHigh;
     float humiComfortableLow, humiComfortableHigh, humiAcceptableLow, humiAcceptableHigh;
     int inactivityTimerDelay;
+    int i2cDirectDevices;   // I2CDevice bits of the sensors wired to the ESP32, read at boot
     int co2WarnThreshold, co2DangerThreshold, vocWarnThreshold, vocDangerThreshold;
     int no2WarnThreshold, no2DangerThreshold, o3WarnThreshold, o3DangerThreshold, noxWarnThreshold, noxDangerThreshold, coWarnThreshold, coDangerThreshold;
     int pm1WarnThreshold, pm1DangerThreshold, pm25WarnThreshold, pm25DangerThreshold, pm4WarnThreshold, pm4DangerThreshold, pm10WarnThreshold, pm10DangerThreshold;
@@ -174,6 +177,7 @@ private:
     static const char* KEY_HUMI_ACCEPTABLE_LOW;
     static const char* KEY_HUMI_ACCEPTABLE_HIGH;
     static const char* KEY_INACTIVITY_TIMER_DELAY;
+    static const char* KEY_I2C_DIRECT;
     static const char* KEY_MQTT_HOST;
     static const char* KEY_MQTT_PORT;
     static const char* KEY_MQTT_USER;
@@ -227,6 +231,7 @@ private:
     static const float DEFAULT_HUMI_ACCEPTABLE_LOW;
     static const float DEFAULT_HUMI_ACCEPTABLE_HIGH;
     static const int DEFAULT_INACTIVITY_TIMER_DELAY;
+    static const int DEFAULT_I2C_DIRECT_DEVICES;
     static const char* DEFAULT_MQTT_HOST;
     static const int DEFAULT_MQTT_PORT;
     static const char* DEFAULT_MQTT_USER;
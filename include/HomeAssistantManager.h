@@ -2,6 +2,8 @@
 
 #include <ArduinoHA.h>
 #include <WiFi.h>
+#include "NanoLinkMetrics.h"
+#include "I2CBridgeStats.h"
 
 // Forward declarations to avoid circular dependencies
 class LGFX;
@@ -43,6 +45,7 @@ public:
     void setSensorStackVersionUnavailable(); // Renamed from setNanoVersionUnavailable
     void publishSensorStackUptime(uint32_t uptime_seconds, bool force = false);
     void publishSensorStackFreeRam(uint16_t free_ram);
+    void publishSensorStackBusWait(uint16_t bus_wait_ms);
     void resetSensorStackUptimePublishTime();
     
     // Method to get the MQTT client for the logger
@@ -56,6 +59,8 @@ public:
     void updateScd30ForceCalValue(uint16_t value);
     void publishEsp32FreeRam(uint32_t free_ram);
     void publishEsp32Uptime(uint32_t uptime_seconds);
+    void publishNanoLinkMetrics(const NanoLinkMetrics::Summary& metrics);
+    void publishI2cBridgeStats(const I2CBridgeStats::Summary& stats);
     void updateInactivityTimerDelayState();
 
 private:
@@ -94,6 +99,7 @@ private:
     HASensorNumber _sensorStackUptimeSensor;
     HASensor _sensorStackVersionSensor;
     HASensorNumber _sensorStackFreeRamSensor;
+    HASensorNumber _sensorStackBusWaitSensor;
     HASensor _voc_index_sensor;
     HASensor _nox_index_sensor;
     HASensor _currentSensor;
@@ -110,6 +116,14 @@ private:
     HANumber _scd30ForceCalNumber;
     HASensorNumber _esp32FreeRamSensor;
     HASensorNumber _esp32UptimeSensor;
+    HASensorNumber _linkErrorsSensor;
+    HASensorNumber _linkTimeoutsSensor;
+    HASensorNumber _linkLostFramesSensor;
+    HASensorNumber _linkLatencyP50Sensor;
+    HASensorNumber _linkLatencyP99Sensor;
+    HASensorNumber _i2cErrorsSensor;
+    HASensorNumber _i2cLatencyP99Sensor;
+    HASensor _i2cBusiestDeviceSensor;
 
     // State tracking for publishing
     float _lastPublishedPressure, _lastPublishedTemp, _lastPublishedHumi, _lastPublishedCo2;
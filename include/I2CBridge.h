@@ -3,19 +3,40 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "I2CBus.h"
 #include "NanoCommands.h"
 
-// I2C Bridge class for communicating with sensors via the Arduino Nano
+#define I2C_SCRIPT_STEP_DELAY_MARGIN_MS 5 // Per step on top of _timeout_ms, covers the Nano's bus time
+#define I2C_TRANSFER_SEGMENT_MARGIN_MS 50 // Per read segment on top of _timeout_ms, one RSP_I2C_SEGMENT at LINK_DEFAULT_BAUD
+#define I2C_PENDING_SLOTS       8   // Transactions submitted and not yet collected
+// Command bytes sent ahead of their answers. Keeps every outstanding command
+// inside the Nano's 128 byte serial RX buffer while it is busy on the bus.
+#define I2C_IN_FLIGHT_BUDGET    120
+#define I2C_PACKET_OVERHEAD     9   // '<', "#XX", ',', checksum and '>' around the data part
+#define I2C_FRAME_OVERHEAD      7   // Delimiters, COBS code, header and CRC-16 around a binary payload
+
+// I2C Bridge class for communicating with sensors via the Arduino Nano.
+// Drivers reach it through I2CBridgeBus, see I2CBus.h.
 class I2CBridge {
 public:
     
-    // Result structure for I2C operations
-    struct Result {
-        bool success;
-        uint8_t error_code;
-        uint8_t data[32]; // Max 32 bytes of data
-        uint8_t data_len;
+    // Transaction types shared with the other I2CBus backends
+    using Result = I2CBus::Result;
+    using Script = I2CBus::Script;
+    using TransferResult = I2CBus::TransferResult;
+    using ScriptResult = I2CBus::ScriptResult;
+    using Watch = I2CBus::Watch;
+    using WatchSample = I2CBus::WatchSample;
+
+    // A submitted transaction. Collect it with wait() or drop it with
+    // cancel(), either releases its slot. A handle whose slot was reclaimed
+    // after its deadline reads as a timeout.
+    struct Handle {
+        uint8_t slot;
+        uint8_t request_id; // REQUEST_ID_NONE if the submit failed
+
+        bool valid() const { return request_id != REQUEST_ID_NONE; }
     };
     
     // Singleton instance
@@ -26,41 +47,151 @@ public:
     
     static bool begin();
     static void setTimeout(unsigned long timeout_ms) { _timeout_ms = timeout_ms; }
+
+    // Non-blocking submits. Responses are matched to their transaction by the
+    // request ID the Nano echoes, or in send order by response letter on
+    // firmware without PROTOCOL_CAP_REQUEST_IDS. Several transactions from
+    // different drivers can be outstanding at once.
+    static Handle submitRead(uint8_t addr, uint8_t len);
+    static Handle submitWrite(uint8_t addr, const uint8_t* data, uint8_t len);  // At most I2C_WRITE_MAX_LEN bytes, I2C_WRITE_CHUNK_LEN with chunked ASCII writes
+    static Handle submitWriteRead(uint8_t addr, const uint8_t* writeData, uint8_t writeLen, uint8_t readLen);
+    static Handle submitScript(const Script& script);  // Needs PROTOCOL_CAP_I2C_SCRIPTS
+
+    static bool isDone(Handle handle);
+    // Block until the transaction completes or its deadline passes
+    static Result wait(Handle handle);
+    static ScriptResult waitScript(Handle handle);
+    static void cancel(Handle handle);
     
-    // Basic I2C operations
+    // Blocking operations, submit and wait in one call
     static Result readBytes(uint8_t addr, uint8_t len);
-    static Result writeBytes(uint8_t addr, uint8_t* data, uint8_t len);
-    static Result writeReadBytes(uint8_t addr, uint8_t* writeData, uint8_t writeLen, uint8_t readLen);
-    
-    // Response handling
-    static void processReadResponse(uint8_t status, uint8_t* data, uint8_t len);
-    static void processWriteResponse(uint8_t status);
-    
-    // Queue for I2C responses
-    static QueueHandle_t getResponseQueue() {
-        if (_response_queue == nullptr) {
-            _response_queue = xQueueCreate(1, sizeof(Result));
-        }
-        return _response_queue;
-    }
+    static Result writeBytes(uint8_t addr, const uint8_t* data, uint8_t len);
+    static Result writeReadBytes(uint8_t addr, const uint8_t* writeData, uint8_t writeLen, uint8_t readLen);
+
+    // All steps in one CMD_I2C_SCRIPT, needs PROTOCOL_CAP_I2C_SCRIPTS.
+    // I2CBridgeBus runs them step by step on older Nano firmware.
+    static ScriptResult runScript(const Script& script);
     
-    // I2C communication functions
-    static void send_i2c_read_request(uint8_t address, uint8_t num_bytes);
-    static void send_i2c_write_request(uint8_t address, uint8_t* data, uint8_t data_len);
-    static void send_i2c_write_read_request(uint8_t address, uint8_t* write_data, uint8_t write_len, uint8_t read_len);
+    // Register blocks of up to I2C_TRANSFER_MAX_LEN bytes, read into or
+    // written from the caller's buffer in segments, see I2C_TRANSFER_* in
+    // protocol/Commands.h. Segments address reg + offset, or reg itself with
+    // fixed_reg for FIFOs. Needs PROTOCOL_CAP_I2C_TRANSFERS, I2CBridgeBus
+    // sends one bridge transaction per segment to older Nano firmware.
+    static TransferResult readBlock(uint8_t addr, uint8_t reg, uint8_t* out, uint16_t len, bool fixed_reg = false);
+    static TransferResult writeBlock(uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t len, bool fixed_reg = false);
+
+    // Register watches, PROTOCOL_CAP_I2C_WATCH only. addWatch() returns the
+    // watch ID or -1 when the Nano cannot run it, the caller then polls the
+    // registers itself. Jobs are lost when the Nano reboots, register again.
+    static int8_t addWatch(const Watch& watch);
+    static void removeWatch(int8_t id);
+    // True once per push, sample holds the pushed read
+    static bool takeWatchSample(int8_t id, WatchSample& sample);
+
+    // Response handling, called from the NanoLink RX task
+    static void processReadResponse(uint8_t request_id, uint8_t status, uint8_t* data, uint8_t len);
+    static void processWriteResponse(uint8_t request_id, char response, uint8_t status);
+    static void processScriptResponse(uint8_t request_id, const char* statuses, const uint8_t* data, uint8_t len);
+    static void processWatchPush(uint8_t id, uint8_t status, const uint8_t* data, uint8_t len);
+    static void processSegment(uint8_t xfer_id, uint16_t offset, const uint8_t* data, uint8_t len);
+    static void processReadBlockResponse(uint8_t request_id, uint8_t status, uint16_t len);
     
 private:
     I2CBridge() {} // Private constructor for singleton
-    
-    // Helper function for checksum calculation
-    static uint8_t calculate_checksum(const char* data_str);
+
+    struct Pending {
+        bool used;
+        bool done;
+        bool is_script;
+        bool is_transfer;       // CMD_I2C_READ_BLOCK, segments land in transfer_out
+        uint8_t request_id;
+        uint8_t addr;           // Device, for I2CBridgeStats
+        char op;                // Command letter, for I2CBridgeStats
+        int64_t submitted_us;
+        char response;          // Letter that completes it, matches untagged responses in send order
+        uint8_t wire_len;       // Bytes counted against I2C_IN_FLIGHT_BUDGET until answered
+        uint32_t sequence;
+        unsigned long deadline;
+        uint8_t script_steps;
+        uint8_t step_read[I2C_SCRIPT_MAX_STEPS];   // Bytes each script step reads
+        uint8_t xfer_id;
+        uint8_t* transfer_out;
+        uint16_t transfer_len;
+        union {
+            Result result;
+            ScriptResult script;
+            TransferResult transfer;    // len counts the segments copied so far
+        };
+        SemaphoreHandle_t done_sem;
+        StaticSemaphore_t done_sem_buffer;
+    };
+
+    // Caller's buffer of a block read
+    struct BlockTarget {
+        uint8_t xfer_id;
+        uint8_t* out;
+        uint16_t len;
+    };
+
+    // A command as an ASCII data part, or as a binary frame payload with
+    // PROTOCOL_CAP_BINARY_I2C
+    struct Command {
+        char op;
+        const char* data_part;      // nullptr for a binary frame
+        const uint8_t* payload;
+        uint8_t payload_len;
+    };
+
+    // Reserves a slot, sends the command and records its request ID, all
+    // under the table lock so the response cannot overtake the bookkeeping
+    static Handle submit(uint8_t addr, const Command& command, unsigned long timeout_ms, const Script* script = nullptr, const BlockTarget* block = nullptr);
+    static Handle submit(uint8_t addr, const char* data_part, unsigned long timeout_ms, const Script* script = nullptr, const BlockTarget* block = nullptr);
+    static Pending* find(uint8_t request_id, char response);   // Table lock held
+    // Marks the slot done, wakes its waiter and records the transaction. Table lock held.
+    static void finish(Pending* pending, uint8_t status);
+    // Blocks until the slot completes or its deadline passes, then releases
+    // it. out receives the Result or ScriptResult if it completed.
+    static bool collect(Handle handle, void* out, size_t size);
+
+    // CMD_I2C_* data parts, false if the request does not fit
+    static bool format_read_request(char* out, size_t size, uint8_t address, uint8_t num_bytes);
+    static bool format_write_request(char* out, size_t size, uint8_t address, const uint8_t* data, uint8_t data_len);
+    static bool format_write_read_request(char* out, size_t size, uint8_t address, const uint8_t* write_data, uint8_t write_len, uint8_t read_len);
+    static bool format_write_chunk(char* out, size_t size, uint8_t address, const uint8_t* data, uint8_t offset, uint8_t len, uint8_t total);
+    static bool format_script(char* out, size_t size, const Script& script);
+    // CMD_I2C_READ frame payload, returns its length
+    static uint8_t format_read_frame(uint8_t* out, uint8_t address, const uint8_t* write_data, uint8_t write_len, uint8_t read_len);
+
+    static Handle submitChunk(uint8_t addr, const uint8_t* data, uint8_t offset, uint8_t len, uint8_t total);
+
+    // CMD_I2C_WRITE_CHUNK transfer, see I2C_WRITE_WINDOW
+    static Result writeChunked(uint8_t addr, const uint8_t* data, uint8_t len);
+
+    static uint8_t nextTransferId();
+    static Handle submitWriteSegment(uint8_t xfer_id, uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t offset, uint8_t len, uint16_t total, bool fixed_reg);
+
+    struct WatchSlot {
+        bool used;
+        bool fresh;             // Pushed since the last takeWatchSample()
+        uint8_t addr;
+        WatchSample sample;
+    };
+
+    // Sends a CMD_I2C_WATCH data part and waits for its RSP_I2C_WATCH
+    static bool sendWatchCommand(uint8_t addr, const char* data_part);
     
     static unsigned long _timeout_ms;
-    static QueueHandle_t _response_queue;
+    static Pending _pending[I2C_PENDING_SLOTS];
+    static uint32_t _next_sequence;
+    static uint8_t _next_xfer_id;
+    static WatchSlot _watches[I2C_WATCH_SLOTS];
+    static bool _watches_cleared;   // Jobs left over from before an ESP32 restart were removed
+    static SemaphoreHandle_t _mutex;
+    static StaticSemaphore_t _mutex_buffer;
 };
 
 // Function declarations for HAL implementation
 extern "C" {
     int i2c_write(uint8_t addr, uint8_t* data, uint8_t len);
     int i2c_read(uint8_t addr, uint8_t* data, uint8_t len);
-}
\ No newline at end of file
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "NanoLinkMetrics.h"
+#include "protocol/Commands.h"
+
+#define I2C_STATS_SLOTS         16  // Address and operation pairs, pairs seen after the table filled up are not counted
+#define I2C_STATS_ERROR_CODES   I2C_ERROR_BUF_LEN   // I2C_ERROR_ADDR_NACK..I2C_ERROR_BUF_LEN
+
+// Counters and latency of I2C bridge transactions per device address and
+// operation, the operation being the command letter that carried it
+// (CMD_I2C_READ, CMD_I2C_SCRIPT, ...). Latency runs from the submit to the
+// Nano's answer and uses the NanoLinkMetrics histogram buckets. Updated
+// with atomics only, from the NanoLink RX task on completion and from the
+// sensor tasks on timeouts and retries, so recording never waits on a
+// reader. Read by loop() for Home Assistant and by the /metrics/i2c page.
+class I2CBridgeStats {
+public:
+    struct Summary {
+        uint32_t transactions;  // Answered by the Nano
+        uint32_t errors;        // Answered with an I2C_ERROR_* code
+        uint32_t timeouts;      // No answer before the deadline
+        uint32_t retries;
+        uint32_t latency_p99_us;
+        uint8_t busiest_addr;   // Most time spent in bridge transactions, 0 before the first one
+        uint8_t busiest_percent;
+    };
+
+    static I2CBridgeStats& getInstance() {
+        static I2CBridgeStats instance;
+        return instance;
+    }
+
+    // status is the Nano's I2C_ERROR_*, I2C_ERROR_PENDING acknowledges a staged chunk
+    void record(uint8_t addr, char op, uint8_t status, uint32_t latency_us);
+    void countTimeout(uint8_t addr, char op);
+    void countRetry(uint8_t addr, char op);
+    void reset();
+
+    Summary summary();
+    void writeJson(String& out);
+
+private:
+    struct Entry {
+        std::atomic<uint16_t> key;  // addr << 8 | op, 0 while the slot is free
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> retries;
+        std::atomic<uint32_t> timeouts;
+        std::atomic<uint32_t> errors[I2C_STATS_ERROR_CODES];
+        std::atomic<uint32_t> latency_min_us;
+        std::atomic<uint32_t> latency_max_us;
+        std::atomic<uint64_t> latency_sum_us;  // libatomic guards 64 bit adds with a short critical section on the ESP32
+        std::atomic<uint32_t> buckets[NANO_LATENCY_BUCKETS];
+    };
+
+    I2CBridgeStats();
+    I2CBridgeStats(const I2CBridgeStats&) = delete;
+    I2CBridgeStats& operator=(const I2CBridgeStats&) = delete;
+
+    // Claims a free slot the first time a pair is seen, nullptr when full
+    Entry* entryFor(uint8_t addr, char op);
+
+    static const char* opName(char op);
+    static uint32_t percentileUs(const uint32_t* buckets, uint32_t count, uint32_t max_us, uint8_t percent);
+
+    Entry _entries[I2C_STATS_SLOTS];
+    std::atomic<unsigned long> _since;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "protocol/Commands.h"
+
+// One I2C bus as the sensor drivers see it. Backends are the serial bridge
+// to the Nano (I2CBridgeBus), the ESP32's own I2C controller (WireI2CBus)
+// and an in-memory register map for host builds (MockI2CBus). Each device
+// is bound to one backend at startup, see I2CBuses. Nothing in here needs
+// Arduino or FreeRTOS, so drivers written against it build on Linux.
+class I2CBus {
+public:
+    // Result structure for I2C operations
+    struct Result {
+        bool success;
+        uint8_t error_code;     // I2C_ERROR_*
+        uint8_t data[32]; // Max 32 bytes of data
+        uint8_t data_len;
+    };
+
+    // Steps for one device, run with runScript(). The bridge sends them in a
+    // single link round trip when the Nano has PROTOCOL_CAP_I2C_SCRIPTS.
+    // Adding a step past the I2C_SCRIPT_* limits marks the script invalid.
+    class Script {
+    public:
+        explicit Script(uint8_t addr) : _addr(addr) {}
+
+        Script& write(const uint8_t* data, uint8_t len);
+        Script& read(uint8_t len);
+        Script& writeRead(const uint8_t* data, uint8_t write_len, uint8_t read_len);
+        Script& readRegister(uint8_t reg, uint8_t len) { return writeRead(&reg, 1, len); }
+        Script& delayMs(uint8_t ms);
+
+        bool valid() const { return _valid && _step_count > 0; }
+        uint8_t stepCount() const { return _step_count; }
+        uint8_t addr() const { return _addr; }
+
+    private:
+        friend class I2CBus;
+        friend class I2CBridge;
+
+        struct Step {
+            char op;            // I2C_SCRIPT_OP_*
+            uint8_t write_len;
+            uint8_t read_len;   // Delay in ms for I2C_SCRIPT_OP_DELAY
+            uint8_t write[I2C_SCRIPT_MAX_WRITE];
+        };
+
+        Script& add(char op, const uint8_t* data, uint8_t write_len, uint8_t read_len);
+
+        uint8_t _addr;
+        Step _steps[I2C_SCRIPT_MAX_STEPS];
+        uint8_t _step_count = 0;
+        uint8_t _read_total = 0;
+        uint16_t _delay_total_ms = 0;
+        uint8_t _command_len = 3; // "Q" and the address
+        bool _valid = true;
+    };
+
+    // Outcome of readBlock() and writeBlock()
+    struct TransferResult {
+        bool success;
+        uint8_t error_code;
+        uint16_t len;           // Bytes read into or written from the caller's buffer
+    };
+
+    struct ScriptResult {
+        bool success;           // Every step succeeded
+        uint8_t error_code;     // Status of the first failed step
+        uint8_t step_count;
+        uint8_t status[I2C_SCRIPT_MAX_STEPS];   // I2C_ERROR_PENDING for steps that did not run
+        uint8_t offset[I2C_SCRIPT_MAX_STEPS];   // Start of each step's read data in data
+        uint8_t data[I2C_SCRIPT_MAX_READ];
+        uint8_t data_len;
+
+        const uint8_t* stepData(uint8_t step) const { return data + offset[step]; }
+    };
+
+    // A register watch run by the Nano, see I2C_WATCH_* in protocol/Commands.h
+    struct Watch {
+        uint8_t addr;
+        uint8_t mode;           // I2C_WATCH_*
+        uint8_t mask;
+        uint8_t cond_reg;       // Tested by the I2C_WATCH_BITS_* modes
+        uint8_t reg;
+        uint8_t len;            // Bytes read from reg, 0 to push only the cond_reg byte
+        uint16_t period_ms;
+    };
+
+    // The latest push of a watch
+    struct WatchSample {
+        uint8_t status;         // I2C_ERROR_* of the Nano's read
+        uint8_t data[I2C_WATCH_MAX_LEN + 1];   // The cond_reg byte first for the I2C_WATCH_BITS_* modes
+        uint8_t data_len;
+        unsigned long received_ms;
+    };
+
+    virtual ~I2CBus() {}
+
+    // "bridge", "wire" or "mock", for the log
+    virtual const char* name() const = 0;
+
+    // Blocking transactions, reads of at most sizeof(Result::data) bytes.
+    // writeRead() sends a repeated start between its write and its read.
+    virtual Result read(uint8_t addr, uint8_t len) = 0;
+    virtual Result write(uint8_t addr, const uint8_t* data, uint8_t len) = 0;
+    virtual Result writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) = 0;
+
+    // The defaults below are built on the three transactions above, one per
+    // step or segment. Backends with a faster path override them.
+    virtual ScriptResult runScript(const Script& script);
+    // Register blocks of up to I2C_TRANSFER_MAX_LEN bytes. Segments address
+    // reg + offset, or reg itself with fixed_reg for FIFOs.
+    virtual TransferResult readBlock(uint8_t addr, uint8_t reg, uint8_t* out, uint16_t len, bool fixed_reg = false);
+    virtual TransferResult writeBlock(uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t len, bool fixed_reg = false);
+
+    // Cache for registers that never change while the device stays powered,
+    // keyed by address, register and length. Drivers check it before reading
+    // such a block and store what they read. Only the bridge keeps one, a
+    // register read there is a serial round trip; it is dropped when the
+    // Nano reboots or recovers its bus.
+    virtual bool loadConstant(uint8_t addr, uint16_t reg, uint8_t* out, uint8_t len) { (void)addr; (void)reg; (void)out; (void)len; return false; }
+    virtual void storeConstant(uint8_t addr, uint16_t reg, const uint8_t* data, uint8_t len) { (void)addr; (void)reg; (void)data; (void)len; }
+
+    // Register watches need a bus master that polls on its own, only the
+    // bridge has one. addWatch() returns -1 elsewhere and the driver polls.
+    virtual int8_t addWatch(const Watch& watch) { (void)watch; return -1; }
+    virtual void removeWatch(int8_t id) { (void)id; }
+    // True once per push, sample holds the pushed read
+    virtual bool takeWatchSample(int8_t id, WatchSample& sample) { (void)id; (void)sample; return false; }
+
+protected:
+    // I2C_SCRIPT_OP_DELAY steps of the default runScript()
+    virtual void sleepMs(uint16_t ms) = 0;
+
+    static Result failed(uint8_t error_code) { return {false, error_code, {0}, 0}; }
+    static ScriptResult rejectScript(const Script& script);
+    static bool transferFits(uint8_t reg, uint16_t len, bool fixed_reg) {
+        return len > 0 && len <= I2C_TRANSFER_MAX_LEN && (fixed_reg || reg + len <= 0x100);
+    }
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "I2CBus.h"
+#include "I2CBridge.h"
+
+#define I2C_WIRE_SDA_PIN        21  // The CST820 touch controller's bus
+#define I2C_WIRE_SCL_PIN        22
+#define I2C_WIRE_FREQUENCY      400000
+#define I2C_WIRE_TIMEOUT_MS     50
+
+// Sensors that can be wired to either bus. Bit n of the i2c_direct setting
+// puts device n on the ESP32's own bus, the others stay behind the Nano.
+enum I2CDevice : uint8_t {
+    I2C_DEVICE_ZMOD4510,
+    I2C_DEVICE_BMP280,
+    I2C_DEVICE_AHT20,
+    I2C_DEVICE_COUNT
+};
+
+// I2CBus over the serial bridge. Scripts and block transfers fall back to
+// the step by step defaults on Nano firmware without PROTOCOL_CAP_I2C_SCRIPTS
+// or PROTOCOL_CAP_I2C_TRANSFERS.
+class I2CBridgeBus : public I2CBus {
+public:
+    static I2CBridgeBus& getInstance() {
+        static I2CBridgeBus instance;
+        return instance;
+    }
+
+    const char* name() const override { return "bridge"; }
+
+    Result read(uint8_t addr, uint8_t len) override;
+    Result write(uint8_t addr, const uint8_t* data, uint8_t len) override;
+    Result writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) override;
+
+    ScriptResult runScript(const Script& script) override;
+    TransferResult readBlock(uint8_t addr, uint8_t reg, uint8_t* out, uint16_t len, bool fixed_reg = false) override;
+    TransferResult writeBlock(uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t len, bool fixed_reg = false) override;
+
+    // Backed by I2CRegisterCache
+    bool loadConstant(uint8_t addr, uint16_t reg, uint8_t* out, uint8_t len) override;
+    void storeConstant(uint8_t addr, uint16_t reg, const uint8_t* data, uint8_t len) override;
+
+    int8_t addWatch(const Watch& watch) override;
+    void removeWatch(int8_t id) override;
+    bool takeWatchSample(int8_t id, WatchSample& sample) override;
+
+protected:
+    void sleepMs(uint16_t ms) override;
+
+private:
+    I2CBridgeBus() {}
+};
+
+// I2CBus on the ESP32's I2C controller, register access in microseconds
+// instead of a serial round trip. Shares Wire with the CST820 touch
+// controller; Wire's own lock keeps the UI task's transactions apart and is
+// held from a write across the repeated start to its read.
+class WireI2CBus : public I2CBus {
+public:
+    static WireI2CBus& getInstance() {
+        static WireI2CBus instance(Wire);
+        return instance;
+    }
+
+    bool begin();
+
+    const char* name() const override { return "wire"; }
+
+    Result read(uint8_t addr, uint8_t len) override;
+    Result write(uint8_t addr, const uint8_t* data, uint8_t len) override;
+    Result writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) override;
+
+protected:
+    void sleepMs(uint16_t ms) override;
+
+private:
+    explicit WireI2CBus(TwoWire& wire) : _wire(wire) {}
+
+    // Wire's endTransmission() codes as I2C_ERROR_*
+    static uint8_t statusOf(uint8_t wire_error);
+    // requestFrom() with sendStop, fills result
+    void requestInto(uint8_t addr, uint8_t len, Result& result);
+
+    TwoWire& _wire;
+};
+
+// Which backend each I2CDevice talks through, chosen once at startup
+class I2CBuses {
+public:
+    // direct_devices is the i2c_direct setting, starts Wire if any bit is set
+    static void begin(uint8_t direct_devices);
+    static I2CBus& forDevice(I2CDevice device);
+
+private:
+    static uint8_t _direct_devices;
+};
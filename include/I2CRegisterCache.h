@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#define I2C_REGISTER_CACHE_ENTRIES  8
+#define I2C_REGISTER_CACHE_MAX_LEN  32  // Largest cached read, the BMP280 calibration is 26 bytes
+
+// Read-only registers of the sensors behind the bridge (chip IDs,
+// calibration and trimming data), keyed by address, register and length so
+// re-initialising a sensor skips the round trips and the ZMOD4510's NVM
+// readout. Mirrored to NVS, a warm ESP32 reboot finds the entries again
+// while the Nano and its sensors kept running. Everything is dropped when
+// the Nano reboots or recovers the bus, the sensors may have been swapped
+// or power cycled. Entries are only ever written with successful reads.
+class I2CRegisterCache {
+public:
+    static I2CRegisterCache& getInstance() {
+        static I2CRegisterCache instance;
+        return instance;
+    }
+
+    // Loads the entries a previous boot stored, call once at startup
+    void begin();
+
+    // False on a miss, out is left untouched then
+    bool load(uint8_t addr, uint16_t reg, uint8_t* out, uint8_t len);
+    // Replaces an entry with the same key or takes a free one, full tables keep what they have
+    void store(uint8_t addr, uint16_t reg, const uint8_t* data, uint8_t len);
+    // Drops every entry, in RAM and in NVS
+    void invalidate(const char* reason);
+
+    uint32_t hits() const { return _hits; }
+    uint32_t misses() const { return _misses; }
+
+private:
+    struct Entry {
+        uint8_t used;
+        uint8_t addr;
+        uint16_t reg;
+        uint8_t len;
+        uint8_t data[I2C_REGISTER_CACHE_MAX_LEN];
+    };
+
+    I2CRegisterCache();
+    I2CRegisterCache(const I2CRegisterCache&) = delete;
+    I2CRegisterCache& operator=(const I2CRegisterCache&) = delete;
+
+    Entry* find(uint8_t addr, uint16_t reg, uint8_t len);
+    // Writes the table to NVS, caller holds _mutex
+    void persist();
+
+    static const char* NVS_NAMESPACE;
+    static const char* KEY_ENTRIES;
+
+    SemaphoreHandle_t _mutex;
+    StaticSemaphore_t _mutexBuffer;
+    Preferences _preferences;
+    bool _nvs_ready;
+    Entry _entries[I2C_REGISTER_CACHE_ENTRIES];
+    uint32_t _hits;
+    uint32_t _misses;
+};
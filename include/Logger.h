@@ -12,6 +12,9 @@
 
 #include <atomic>
 
+// UART0 console for SERIAL_OUT_DEBUG, the Nano link runs on its own UART
+#define CONSOLE_BAUD_RATE 921600
+
 enum AppLogLevel {
     APP_LOG_DEBUG,
     APP_LOG_INFO,
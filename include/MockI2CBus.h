@@ -0,0 +1,58 @@
+#pragma once
+
+#include "I2CBus.h"
+
+#define MOCK_I2C_DEVICES        4
+
+// In-memory I2CBus for host builds, so drivers run and can be timed on
+// Linux. Every device is a 256 byte register map behind an auto-incrementing
+// register pointer: a write sets the pointer from its first byte and stores
+// the rest from there, a read returns bytes from the pointer on. Addresses
+// without a device NACK. Delays only advance sleptMs().
+class MockI2CBus : public I2CBus {
+public:
+    MockI2CBus();
+
+    // False if all MOCK_I2C_DEVICES are taken
+    bool addDevice(uint8_t addr);
+    // The device's register map, nullptr if there is none at addr
+    uint8_t* registers(uint8_t addr);
+    // The next count transactions with addr fail with error_code
+    void failNext(uint8_t addr, uint8_t error_code, uint8_t count = 1);
+    // Reads from addr start at reg whatever was written before, as on
+    // command driven chips (AHT20) that answer every read status first
+    void fixReadPointer(uint8_t addr, uint8_t reg);
+
+    uint32_t transactions() const { return _transactions; }
+    uint32_t sleptMs() const { return _slept_ms; }
+
+    const char* name() const override { return "mock"; }
+
+    Result read(uint8_t addr, uint8_t len) override;
+    Result write(uint8_t addr, const uint8_t* data, uint8_t len) override;
+    Result writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) override;
+
+protected:
+    void sleepMs(uint16_t ms) override { _slept_ms += ms; }
+
+private:
+    struct Device {
+        bool used;
+        uint8_t addr;
+        uint8_t pointer;
+        uint8_t fail_code;
+        uint8_t fail_count;
+        bool fixed_read;
+        uint8_t read_reg;
+        uint8_t regs[256];
+    };
+
+    // Counts the transaction, nullptr with error set if it fails
+    Device* begin(uint8_t addr, uint8_t& error);
+    static void store(Device& device, const uint8_t* data, uint8_t len);
+    static Result load(Device& device, uint8_t len);
+
+    Device _devices[MOCK_I2C_DEVICES];
+    uint32_t _transactions;
+    uint32_t _slept_ms;
+};
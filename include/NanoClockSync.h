@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define NANO_CLOCK_SYNC_SAMPLES      8
+#define NANO_CLOCK_SYNC_FAST_MS      5000   // Interval until NANO_CLOCK_SYNC_SAMPLES are collected
+#define NANO_CLOCK_SYNC_INTERVAL_MS  60000
+#define NANO_CLOCK_MAX_DRIFT_PPM     10000  // Ceramic resonators are within 0.5 %
+
+// Maps the Nano's millis() onto the ESP32's time base. Each CMD_TIME_SYNC
+// exchange gives four timestamps, NTP style:
+//   t1 ESP32 send, t2 Nano receive, t3 Nano send, t4 ESP32 receive
+// The round trip without the Nano's processing time is the delay, the
+// midpoints of both sides are taken as simultaneous. The sample with the
+// smallest delay anchors the mapping and the drift is the least squares
+// slope over the samples whose delay is close to it. Used from loop() only.
+class NanoClockSync {
+public:
+    NanoClockSync() { reset(); }
+
+    void reset();
+
+    // t1/t4 are esp_timer_get_time() microseconds, t2/t3 Nano millis()
+    void addSample(int64_t t1_us, uint32_t t2_ms, uint32_t t3_ms, int64_t t4_us);
+
+    bool isSynchronized() const { return _count > 0; }
+    uint8_t sampleCount() const { return _count; }
+
+    // ESP32 millis() at which the Nano's clock read nano_ms. Returns false
+    // until the first exchange completed.
+    bool toLocalMillis(uint32_t nano_ms, unsigned long& local_ms) const;
+
+    // Nano clock minus ESP32 clock at the anchor sample, in microseconds
+    int64_t offsetUs() const { return (int64_t)_anchorNanoMs * 1000 - _anchorLocalUs; }
+    float driftPpm() const { return (float)((_rate - 1.0) * 1e6); }
+    uint32_t anchorDelayUs() const { return _anchorDelayUs; }
+
+private:
+    struct Sample {
+        int64_t local_us;   // Midpoint of t1 and t4
+        uint32_t nano_ms;   // Midpoint of t2 and t3
+        uint32_t delay_us;  // (t4 - t1) - (t3 - t2)
+    };
+
+    void update();
+
+    Sample _samples[NANO_CLOCK_SYNC_SAMPLES];
+    uint8_t _count;
+    uint8_t _head;
+    int64_t _anchorLocalUs;
+    uint32_t _anchorNanoMs;
+    uint32_t _anchorDelayUs;
+    double _rate;           // Nano milliseconds per ESP32 millisecond
+};
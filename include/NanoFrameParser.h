@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "protocol/Frames.h"
+
+// Byte-at-a-time parser for everything the Nano sends on the serial link.
+// Handles both "<DATA,CRC8>" ASCII packets and 0x00 delimited COBS binary
+// frames. Works in a fixed buffer and validates the checksum while bytes
+// arrive, so a completed frame can be used in place without any copy.
+class NanoFrameParser {
+public:
+    static const size_t MAX_ASCII_LEN = 255;  // DATA + ',' + checksum digits
+
+    enum class Result {
+        NONE,           // Need more bytes
+        ASCII_FRAME,    // asciiData() holds a validated DATA part
+        BINARY_FRAME,   // frameType()/payload() hold a validated binary frame
+        ERROR           // Frame dropped, see error()
+    };
+
+    enum class Error {
+        NONE,
+        UNEXPECTED_CHAR,    // Byte outside of any frame
+        ASCII_OVERFLOW,
+        NO_CHECKSUM,        // ASCII packet without ',' before '>'
+        CHECKSUM_MISMATCH,  // ASCII CRC-8 mismatch
+        BINARY_OVERFLOW,
+        COBS_MALFORMED,
+        BINARY_TOO_SHORT,
+        CRC_MISMATCH        // Binary CRC-16 mismatch
+    };
+
+    NanoFrameParser();
+
+    Result feed(uint8_t byte);
+    void reset();
+
+    // Valid after ASCII_FRAME until the next feed(). NUL terminated and
+    // writable so decoders can tokenize it in place.
+    char* asciiData() { return ascii_buffer; }
+    size_t asciiLength() const { return ascii_data_len; }
+
+    // Valid after BINARY_FRAME until the next feed()
+    uint8_t frameType() const { return binary_buffer[0]; }
+    uint8_t frameRequestId() const { return binary_buffer[1]; }
+    const uint8_t* payload() const { return binary_buffer + BINARY_FRAME_HEADER_LEN; }
+    size_t payloadLength() const { return binary_len - BINARY_FRAME_HEADER_LEN - 2; }
+
+    Error error() const { return last_error; }
+    uint8_t errorByte() const { return error_byte; }
+    static const char* errorToString(Error error);
+
+private:
+    enum class State { IDLE, ASCII, BINARY, DISCARD };
+
+    Result fail(Error error, uint8_t byte);
+    Result feedAscii(uint8_t byte);
+    Result feedBinary(uint8_t byte);
+    Result finishBinary();
+
+    State state;
+    Error last_error;
+    uint8_t error_byte;
+
+    // ASCII state
+    char ascii_buffer[MAX_ASCII_LEN + 1];
+    size_t ascii_len;
+    size_t ascii_data_len;
+    int last_comma;             // Index of the last ',' seen, -1 if none
+    uint8_t crc8;               // Running CRC-8 over the bytes received so far
+    uint8_t crc8_at_last_comma; // CRC-8 of everything before last_comma
+
+    // Binary state, decoded on the fly
+    uint8_t binary_buffer[BINARY_FRAME_MAX_RAW_LEN];
+    size_t binary_len;
+    size_t binary_encoded_len;  // Bytes received since the leading delimiter
+    uint8_t cobs_remaining;     // Data bytes left in the current COBS block
+    bool cobs_zero_pending;     // Current block ends with an implicit zero
+    uint16_t crc16;             // Running CRC-16, lags two bytes behind to skip the trailer
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "NanoFrameParser.h"
+
+// --- Nano Serial Link Configuration ---
+// The link has UART2 to itself, UART0 stays the console for boot ROM output
+// and SERIAL_OUT_DEBUG. Port and pins can be overridden with build flags,
+// boards still wired to UART0 build with -DNANO_UART_PORT=UART_NUM_0
+// -DNANO_UART_TX_PIN=1 -DNANO_UART_RX_PIN=3.
+#ifndef NANO_UART_PORT
+#define NANO_UART_PORT            UART_NUM_2
+#endif
+#ifndef NANO_UART_TX_PIN
+#define NANO_UART_TX_PIN          26 // Not used by the display, touch or backlight
+#endif
+#ifndef NANO_UART_RX_PIN
+#define NANO_UART_RX_PIN          35 // Input only, fine for RX
+#endif
+#define NANO_UART_BAUD            LINK_DEFAULT_BAUD // Raised at runtime with setBaudRate()
+#define NANO_UART_RX_BUFFER_SIZE  2048 // Several full ASCII packets even if loop() stalls
+#define NANO_UART_EVENT_QUEUE_LEN 16
+// The hardware FIFO holds 128 bytes. Hand data to the driver once it is half
+// full, so a burst at 500 kbaud never overruns it, and after 2 idle symbols,
+// which ends a binary frame without waiting for the default 10.
+#define NANO_UART_RX_FIFO_FULL_THRESH 64
+#define NANO_UART_RX_TIMEOUT_SYMBOLS  2
+
+#define NANO_FRAME_QUEUE_LEN      8 // Per channel, see PROTOCOL_CHANNEL_*
+#define NANO_RX_TASK_STACK_SIZE   3072
+#define NANO_RX_TASK_PRIORITY     (tskIDLE_PRIORITY + 4) // Above the main loop
+
+// A complete, checksum-validated frame received from the Nano
+struct NanoFrame {
+    enum Kind : uint8_t { ASCII, BINARY };
+
+    Kind kind;
+    uint8_t type;          // Binary frame type (BINARY only)
+    uint8_t request_id;    // Request ID the frame answers, REQUEST_ID_NONE if untagged
+    uint8_t channel;       // PROTOCOL_CHANNEL_* of the frame type
+    uint16_t length;       // ASCII DATA length or binary payload length
+    int64_t received_us;   // esp_timer_get_time() when the last byte was parsed
+    char data[NanoFrameParser::MAX_ASCII_LEN + 1]; // ASCII DATA without the tag (NUL terminated) or binary payload
+};
+
+// Owns the UART connected to the Nano. A dedicated task sleeps on the ESP-IDF
+// UART event queue, which is woken by pattern detection on '>' (end of an
+// ASCII packet) or by the RX idle timeout (end of a binary frame). Received
+// bytes are parsed right away and complete frames are queued for consumers,
+// one queue per logical channel.
+class NanoLink {
+public:
+    // Runs on the RX task, must not block
+    typedef void (*ChannelHandler)(NanoFrame& frame);
+
+    static NanoLink& getInstance() {
+        static NanoLink instance;
+        return instance;
+    }
+
+    bool begin();
+
+    // Pops the next received frame, highest priority channel first
+    bool receive(NanoFrame& frame);
+
+    // Frames of the channel go to handler as soon as they are parsed
+    // instead of being queued. Set before begin().
+    void setChannelHandler(uint8_t channel, ChannelHandler handler);
+
+    // Writes raw bytes to the Nano, safe to call from several tasks
+    void write(const uint8_t* data, size_t len);
+
+    // Switches the UART speed once pending output has been sent. Anything
+    // half received is dropped since it arrived at the old rate.
+    void setBaudRate(uint32_t baud);
+    uint32_t baudRate() const { return _baudRate; }
+
+    // Packets rejected by the parser (checksum, COBS, overflow) since boot
+    uint32_t errorCount() const { return _errorCount; }
+
+private:
+    NanoLink() : _uartEventQueue(nullptr), _frameQueues{}, _channelHandlers{}, _taskHandle(nullptr),
+                 _baudRate(NANO_UART_BAUD), _errorCount(0), _parserResetPending(false) {
+        _writeMutex = xSemaphoreCreateMutexStatic(&_writeMutexBuffer);
+    }
+    NanoLink(const NanoLink&) = delete;
+    NanoLink& operator=(const NanoLink&) = delete;
+
+    static void taskFunction(void* parameter);
+    void taskLoop();
+    void drainRx();
+    void publishFrame(NanoFrameParser::Result result);
+
+    NanoFrameParser _parser;
+    QueueHandle_t _uartEventQueue;
+    QueueHandle_t _frameQueues[PROTOCOL_CHANNEL_COUNT];
+    ChannelHandler _channelHandlers[PROTOCOL_CHANNEL_COUNT];
+    TaskHandle_t _taskHandle;
+    uint32_t _baudRate;
+    volatile uint32_t _errorCount;
+    volatile bool _parserResetPending; // Set by setBaudRate(), handled by the RX task
+
+    // Keeps packets from different tasks from interleaving on the wire
+    SemaphoreHandle_t _writeMutex;
+    StaticSemaphore_t _writeMutexBuffer;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "protocol/Commands.h"
+
+#define NANO_METRICS_TYPE_SLOTS       27  // Response letters 'a'..'z', the last slot counts everything else
+#define NANO_METRICS_OTHER_SLOT       26
+
+// Log-linear latency histogram: every power of two is split into
+// 2^NANO_LATENCY_SUB_BITS linear steps, so a bucket is at most 12.5 % wide
+#define NANO_LATENCY_SUB_BITS         3
+#define NANO_LATENCY_MIN_SHIFT        7   // Bucket 0 holds everything below 128 us
+#define NANO_LATENCY_GROUPS           14  // 128 us up to 2.1 s, slower lands in the last bucket
+#define NANO_LATENCY_BUCKETS          ((NANO_LATENCY_GROUPS << NANO_LATENCY_SUB_BITS) + 2)
+
+// X-macro list of the per response type counters and their JSON names
+#define NANO_LINK_COUNTER_LIST \
+    X(FRAMES, "frames") \
+    X(CRC_ERRORS, "crc_errors") \
+    X(FRAMING_ERRORS, "framing_errors") \
+    X(TIMEOUTS, "timeouts") \
+    X(DUPLICATES, "duplicates") \
+    X(GAPS, "gaps")
+
+// Link quality counters for the Nano link, kept per response type, and the
+// request to response latency of every tracked command in one histogram per
+// logical channel. Recorded from the NanoLink RX task and loop(), read by
+// loop() for the UI, Home Assistant and the /metrics web endpoint.
+class NanoLinkMetrics {
+public:
+    enum Counter : uint8_t {
+#define X(name, json) name,
+        NANO_LINK_COUNTER_LIST
+#undef X
+        COUNTER_COUNT
+    };
+
+    // Totals over all response types and channels
+    struct Summary {
+        uint32_t frames;
+        uint32_t errors;        // CRC and framing errors
+        uint32_t timeouts;
+        uint32_t duplicates;
+        uint32_t gaps;
+        uint32_t latency_p50_us;
+        uint32_t latency_p99_us;
+        uint32_t latency_max_us;
+    };
+
+    static NanoLinkMetrics& getInstance() {
+        static NanoLinkMetrics instance;
+        return instance;
+    }
+
+    // type is the response letter or binary frame type, 0 if unknown
+    void count(char type, Counter counter, uint32_t amount = 1);
+    void recordLatency(char type, uint32_t latency_us);
+    void reset();
+
+    // Both read into a snapshot owned by the instance, call from loop() only
+    Summary summary();
+    void writeJson(String& out);
+
+    // Latency histogram buckets, also used by I2CBridgeStats
+    static uint8_t bucketOf(uint32_t latency_us);
+    static uint32_t bucketUpperUs(uint8_t bucket);
+
+private:
+    struct TypeMetrics {
+        uint32_t counters[COUNTER_COUNT];
+        uint32_t latency_count;
+        uint32_t latency_max_us;
+        uint64_t latency_sum_us;
+    };
+
+    struct Histogram {
+        uint32_t buckets[NANO_LATENCY_BUCKETS];
+        uint32_t count;
+        uint32_t max_us;
+    };
+
+    struct Data {
+        TypeMetrics types[NANO_METRICS_TYPE_SLOTS];
+        Histogram latency[PROTOCOL_CHANNEL_COUNT];
+        unsigned long since;    // millis() of the last reset
+    };
+
+    NanoLinkMetrics();
+    NanoLinkMetrics(const NanoLinkMetrics&) = delete;
+    NanoLinkMetrics& operator=(const NanoLinkMetrics&) = delete;
+
+    void takeSnapshot();
+
+    static uint8_t slotOf(char type);
+    static uint32_t percentileUs(const Histogram& histogram, uint8_t percent);
+
+    Data _data;
+    Data _snapshot;
+
+    SemaphoreHandle_t _mutex;
+    StaticSemaphore_t _mutexBuffer;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "protocol/Commands.h"
+
+#define NANO_REQUEST_TABLE_SIZE  16  // loop() commands and every outstanding I2CBridge transaction
+#define NANO_REQUEST_TIMEOUT_MS  500
+
+// Commands sent to the Nano that are still waiting for their response.
+// Each entry gets a request ID (1..255) and a deadline. Responses are matched
+// by ID when the Nano supports tagging, otherwise by response letter in send
+// order. Safe to use from several tasks.
+class NanoRequestTable {
+public:
+    struct Entry {
+        uint8_t id;
+        char cmd;
+        unsigned long sent_time;
+        unsigned long deadline;
+        int64_t sent_us;        // esp_timer_get_time() when registered, for latency metrics
+    };
+
+    NanoRequestTable();
+
+    // Registers a command, returns its ID or REQUEST_ID_NONE if the table is full
+    uint8_t add(char cmd, unsigned long timeout_ms = NANO_REQUEST_TIMEOUT_MS);
+
+    // Removes the entry answered by a response. request_id is REQUEST_ID_NONE
+    // for untagged responses, which complete the oldest entry for that letter.
+    bool complete(uint8_t request_id, char response, Entry& out);
+
+    // Removes one entry whose deadline has passed
+    bool popExpired(unsigned long now, Entry& out);
+
+    uint8_t pendingCount();
+    // Without the I2C bridge transactions, which are limited by their own
+    // byte budget. These are the commands loop() pipelines.
+    uint8_t pendingLoopCount();
+    void clear();
+
+private:
+    uint8_t countPending(bool include_bridge);
+
+    Entry entries[NANO_REQUEST_TABLE_SIZE];
+    bool used[NANO_REQUEST_TABLE_SIZE];
+    uint8_t nextId;
+
+    SemaphoreHandle_t mutex;
+    StaticSemaphore_t mutexBuffer;
+};
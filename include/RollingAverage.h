@@ -48,34 +48,58 @@ public:
      * @param newValue The new value to add.
      */
     void add(T newValue) {
+        add(newValue, millis());
+    }
+
+    /**
+     * @brief Adds a new value measured at the given millis() time.
+     * Samples are kept in timestamp order, so a late sample (e.g. a remote one whose
+     * mapped time lands before the last local one) is slotted in where it belongs.
+     * The time window is measured back from the newest sample.
+     * @param newValue The new value to add.
+     * @param timestamp When the value was measured, e.g. a remote sample mapped onto millis().
+     */
+    void add(T newValue, unsigned long timestamp) {
         // Ensure history is valid before proceeding
         if (history == nullptr) return;
 
-        unsigned long currentTime = millis();
-        this->lastValue = newValue; // Cache the latest value
+        if (count == max_samples) {
+            // Buffer is full, drop the oldest sample unless the new one is older still
+            if (isBefore(timestamp, history[tail].timestamp)) return;
+            tail = (tail + 1) % max_samples;
+            count--;
+        }
 
-        // Add the new data point
-        history[head] = {currentTime, newValue};
+        // Move newer samples up one slot until the new one fits in order
+        size_t pos = head;
+        size_t newer = 0;
+        while (newer < count) {
+            size_t prev = (pos + max_samples - 1) % max_samples;
+            if (!isBefore(timestamp, history[prev].timestamp)) break;
+            history[pos] = history[prev];
+            pos = prev;
+            newer++;
+        }
+        history[pos] = {timestamp, newValue};
         head = (head + 1) % max_samples;
-        
-        // Increase count if not full yet
-        if (count < max_samples) {
-            count++;
-        } else {
-            // Buffer is full, the oldest value is overwritten, so move tail forward
-            tail = (tail + 1) % max_samples;
+        count++;
+        if (newer == 0) {
+            this->lastValue = newValue; // Cache the latest value
         }
 
         // Remove old data points that are outside the time window
-        unsigned long cutoffTime = currentTime - WINDOW_MS;
-        while (count > 0 && history[tail].timestamp < cutoffTime) {
+        unsigned long newestTime = history[(head + max_samples - 1) % max_samples].timestamp;
+        while (count > 0 && newestTime - history[tail].timestamp > WINDOW_MS) {
             tail = (tail + 1) % max_samples;
             count--;
         }
     }
 
     /**
-     * @brief Calculates and returns the current average of the values within the time window.
+     * @brief Calculates and returns the time-weighted average of the values within the time window.
+     * Each interval between two samples counts by its length (trapezoid rule), so a burst of
+     * samples after a gap does not outweigh the steady samples around it. Falls back to the
+     * plain mean when all samples share one timestamp.
      * @return The calculated rolling average.
      */
     T getAverage() {
@@ -84,17 +108,27 @@ public:
             return this->lastValue; // Return the last known value to avoid division by zero.
         }
 
-        // Sum all the values currently in the history
         // Use double for precision regardless of T type
-        double sum = 0.0;
-        size_t current_pos = tail;
-        for (size_t i = 0; i < count; i++) {
-            sum += static_cast<double>(history[current_pos].value);
-            current_pos = (current_pos + 1) % max_samples;
+        double sum = static_cast<double>(history[tail].value);
+        double area = 0.0;
+        unsigned long span = 0;
+        size_t prev_pos = tail;
+        for (size_t i = 1; i < count; i++) {
+            size_t current_pos = (prev_pos + 1) % max_samples;
+            double prev_value = static_cast<double>(history[prev_pos].value);
+            double value = static_cast<double>(history[current_pos].value);
+            unsigned long interval = history[current_pos].timestamp - history[prev_pos].timestamp;
+            area += (prev_value + value) * 0.5 * interval;
+            span += interval;
+            sum += value;
+            prev_pos = current_pos;
         }
 
         // Return the calculated average, cast back to T
-        return static_cast<T>(sum / count);
+        if (span == 0) {
+            return static_cast<T>(sum / count);
+        }
+        return static_cast<T>(area / span);
     }
 
     /**
@@ -107,6 +141,11 @@ public:
     }
 
 private:
+    // millis() comparison that survives the 49 day rollover
+    static bool isBefore(unsigned long a, unsigned long b) {
+        return static_cast<long>(a - b) < 0;
+    }
+
     // A structure to hold a sensor value and its timestamp.
     struct DataPoint {
         unsigned long timestamp;
@@ -118,7 +157,7 @@ private:
     size_t count;                   // Current number of valid samples in the buffer
     size_t head;                    // Index where the next sample will be written
     size_t tail;                    // Index of the oldest sample in the buffer
-    T lastValue;                    // Caches the most recent value for immediate access
+    T lastValue;                    // Caches the newest value for immediate access
 };
 
 #endif // ROLLING_AVERAGE_H
@@ -47,6 +47,8 @@ class IUIUpdater;
     X(UI_SCD30_AUTOCAL) \
     X(UI_SCD30_FORCECAL) \
     X(UI_LAST_PACKET_TIME) \
+    X(UI_LINK_ERRORS) \
+    X(UI_LINK_LATENCY) \
     X(UI_RUNTIME_FREE_HEAP) \
     X(UI_RUNTIME_UPTIME) \
     X(UI_SENSORSTACK_UPTIME) \
@@ -133,6 +135,8 @@ public:
     void update_scd30_autocal(bool enabled);
     void update_scd30_forcecal(uint16_t value);
     void update_last_packet_time(uint32_t seconds_since_packet);
+    void update_link_errors(uint32_t errors);
+    void update_link_latency(uint32_t p99_us);
     void update_runtime_free_heap(uint32_t free_heap);
     void update_runtime_uptime(unsigned long system_uptime);
     void update_sensorstack_uptime(uint32_t uptime);
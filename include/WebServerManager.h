@@ -15,6 +15,9 @@ private:
     static void handleConfigUpdate();
     static void handleUpload();
     static void handleNotFound();
+    static void handleMetrics();
+    static void handleI2cMetrics();
+    static void handleMetricsReset();
 
 
     static void handleConfigGas();
@@ -2,9 +2,12 @@
 
 #include <Arduino.h>
 #include "zmod4510/no2_o3-arduino.h"
-#include "I2CBridge.h"
+#include "I2CBus.h"
 #include "Logger.h"
 
+// The Nano pushes status and ADC result once the sequencer stopped
+#define ZMOD4510_WATCH_PERIOD_MS 100
+
 class ZMOD4510Sensor {
 public:
     // Measurement results structure
@@ -17,7 +20,7 @@ public:
         bool valid;           // Whether the results are valid
     };
 
-    ZMOD4510Sensor();
+    explicit ZMOD4510Sensor(I2CBus& bus);
     ~ZMOD4510Sensor();
 
     // Initialize HAL and data structures (call once at startup)
@@ -50,7 +53,8 @@ private:
         STATE_DATA_READY
     };
 
-    // Hardware interface
+    // Hardware interface, hal.handle points at bus
+    I2CBus& bus;
     Interface_t hal;
     
     // Sensor data structures
@@ -73,9 +77,15 @@ private:
     Results latest_results;
     bool new_data_available;
     unsigned long measurement_start_time;
+    int8_t watch_id;        // -1 while the results are polled
     
     // Helper methods
     int detect_and_configure();
+    // zmod4xxx_read_sensor_info() behind the bus's register cache
+    int read_sensor_info();
     void read_and_verify();
+    // Status and ADC result pushed since the measurement started, false if none
+    bool take_pushed_result();
+    static int decode_error_event(uint8_t event);
     void processResults();
 };
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+
+// --- ESP32 <-> Nano Protocol Definitions ---
+// Shared by both firmwares. Commands are upper case (ESP32 -> Nano),
+// responses are the matching lower case letter (Nano -> ESP32).
+#define CMD_GET_SENSORS        'S' // Request sensor data
+#define RSP_SENSORS            's' // Response with sensor data
+#define RSP_SENSORS_DELTA      'x' // Binary only: sensor fields changed since the previous frame
+#define CMD_GET_VERSION        'V' // Request version, optional payload: ESP32 capabilities in hex
+#define RSP_VERSION            'v' // Response: <version>,<capabilities hex>
+#define CMD_GET_HEALTH         'H'
+#define RSP_HEALTH             'h' // Overall health status response
+#define CMD_ACK_HEALTH         'A' // Acknowledge Health Status
+#define CMD_REBOOT             'R' // Request Nano Reboot
+#define CMD_GET_SPS30_INFO     'P' // Request SPS30 info
+#define RSP_SPS30_INFO         'p' // Response with SPS30 info
+#define CMD_SPS30_CLEAN        'C' // Request manual SPS30 fan cleaning
+#define RSP_SPS30_CLEAN        'c' // ACK for fan cleaning command
+#define CMD_SGP41_TEST         'G' // Request SGP41 test
+#define RSP_SGP41_TEST         'g' // Response with SGP41 test result
+#define CMD_GET_SCD30_INFO     'D' // Request SCD30 info
+#define RSP_SCD30_INFO         'd' // Response with SCD30 info
+#define CMD_SET_SCD30_AUTOCAL  'T' // Set SCD30 AutoCalibration
+#define RSP_SCD30_AUTOCAL      't' // Response with SCD30 AutoCalibration result
+#define CMD_SET_SCD30_FORCECAL 'F' // Set SCD30 Forced Recalibration
+#define RSP_SCD30_FORCECAL     'f' // Response with SCD30 Forced Recalibration result
+#define CMD_SENSOR_STREAM      'U' // Subscribe to RSP_SENSORS, payload: period in ms (0 stops the stream)
+#define RSP_SENSOR_STREAM      'u' // Response with the accepted period in ms
+#define CMD_SET_BAUD_RATE      'B' // Switch the link speed, payload: baud rate
+#define RSP_BAUD_RATE          'b' // Response at the old rate with the rate used from now on
+#define CMD_PING               'K' // Link check, sent to verify a new baud rate
+#define RSP_PING               'k' // Response to CMD_PING
+#define CMD_TIME_SYNC          'Z' // Clock exchange, payload: ESP32 send time (t1) in hex
+#define RSP_TIME_SYNC          'z' // z<t1>,<t2>,<t3>: t1 echoed, Nano millis() at receive and at send, hex
+#define RSP_EVENT              'e' // Unsolicited event: e<code hex>,<param hex>, see NANO_EVENT_*
+#define RSP_LEGACY_EVENT       'E' // Event text as sent by Nano firmware before 1.10.0: E,<text>
+
+// --- I2C Bridge Commands ---
+#define CMD_I2C_READ           'I' // Request I2C read operation
+#define RSP_I2C_READ           'i' // Response with I2C read result
+#define CMD_I2C_WRITE          'W' // Request I2C write operation
+#define RSP_I2C_WRITE          'w' // Response with I2C write result
+#define CMD_I2C_WRITE_CHUNK    'Y' // Part of a chunked I2C write: Y<addr>,<offset>,<total>,<bytes...>
+#define RSP_I2C_WRITE_CHUNK    'y' // y<status>, I2C_ERROR_PENDING until the last chunk is written
+#define CMD_I2C_SCRIPT         'Q' // Transaction script: Q<addr>,<step>,<step>..., see I2C_SCRIPT_OP_*
+#define RSP_I2C_SCRIPT         'q' // q<status digit per step>,<read data of all steps as one hex string>
+#define CMD_I2C_WATCH          'J' // Set or remove a register watch, see I2C_WATCH_*
+#define RSP_I2C_WATCH          'j' // j<status>
+#define RSP_I2C_WATCH_DATA     'n' // Unsolicited: n<slot>,<status>,<read data as one hex string>
+#define CMD_I2C_READ_BLOCK     'L' // Segmented register read: L<xfer>,<addr>,<reg>,<total>,<flags>
+#define RSP_I2C_READ_BLOCK     'l' // l<xfer>,<status>,<bytes sent>, after the last RSP_I2C_SEGMENT
+#define RSP_I2C_SEGMENT        'm' // Unsolicited: m<xfer>,<offset>,<read data as one hex string>
+#define CMD_I2C_WRITE_BLOCK    'O' // Segment of a register write: O<xfer>,<addr>,<reg>,<offset>,<total>,<flags>,<bytes as one hex string>
+#define RSP_I2C_WRITE_BLOCK    'o' // o<status>, I2C_ERROR_PENDING until the last segment is written
+
+// --- Chunked I2C Writes ---
+// Long writes are split into chunks the Nano stages until the last one
+// arrives, then sends as one I2C transaction. The ESP32 keeps at most
+// I2C_WRITE_WINDOW chunks unacknowledged, each ack returns one credit. A
+// chunk is at most "<#XXYaa,oo,tt" + 12 x ",bb" + ",crc>" = 54 bytes, so a
+// full window fits the Nano's 128 byte serial RX buffer even while it is
+// busy reading its sensors.
+#define I2C_WRITE_CHUNK_LEN    12
+#define I2C_WRITE_WINDOW       2
+#define I2C_WRITE_MAX_LEN      36 // TWI_BUFFER_SIZE on the Nano
+
+// --- I2C Transaction Scripts ---
+// Steps for one device run back to back on the Nano and are answered with a
+// single RSP_I2C_SCRIPT. Every step is its op letter followed by hex byte
+// pairs: "Q76,X06F7,D0A,WF427" reads 6 bytes from register F7, waits 10 ms
+// and writes 27 to register F4. The Nano stops at the first failed step, the
+// steps after it report I2C_ERROR_PENDING. The read data of the successful
+// steps is concatenated in step order, a script rejected before it runs is
+// answered with a single status digit. The limits keep a command inside the
+// Nano's 128 byte serial RX buffer and a full response inside
+// ASCII_PACKET_MAX_LEN.
+#define I2C_SCRIPT_OP_WRITE      'W' // W<bytes>: write, then STOP
+#define I2C_SCRIPT_OP_READ       'R' // R<len>: read len bytes
+#define I2C_SCRIPT_OP_WRITE_READ 'X' // X<len><bytes>: write, repeated START, read len bytes
+#define I2C_SCRIPT_OP_DELAY      'D' // D<ms>: wait up to 255 ms
+#define I2C_SCRIPT_MAX_STEPS     8
+#define I2C_SCRIPT_MAX_WRITE     16  // Bytes written by one step
+#define I2C_SCRIPT_MAX_STEP_READ 32  // Wire library buffer
+#define I2C_SCRIPT_MAX_READ      64  // Bytes read by the whole script
+#define I2C_SCRIPT_MAX_CMD_LEN   112 // Data part of CMD_I2C_SCRIPT without the request ID
+
+// --- I2C Register Watches ---
+// Fixed register reads the Nano repeats on its own clock, pushing the result
+// as RSP_I2C_WATCH_DATA only when the job's condition triggers:
+//   J<slot>,<addr>,<mode>,<mask>,<cond_reg>,<reg>,<len>,<period_ms>
+// sets a job (all hex), J<slot> removes one and a bare J removes all of them.
+// The I2C_WATCH_BITS_* modes read cond_reg every period and fire once when
+// the masked bits reach the wanted state, then read len bytes from reg; the
+// push carries the cond_reg byte followed by that data. The other modes read
+// len bytes from reg every period. A failed read is pushed once with its
+// status until a read succeeds again. Jobs do not survive a Nano reboot.
+#define I2C_WATCH_ALWAYS         0 // Push every read
+#define I2C_WATCH_CHANGED        1 // Push when the data differs from the last push, mask bits of the first byte are ignored
+#define I2C_WATCH_BITS_CLEAR     2 // Push when all mask bits of cond_reg went clear
+#define I2C_WATCH_BITS_SET       3 // Push when all mask bits of cond_reg went set
+#define I2C_WATCH_SLOTS          4
+#define I2C_WATCH_MAX_LEN        32 // Wire library buffer
+#define I2C_WATCH_MIN_PERIOD_MS  20
+
+// --- Segmented I2C Transfers ---
+// Register blocks longer than the Wire library buffer. A transfer is a
+// run of I2C transactions to reg + offset, or to reg every time with
+// I2C_TRANSFER_FIXED_REG for FIFOs, under one transfer ID chosen by the
+// ESP32. Reads stream RSP_I2C_SEGMENT frames that the ESP32 copies into the
+// caller's buffer by offset, the tagged RSP_I2C_READ_BLOCK closes the
+// transfer. Writes are sent as CMD_I2C_WRITE_BLOCK segments under the
+// I2C_WRITE_WINDOW credit scheme, the Nano writes each one as it arrives
+// and rejects a segment whose offset does not continue its transfer.
+#define I2C_TRANSFER_FIXED_REG        0x01 // Every segment addresses reg itself
+#define I2C_TRANSFER_READ_SEGMENT     32   // Wire library buffer
+#define I2C_TRANSFER_WRITE_SEGMENT    I2C_WRITE_CHUNK_LEN
+#define I2C_TRANSFER_MAX_LEN          512  // Bytes of one transfer, also bounded by the register space without I2C_TRANSFER_FIXED_REG
+
+// --- I2C Error Codes ---
+#define I2C_ERROR_NONE         0x00 // No error
+#define I2C_ERROR_ADDR_NACK    0x01 // Address not acknowledged
+#define I2C_ERROR_DATA_NACK    0x02 // Data not acknowledged
+#define I2C_ERROR_OTHER        0x03 // Other error
+#define I2C_ERROR_TIMEOUT      0x04 // Timeout
+#define I2C_ERROR_BUF_LEN      0x05 // Buffer length exceeded
+#define I2C_ERROR_PENDING      0x06 // Operation pending, or chunk staged and more expected
+
+// --- Nano Events (RSP_EVENT) ---
+// Codes index the ESP32 dispatch table, append new ones before NANO_EVENT_COUNT.
+#define NANO_EVENT_I2C_RECOVER_START    0x00 // Bus recovery started
+#define NANO_EVENT_I2C_RECOVER_DONE     0x01 // Bus recovery completed
+#define NANO_EVENT_I2C_RECOVER_MANUAL   0x02 // Bus stuck, clocking SCL to release it
+#define NANO_EVENT_I2C_RECOVER_SDA_LOW  0x03 // Recovery failed, SDA still held low
+#define NANO_EVENT_I2C_RECOVER_BUS_BUSY 0x04 // Recovery failed, manual STOP did not free the bus
+#define NANO_EVENT_I2C_BUS_STUCK        0x05 // param: 0 periodic check, 1 sensor read cycle
+#define NANO_EVENT_I2C_TIMEOUT          0x06 // Wire timeout flag was set
+#define NANO_EVENT_SPS30_DATA_READY     0x07 // param: driver return code
+#define NANO_EVENT_SPS30_MEASUREMENT    0x08 // param: driver return code
+#define NANO_EVENT_SCD30_DATA_READY     0x09 // param: driver return code
+#define NANO_EVENT_SCD30_MEASUREMENT    0x0A // param: driver return code
+#define NANO_EVENT_SGP41_CONDITIONING   0x0B // param: driver return code
+#define NANO_EVENT_SGP41_MEASUREMENT    0x0C // param: driver return code
+#define NANO_EVENT_COUNT                0x0D
+
+// --- Capabilities (exchanged through CMD_GET_VERSION / RSP_VERSION) ---
+#define PROTOCOL_CAP_BINARY_FRAMES  0x01 // Sensor frames as COBS/CRC-16 binary
+#define PROTOCOL_CAP_SENSOR_STREAM  0x02 // Nano pushes RSP_SENSORS after CMD_SENSOR_STREAM
+#define PROTOCOL_CAP_REQUEST_IDS    0x04 // Commands and responses carry a request ID
+#define PROTOCOL_CAP_BAUD_SWITCH    0x08 // Link speed can be raised with CMD_SET_BAUD_RATE
+#define PROTOCOL_CAP_DELTA_FRAMES   0x10 // Streamed sensor frames as RSP_SENSORS_DELTA between keyframes
+#define PROTOCOL_CAP_CHUNKED_WRITES 0x20 // Nano accepts CMD_I2C_WRITE_CHUNK
+#define PROTOCOL_CAP_TIME_SYNC      0x40 // Nano answers CMD_TIME_SYNC
+#define PROTOCOL_CAP_I2C_SCRIPTS    0x80 // Nano runs CMD_I2C_SCRIPT
+#define PROTOCOL_CAP_I2C_WATCH      0x100 // Nano runs CMD_I2C_WATCH jobs, reported as three hex digits
+#define PROTOCOL_CAP_I2C_TRANSFERS  0x200 // Nano runs CMD_I2C_READ_BLOCK and CMD_I2C_WRITE_BLOCK
+#define PROTOCOL_CAP_BINARY_I2C     0x400 // Bridge reads, writes and their data as binary frames, see Frames.h
+
+// --- Sensor Stream ---
+#define SENSOR_STREAM_MIN_PERIOD_MS 500   // Nano clamps shorter periods to this
+
+// --- Link Speed ---
+// Both sides start at LINK_DEFAULT_BAUD. After CMD_SET_BAUD_RATE is answered
+// they switch and the ESP32 sends CMD_PING at the new rate. Each side drops
+// back to the default rate on its own when the ping does not arrive, when
+// the peer goes silent or when too many corrupted packets are received.
+#define LINK_DEFAULT_BAUD            19200
+#define LINK_FAST_BAUD               500000 // 16 MHz AVR with U2X: 0% clock error
+#define LINK_BAUD_VERIFY_TIMEOUT_MS  1000   // Ping must arrive this long after the switch
+#define LINK_SILENCE_TIMEOUT_MS      15000  // Nano reverts without a valid command for this long
+#define LINK_MAX_CRC_ERRORS          5      // Corrupted packets per window before reverting
+#define LINK_CRC_ERROR_WINDOW_MS     10000
+
+// --- Request IDs ---
+// 1..255 tag a command and its response, 0 marks an untagged or unsolicited frame
+#define REQUEST_ID_NONE 0
+
+// Every response letter is the lower case command letter
+static inline char protocol_response_for(char cmd) {
+    return (cmd >= 'A' && cmd <= 'Z') ? (char)(cmd + ('a' - 'A')) : cmd;
+}
+
+static inline bool protocol_command_has_response(char cmd) {
+    return cmd != CMD_ACK_HEALTH && cmd != CMD_REBOOT;
+}
+
+// --- Logical Channels ---
+// Every frame belongs to a channel given by the type byte it already starts
+// with (the response letter), lower numbers are served first. Both sides
+// keep bulk telemetry behind the other channels: the Nano only starts a
+// sensor frame while no command is waiting and its TX buffer is empty, the
+// ESP32 hands bridge responses over from its RX task and drains the other
+// channels in priority order.
+#define PROTOCOL_CHANNEL_BRIDGE    0 // I2C bridge transactions
+#define PROTOCOL_CHANNEL_EVENT     1 // RSP_EVENT alarms
+#define PROTOCOL_CHANNEL_CONTROL   2 // Health, version, configuration responses
+#define PROTOCOL_CHANNEL_TELEMETRY 3 // RSP_SENSORS, RSP_SENSORS_DELTA
+#define PROTOCOL_CHANNEL_COUNT     4
+#define SENSOR_STREAM_MAX_DEFER_MS 100 // Longest a due sensor frame yields to the other channels
+
+// The Nano's rule for a due sensor frame: it waits while a command is being
+// received (rx_busy) or earlier frames are still in the TX buffer
+// (tx_pending), unless it is SENSOR_STREAM_MAX_DEFER_MS overdue already
+static inline bool protocol_telemetry_may_start(bool rx_busy, bool tx_pending, uint32_t overdue_ms) {
+    return (!rx_busy && !tx_pending) || overdue_ms >= SENSOR_STREAM_MAX_DEFER_MS;
+}
+
+static inline uint8_t protocol_channel_of(char type) {
+    switch (type) {
+        case RSP_I2C_READ:
+        case RSP_I2C_WRITE:
+        case RSP_I2C_WRITE_CHUNK:
+        case RSP_I2C_SCRIPT:
+        case RSP_I2C_WATCH:
+        case RSP_I2C_WATCH_DATA:
+        case RSP_I2C_READ_BLOCK:
+        case RSP_I2C_SEGMENT:
+        case RSP_I2C_WRITE_BLOCK:
+            return PROTOCOL_CHANNEL_BRIDGE;
+        case RSP_EVENT:
+        case RSP_LEGACY_EVENT:
+            return PROTOCOL_CHANNEL_EVENT;
+        case RSP_SENSORS:
+        case RSP_SENSORS_DELTA:
+            return PROTOCOL_CHANNEL_TELEMETRY;
+        default:
+            return PROTOCOL_CHANNEL_CONTROL;
+    }
+}
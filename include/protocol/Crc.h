@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Checksums used on the ESP32 <-> Nano link. Header-only so the same code
+// runs on the Nano, the ESP32 and on a host build.
+//
+// CRC-8 (poly 0x07, init 0x00) protects ASCII "<DATA,CRC8>" packets. Its
+// lookup table is generated at compile time and lives in flash on AVR.
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) protects binary frames.
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define PROTOCOL_PROGMEM PROGMEM
+#define PROTOCOL_READ_TABLE_BYTE(addr) pgm_read_byte(addr)
+#else
+#define PROTOCOL_PROGMEM
+#define PROTOCOL_READ_TABLE_BYTE(addr) (*(addr))
+#endif
+
+#define PROTOCOL_CRC8_POLY 0x07
+
+namespace protocol_detail {
+
+// C++11 constexpr: one return statement, so recurse over the 8 bits
+constexpr uint8_t crc8_shift(uint8_t crc, uint8_t bits) {
+    return bits == 0 ? crc
+        : crc8_shift((crc & 0x80) ? (uint8_t)((crc << 1) ^ PROTOCOL_CRC8_POLY) : (uint8_t)(crc << 1), bits - 1);
+}
+
+constexpr uint8_t crc8_bitwise(const char* str, uint8_t crc) {
+    return *str == '\0' ? crc : crc8_bitwise(str + 1, crc8_shift(crc ^ (uint8_t)*str, 8));
+}
+
+template<unsigned... I> struct IndexSequence {};
+template<unsigned N, unsigned... I> struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+template<unsigned... I> struct MakeIndexSequence<0, I...> { typedef IndexSequence<I...> type; };
+
+template<typename Sequence> struct Crc8Table;
+template<unsigned... I> struct Crc8Table<IndexSequence<I...>> {
+    static const uint8_t values[sizeof...(I)];
+};
+template<unsigned... I>
+const uint8_t Crc8Table<IndexSequence<I...>>::values[sizeof...(I)] PROTOCOL_PROGMEM = { crc8_shift((uint8_t)I, 8)... };
+
+typedef Crc8Table<MakeIndexSequence<256>::type> Crc8;
+
+} // namespace protocol_detail
+
+static_assert(protocol_detail::crc8_bitwise("123456789", 0x00) == 0xF4, "CRC-8 check value");
+
+static inline uint8_t crc8_update(uint8_t crc, uint8_t data) {
+    return PROTOCOL_READ_TABLE_BYTE(&protocol_detail::Crc8::values[crc ^ data]);
+}
+
+// Checksum of a NUL terminated ASCII packet body
+static inline uint8_t crc8_calculate(const char* data_str) {
+    uint8_t crc = 0x00;
+    while (*data_str) {
+        crc = crc8_update(crc, (uint8_t)*data_str++);
+    }
+    return crc;
+}
+
+// Byte-wise without a table: cheap enough for 40 byte frames and saves 512 bytes of flash
+static inline uint16_t crc16_update(uint16_t crc, uint8_t data) {
+    uint8_t x = (crc >> 8) ^ data;
+    x ^= x >> 4;
+    return (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+}
+
+static inline uint16_t crc16_calculate(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = crc16_update(crc, data[i]);
+    }
+    return crc;
+}
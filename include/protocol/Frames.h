@@ -0,0 +1,249 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "Crc.h"
+#include "Commands.h"
+#include "Schema.h"
+
+// --- ASCII Packets ---
+// "<DATA,CRC8>" with the CRC-8 printed in decimal. Still used for every
+// command and for responses when binary frames were not negotiated.
+#define ASCII_PACKET_START '<'
+#define ASCII_PACKET_END   '>'
+#define ASCII_PACKET_MAX_LEN 160 // Whole packet including markers, checksum and NUL
+
+// Tagged packets start DATA with "#XX", XX being the request ID in hex:
+// "<#1AH,crc>" is answered with "<#1Ah...,crc>". The tag is covered by the CRC.
+#define ASCII_REQUEST_ID_PREFIX '#'
+#define ASCII_REQUEST_ID_LEN    3
+
+// Writes "<data,crc>" into out. Returns the length, or 0 if it does not fit.
+static inline size_t ascii_packet_encode(const char* data, char* out, size_t out_size) {
+    int len = snprintf(out, out_size, "%c%s,%u%c", ASCII_PACKET_START, data, crc8_calculate(data), ASCII_PACKET_END);
+    return (len > 0 && (size_t)len < out_size) ? (size_t)len : 0;
+}
+
+// Strips a "#XX" request ID tag from a packet's DATA. Returns the untagged
+// DATA and stores the ID, REQUEST_ID_NONE when the packet has no tag.
+static inline const char* ascii_packet_split_request_id(const char* data, uint8_t* request_id) {
+    *request_id = REQUEST_ID_NONE;
+    if (data[0] != ASCII_REQUEST_ID_PREFIX) {
+        return data;
+    }
+    uint8_t id = 0;
+    for (uint8_t i = 1; i < ASCII_REQUEST_ID_LEN; i++) {
+        char c = data[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else return data; // Not a tag, leave it to the command decoder
+        id = (id << 4) | nibble;
+    }
+    *request_id = id;
+    return data + ASCII_REQUEST_ID_LEN;
+}
+
+// --- Binary Frames ---
+// Negotiated through CMD_GET_VERSION: the ESP32 appends its capability bits
+// to the request, the Nano answers with its own. Binary frames are only sent
+// once both sides advertised PROTOCOL_CAP_BINARY_FRAMES, otherwise the ASCII
+// format stays in use.
+//
+// On the wire:  0x00 | COBS( type | request_id | payload | crc16_le ) | 0x00
+// The CRC-16 covers the header and the payload. request_id is
+// REQUEST_ID_NONE for unsolicited frames such as the sensor stream.
+#define BINARY_FRAME_DELIMITER       0x00
+#define BINARY_FRAME_HEADER_LEN      2    // type + request_id
+#define BINARY_FRAME_MAX_RAW_LEN     80   // header + payload + crc, before COBS
+#define BINARY_FRAME_MAX_ENCODED_LEN (BINARY_FRAME_MAX_RAW_LEN + 2)
+#define BINARY_FRAME_PAYLOAD_OFFSET  (1 + BINARY_FRAME_HEADER_LEN) // Where binary_frame_encode() puts the payload in out
+
+// RSP_SENSORS payload: NanoSensorFrame from Schema.h, sent as-is.
+static_assert(sizeof(NanoSensorFrame) == 37, "NanoSensorFrame layout is part of the wire format");
+
+// --- Binary Bridge Frames ---
+// Negotiated with PROTOCOL_CAP_BINARY_I2C on top of binary frames, in both
+// directions. The type byte is the usual command or response letter, so
+// request IDs, channels and response matching work as for ASCII packets;
+// the frame CRC-16 replaces the CRC-8. Payloads, data as raw bytes:
+//   CMD_I2C_READ        addr | read_len | write bytes (0..BRIDGE_FRAME_MAX_WRITE_READ)
+//   CMD_I2C_WRITE       addr | write bytes (0..I2C_WRITE_MAX_LEN), no chunks needed
+//   RSP_I2C_READ        status | read bytes
+//   RSP_I2C_WRITE       status
+//   RSP_I2C_SCRIPT      step count | status per step | read data of all steps
+//   RSP_I2C_WATCH_DATA  slot | status | read data
+//   RSP_I2C_SEGMENT     xfer | offset (u16) | read data
+// Scripts, watches and block transfers are still set up with their ASCII
+// commands, their short status responses stay ASCII too.
+#define BRIDGE_FRAME_MAX_WRITE_READ  16
+
+// --- Delta Sensor Frames ---
+// Negotiated with PROTOCOL_CAP_DELTA_FRAMES on top of binary frames. A
+// streamed RSP_SENSORS_DELTA only carries what changed since the previous
+// sensor frame:
+//   sequence (u16) | timestamp - previous timestamp (u16) | field bitmap (u16) | changed fields
+// Bit n of the bitmap stands for the n-th PROTOCOL_DATA field of the
+// schema, the changed fields follow in that order with their size. A full
+// RSP_SENSORS keyframe is sent every SENSOR_KEYFRAME_INTERVAL frames, for
+// every polled frame and whenever the delta cannot be expressed.
+#define SENSOR_KEYFRAME_INTERVAL  10
+#define SENSOR_DELTA_HEADER_LEN   6
+
+struct SensorDeltaField {
+    uint8_t offset;
+    uint8_t size;
+    uint8_t in_bitmap;  // PROTOCOL_META fields travel in the delta header
+};
+
+#define SENSOR_DELTA_FIELD(type, name, radix, kind) { offsetof(NanoSensorFrame, name), sizeof(type), kind },
+static const SensorDeltaField NANO_SENSOR_DELTA_FIELDS[] PROTOCOL_PROGMEM = {
+    PROTOCOL_SENSORS_FIELDS(SENSOR_DELTA_FIELD)
+};
+#undef SENSOR_DELTA_FIELD
+
+#define SENSOR_DELTA_FIELD_COUNT (sizeof(NANO_SENSOR_DELTA_FIELDS) / sizeof(NANO_SENSOR_DELTA_FIELDS[0]))
+#define SENSOR_DELTA_COUNT_BITMAP_FIELD(type, name, radix, kind) + kind
+static_assert(0 PROTOCOL_SENSORS_FIELDS(SENSOR_DELTA_COUNT_BITMAP_FIELD) <= 16, "Field bitmap is 16 bits");
+#undef SENSOR_DELTA_COUNT_BITMAP_FIELD
+
+// Writes the delta from previous to current into out. Returns its length,
+// or 0 when a keyframe has to be sent instead.
+static inline size_t sensor_delta_encode(const NanoSensorFrame& previous, const NanoSensorFrame& current, uint8_t* out, size_t out_size) {
+    const uint32_t elapsed = current.timestamp - previous.timestamp;
+    if ((uint16_t)(previous.sequence + 1) != current.sequence || elapsed > 0xFFFF ||
+        out_size < SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)) {
+        return 0;
+    }
+
+    const uint8_t* prev_bytes = reinterpret_cast<const uint8_t*>(&previous);
+    const uint8_t* cur_bytes = reinterpret_cast<const uint8_t*>(&current);
+    uint16_t bitmap = 0;
+    size_t len = SENSOR_DELTA_HEADER_LEN;
+    uint8_t bit = 0;
+    for (uint8_t i = 0; i < SENSOR_DELTA_FIELD_COUNT; i++) {
+        if (!PROTOCOL_READ_TABLE_BYTE(&NANO_SENSOR_DELTA_FIELDS[i].in_bitmap)) continue;
+        const uint8_t offset = PROTOCOL_READ_TABLE_BYTE(&NANO_SENSOR_DELTA_FIELDS[i].offset);
+        const uint8_t size = PROTOCOL_READ_TABLE_BYTE(&NANO_SENSOR_DELTA_FIELDS[i].size);
+        if (memcmp(prev_bytes + offset, cur_bytes + offset, size) != 0) {
+            bitmap |= (uint16_t)1 << bit;
+            memcpy(out + len, cur_bytes + offset, size);
+            len += size;
+        }
+        bit++;
+    }
+
+    out[0] = current.sequence & 0xFF;
+    out[1] = current.sequence >> 8;
+    out[2] = elapsed & 0xFF;
+    out[3] = elapsed >> 8;
+    out[4] = bitmap & 0xFF;
+    out[5] = bitmap >> 8;
+    return len;
+}
+
+// Applies a delta payload to snapshot. Returns false, leaving snapshot
+// untouched, when the payload is malformed or does not follow snapshot.
+static inline bool sensor_delta_apply(NanoSensorFrame& snapshot, const uint8_t* payload, size_t payload_len) {
+    if (payload_len < SENSOR_DELTA_HEADER_LEN) {
+        return false;
+    }
+    const uint16_t sequence = payload[0] | (payload[1] << 8);
+    const uint16_t elapsed = payload[2] | (payload[3] << 8);
+    const uint16_t bitmap = payload[4] | (payload[5] << 8);
+    if ((uint16_t)(snapshot.sequence + 1) != sequence) {
+        return false;
+    }
+
+    NanoSensorFrame updated = snapshot;
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&updated);
+    size_t pos = SENSOR_DELTA_HEADER_LEN;
+    uint16_t remaining = bitmap;
+    for (uint8_t i = 0; i < SENSOR_DELTA_FIELD_COUNT; i++) {
+        if (!PROTOCOL_READ_TABLE_BYTE(&NANO_SENSOR_DELTA_FIELDS[i].in_bitmap)) continue;
+        const bool changed = remaining & 1;
+        remaining >>= 1;
+        if (!changed) continue;
+        const uint8_t offset = PROTOCOL_READ_TABLE_BYTE(&NANO_SENSOR_DELTA_FIELDS[i].offset);
+        const uint8_t size = PROTOCOL_READ_TABLE_BYTE(&NANO_SENSOR_DELTA_FIELDS[i].size);
+        if (pos + size > payload_len) {
+            return false;
+        }
+        memcpy(bytes + offset, payload + pos, size);
+        pos += size;
+    }
+    if (remaining != 0 || pos != payload_len) {
+        return false;
+    }
+
+    updated.timestamp += elapsed;
+    updated.sequence = sequence;
+    snapshot = updated;
+    return true;
+}
+
+// Builds COBS( type | request_id | payload | crc16_le ) into out, without the delimiters.
+// The raw frame is assembled at out + 1 and encoded in place: every zero is
+// overwritten with the distance to the next one, the first distance goes into
+// out[0]. Returns the encoded length, or 0 if it does not fit in out_size.
+static inline size_t binary_frame_encode(uint8_t type, uint8_t request_id, const void* payload, size_t payload_len, uint8_t* out, size_t out_size) {
+    const size_t raw_len = BINARY_FRAME_HEADER_LEN + payload_len + 2;
+    if (raw_len > 253 || raw_len + 1 > out_size) {
+        return 0;
+    }
+
+    out[1] = type;
+    out[2] = request_id;
+    memmove(out + 1 + BINARY_FRAME_HEADER_LEN, payload, payload_len);
+    const uint16_t crc = crc16_calculate(out + 1, BINARY_FRAME_HEADER_LEN + payload_len);
+    out[1 + BINARY_FRAME_HEADER_LEN + payload_len] = crc & 0xFF;
+    out[2 + BINARY_FRAME_HEADER_LEN + payload_len] = crc >> 8;
+
+    size_t code_pos = 0;
+    for (size_t i = 1; i <= raw_len; i++) {
+        if (out[i] == 0) {
+            out[code_pos] = (uint8_t)(i - code_pos);
+            code_pos = i;
+        }
+    }
+    out[code_pos] = (uint8_t)(raw_len + 1 - code_pos);
+    return raw_len + 1;
+}
+
+// Decodes a COBS block (delimiters already stripped). Returns the decoded
+// length, or 0 if the block is malformed or does not fit in out_size.
+static inline size_t cobs_decode(const uint8_t* in, size_t in_len, uint8_t* out, size_t out_size) {
+    size_t read_pos = 0;
+    size_t write_pos = 0;
+    while (read_pos < in_len) {
+        uint8_t code = in[read_pos++];
+        if (code == 0 || read_pos + code - 1 > in_len) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (write_pos >= out_size) return 0;
+            out[write_pos++] = in[read_pos++];
+        }
+        if (code != 0xFF && read_pos < in_len) {
+            if (write_pos >= out_size) return 0;
+            out[write_pos++] = 0;
+        }
+    }
+    return write_pos;
+}
+
+// Decodes a binary frame (delimiters already stripped) in place and checks
+// its CRC-16. Returns the length of header and payload, or 0 if the frame is
+// malformed, too short or corrupted.
+static inline size_t binary_frame_decode(uint8_t* frame, size_t encoded_len) {
+    const size_t raw_len = cobs_decode(frame, encoded_len, frame, encoded_len);
+    if (raw_len < BINARY_FRAME_HEADER_LEN + 2) {
+        return 0;
+    }
+    const size_t len = raw_len - 2;
+    const uint16_t received_crc = frame[len] | (frame[len + 1] << 8);
+    return crc16_calculate(frame, len) == received_crc ? len : 0;
+}
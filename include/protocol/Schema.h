@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Commands.h"
+
+// Declarative layout of the structured responses. Each message is one field
+// list, everything else is generated from it: the typed struct, the ASCII
+// encoder used by the Nano, the ASCII decoder used by the ESP32 and the
+// SERIAL_PACKET_DEBUG printer. protocol_schema.py reads the same lists to
+// build simulator packets, so changing a format is a one-line edit here.
+//
+// X(type, name, radix, kind)
+//   radix: PROTOCOL_DEC or PROTOCOL_HEX, how the value is printed in ASCII
+//   kind:  PROTOCOL_DATA, or PROTOCOL_META for bookkeeping fields that
+//          delta frames carry in their header instead of the bitmap
+//
+// ASCII packets list the values in order, comma separated, after the
+// response letter. Trailing fields added later may be missing from older
+// firmware, the decoder reports how many it found.
+#define PROTOCOL_DEC 10
+#define PROTOCOL_HEX 16
+#define PROTOCOL_DATA 1
+#define PROTOCOL_META 0
+
+// RSP_SENSORS. Scaled integers, see the units in the names.
+#define PROTOCOL_SENSORS_FIELDS(X) \
+    X(uint32_t, timestamp,                 PROTOCOL_DEC, PROTOCOL_META) /* Nano millis() at read time */ \
+    X(uint16_t, pressure_adc_raw,          PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, pulse_count,               PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(int16_t,  temperature_x10,           PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(int16_t,  humidity_x10,              PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, co2_ppm,                   PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, voc_raw,                   PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, nox_raw,                   PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, fan_amps_x100,             PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, pm1_x10,                   PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, pm25_x10,                  PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, pm4_x10,                   PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, pm10_x10,                  PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, compressor_amps_x100,      PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, geothermal_pump_amps_x100, PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint8_t,  liquid_level_raw,          PROTOCOL_DEC, PROTOCOL_DATA) /* GPIO level, 0 == sensor triggered */ \
+    X(uint16_t, co_adc_raw,                PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint16_t, sequence,                  PROTOCOL_DEC, PROTOCOL_META) /* +1 per frame, 0 after a Nano boot */
+
+// RSP_SPS30_INFO. ret_* are the Sensirion driver return codes.
+#define PROTOCOL_SPS30_INFO_FIELDS(X) \
+    X(int16_t,  ret_fw,           PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint8_t,  fw_major,         PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint8_t,  fw_minor,         PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(int16_t,  ret_fan_interval, PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint32_t, fan_interval,     PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(int16_t,  ret_fan_days,     PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint8_t,  fan_days,         PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(int16_t,  ret_status,       PROTOCOL_DEC, PROTOCOL_DATA) \
+    X(uint32_t, status_reg,       PROTOCOL_DEC, PROTOCOL_DATA)
+
+// RSP_SCD30_INFO. ret_* are the Sensirion driver return codes.
+#define PROTOCOL_SCD30_INFO_FIELDS(X) \
+    X(int16_t,  ret_interval,          PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint16_t, measurement_interval,  PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(int16_t,  ret_auto_cal,          PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint16_t, auto_calibration,      PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(int16_t,  ret_forced_cal,        PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint16_t, forced_recalibration,  PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(int16_t,  ret_temp_offset,       PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint16_t, temperature_offset,    PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(int16_t,  ret_altitude,          PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint16_t, altitude_compensation, PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(int16_t,  ret_firmware,          PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint8_t,  fw_major,              PROTOCOL_HEX, PROTOCOL_DATA) \
+    X(uint8_t,  fw_minor,              PROTOCOL_HEX, PROTOCOL_DATA)
+
+// --- Field Codecs ---
+// Format strings stay in flash on AVR
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define PROTOCOL_SNPRINTF(out, size, fmt, ...) snprintf_P(out, size, PSTR(fmt), __VA_ARGS__)
+#else
+#define PROTOCOL_SNPRINTF(out, size, fmt, ...) snprintf(out, size, fmt, __VA_ARGS__)
+#endif
+
+template<typename T> struct ProtocolFieldTraits {
+    static const bool is_signed = (T)-1 < (T)0;
+    // Two half shifts so a T as wide as unsigned long wraps to all ones
+    static const unsigned long mask = ((1UL << (4 * sizeof(T))) << (4 * sizeof(T))) - 1;
+};
+
+// Appends the value, preceded by ',' unless it is the first field. Hex
+// values are printed as their unsigned bit pattern, so -1 in an int16_t is
+// "FFFF". Returns false when out is full.
+template<typename T>
+static inline bool protocol_ascii_put(char*& pos, char* end, bool first, uint8_t radix, T value) {
+    const char* sep = first ? "" : ",";
+    int len;
+    if (radix == PROTOCOL_HEX) {
+        len = PROTOCOL_SNPRINTF(pos, end - pos, "%s%lX", sep, (unsigned long)value & ProtocolFieldTraits<T>::mask);
+    } else if (ProtocolFieldTraits<T>::is_signed) {
+        len = PROTOCOL_SNPRINTF(pos, end - pos, "%s%ld", sep, (long)value);
+    } else {
+        len = PROTOCOL_SNPRINTF(pos, end - pos, "%s%lu", sep, (unsigned long)value);
+    }
+    if (len <= 0 || len >= end - pos) {
+        return false;
+    }
+    pos += len;
+    return true;
+}
+
+// Parses the next value. Empty fields are skipped, older Nano firmware
+// printed ",," in RSP_SCD30_INFO. Returns false when no value is left.
+template<typename T>
+static inline bool protocol_ascii_get(char*& pos, uint8_t radix, T& value) {
+    while (*pos == ',') pos++;
+    char* end;
+    if (radix == PROTOCOL_DEC && ProtocolFieldTraits<T>::is_signed) {
+        value = (T)strtol(pos, &end, radix);
+    } else {
+        value = (T)strtoul(pos, &end, radix);
+    }
+    if (end == pos) {
+        return false;
+    }
+    pos = end;
+    return true;
+}
+
+template<typename T>
+static inline int protocol_debug_put(char* pos, size_t size, const char* name, uint8_t radix, T value) {
+    if (radix == PROTOCOL_HEX) {
+        return snprintf(pos, size, "%s=0x%lX, ", name, (unsigned long)value & ProtocolFieldTraits<T>::mask);
+    } else if (ProtocolFieldTraits<T>::is_signed) {
+        return snprintf(pos, size, "%s=%ld, ", name, (long)value);
+    }
+    return snprintf(pos, size, "%s=%lu, ", name, (unsigned long)value);
+}
+
+// --- Generators ---
+#define PROTOCOL_STRUCT_FIELD(type, name, radix, kind) type name;
+#define PROTOCOL_COUNT_FIELD(type, name, radix, kind) + 1
+#define PROTOCOL_ENCODE_FIELD(type, name, radix, kind) \
+    if (!protocol_ascii_put(pos, end, pos == fields, radix, (type)value.name)) return 0;
+// Through a local, packed structs cannot bind their members to a reference
+#define PROTOCOL_DECODE_FIELD(type, name, radix, kind) \
+    { type field; if (!protocol_ascii_get(pos, radix, field)) return count; value.name = field; count++; }
+#define PROTOCOL_DEBUG_FIELD(type, name, radix, kind) \
+    if (pos < end) pos += protocol_debug_put(pos, end - pos, #name, radix, (type)value.name);
+
+template<typename Message> struct ProtocolMessage;
+
+// Struct plus ProtocolMessage<Struct> with the response letter and the
+// number of fields. Wrap in #pragma pack when the struct is a wire format.
+#define PROTOCOL_DEFINE_STRUCT(Struct, response, FIELDS) \
+    struct Struct { FIELDS(PROTOCOL_STRUCT_FIELD) }; \
+    template<> struct ProtocolMessage<Struct> { \
+        static const char response_letter = response; \
+        static const uint8_t field_count = 0 FIELDS(PROTOCOL_COUNT_FIELD); \
+    };
+
+// protocol_ascii_encode() writes "<letter><fields>" without the packet
+// markers and checksum, returns its length or 0 if it does not fit.
+// protocol_ascii_decode() parses the fields after the letter in place and
+// returns how many were found. protocol_debug_format() prints name=value.
+#define PROTOCOL_DEFINE_CODEC(Struct, FIELDS) \
+    static inline size_t protocol_ascii_encode(const Struct& value, char* out, size_t out_size) { \
+        if (out_size < 2) return 0; \
+        out[0] = ProtocolMessage<Struct>::response_letter; \
+        char* const fields = out + 1; \
+        char* pos = fields; \
+        char* end = out + out_size; \
+        FIELDS(PROTOCOL_ENCODE_FIELD) \
+        return pos - out; \
+    } \
+    static inline uint8_t protocol_ascii_decode(char* fields, Struct& value) { \
+        char* pos = fields; \
+        uint8_t count = 0; \
+        FIELDS(PROTOCOL_DECODE_FIELD) \
+        return count; \
+    } \
+    static inline size_t protocol_debug_format(const Struct& value, char* out, size_t out_size) { \
+        if (out_size == 0) return 0; \
+        out[0] = '\0'; \
+        char* pos = out; \
+        char* end = out + out_size; \
+        FIELDS(PROTOCOL_DEBUG_FIELD) \
+        if (pos >= end) pos = end - 1; \
+        else if (pos - out >= 2) pos -= 2; /* Trailing ", " */ \
+        *pos = '\0'; \
+        return pos - out; \
+    }
+
+// --- Messages ---
+// RSP_SENSORS is also the binary frame payload, both MCUs are little-endian
+// and the struct is sent as-is.
+#pragma pack(push, 1)
+PROTOCOL_DEFINE_STRUCT(NanoSensorFrame, RSP_SENSORS, PROTOCOL_SENSORS_FIELDS)
+#pragma pack(pop)
+PROTOCOL_DEFINE_CODEC(NanoSensorFrame, PROTOCOL_SENSORS_FIELDS)
+
+PROTOCOL_DEFINE_STRUCT(Sps30InfoFrame, RSP_SPS30_INFO, PROTOCOL_SPS30_INFO_FIELDS)
+PROTOCOL_DEFINE_CODEC(Sps30InfoFrame, PROTOCOL_SPS30_INFO_FIELDS)
+
+PROTOCOL_DEFINE_STRUCT(Scd30InfoFrame, RSP_SCD30_INFO, PROTOCOL_SCD30_INFO_FIELDS)
+PROTOCOL_DEFINE_CODEC(Scd30InfoFrame, PROTOCOL_SCD30_INFO_FIELDS)
@@ -59,6 +59,8 @@ public:
     void update_network_rssi(int8_t) override;
     void update_network_ha_conn(bool) override;
     void update_last_packet_time(uint32_t) override;
+    void update_link_errors(uint32_t) override;
+    void update_link_latency(uint32_t) override;
     void update_ssid(const char* ssid) override;
     void update_ip(const char* ip) override;
     void update_mac(const char* mac) override;
@@ -47,6 +47,8 @@ public:
     virtual void update_network_rssi(int8_t rssi) = 0;
     virtual void update_network_ha_conn(bool ha_conn) = 0;
     virtual void update_last_packet_time(uint32_t seconds_since_packet) = 0;
+    virtual void update_link_errors(uint32_t errors) = 0;
+    virtual void update_link_latency(uint32_t p99_us) = 0;
     virtual void update_ssid(const char* ssid) = 0;
     virtual void update_ip(const char* ip) = 0;
     virtual void update_mac(const char* mac) = 0;
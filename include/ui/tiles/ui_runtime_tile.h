@@ -11,6 +11,8 @@ public:
     void update_runtime_uptime(unsigned long system_uptime);
     void update_sensor_status(bool connected);
     void update_last_packet_time(uint32_t seconds_since_packet);
+    void update_link_errors(uint32_t errors);
+    void update_link_latency(uint32_t p99_us);
     static void high_pressure_blink_cb(lv_timer_t* timer);
 private:
     lv_obj_t* fw_label;
@@ -18,6 +20,11 @@ private:
     lv_obj_t* uptime_label;
     lv_obj_t* reset_label;
     lv_obj_t* pkt_icon, *pkt_label;
+    // Shown together on the packet line, which scrolls when too long
+    uint32_t seconds_since_packet = 0;
+    uint32_t link_errors = 0;
+    uint32_t link_p99_us = 0;
+    void refresh_packet_label();
 };
 
 #endif // UI_RUNTIME_TILE_H
\ No newline at end of file
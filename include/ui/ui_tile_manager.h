@@ -65,6 +65,8 @@ public:
     void update_network_ha_conn(bool ha_conn);
     void update_sensor_status(bool connected);
     void update_last_packet_time(uint32_t seconds_since_packet);
+    void update_link_errors(uint32_t errors);
+    void update_link_latency(uint32_t p99_us);
     void update_ssid(const char* ssid);
     void update_ip(const char* ip);
     void update_mac(const char* mac);
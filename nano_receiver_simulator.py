@@ -93,6 +93,122 @@ def send_i2c_write_command(ser, address, data):
     ser.write(packet.encode())
     print(f"[ESP32] Sent write command: {packet.strip()}")
 
+def benchmark_transfers(ser, address, repeats=5):
+    """Times segmented block reads (CMD_I2C_READ_BLOCK) and prints the throughput per transfer size.
+
+    Every segment rereads register 0 (I2C_TRANSFER_FIXED_REG), so any device
+    that answers a register read will do.
+    """
+    print(f"[ESP32] Block read throughput from address 0x{address:02X}, {repeats} transfers per size")
+    print(f"{'bytes':>6} {'ms':>8} {'bytes/s':>9}  status")
+    xfer_id = 0
+    for size in (16, 32, 64, 128, 256, 512):
+        total_time = 0.0
+        runs = 0
+        status = None
+        for _ in range(repeats):
+            command = f"L{xfer_id:X},{address:02X},00,{size:X},1"
+            xfer_id = (xfer_id + 1) & 0xFF
+            ser.reset_input_buffer()
+            start = time.perf_counter()
+            ser.write(f"<{command},{calculate_checksum(command)}>\n".encode())
+            received = 0
+            status = None
+            while status is None:
+                line = ser.readline().decode('utf-8', errors='ignore').strip()
+                if not line:
+                    break  # Serial timeout
+                fields = line.strip('<>').split(',')
+                if fields[0].startswith('m') and len(fields) >= 3:
+                    received += len(fields[2]) // 2
+                elif fields[0].startswith('l') and len(fields) >= 3:
+                    status = int(fields[1], 16)
+            total_time += time.perf_counter() - start
+            runs += 1
+            if status != 0 or received != size:
+                break
+        average_ms = total_time * 1000 / runs
+        result = "timeout" if status is None else ("ok" if status == 0 and received == size else f"error 0x{status:02X}, {received} bytes")
+        print(f"{size:>6} {average_ms:>8.1f} {size / (average_ms / 1000):>9.0f}  {result}")
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE of binary frames (poly 0x1021, init 0xFFFF)."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def encode_binary_frame(frame_type, request_id, payload):
+    """0x00 | COBS(type | request_id | payload | crc16_le) | 0x00, as binary_frame_encode() builds it."""
+    raw = bytes([ord(frame_type), request_id]) + bytes(payload)
+    raw += crc16_ccitt(raw).to_bytes(2, 'little')
+    encoded = bytearray()
+    for block in raw.split(b'\x00'):
+        encoded.append(len(block) + 1)
+        encoded += block
+    return b'\x00' + bytes(encoded) + b'\x00'
+
+def decode_binary_frame(frame):
+    """Returns (type, request_id, payload), or None if the frame is malformed or corrupted."""
+    encoded = frame.strip(b'\x00')
+    raw = bytearray()
+    pos = 0
+    while pos < len(encoded):
+        code = encoded[pos]
+        raw += encoded[pos + 1:pos + code]
+        pos += code
+        if pos < len(encoded):
+            raw.append(0)
+    if len(raw) < 4 or crc16_ccitt(raw[:-2]) != int.from_bytes(raw[-2:], 'little'):
+        return None
+    return chr(raw[0]), raw[1], bytes(raw[2:-2])
+
+def benchmark_encoding(repeats=2000):
+    """Compares a bridge register read (CMD_I2C_READ and its RSP_I2C_READ) as
+    tagged hex ASCII packets and as PROTOCOL_CAP_BINARY_I2C frames.
+
+    Needs no serial port. Wire time assumes 10 bits per byte, the host time
+    covers encoding and decoding both packets in Python and only compares the
+    two formats with each other.
+    """
+    address, reg, request_id = ZMOD4510_ADDRESS, 0x20, 0x05
+    print(f"Bridge read exchange, request + response, {repeats} runs per row")
+    print(f"{'bytes':>6} {'format':>7} {'wire':>5} {'ms @19200':>10} {'ms @500k':>9} {'host us':>8}")
+    for size in (1, 6, 32):
+        data = bytes((reg + i) & 0xFF for i in range(size))
+
+        def ascii_exchange():
+            command = f"#{request_id:02X}I{address:02X},01,{size:02X},{reg:02X}"
+            request = f"<{command},{calculate_checksum(command)}>\n".encode()
+            response_data = f"#{request_id:02X}i00,{size:02X}," + ','.join(f"{b:02X}" for b in data)
+            response = f"<{response_data},{calculate_checksum(response_data)}>\n".encode()
+            # Decoded the way both firmwares parse the hex fields
+            fields = request.decode().strip('<>\n').split(',')
+            int(fields[0][4:], 16), [int(field, 16) for field in fields[1:-1]]
+            fields = response.decode().strip('<>\n').split(',')
+            decoded = bytes(int(field, 16) for field in fields[2:-1])
+            assert decoded == data
+            return len(request) + len(response)
+
+        def binary_exchange():
+            request = encode_binary_frame('I', request_id, [address, size, reg])
+            response = encode_binary_frame('i', request_id, bytes([0]) + data)
+            decode_binary_frame(request)
+            frame_type, _, payload = decode_binary_frame(response)
+            assert frame_type == 'i' and payload[1:] == data
+            return len(request) + len(response)
+
+        for name, exchange in (("ascii", ascii_exchange), ("binary", binary_exchange)):
+            wire_bytes = exchange()
+            start = time.perf_counter()
+            for _ in range(repeats):
+                exchange()
+            host_us = (time.perf_counter() - start) * 1e6 / repeats
+            print(f"{size:>6} {name:>7} {wire_bytes:>5} {wire_bytes * 10 / 19.2:>10.2f} {wire_bytes * 10 / 500:>9.3f} {host_us:>8.1f}")
+
 def handle_nano_response(packet_str):
     """Handle response from Arduino Nano."""
     try:
@@ -406,8 +522,13 @@ def main():
     """Main function to run the simulator."""
     global stop_threads, send_sensor_data, ser
 
+    if "--benchmark-encoding" in sys.argv:
+        benchmark_encoding()
+        return
+
     if len(sys.argv) < 2:
-        print("Usage: python simulator.py <COM_PORT> [--no-sensor-packets]")
+        print("Usage: python simulator.py <COM_PORT> [--no-sensor-packets] [--benchmark-transfers <addr>]")
+        print("       python simulator.py --benchmark-encoding")
         sys.exit(1)
 
     port_name = sys.argv[1]
@@ -423,6 +544,13 @@ def main():
         print(f"Error: Could not open serial port {port_name}.")
         print(e)
         sys.exit(1)
+
+    if "--benchmark-transfers" in sys.argv:
+        index = sys.argv.index("--benchmark-transfers")
+        address = int(sys.argv[index + 1], 16) if index + 1 < len(sys.argv) else ZMOD4510_ADDRESS
+        benchmark_transfers(ser, address)
+        ser.close()
+        return
         
     input_handler = threading.Thread(target=user_input_thread, daemon=True)
     reader_handler = threading.Thread(target=serial_reader_thread, args=(ser,), daemon=True)
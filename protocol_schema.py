@@ -0,0 +1,104 @@
+"""Reads the message layouts from include/protocol/Schema.h.
+
+The simulators build their packets from here so they follow the firmware
+whenever a field list changes. Run this file directly to print one fixture
+packet per message.
+"""
+import os
+import re
+
+HEADER_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "include", "protocol")
+
+# X-macro lists and the message they describe
+MESSAGES = {
+    "NanoSensorFrame": ("PROTOCOL_SENSORS_FIELDS", "RSP_SENSORS"),
+    "Sps30InfoFrame": ("PROTOCOL_SPS30_INFO_FIELDS", "RSP_SPS30_INFO"),
+    "Scd30InfoFrame": ("PROTOCOL_SCD30_INFO_FIELDS", "RSP_SCD30_INFO"),
+}
+
+TYPE_BITS = {"uint8_t": 8, "int8_t": 8, "uint16_t": 16, "int16_t": 16, "uint32_t": 32, "int32_t": 32}
+
+
+def _read(name):
+    with open(os.path.join(HEADER_DIR, name), encoding="utf-8") as f:
+        return f.read()
+
+
+def _load():
+    commands = dict(re.findall(r"#define\s+(RSP_\w+)\s+'(.)'", _read("Commands.h")))
+    schema = _read("Schema.h")
+    messages = {}
+    for message, (list_name, response) in MESSAGES.items():
+        body = re.search(r"#define\s+%s\(X\)((?:.*\\\n)*.*)" % list_name, schema).group(1)
+        fields = []
+        for field_type, name, radix, kind in re.findall(r"X\((\w+),\s*(\w+),\s*(\w+),\s*(\w+)\)", body):
+            fields.append({
+                "type": field_type,
+                "name": name,
+                "hex": radix == "PROTOCOL_HEX",
+                "meta": kind == "PROTOCOL_META",
+            })
+        messages[message] = {"letter": commands[response], "fields": fields}
+    return messages
+
+
+SCHEMA = _load()
+
+
+def calculate_checksum(data_str):
+    """CRC-8, polynomial 0x07, same as crc8() in include/protocol/Crc.h."""
+    crc = 0x00
+    for byte_char in data_str.encode("ascii"):
+        crc ^= byte_char
+        for _ in range(8):
+            if crc & 0x80:
+                crc = ((crc << 1) ^ 0x07) & 0xFF
+            else:
+                crc = (crc << 1) & 0xFF
+    return crc
+
+
+def _format_value(field, value):
+    bits = TYPE_BITS[field["type"]]
+    value = int(value) & ((1 << bits) - 1)
+    if field["hex"]:
+        return "%X" % value
+    if field["type"].startswith("int") and value >= 1 << (bits - 1):
+        value -= 1 << bits
+    return str(value)
+
+
+def encode(message, values):
+    """Returns "<letter><fields>", the data part of an ASCII packet."""
+    spec = SCHEMA[message]
+    return spec["letter"] + ",".join(_format_value(f, values.get(f["name"], 0)) for f in spec["fields"])
+
+
+def encode_packet(message, values):
+    """Returns a complete "<data,crc>\\n" packet."""
+    data_part = encode(message, values)
+    return f"<{data_part},{calculate_checksum(data_part)}>\n"
+
+
+def decode(message, data_part):
+    """Parses a data part back into a dict, missing trailing fields are left out."""
+    spec = SCHEMA[message]
+    if not data_part.startswith(spec["letter"]):
+        raise ValueError(f"{message} starts with '{spec['letter']}'")
+    tokens = [t for t in data_part[1:].split(",") if t]
+    values = {}
+    for field, token in zip(spec["fields"], tokens):
+        bits = TYPE_BITS[field["type"]]
+        value = int(token, 16 if field["hex"] else 10)
+        if field["type"].startswith("int") and value >= 1 << (bits - 1):
+            value -= 1 << bits
+        values[field["name"]] = value
+    return values
+
+
+if __name__ == "__main__":
+    for message, spec in SCHEMA.items():
+        fixture = {f["name"]: i + 1 for i, f in enumerate(spec["fields"])}
+        packet = encode_packet(message, fixture)
+        assert decode(message, encode(message, fixture)) == fixture
+        print(f"{message}: {packet.strip()}")
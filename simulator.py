@@ -3,6 +3,8 @@ import time
 import threading
 import sys
 
+import protocol_schema
+
 # --- Configuration ---
 SEND_INTERVAL_SECONDS = 2
 
@@ -38,6 +40,7 @@ AHT20_ADDRESS = 0x38
 BMP280_ADDRESS = 0x77  # Could also be 0x76
 ZMOD4510_ADDRESS = 0x32
 
+sensor_sequence = 0
 stop_threads = False
 serial_buffer = ""
 
@@ -58,37 +61,34 @@ def calculate_checksum(data_str):
 
     return crc
 
-def format_packet(p, pulse_count, t, h, co2, voc, nox, amps, pm1, pm25, pm4, pm10, 
-                 compressor_amps, geothermal_pump_amps, liquid_level_sensor_state,
-                 aht20_temp, aht20_humidity, bmp280_pressure, bmp280_temp, 
-                 zmod4510_o3, zmod4510_no2, zmod4510_fast_aqi, zmod4510_epa_aqi):
-    """Formats the data into the <pressure,pulse_count,temp,humi,co2,voc,nox,amps,pm...,aht20_temp,aht20_humidity,bmp280_pressure,bmp280_temp,zmod4510_o3,zmod4510_no2,zmod4510_fast_aqi,zmod4510_epa_aqi,checksum>\n protocol."""
-    # Scale float values to integers to match the Arduino Nano's new format
-    p_val = int(p * 10)
-    t_val = int(t * 10)
-    h_val = int(h * 10)
-    co2_val = int(co2)
-    amps_val = int(amps * 100)
-    pm1_val = int(pm1 * 10)
-    pm25_val = int(pm25 * 10)
-    pm4_val = int(pm4 * 10)
-    pm10_val = int(pm10 * 10)
-    
-    # I2C Bridge sensor values (scaled to integers)
-    aht20_temp_val = int(aht20_temp * 10)
-    aht20_humidity_val = int(aht20_humidity * 10)
-    bmp280_pressure_val = int(bmp280_pressure / 10)  # Pressure in Pa, scale down
-    bmp280_temp_val = int(bmp280_temp * 10)
-    zmod4510_o3_val = int(zmod4510_o3)
-    zmod4510_no2_val = int(zmod4510_no2)
-    zmod4510_fast_aqi_val = int(zmod4510_fast_aqi)
-    zmod4510_epa_aqi_val = int(zmod4510_epa_aqi)
-
-    # Format the data part with scaled integers
-    payload = f"{p_val},{pulse_count},{t_val},{h_val},{co2_val},{int(voc)},{int(nox)},{amps_val},{pm1_val},{pm25_val},{pm4_val},{pm10_val},{int(compressor_amps * 100)},{int(geothermal_pump_amps * 100)},{int(liquid_level_sensor_state)},{aht20_temp_val},{aht20_humidity_val},{bmp280_pressure_val},{bmp280_temp_val},{zmod4510_o3_val},{zmod4510_no2_val},{zmod4510_fast_aqi_val},{zmod4510_epa_aqi_val}"
-    data_part = f"S{payload}"
-    checksum = calculate_checksum(data_part)
-    return f"<{data_part},{checksum}>\n"
+def format_packet(p, pulse_count, t, h, co2, voc, nox, amps, pm1, pm25, pm4, pm10,
+                 compressor_amps, geothermal_pump_amps, liquid_level_sensor_state):
+    """Formats an RSP_SENSORS packet, the field layout comes from include/protocol/Schema.h."""
+    global sensor_sequence
+    # Inverse of the ESP32 pressure conversion: 4-20 mA over 0-300 Pa, across a 150 ohm shunt
+    current_ma = 4.0 + p * 16.0 / 300.0
+    pressure_adc_raw = current_ma / 1000.0 * 150.0 * 1023 / 5.0
+    sensor_sequence = (sensor_sequence + 1) & 0xFFFF or 1
+    return protocol_schema.encode_packet("NanoSensorFrame", {
+        "timestamp": int(time.monotonic() * 1000),
+        "pressure_adc_raw": int(pressure_adc_raw),
+        "pulse_count": pulse_count,
+        "temperature_x10": int(t * 10),
+        "humidity_x10": int(h * 10),
+        "co2_ppm": int(co2),
+        "voc_raw": int(voc),
+        "nox_raw": int(nox),
+        "fan_amps_x100": int(amps * 100),
+        "pm1_x10": int(pm1 * 10),
+        "pm25_x10": int(pm25 * 10),
+        "pm4_x10": int(pm4 * 10),
+        "pm10_x10": int(pm10 * 10),
+        "compressor_amps_x100": int(compressor_amps * 100),
+        "geothermal_pump_amps_x100": int(geothermal_pump_amps * 100),
+        "liquid_level_raw": int(liquid_level_sensor_state),
+        "co_adc_raw": 0,
+        "sequence": sensor_sequence,
+    })
 
 def user_input_thread():
     """A separate thread to handle user input without blocking."""
@@ -429,9 +429,7 @@ def main():
                 current_pressure, current_pulse_count, current_temperature, current_humidity,
                 current_co2, current_voc_raw, current_nox_raw, current_amps,
                 current_pm1_0, current_pm2_5, current_pm4_0, current_pm10_0,
-                current_compressor_amps, current_geothermal_pump_amps, current_liquid_level_sensor_state,
-                current_aht20_temp, current_aht20_humidity, current_bmp280_pressure, current_bmp280_temp,
-                current_zmod4510_o3, current_zmod4510_no2, current_zmod4510_fast_aqi, current_zmod4510_epa_aqi
+                current_compressor_amps, current_geothermal_pump_amps, current_liquid_level_sensor_state
             )
             
             print(f"--> [SIM Sending]: {packet.strip()}")
@@ -1,12 +1,12 @@
 /****************************************************************
  * AHT20.cpp
  * AHT20 Temperature and Humidity Sensor Library Implementation
- * Adapted to use I2CBridge for ESP32-Nano communication
+ * Adapted to use I2CBus, the ESP32-Nano bridge or the ESP32's own I2C
  * 
  * This file implements all the functions of the AHT20 class.
  * Functions in this library can return the humidity and temperature 
  * measured by the sensor. All data is communicated over I2C bus
- * via the I2CBridge.
+ * via an I2CBus.
  * 
  * Distributed as-is; no warranty is given.
  ***************************************************************/
@@ -16,8 +16,9 @@
 #include "AHT20.h"
 #include "Logger.h"
 
-AHT20::AHT20(uint8_t address) 
-    : _deviceAddress(address), 
+AHT20::AHT20(I2CBus& bus, uint8_t address) 
+    : _bus(bus),
+      _deviceAddress(address), 
       _initialized(false),
       _measurementStarted(false),
       _dataValid(false),
@@ -117,7 +118,13 @@ bool AHT20::SensorInit() {
     
     uint8_t queryRetry = 100;
     while(queryRetry--) {
-        if(isBusy() == false) {
+        uint8_t statusByte = 0;
+        if(isBusy(&statusByte) == false) {
+            // A soft reset keeps the calibration, only power-up clears it
+            if (statusByte & AHT20_STATUS_CAL) {
+                _status = AHT20_NO_ERROR;
+                return true;
+            }
             bool calResult = calibrate();
             if (calResult) {
                 _status = AHT20_NO_ERROR;
@@ -137,8 +144,7 @@ bool AHT20::SensorInit() {
 }
 
 uint8_t AHT20::getStatus() {
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeReadBytes(_deviceAddress, nullptr, 0, 1);
+    I2CBus::Result result = _bus.read(_deviceAddress, 1);
     
     if (result.success && result.data_len > 0) {
         return result.data[0];
@@ -153,24 +159,24 @@ bool AHT20::isCalibrated() {
     return (getStatus() & AHT20_STATUS_CAL);
 }
 
-bool AHT20::isBusy() const {
+bool AHT20::isBusy(uint8_t* statusByte) const {
     // Check if sensor is busy by reading status
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeReadBytes(_deviceAddress, nullptr, 0, 1);
+    I2CBus::Result result = _bus.read(_deviceAddress, 1);
     
     if (result.success && result.data_len > 0) {
         uint8_t status = result.data[0];
+        if (statusByte) *statusByte = status;
         return (status & AHT20_STATUS_BUSY) != 0; // Return true if busy
     }
     
+    if (statusByte) *statusByte = 0;
     return true; // Assume busy on communication error
 }
 
 bool AHT20::calibrate() {
     uint8_t cmd[3] = {AHT20_REG_CALIBRATE, 0x08, 0x00};
     
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeBytes(_deviceAddress, cmd, 3);
+    I2CBus::Result result = _bus.write(_deviceAddress, cmd, 3);
 
     if(result.success) {
         uint8_t queryRetry = 100;
@@ -197,8 +203,7 @@ bool AHT20::calibrate() {
 bool AHT20::triggerMeasurement() {
     uint8_t cmd[3] = {AHT20_REG_MEASURE, 0x33, 0x00};
     
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeBytes(_deviceAddress, cmd, 3);
+    I2CBus::Result result = _bus.write(_deviceAddress, cmd, 3);
     
     if (!result.success) {
         logger.error("AHT20: Failed to trigger measurement");
@@ -220,8 +225,7 @@ bool AHT20::isReadyForMeasurement() const {
     }
     
     // Check if sensor is busy by reading status
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeReadBytes(_deviceAddress, nullptr, 0, 1);
+    I2CBus::Result result = _bus.read(_deviceAddress, 1);
     
     if (result.success && result.data_len > 0) {
         uint8_t status = result.data[0];
@@ -232,8 +236,7 @@ bool AHT20::isReadyForMeasurement() const {
 }
 
 void AHT20::getDetailedStatus(uint8_t& status, bool& busy, bool& calibrated) const {
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeReadBytes(_deviceAddress, nullptr, 0, 1);
+    I2CBus::Result result = _bus.read(_deviceAddress, 1);
     
     if (result.success && result.data_len > 0) {
         status = result.data[0];
@@ -252,9 +255,8 @@ bool AHT20::readData() {
     sensorData.temperature = 0;
     sensorData.humidity = 0;
     
-    I2CBridge& i2c = I2CBridge::getInstance();
     // Read 7 bytes: {status, RH, RH, RH+T, T, T, CRC}
-    I2CBridge::Result result = i2c.writeReadBytes(_deviceAddress, nullptr, 0, 7);
+    I2CBus::Result result = _bus.read(_deviceAddress, 7);
     
     if (!result.success || result.data_len < 7) {
         logger.error("AHT20: Failed to read sensor data");
@@ -304,8 +306,7 @@ bool AHT20::readData() {
 bool AHT20::softReset() {
     uint8_t cmd[1] = {AHT20_REG_RESET};
     
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeBytes(_deviceAddress, cmd, 1);
+    I2CBus::Result result = _bus.write(_deviceAddress, cmd, 1);
     
     if (result.success) {
         // Reset internal state
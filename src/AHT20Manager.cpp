@@ -1,5 +1,6 @@
 #ifdef AHT20_ENABLED
 #include "AHT20Manager.h"
+#include "I2CBuses.h"
 
 AHT20Manager& AHT20Manager::getInstance() {
     static AHT20Manager* instance = nullptr;
@@ -19,7 +20,7 @@ AHT20Manager::AHT20Manager()
       new_data_available(false),
       nano_reboot_detected_(false),
       previous_nano_connected_(false),
-      sensor(AHT20_DEFAULT_ADDRESS) {
+      sensor(I2CBuses::forDevice(I2C_DEVICE_AHT20), AHT20_DEFAULT_ADDRESS) {
 }
 
 void AHT20Manager::init() {
@@ -1,7 +1,9 @@
 #include "BMP280Manager.h"
+#include "I2CBuses.h"
 
 BMP280Manager::BMP280Manager() 
-    : initialized_(false), 
+    : sensor_(I2CBuses::forDevice(I2C_DEVICE_BMP280)),
+      initialized_(false), 
       healthy_(false), 
       new_data_available_(false),
       last_measurement_time_(0),
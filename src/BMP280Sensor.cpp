@@ -1,9 +1,19 @@
 #include "BMP280Sensor.h"
 
-BMP280Sensor::BMP280Sensor(uint8_t i2c_address) 
-    : address_(i2c_address), data_valid_(false) {
+static const struct {
+    uint8_t start;
+    uint8_t len;
+} cache_windows[] = {
+    { BMP280_REG_ID, 1 },
+    { BMP280_REG_CALIB, BMP280_CALIB_LEN },
+    { BMP280_REG_DATA, BMP280_DATA_LEN },
+};
+
+BMP280Sensor::BMP280Sensor(I2CBus& bus, uint8_t i2c_address) 
+    : bus_(bus), address_(i2c_address), data_valid_(false), watch_id_(-1), last_watch_time_(0) {
     memset(&latest_data_, 0, sizeof(SensorData));
     latest_data_.valid = false;
+    memset(cache_, 0, sizeof(cache_));
 }
 
 BMP280Sensor::~BMP280Sensor() {
@@ -12,12 +22,24 @@ BMP280Sensor::~BMP280Sensor() {
 
 bool BMP280Sensor::begin() {
     logger.info("BMP280: Initializing sensor");
+
+    // The library reads the ID and the calibration one register at a time.
+    // The ID is read every time, it tells the sensor is there, the calibration
+    // comes from the bus's cache once a begin() read it.
+    RegisterCache& calib = cache_[CACHE_CALIB];
+    const bool calib_cached = bus_.loadConstant(address_, BMP280_REG_CALIB, calib.data, BMP280_CALIB_LEN);
+    calib.valid = calib_cached;
+    prefetch(CACHE_ID, calib_cached ? 1 : 2);
     
     // Call the parent class begin() which will use our overridden methods
     if (!BMx280MI::begin()) {
         logger.error("BMP280: Sensor initialization failed");
         return false;
     }
+    if (!calib_cached && calib.valid) {
+        // Only once the ID matched, nothing else at this address gets cached as calibration
+        bus_.storeConstant(address_, BMP280_REG_CALIB, calib.data, BMP280_CALIB_LEN);
+    }
     
     // Reset sensor to default parameters
     resetToDefaults();
@@ -32,6 +54,15 @@ bool BMP280Sensor::begin() {
     // Set to normal mode for continuous measurements
     writeStandbyTime(BMx280MI::T_SB_7); // 4000ms standby time
     writePowerMode(BMx280MI::BMx280_MODE_NORMAL);
+
+    // A new conversion changes the result registers, the busy bits alone do not
+    bus_.removeWatch(watch_id_);
+    const I2CBus::Watch watch = { address_, I2C_WATCH_CHANGED, BMP280_STATUS_BUSY, 0, BMP280_REG_DATA, BMP280_DATA_LEN, BMP280_WATCH_PERIOD_MS };
+    watch_id_ = bus_.addWatch(watch);
+    last_watch_time_ = millis();
+    if (watch_id_ >= 0) {
+        logger.info("BMP280: Results are pushed by the Nano");
+    }
     
     return true;
 }
@@ -41,7 +72,14 @@ bool BMP280Sensor::startMeasurement() {
 }
 
 bool BMP280Sensor::hasValue() {
-    if (BMx280MI::hasValue()) {
+    // Status and the result registers, only valid for this call
+    if (!updateDataWindow()) {
+        return false;
+    }
+    const bool has_value = BMx280MI::hasValue();
+    cache_[CACHE_DATA].valid = false;
+
+    if (has_value) {
         // Update our data structure with pressure and temperature
         latest_data_.pressure_pa = BMx280MI::getPressure();
         latest_data_.temperature_degc = BMx280MI::getTemperature();
@@ -69,13 +107,65 @@ float BMP280Sensor::getTemperature() {
 // Override virtual functions from BMx280MI
 
 bool BMP280Sensor::beginInterface() {
-    // Nothing to do here as I2CBridge is already initialized
+    // Nothing to do here as the bus is already initialized
+    return true;
+}
+
+void BMP280Sensor::prefetch(CacheWindow first, uint8_t count) {
+    I2CBus::Script script(address_);
+    for (uint8_t i = first; i < first + count; i++) {
+        script.readRegister(cache_windows[i].start, cache_windows[i].len);
+    }
+
+    I2CBus::ScriptResult result = bus_.runScript(script);
+    for (uint8_t step = 0; step < count; step++) {
+        RegisterCache& cache = cache_[first + step];
+        cache.valid = (result.status[step] == I2C_ERROR_NONE);
+        if (cache.valid) {
+            memcpy(cache.data, result.stepData(step), cache_windows[first + step].len);
+        }
+    }
+}
+
+bool BMP280Sensor::updateDataWindow() {
+    if (watch_id_ >= 0) {
+        I2CBus::WatchSample sample;
+        if (bus_.takeWatchSample(watch_id_, sample)) {
+            last_watch_time_ = sample.received_ms;
+            RegisterCache& cache = cache_[CACHE_DATA];
+            cache.valid = (sample.status == I2C_ERROR_NONE && sample.data_len == BMP280_DATA_LEN);
+            if (cache.valid) {
+                memcpy(cache.data, sample.data, BMP280_DATA_LEN);
+            }
+            return cache.valid;
+        }
+        if (millis() - last_watch_time_ < BMP280_WATCH_TIMEOUT_MS) {
+            return false; // Nothing new since the last push
+        }
+    }
+    // One round trip, also when the pushes stopped
+    prefetch(CACHE_DATA, 1);
     return true;
 }
 
+bool BMP280Sensor::readCached(uint8_t reg, uint8_t length, uint8_t* out) const {
+    for (uint8_t i = 0; i < CACHE_WINDOW_COUNT; i++) {
+        if (cache_[i].valid && reg >= cache_windows[i].start &&
+            reg + length <= cache_windows[i].start + cache_windows[i].len) {
+            memcpy(out, cache_[i].data + (reg - cache_windows[i].start), length);
+            return true;
+        }
+    }
+    return false;
+}
+
 uint8_t BMP280Sensor::readRegister(uint8_t reg) {
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeReadBytes(address_, &reg, 1, 1);
+    uint8_t value;
+    if (readCached(reg, 1, &value)) {
+        return value;
+    }
+
+    I2CBus::Result result = bus_.writeRead(address_, &reg, 1, 1);
     
     if (!result.success || result.data_len == 0) {
         logger.errorf("BMP280: Failed to read register 0x%02X", reg);
@@ -90,9 +180,11 @@ uint32_t BMP280Sensor::readRegisterBurst(uint8_t reg, uint8_t length) {
         logger.errorf("BMP280: Burst read length %d exceeds maximum of 4", length);
         return 0;
     }
-    
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeReadBytes(address_, &reg, 1, length);
+
+    I2CBus::Result result = {true, I2C_ERROR_NONE, {0}, length};
+    if (!readCached(reg, length, result.data)) {
+        result = bus_.writeRead(address_, &reg, 1, length);
+    }
     
     if (!result.success || result.data_len != length) {
         logger.errorf("BMP280: Failed to read %d bytes from register 0x%02X", length, reg);
@@ -111,9 +203,9 @@ uint32_t BMP280Sensor::readRegisterBurst(uint8_t reg, uint8_t length) {
 
 void BMP280Sensor::writeRegister(uint8_t reg, uint8_t data) {
     uint8_t write_data[2] = {reg, data};
+    cache_[CACHE_DATA].valid = false;
     
-    I2CBridge& i2c = I2CBridge::getInstance();
-    I2CBridge::Result result = i2c.writeBytes(address_, write_data, 2);
+    I2CBus::Result result = bus_.write(address_, write_data, 2);
     
     if (!result.success) {
         logger.errorf("BMP280: Failed to write 0x%02X to register 0x%02X", data, reg);
@@ -37,6 +37,7 @@ const char* ConfigManager::KEY_HUMI_COMFORTABLE_HIGH = "humi_comfortable_high";
 const char* ConfigManager::KEY_HUMI_ACCEPTABLE_LOW = "humi_acceptable_low";
 const char* ConfigManager::KEY_HUMI_ACCEPTABLE_HIGH = "humi_acceptable_high";
 const char* ConfigManager::KEY_INACTIVITY_TIMER_DELAY = "inactivity_timer_delay";
+const char* ConfigManager::KEY_I2C_DIRECT = "i2c_direct";
 const char* ConfigManager::KEY_MQTT_HOST = "mqtt_host";
 const char* ConfigManager::KEY_MQTT_PORT = "mqtt_port";
 const char* ConfigManager::KEY_MQTT_USER = "mqtt_user";
@@ -91,6 +92,7 @@ const float ConfigManager::DEFAULT_HUMI_COMFORTABLE_HIGH = 60.0f;
 const float ConfigManager::DEFAULT_HUMI_ACCEPTABLE_LOW = 20.0f;
 const float ConfigManager::DEFAULT_HUMI_ACCEPTABLE_HIGH = 70.0f;
 const int ConfigManager::DEFAULT_INACTIVITY_TIMER_DELAY = 30; // 30 seconds
+const int ConfigManager::DEFAULT_I2C_DIRECT_DEVICES = 0; // Every sensor behind the Nano
 const char* ConfigManager::DEFAULT_MQTT_HOST = MQTT_HOST;
 const int ConfigManager::DEFAULT_MQTT_PORT = MQTT_PORT;
 const char* ConfigManager::DEFAULT_MQTT_USER = MQTT_USER;
@@ -148,6 +150,7 @@ void ConfigManager::init() {
         humiAcceptableLow = DEFAULT_HUMI_ACCEPTABLE_LOW;
         humiAcceptableHigh = DEFAULT_HUMI_ACCEPTABLE_HIGH;
         inactivityTimerDelay = DEFAULT_INACTIVITY_TIMER_DELAY;
+        i2cDirectDevices = DEFAULT_I2C_DIRECT_DEVICES;
         co2WarnThreshold = DEFAULT_CO2_WARN_THRESHOLD;
         co2DangerThreshold = DEFAULT_CO2_DANGER_THRESHOLD;
         vocWarnThreshold = DEFAULT_VOC_WARN_THRESHOLD;
@@ -209,6 +212,7 @@ void ConfigManager::init() {
     humiAcceptableHigh = preferences.getFloat(KEY_HUMI_ACCEPTABLE_HIGH, DEFAULT_HUMI_ACCEPTABLE_HIGH);
     
     inactivityTimerDelay = preferences.getInt(KEY_INACTIVITY_TIMER_DELAY, DEFAULT_INACTIVITY_TIMER_DELAY);
+    i2cDirectDevices = preferences.getInt(KEY_I2C_DIRECT, DEFAULT_I2C_DIRECT_DEVICES);
     co2WarnThreshold = preferences.getInt(KEY_CO2_WARN, DEFAULT_CO2_WARN_THRESHOLD);
     co2DangerThreshold = preferences.getInt(KEY_CO2_DANGER, DEFAULT_CO2_DANGER_THRESHOLD);
     vocWarnThreshold = preferences.getInt(KEY_VOC_WARN, DEFAULT_VOC_WARN_THRESHOLD);
@@ -390,6 +394,7 @@ float ConfigManager::getHumiComfortableHigh() { return humiComfortableHigh; }
 float ConfigManager::getHumiAcceptableLow() { return humiAcceptableLow; }
 float ConfigManager::getHumiAcceptableHigh() { return humiAcceptableHigh; }
 int ConfigManager::getInactivityTimerDelay() { return inactivityTimerDelay; }
+int ConfigManager::getI2cDirectDevices() { return i2cDirectDevices; }
 const char* ConfigManager::getMqttHost() { return mqttHost; }
 int ConfigManager::getMqttPort() { return mqttPort; }
 const char* ConfigManager::getMqttUser() { return mqttUser; }
@@ -560,6 +565,16 @@ void ConfigManager::setInactivityTimerDelay(int value) {
         }
     }
 }
+void ConfigManager::setI2cDirectDevices(int value) {
+    if (i2cDirectDevices != value) {
+        i2cDirectDevices = value;
+        if (preferences.putInt(KEY_I2C_DIRECT, value) > 0) {
+            logger.infof("Saved new I2C direct devices: 0x%X, used from the next boot", value);
+        } else {
+            logger.errorf("Failed to save key '%s' to NVS.", KEY_I2C_DIRECT);
+        }
+    }
+}
 void ConfigManager::setCo2WarnThreshold(int value) {
     if (co2WarnThreshold != value) {
         co2WarnThreshold = value;
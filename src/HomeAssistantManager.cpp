@@ -52,6 +52,7 @@ HomeAssistantManager::HomeAssistantManager() :
     _sensorStackUptimeSensor("nano_uptime" RANDOM_SUFFIX, HASensor::PrecisionP0),
     _sensorStackVersionSensor("nano_firmware_version" RANDOM_SUFFIX), 
     _sensorStackFreeRamSensor("nano_free_ram" RANDOM_SUFFIX, HASensor::PrecisionP0),
+    _sensorStackBusWaitSensor("nano_bus_wait" RANDOM_SUFFIX, HASensor::PrecisionP0),
     _voc_index_sensor("voc_index" RANDOM_SUFFIX, HASensor::PrecisionP0),
     _nox_index_sensor("nox_index" RANDOM_SUFFIX, HASensor::PrecisionP0),
     _currentSensor("current" RANDOM_SUFFIX, HASensor::PrecisionP2),
@@ -64,6 +65,14 @@ HomeAssistantManager::HomeAssistantManager() :
     _scd30ForceCalNumber("scd30_forcecal" RANDOM_SUFFIX, HANumber::PrecisionP0),
     _esp32FreeRamSensor("esp32_free_ram" RANDOM_SUFFIX, HASensor::PrecisionP0),
     _esp32UptimeSensor("esp32_uptime" RANDOM_SUFFIX, HASensorNumber::PrecisionP0),
+    _linkErrorsSensor("nano_link_errors" RANDOM_SUFFIX, HASensorNumber::PrecisionP0),
+    _linkTimeoutsSensor("nano_link_timeouts" RANDOM_SUFFIX, HASensorNumber::PrecisionP0),
+    _linkLostFramesSensor("nano_link_lost_frames" RANDOM_SUFFIX, HASensorNumber::PrecisionP0),
+    _linkLatencyP50Sensor("nano_link_latency_p50" RANDOM_SUFFIX, HASensorNumber::PrecisionP1),
+    _linkLatencyP99Sensor("nano_link_latency_p99" RANDOM_SUFFIX, HASensorNumber::PrecisionP1),
+    _i2cErrorsSensor("i2c_bridge_errors" RANDOM_SUFFIX, HASensorNumber::PrecisionP0),
+    _i2cLatencyP99Sensor("i2c_bridge_latency_p99" RANDOM_SUFFIX, HASensorNumber::PrecisionP1),
+    _i2cBusiestDeviceSensor("i2c_bridge_busiest_device" RANDOM_SUFFIX),
     _compressorCurrentSensor("compressor_current" RANDOM_SUFFIX, HASensorNumber::PrecisionP2),
     _geothermalPumpCurrentSensor("geothermal_pump_current" RANDOM_SUFFIX, HASensorNumber::PrecisionP2),
     _liquidLevelSensor("liquid_level_sensor" RANDOM_SUFFIX),
@@ -371,6 +380,13 @@ void HomeAssistantManager::init(const char* firmware_version) {
     // Set expire time to > 2x the poll interval (30s * 2 + 5s buffer)
     _sensorStackFreeRamSensor.setExpireAfter(65);
 
+    // Longest a bridge command could wait behind the Nano's own sensor reads
+    _sensorStackBusWaitSensor.setName("SensorStack I2C Bus Wait");
+    _sensorStackBusWaitSensor.setIcon("mdi:timer-sand");
+    _sensorStackBusWaitSensor.setUnitOfMeasurement("ms");
+    _sensorStackBusWaitSensor.setEntityCategory(entity_category_diagnostic);
+    _sensorStackBusWaitSensor.setExpireAfter(65);
+
     _sensorStackResetCauseSensor.setName("SensorStack Reset Cause");
     _sensorStackResetCauseSensor.setIcon("mdi:restart-alert");
     _sensorStackResetCauseSensor.setEntityCategory(entity_category_diagnostic);
@@ -441,6 +457,43 @@ void HomeAssistantManager::init(const char* firmware_version) {
     _esp32UptimeSensor.setUnitOfMeasurement("s");
     _esp32UptimeSensor.setEntityCategory(entity_category_diagnostic);
 
+    // Counters since boot, see /metrics for the per response type breakdown
+    _linkErrorsSensor.setName("SensorStack Link Errors");
+    _linkErrorsSensor.setIcon("mdi:lan-disconnect");
+    _linkErrorsSensor.setEntityCategory(entity_category_diagnostic);
+
+    _linkTimeoutsSensor.setName("SensorStack Link Timeouts");
+    _linkTimeoutsSensor.setIcon("mdi:timer-alert");
+    _linkTimeoutsSensor.setEntityCategory(entity_category_diagnostic);
+
+    _linkLostFramesSensor.setName("SensorStack Lost Frames");
+    _linkLostFramesSensor.setIcon("mdi:lan-pending");
+    _linkLostFramesSensor.setEntityCategory(entity_category_diagnostic);
+
+    _linkLatencyP50Sensor.setName("SensorStack Latency p50");
+    _linkLatencyP50Sensor.setIcon("mdi:timer-outline");
+    _linkLatencyP50Sensor.setUnitOfMeasurement("ms");
+    _linkLatencyP50Sensor.setEntityCategory(entity_category_diagnostic);
+
+    _linkLatencyP99Sensor.setName("SensorStack Latency p99");
+    _linkLatencyP99Sensor.setIcon("mdi:timer-alert-outline");
+    _linkLatencyP99Sensor.setUnitOfMeasurement("ms");
+    _linkLatencyP99Sensor.setEntityCategory(entity_category_diagnostic);
+
+    // I2C bridge totals, see /metrics/i2c for the per address breakdown
+    _i2cErrorsSensor.setName("I2C Bridge Errors");
+    _i2cErrorsSensor.setIcon("mdi:alert-circle-outline");
+    _i2cErrorsSensor.setEntityCategory(entity_category_diagnostic);
+
+    _i2cLatencyP99Sensor.setName("I2C Bridge Latency p99");
+    _i2cLatencyP99Sensor.setIcon("mdi:timer-alert-outline");
+    _i2cLatencyP99Sensor.setUnitOfMeasurement("ms");
+    _i2cLatencyP99Sensor.setEntityCategory(entity_category_diagnostic);
+
+    _i2cBusiestDeviceSensor.setName("I2C Bridge Busiest Device");
+    _i2cBusiestDeviceSensor.setIcon("mdi:chip");
+    _i2cBusiestDeviceSensor.setEntityCategory(entity_category_diagnostic);
+
     _device.enableSharedAvailability();
     _device.enableLastWill();
 
@@ -773,6 +826,10 @@ void HomeAssistantManager::publishSensorStackFreeRam(uint16_t free_ram) {
     _sensorStackFreeRamSensor.setValue(free_ram, true);
 }
 
+void HomeAssistantManager::publishSensorStackBusWait(uint16_t bus_wait_ms) {
+    _sensorStackBusWaitSensor.setValue(bus_wait_ms, true);
+}
+
 void HomeAssistantManager::onRebootCommand(HAButton* sender) {
     logger.warning("Reboot command received from Home Assistant. Rebooting now.");
     sender->setAvailability(false);
@@ -842,22 +899,7 @@ void HomeAssistantManager::publishNanoResetCause(const char* cause) {
 
 void HomeAssistantManager::onScd30AutoCalCommand(bool state, HASwitch* sender) {
     logger.infof("SCD30 AutoCalibration %s command from Home Assistant.", state ? "ON" : "OFF");
-    // Use the existing send_command_to_nano function with parameter
-    char cmd_with_param[3];
-    cmd_with_param[0] = CMD_SET_SCD30_AUTOCAL;
-    cmd_with_param[1] = state ? '1' : '0';
-    cmd_with_param[2] = '\0';
-    
-    uint8_t crc = 0x00;
-    uint8_t polynomial = 0x07;
-    for (int i = 0; i < 2; i++) {
-        crc ^= cmd_with_param[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc & 0x80) ? (crc << 1) ^ polynomial : (crc << 1);
-        }
-    }
-    
-    Serial.print('<'); Serial.print(cmd_with_param); Serial.print(','); Serial.print(crc); Serial.print('>');
+    send_command_to_nano_with_payload(CMD_SET_SCD30_AUTOCAL, state ? "1" : "0");
 }
 
 void HomeAssistantManager::updateScd30AutoCalState(bool state) {
@@ -868,19 +910,9 @@ void HomeAssistantManager::onScd30ForceCalCommand(HANumeric number, HANumber* se
     uint16_t ppm_value = (uint16_t)number.toUInt16();
     logger.infof("SCD30 Force Calibration to %u ppm command from Home Assistant.", ppm_value);
     
-    char cmd_with_param[8];
-    sprintf(cmd_with_param, "%c%u", CMD_SET_SCD30_FORCECAL, ppm_value);
-    
-    uint8_t crc = 0x00;
-    uint8_t polynomial = 0x07;
-    for (int i = 0; cmd_with_param[i] != '\0'; i++) {
-        crc ^= cmd_with_param[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc & 0x80) ? (crc << 1) ^ polynomial : (crc << 1);
-        }
-    }
-    
-    Serial.print('<'); Serial.print(cmd_with_param); Serial.print(','); Serial.print(crc); Serial.print('>');
+    char ppm_str[6];
+    snprintf(ppm_str, sizeof(ppm_str), "%u", ppm_value);
+    send_command_to_nano_with_payload(CMD_SET_SCD30_FORCECAL, ppm_str);
 }
 
 void HomeAssistantManager::updateScd30ForceCalValue(uint16_t value) {
@@ -904,6 +936,25 @@ void HomeAssistantManager::publishEsp32Uptime(uint32_t uptime_seconds) {
     _esp32UptimeSensor.setValue(uptime_seconds);
 }
 
+void HomeAssistantManager::publishNanoLinkMetrics(const NanoLinkMetrics::Summary& metrics) {
+    _linkErrorsSensor.setValue(metrics.errors);
+    _linkTimeoutsSensor.setValue(metrics.timeouts);
+    _linkLostFramesSensor.setValue(metrics.gaps);
+    _linkLatencyP50Sensor.setValue(metrics.latency_p50_us / 1000.0f);
+    _linkLatencyP99Sensor.setValue(metrics.latency_p99_us / 1000.0f);
+}
+
+void HomeAssistantManager::publishI2cBridgeStats(const I2CBridgeStats::Summary& stats) {
+    _i2cErrorsSensor.setValue(stats.errors + stats.timeouts);
+    _i2cLatencyP99Sensor.setValue(stats.latency_p99_us / 1000.0f);
+    if (stats.busiest_addr != 0) {
+        // Address and its share of the time spent in bridge transactions
+        char busiest[16];
+        snprintf(busiest, sizeof(busiest), "0x%02X (%u%%)", stats.busiest_addr, stats.busiest_percent);
+        _i2cBusiestDeviceSensor.setValue(busiest);
+    }
+}
+
 void HomeAssistantManager::updateInactivityTimerDelayState() {
     unsigned long currentTime = millis();
     // Use a longer interval for configuration values that don't change frequently
@@ -1,110 +1,57 @@
 #include "I2CBridge.h"
+#include <esp_timer.h>
+#include "I2CBridgeStats.h"
 #include "NanoCommands.h"
 #include "Logger.h"
-#include "SerialMutex.h"
+#include "protocol/Frames.h"
 
 //#define I2C_BRIDGE_DEBUG // Uncomment for debug output
 
+// A transaction nobody collected this long after its deadline gives its slot back
+#define I2C_STALE_SLOT_MS 1000
+
 // Private member variables for the singleton
 unsigned long I2CBridge::_timeout_ms = 1000;
-QueueHandle_t I2CBridge::_response_queue = nullptr;
-
-// Helper function for checksum calculation
-uint8_t I2CBridge::calculate_checksum(const char* data_str) {
-    uint8_t crc = 0x00;
-    uint8_t polynomial = 0x07;
-    size_t length = strlen(data_str);
-    for (size_t i = 0; i < length; i++) {
-        crc ^= data_str[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc & 0x80) ? (crc << 1) ^ polynomial : (crc << 1);
-        }
-    }
-    return crc;
-}
+I2CBridge::Pending I2CBridge::_pending[I2C_PENDING_SLOTS];
+uint32_t I2CBridge::_next_sequence = 0;
+uint8_t I2CBridge::_next_xfer_id = 0;
+I2CBridge::WatchSlot I2CBridge::_watches[I2C_WATCH_SLOTS];
+bool I2CBridge::_watches_cleared = false;
+SemaphoreHandle_t I2CBridge::_mutex = nullptr;
+StaticSemaphore_t I2CBridge::_mutex_buffer;
 
 // I2C communication functions
-void I2CBridge::send_i2c_read_request(uint8_t address, uint8_t num_bytes) {
+bool I2CBridge::format_read_request(char* out, size_t size, uint8_t address, uint8_t num_bytes) {
     if (num_bytes > 32) {
         logger.warning("I2C read request exceeds maximum buffer size (32 bytes)");
         num_bytes = 32; // Limit to maximum allowed
     }
-    
-    char data_part[16]; // Buffer for command data
-    snprintf(data_part, 16, "%c%02X,%02X", CMD_I2C_READ, address, num_bytes);
-    
-    uint8_t checksum = calculate_checksum(data_part);
-#ifdef I2C_BRIDGE_DEBUG
-    logger.debugf("Sending I2C read request: <%s,%d>", data_part, checksum);
-#endif
-    // Use SerialMutex for atomic packet sending
-    SerialMutex& serialMutex = SerialMutex::getInstance();
-    if (serialMutex.lock()) {
-        // We still need to use direct Serial here for communication with the Nano
-        Serial.print('<');
-        Serial.print(data_part);
-        Serial.print(',');
-        Serial.print(checksum);
-        Serial.print('>');
-        serialMutex.unlock();
-    }
+    int written_len = snprintf(out, size, "%c%02X,%02X", CMD_I2C_READ, address, num_bytes);
+    return written_len > 0 && (size_t)written_len < size;
 }
 
-void I2CBridge::send_i2c_write_request(uint8_t address, uint8_t* data, uint8_t data_len) {
-    // 1. Initial check remains the same
-    if (data_len > 96) {
-        logger.warning("I2C write request exceeds maximum buffer size (96 bytes)");
-        data_len = 96;
-    }
-    
-    // 2. Safely construct the data_part string
-    char data_part[128];
-    size_t buffer_size = sizeof(data_part);
-    int written_len = 0;
-    int result;
-
+bool I2CBridge::format_write_request(char* out, size_t size, uint8_t address, const uint8_t* data, uint8_t data_len) {
     // Write the initial part of the command (e.g., "W33,0A")
-    result = snprintf(data_part, buffer_size, "%c%02X,%02X", CMD_I2C_WRITE, address, data_len);
-
-    // Check if the initial write failed or was truncated
-    if (result < 0 || (size_t)result >= buffer_size) {
+    int result = snprintf(out, size, "%c%02X,%02X", CMD_I2C_WRITE, address, data_len);
+    if (result < 0 || (size_t)result >= size) {
         logger.errorf("Buffer error during initial formatting of I2C write request.");
-        return; // Abort sending the malformed packet
+        return false;
     }
-    written_len = result;
+    size_t written_len = result;
 
     // Append each data byte as hex, safely checking remaining space each time
     for (uint8_t i = 0; i < data_len; i++) {
-        size_t remaining_size = buffer_size - written_len;
-        result = snprintf(data_part + written_len, remaining_size, ",%02X", data[i]);
-
-        // Check if the append operation failed or was truncated
-        if (result < 0 || (size_t)result >= remaining_size) {
-            logger.errorf("Buffer overflow while formatting I2C write data. Command truncated.");
-            break; // Stop appending data to prevent overflow
+        result = snprintf(out + written_len, size - written_len, ",%02X", data[i]);
+        if (result < 0 || (size_t)result >= size - written_len) {
+            logger.errorf("Buffer overflow while formatting I2C write data. Command dropped.");
+            return false;
         }
         written_len += result;
     }
-    
-    // 3. The rest of the function proceeds with the safely-built string
-    uint8_t checksum = calculate_checksum(data_part);
-#ifdef I2C_BRIDGE_DEBUG
-    logger.debugf("Sending I2C write request: <%s,%d>", data_part, checksum);
-#endif
-    
-    SerialMutex& serialMutex = SerialMutex::getInstance();
-    if (serialMutex.lock()) {
-        Serial.print('<');
-        Serial.print(data_part);
-        Serial.print(',');
-        Serial.print(checksum);
-        Serial.print('>');
-        serialMutex.unlock();
-    }
+    return true;
 }
 
-void I2CBridge::send_i2c_write_read_request(uint8_t address, uint8_t* write_data, uint8_t write_len, uint8_t read_len) {
-    // 1. Initial checks remain the same
+bool I2CBridge::format_write_read_request(char* out, size_t size, uint8_t address, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) {
     if (write_len > 16) {
         logger.warning("I2C write-read request exceeds maximum write buffer size (16 bytes)");
         write_len = 16;
@@ -113,287 +60,870 @@ void I2CBridge::send_i2c_write_read_request(uint8_t address, uint8_t* write_data
         logger.warning("I2C write-read request exceeds maximum read buffer size (32 bytes)");
         read_len = 32;
     }
-    
-    // 2. Safely construct the data_part string
-    char data_part[128];
-    size_t buffer_size = sizeof(data_part);
-    int written_len = 0;
-    int result;
 
     // Write the initial part of the command (e.g., "I33,01,02")
-    result = snprintf(data_part, buffer_size, "%c%02X,%02X,%02X", CMD_I2C_READ, address, write_len, read_len);
-
-    // Check if the initial write failed or was truncated
-    if (result < 0 || (size_t)result >= buffer_size) {
+    int result = snprintf(out, size, "%c%02X,%02X,%02X", CMD_I2C_READ, address, write_len, read_len);
+    if (result < 0 || (size_t)result >= size) {
         logger.errorf("Buffer error during initial formatting of I2C request.");
-        return; // Abort sending the malformed packet
+        return false;
     }
-    written_len = result;
+    size_t written_len = result;
 
     // Append each write byte as hex, safely checking remaining space each time
     for (uint8_t i = 0; i < write_len; i++) {
-        size_t remaining_size = buffer_size - written_len;
-        result = snprintf(data_part + written_len, remaining_size, ",%02X", write_data[i]);
-
-        // Check if the append operation failed or was truncated
-        if (result < 0 || (size_t)result >= remaining_size) {
-            logger.errorf("Buffer overflow while formatting I2C write data. Command truncated.");
-            break; // Stop appending data to prevent overflow
+        result = snprintf(out + written_len, size - written_len, ",%02X", write_data[i]);
+        if (result < 0 || (size_t)result >= size - written_len) {
+            logger.errorf("Buffer overflow while formatting I2C write data. Command dropped.");
+            return false;
         }
         written_len += result;
     }
-    
-    // 3. The rest of the function proceeds with the safely-built string
-    uint8_t checksum = calculate_checksum(data_part);
-#ifdef I2C_BRIDGE_DEBUG
-    logger.debugf("Sending I2C write-read request: <%s,%d>", data_part, checksum);
-#endif
-    
-    SerialMutex& serialMutex = SerialMutex::getInstance();
-    if (serialMutex.lock()) {
-        Serial.print('<');
-        Serial.print(data_part);
-        Serial.print(',');
-        Serial.print(checksum);
-        Serial.print('>');
-        serialMutex.unlock();
+    return true;
+}
+
+bool I2CBridge::format_write_chunk(char* out, size_t size, uint8_t address, const uint8_t* data, uint8_t offset, uint8_t len, uint8_t total) {
+    int written_len = snprintf(out, size, "%c%02X,%02X,%02X", CMD_I2C_WRITE_CHUNK, address, offset, total);
+    for (uint8_t i = 0; i < len; i++) {
+        written_len += snprintf(out + written_len, size - written_len, ",%02X", data[offset + i]);
+    }
+    return written_len > 0 && (size_t)written_len < size;
+}
+
+bool I2CBridge::format_script(char* out, size_t size, const Script& script) {
+    int written_len = snprintf(out, size, "%c%02X", CMD_I2C_SCRIPT, script._addr);
+    for (uint8_t i = 0; i < script._step_count; i++) {
+        const Script::Step& step = script._steps[i];
+        written_len += snprintf(out + written_len, size - written_len, ",%c", step.op);
+        if (step.op != I2C_SCRIPT_OP_WRITE) {
+            written_len += snprintf(out + written_len, size - written_len, "%02X", step.read_len);
+        }
+        for (uint8_t j = 0; j < step.write_len; j++) {
+            written_len += snprintf(out + written_len, size - written_len, "%02X", step.write[j]);
+        }
+    }
+    return written_len > 0 && (size_t)written_len < size;
+}
+
+uint8_t I2CBridge::format_read_frame(uint8_t* out, uint8_t address, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) {
+    if (write_len > BRIDGE_FRAME_MAX_WRITE_READ) {
+        logger.warning("I2C write-read request exceeds maximum write buffer size (16 bytes)");
+        write_len = BRIDGE_FRAME_MAX_WRITE_READ;
+    }
+    if (read_len > sizeof(Result::data)) {
+        logger.warning("I2C write-read request exceeds maximum read buffer size (32 bytes)");
+        read_len = sizeof(Result::data);
     }
+    out[0] = address;
+    out[1] = read_len;
+    memcpy(out + 2, write_data, write_len);
+    return 2 + write_len;
 }
 
 bool I2CBridge::begin() {
-    // Initialize the response queue
-    if (_response_queue == nullptr) {
-        _response_queue = xQueueCreate(1, sizeof(Result));
-        if (_response_queue == nullptr) {
-            logger.error("Failed to create I2C response queue");
+    if (_mutex == nullptr) {
+        for (uint8_t i = 0; i < I2C_PENDING_SLOTS; i++) {
+            _pending[i].used = false;
+            _pending[i].done_sem = xSemaphoreCreateBinaryStatic(&_pending[i].done_sem_buffer);
+        }
+        _mutex = xSemaphoreCreateMutexStatic(&_mutex_buffer);
+        if (_mutex == nullptr) {
+            logger.error("Failed to create I2C bridge mutex");
             return false;
         }
     }
     return true;
 }
 
-I2CBridge::Result I2CBridge::readBytes(uint8_t addr, uint8_t len) {
-    Result result = {false, I2C_ERROR_PENDING, {0}, 0};
-    
-    // Make sure the queue is empty before sending a new request
-    xQueueReset(_response_queue);
-    
-    // Send the read request to the Nano
-    send_i2c_read_request(addr, len);
-#ifdef I2C_BRIDGE_DEBUG
-    logger.debugf("I2CBridge: Waiting for read response (addr=0x%02X, len=%d)", addr, len);
-#endif
-    
-    // Wait for response with timeout
-    if (xQueueReceive(_response_queue, &result, pdMS_TO_TICKS(1000)) == pdTRUE) {
-        // Log the received data
-        if (result.data_len > 0) {
-            String hexData;
-            for (int i = 0; i < result.data_len; i++) {
-                if (i > 0) hexData += " ";
-                char hex[4];
-                sprintf(hex, "%02X", result.data[i]);
-                hexData += hex;
+I2CBridge::Handle I2CBridge::submit(uint8_t addr, const char* data_part, unsigned long timeout_ms, const Script* script, const BlockTarget* block) {
+    const Command command = {data_part[0], data_part, nullptr, 0};
+    return submit(addr, command, timeout_ms, script, block);
+}
+
+I2CBridge::Handle I2CBridge::submit(uint8_t addr, const Command& command, unsigned long timeout_ms, const Script* script, const BlockTarget* block) {
+    Handle handle = {0, REQUEST_ID_NONE};
+    if (_mutex == nullptr) {
+        logger.error("I2CBridge: Transaction submitted before begin()");
+        return handle;
+    }
+
+    // Wait for a free slot and for room in the Nano's RX buffer, and while
+    // the link changes speed
+    const uint8_t wire_len = command.data_part ? strlen(command.data_part) + I2C_PACKET_OVERHEAD : command.payload_len + I2C_FRAME_OVERHEAD;
+    const unsigned long start = millis();
+    int8_t slot;
+    while (true) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        const unsigned long now = millis();
+        uint16_t in_flight = 0;
+        slot = -1;
+        for (uint8_t i = 0; i < I2C_PENDING_SLOTS; i++) {
+            Pending& pending = _pending[i];
+            const bool expired = pending.used && (long)(now - pending.deadline) >= 0;
+            if (expired && now - pending.deadline > I2C_STALE_SLOT_MS) {
+                pending.used = false; // Its handle now reads as a timeout
+            }
+            if (!pending.used) {
+                if (slot < 0) {
+                    slot = i;
+                }
+            } else if (!pending.done && !expired) {
+                in_flight += pending.wire_len;
             }
+        }
+        if (slot >= 0 && nano_link_accepts_bridge_traffic() &&
+            (in_flight == 0 || in_flight + wire_len <= I2C_IN_FLIGHT_BUDGET)) {
+            break; // Keeps the lock
+        }
+        xSemaphoreGive(_mutex);
+
+        if (millis() - start >= timeout_ms) {
+            logger.warningf("I2CBridge: No room to send %c, %u bytes in flight", command.op, in_flight);
+            return handle;
+        }
+        vTaskDelay(1);
+    }
+
+    Pending& pending = _pending[slot];
+    pending.used = true;
+    pending.done = false;
+    pending.is_script = (script != nullptr);
+    pending.is_transfer = (block != nullptr);
+    pending.addr = addr;
+    pending.op = command.op;
+    pending.response = protocol_response_for(command.op);
+    pending.wire_len = wire_len;
+    pending.sequence = _next_sequence++;
+    pending.deadline = millis() + timeout_ms;
+    pending.script_steps = script ? script->_step_count : 0;
+    for (uint8_t i = 0; i < pending.script_steps; i++) {
+        const Script::Step& step = script->_steps[i];
+        const bool reads = (step.op == I2C_SCRIPT_OP_READ || step.op == I2C_SCRIPT_OP_WRITE_READ);
+        pending.step_read[i] = reads ? step.read_len : 0;
+    }
+    if (block != nullptr) {
+        pending.xfer_id = block->xfer_id;
+        pending.transfer_out = block->out;
+        pending.transfer_len = block->len;
+        pending.transfer = {false, I2C_ERROR_PENDING, 0};
+    }
+    xSemaphoreTake(pending.done_sem, 0); // Left over from a reclaimed transaction
+
+    pending.submitted_us = esp_timer_get_time();
+    pending.request_id = command.data_part ? send_packet_to_nano(command.data_part, timeout_ms) :
+                         send_frame_to_nano(command.op, command.payload, command.payload_len, timeout_ms);
+    if (pending.request_id == REQUEST_ID_NONE) {
+        pending.used = false;
+    } else {
+        handle.slot = slot;
+        handle.request_id = pending.request_id;
+    }
+    xSemaphoreGive(_mutex);
+
 #ifdef I2C_BRIDGE_DEBUG
-            logger.debugf("I2CBridge: Read response received - addr=0x%02X, status=%d, data=%s", 
-                         addr, result.error_code, hexData.c_str());
+    if (command.data_part) {
+        logger.debugf("I2CBridge: Submitted #%u: %s", handle.request_id, command.data_part);
+    } else {
+        logger.debugf("I2CBridge: Submitted #%u: %c frame, %u bytes", handle.request_id, command.op, command.payload_len);
+    }
 #endif
-        } 
-#ifdef I2C_BRIDGE_DEBUG
-        else {
-            logger.debugf("I2CBridge: Read response received - addr=0x%02X, status=%d, no data", 
-                         addr, result.error_code);
+    return handle;
+}
+
+I2CBridge::Handle I2CBridge::submitRead(uint8_t addr, uint8_t len) {
+    if (nano_has_capability(PROTOCOL_CAP_BINARY_I2C)) {
+        return submitWriteRead(addr, nullptr, 0, len);
+    }
+    char data_part[16];
+    if (!format_read_request(data_part, sizeof(data_part), addr, len)) {
+        return {0, REQUEST_ID_NONE};
+    }
+    return submit(addr, data_part, _timeout_ms);
+}
+
+I2CBridge::Handle I2CBridge::submitWrite(uint8_t addr, const uint8_t* data, uint8_t len) {
+    // Same limit for every encoding, the Nano's TWI buffer
+    if (len > I2C_WRITE_MAX_LEN) {
+        logger.warningf("I2CBridge: Write of %u bytes exceeds the Nano's %u byte limit", len, I2C_WRITE_MAX_LEN);
+        return {0, REQUEST_ID_NONE};
+    }
+
+    if (nano_has_capability(PROTOCOL_CAP_BINARY_I2C)) {
+        uint8_t payload[1 + I2C_WRITE_MAX_LEN];
+        payload[0] = addr;
+        memcpy(payload + 1, data, len);
+        const Command command = {CMD_I2C_WRITE, nullptr, payload, (uint8_t)(len + 1)};
+        return submit(addr, command, _timeout_ms);
+    }
+
+    if (nano_has_capability(PROTOCOL_CAP_CHUNKED_WRITES)) {
+        if (len > I2C_WRITE_CHUNK_LEN) {
+            logger.warningf("I2CBridge: Write of %u bytes needs writeBytes(), one chunk holds %u", len, I2C_WRITE_CHUNK_LEN);
+            return {0, REQUEST_ID_NONE};
         }
-#endif
+        return submitChunk(addr, data, 0, len, len);
+    }
+
+    char data_part[16 + I2C_WRITE_MAX_LEN * 3];
+    if (!format_write_request(data_part, sizeof(data_part), addr, data, len)) {
+        return {0, REQUEST_ID_NONE};
+    }
+    return submit(addr, data_part, _timeout_ms);
+}
+
+I2CBridge::Handle I2CBridge::submitChunk(uint8_t addr, const uint8_t* data, uint8_t offset, uint8_t len, uint8_t total) {
+    char data_part[16 + I2C_WRITE_CHUNK_LEN * 3];
+    if (!format_write_chunk(data_part, sizeof(data_part), addr, data, offset, len, total)) {
+        return {0, REQUEST_ID_NONE};
+    }
+    return submit(addr, data_part, _timeout_ms);
+}
+
+I2CBridge::Handle I2CBridge::submitWriteRead(uint8_t addr, const uint8_t* writeData, uint8_t writeLen, uint8_t readLen) {
+    if (nano_has_capability(PROTOCOL_CAP_BINARY_I2C)) {
+        uint8_t payload[2 + BRIDGE_FRAME_MAX_WRITE_READ];
+        const Command command = {CMD_I2C_READ, nullptr, payload, format_read_frame(payload, addr, writeData, writeLen, readLen)};
+        return submit(addr, command, _timeout_ms);
+    }
+
+    char data_part[128];
+    if (!format_write_read_request(data_part, sizeof(data_part), addr, writeData, writeLen, readLen)) {
+        return {0, REQUEST_ID_NONE};
+    }
+    return submit(addr, data_part, _timeout_ms);
+}
+
+I2CBridge::Handle I2CBridge::submitScript(const Script& script) {
+    if (!script.valid() || !nano_has_capability(PROTOCOL_CAP_I2C_SCRIPTS)) {
+        logger.warningf("I2CBridge: Script for addr=0x%02X cannot be sent", script._addr);
+        return {0, REQUEST_ID_NONE};
+    }
+    char data_part[I2C_SCRIPT_MAX_CMD_LEN + 1];
+    if (!format_script(data_part, sizeof(data_part), script)) {
+        return {0, REQUEST_ID_NONE};
+    }
+    const unsigned long timeout_ms = _timeout_ms + script._delay_total_ms + script._step_count * I2C_SCRIPT_STEP_DELAY_MARGIN_MS;
+    return submit(script._addr, data_part, timeout_ms, &script);
+}
+
+bool I2CBridge::isDone(Handle handle) {
+    if (!handle.valid() || handle.slot >= I2C_PENDING_SLOTS || _mutex == nullptr) {
+        return true; // Nothing left to wait for
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const Pending& pending = _pending[handle.slot];
+    const bool done = !pending.used || pending.request_id != handle.request_id || pending.done ||
+                      (long)(millis() - pending.deadline) >= 0;
+    xSemaphoreGive(_mutex);
+    return done;
+}
+
+void I2CBridge::cancel(Handle handle) {
+    if (!handle.valid() || handle.slot >= I2C_PENDING_SLOTS || _mutex == nullptr) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Pending& pending = _pending[handle.slot];
+    if (pending.used && pending.request_id == handle.request_id) {
+        pending.used = false;
+    }
+    xSemaphoreGive(_mutex);
+}
+
+bool I2CBridge::collect(Handle handle, void* out, size_t size) {
+    if (!handle.valid() || handle.slot >= I2C_PENDING_SLOTS || _mutex == nullptr) {
+        return false;
+    }
+    Pending& pending = _pending[handle.slot];
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const bool current = pending.used && pending.request_id == handle.request_id;
+    const unsigned long deadline = pending.deadline;
+    xSemaphoreGive(_mutex);
+    if (!current) {
+        return false;
+    }
+
+    const long remaining_ms = (long)(deadline - millis());
+    xSemaphoreTake(pending.done_sem, remaining_ms > 0 ? pdMS_TO_TICKS(remaining_ms) : 0);
+
+    bool done = false;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (pending.used && pending.request_id == handle.request_id) {
+        done = pending.done;
+        if (!done) {
+            I2CBridgeStats::getInstance().countTimeout(pending.addr, pending.op);
+        } else {
+            const void* result = pending.is_script ? (const void*)&pending.script :
+                                 pending.is_transfer ? (const void*)&pending.transfer : (const void*)&pending.result;
+            memcpy(out, result, size);
+        }
+        pending.used = false;
+    }
+    xSemaphoreGive(_mutex);
+    return done;
+}
+
+I2CBridge::Result I2CBridge::wait(Handle handle) {
+    Result result = {false, I2C_ERROR_PENDING, {0}, 0};
+    if (!handle.valid()) {
+        result.error_code = I2C_ERROR_OTHER; // Never sent
         return result;
     }
-    
-    // Timeout occurred
-    logger.warningf("I2CBridge: Read response timeout for addr=0x%02X", addr);
-    result.error_code = I2C_ERROR_TIMEOUT;
+    if (!collect(handle, &result, sizeof(result))) {
+        logger.warningf("I2CBridge: Response timeout for request #%u", handle.request_id);
+        result = {false, I2C_ERROR_TIMEOUT, {0}, 0};
+    }
     return result;
 }
 
-I2CBridge::Result I2CBridge::writeBytes(uint8_t addr, uint8_t* data, uint8_t len) {
-    Result result = {false, I2C_ERROR_PENDING, {0}, 0};
-    const int max_retries = 3;
-    int attempt = 0;
-
-    while (attempt < max_retries) {
-        // Make sure the queue is empty before sending a new request
-        xQueueReset(_response_queue);
-
-        // Send the write request to the Nano
-        send_i2c_write_request(addr, data, len);
-
-        // Log the data being sent
-        String hexData;
-        for (int i = 0; i < len; i++) {
-            if (i > 0) hexData += " ";
-            char hex[4];
-            sprintf(hex, "%02X", data[i]);
-            hexData += hex;
+I2CBridge::ScriptResult I2CBridge::waitScript(Handle handle) {
+    ScriptResult result = {};
+    if (!handle.valid() || !collect(handle, &result, sizeof(result))) {
+        if (handle.valid()) {
+            logger.warningf("I2CBridge: Script response timeout for request #%u", handle.request_id);
         }
+        result = {};
+        result.error_code = handle.valid() ? I2C_ERROR_TIMEOUT : I2C_ERROR_OTHER;
+        memset(result.status, I2C_ERROR_PENDING, sizeof(result.status));
+    }
+    return result;
+}
+
+I2CBridge::Result I2CBridge::readBytes(uint8_t addr, uint8_t len) {
+    Result result = wait(submitRead(addr, len));
 #ifdef I2C_BRIDGE_DEBUG
-        logger.debugf("I2CBridge: Waiting for write response (addr=0x%02X, data=%s, attempt=%d)", addr, hexData.c_str(), attempt + 1);
+    logger.debugf("I2CBridge: Read response - addr=0x%02X, status=%d, %u bytes", addr, result.error_code, result.data_len);
 #endif
-        // Wait for response with timeout
-        if (xQueueReceive(_response_queue, &result, pdMS_TO_TICKS(1000)) == pdTRUE) {
+    return result;
+}
+
+I2CBridge::Result I2CBridge::writeBytes(uint8_t addr, const uint8_t* data, uint8_t len) {
+    Result result = {false, I2C_ERROR_PENDING, {0}, 0};
+    if (len > I2C_WRITE_MAX_LEN) {
+        logger.warningf("I2CBridge: Write of %u bytes exceeds the Nano's %u byte limit", len, I2C_WRITE_MAX_LEN);
+        result.error_code = I2C_ERROR_BUF_LEN;
+        return result;
+    }
+
+    // One frame carries the whole write, nothing is ever sent twice
+    if (nano_has_capability(PROTOCOL_CAP_BINARY_I2C)) {
+        return wait(submitWrite(addr, data, len));
+    }
+
+    // The Nano acknowledges every chunk, nothing is ever sent twice
+    if (nano_has_capability(PROTOCOL_CAP_CHUNKED_WRITES)) {
+        return writeChunked(addr, data, len);
+    }
+
+    const int max_retries = 3;
+    for (int attempt = 1; attempt <= max_retries; attempt++) {
+        result = wait(submitWrite(addr, data, len));
 #ifdef I2C_BRIDGE_DEBUG
-            logger.debugf("I2CBridge: Write response received - addr=0x%02X, status=%d, attempt=%d", addr, result.error_code, attempt + 1);
+        logger.debugf("I2CBridge: Write response - addr=0x%02X, status=%d, attempt=%d", addr, result.error_code, attempt);
 #endif
-            if (result.success) {
-                return result;
-            }
+        if (result.success) {
+            return result;
         }
-
-        // Timeout or error occurred
-        attempt++;
         if (attempt < max_retries) {
             logger.warningf("I2CBridge: Write attempt %d failed for addr=0x%02X, retrying...", attempt, addr);
+            I2CBridgeStats::getInstance().countRetry(addr, CMD_I2C_WRITE);
             delay(1); // Small delay before retry
         }
     }
 
-    logger.warningf("I2CBridge: Write response timeout after %d attempts for addr=0x%02X", max_retries, addr);
-    result.error_code = I2C_ERROR_TIMEOUT;
+    logger.warningf("I2CBridge: Write failed after %d attempts for addr=0x%02X", max_retries, addr);
     return result;
 }
 
-I2CBridge::Result I2CBridge::writeReadBytes(uint8_t addr, uint8_t* writeData, uint8_t writeLen, uint8_t readLen) {
+I2CBridge::Result I2CBridge::writeChunked(uint8_t addr, const uint8_t* data, uint8_t len) {
     Result result = {false, I2C_ERROR_PENDING, {0}, 0};
-    
-    // Make sure the queue is empty before sending a new request
-    xQueueReset(_response_queue);
-    
-    // Log the write data
-    String writeHexData;
-    for (int i = 0; i < writeLen; i++) {
-        if (i > 0) writeHexData += " ";
-        char hex[4];
-        sprintf(hex, "%02X", writeData[i]);
-        writeHexData += hex;
-    }
+
+    // Chunks still waiting for their ack, oldest first
+    Handle window[I2C_WRITE_WINDOW];
+    uint8_t head = 0;
+    uint8_t in_flight = 0;
+    uint8_t offset = 0;
+    do {
+        // Fill the window, the last chunk is answered with the write result
+        while (offset < len && in_flight < I2C_WRITE_WINDOW) {
+            uint8_t chunk_len = (len - offset > I2C_WRITE_CHUNK_LEN) ? I2C_WRITE_CHUNK_LEN : len - offset;
+            window[(head + in_flight) % I2C_WRITE_WINDOW] = submitChunk(addr, data, offset, chunk_len, len);
+            offset += chunk_len;
+            in_flight++;
+        }
+
+        result = wait(window[head]);
+        head = (head + 1) % I2C_WRITE_WINDOW;
+        in_flight--;
+
+        const bool last = (offset == len && in_flight == 0);
+        if (last ? result.error_code == I2C_ERROR_PENDING : result.error_code != I2C_ERROR_PENDING) {
+            logger.warningf("I2CBridge: Chunked write to addr=0x%02X failed at offset %u of %u, status=%d", addr, offset, len, result.error_code);
+            while (in_flight > 0) {
+                cancel(window[head]);
+                head = (head + 1) % I2C_WRITE_WINDOW;
+                in_flight--;
+            }
+            result.success = false;
+            if (result.error_code == I2C_ERROR_NONE || result.error_code == I2C_ERROR_PENDING) {
+                result.error_code = I2C_ERROR_OTHER;
+            }
+            return result;
+        }
+    } while (in_flight > 0);
+
 #ifdef I2C_BRIDGE_DEBUG
-    logger.debugf("I2CBridge: Sending write-read request (addr=0x%02X, writeData=%s, readLen=%d)", 
-                 addr, writeHexData.c_str(), readLen);
+    logger.debugf("I2CBridge: Chunked write response received - addr=0x%02X, len=%u, status=%d", addr, len, result.error_code);
 #endif
-    // Send the write-read request to the Nano
-    send_i2c_write_read_request(addr, writeData, writeLen, readLen);
-    
-    // Wait for response with timeout
+    return result;
+}
+
+I2CBridge::Result I2CBridge::writeReadBytes(uint8_t addr, const uint8_t* writeData, uint8_t writeLen, uint8_t readLen) {
 #ifdef I2C_BRIDGE_DEBUG
     uint32_t start_time = millis();
 #endif
-    if (xQueueReceive(_response_queue, &result, pdMS_TO_TICKS(1000)) == pdTRUE) {
-        // Log the received data
-        if (result.data_len > 0) {
-            String readHexData;
-            for (int i = 0; i < result.data_len; i++) {
-                if (i > 0) readHexData += " ";
-                char hex[4];
-                sprintf(hex, "%02X", result.data[i]);
-                readHexData += hex;
-            }
+    Result result = wait(submitWriteRead(addr, writeData, writeLen, readLen));
 #ifdef I2C_BRIDGE_DEBUG
-            logger.debugf("I2CBridge: Write-read response received (%u ms round trip) - addr=0x%02X, status=%d, data=%s", 
-                         millis() - start_time, addr, result.error_code, readHexData.c_str());
+    logger.debugf("I2CBridge: Write-read response (%u ms round trip) - addr=0x%02X, reg=0x%02X, status=%d, %u bytes",
+                 millis() - start_time, addr, writeLen > 0 ? writeData[0] : 0, result.error_code, result.data_len);
 #endif
-        } 
-#ifdef I2C_BRIDGE_DEBUG
-        else if (result.error_code == I2C_ERROR_NONE) {
-            logger.debugf("I2CBridge: Write-read response received (%u ms round trip) - addr=0x%02X, status=%d, no data", 
-                         millis() - start_time, addr, result.error_code);
-        } else {
-            logger.debugf("I2CBridge: Failed Write-read response received (%u ms round trip) - addr=0x%02X, status=%d, no data", 
-                         millis() - start_time, addr, result.error_code);
+    return result;
+}
+
+I2CBridge::ScriptResult I2CBridge::runScript(const Script& script) {
+    if (!script.valid() || !nano_has_capability(PROTOCOL_CAP_I2C_SCRIPTS)) {
+        if (!script.valid()) {
+            logger.warningf("I2CBridge: Script for addr=0x%02X exceeds the I2C_SCRIPT_* limits", script._addr);
         }
-#endif
+        ScriptResult result = {};
+        result.error_code = script.valid() ? I2C_ERROR_OTHER : I2C_ERROR_BUF_LEN;
+        result.step_count = script._step_count;
+        memset(result.status, I2C_ERROR_PENDING, sizeof(result.status));
         return result;
     }
-#ifdef I2C_BRIDGE_DEBUG
-    else {
-        logger.debugf("I2CBridge: Failed Write-read response timeout (%u ms round trip) for addr=0x%02X, reg=0x%02X", 
-                  millis() - start_time, addr, writeLen > 0 ? writeData[0] : 0);
+    return waitScript(submitScript(script));
+}
+
+uint8_t I2CBridge::nextTransferId() {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const uint8_t xfer_id = _next_xfer_id++;
+    xSemaphoreGive(_mutex);
+    return xfer_id;
+}
+
+static bool transfer_fits(uint8_t reg, uint16_t len, bool fixed_reg) {
+    return len > 0 && len <= I2C_TRANSFER_MAX_LEN && (fixed_reg || reg + len <= 0x100);
+}
+
+I2CBridge::TransferResult I2CBridge::readBlock(uint8_t addr, uint8_t reg, uint8_t* out, uint16_t len, bool fixed_reg) {
+    TransferResult result = {false, I2C_ERROR_OTHER, 0};
+    if (_mutex == nullptr) {
+        return result;
+    }
+    if (!transfer_fits(reg, len, fixed_reg)) {
+        logger.warningf("I2CBridge: Block read of %u bytes at reg 0x%02X exceeds the I2C_TRANSFER_* limits", len, reg);
+        result.error_code = I2C_ERROR_BUF_LEN;
+        return result;
+    }
+    if (!nano_has_capability(PROTOCOL_CAP_I2C_TRANSFERS)) {
+        return result;
+    }
+
+    const BlockTarget target = {nextTransferId(), out, len};
+    char data_part[24];
+    snprintf(data_part, sizeof(data_part), "%c%X,%02X,%02X,%X,%X", CMD_I2C_READ_BLOCK, target.xfer_id, addr, reg, len,
+             fixed_reg ? I2C_TRANSFER_FIXED_REG : 0);
+    const uint16_t segments = (len + I2C_TRANSFER_READ_SEGMENT - 1) / I2C_TRANSFER_READ_SEGMENT;
+    const Handle handle = submit(addr, data_part, _timeout_ms + segments * I2C_TRANSFER_SEGMENT_MARGIN_MS, nullptr, &target);
+    if (!handle.valid()) {
+        return result;
+    }
+    if (!collect(handle, &result, sizeof(result))) {
+        logger.warningf("I2CBridge: Block read response timeout for request #%u", handle.request_id);
+        result = {false, I2C_ERROR_TIMEOUT, 0};
     }
+#ifdef I2C_BRIDGE_DEBUG
+    logger.debugf("I2CBridge: Block read - addr=0x%02X, reg=0x%02X, status=%d, %u of %u bytes", addr, reg, result.error_code, result.len, len);
 #endif
-    
-    // Timeout occurred
-    logger.warningf("I2CBridge: Write-read response timeout for addr=0x%02X, reg=0x%02X", 
-                  addr, writeLen > 0 ? writeData[0] : 0);
-    result.error_code = I2C_ERROR_TIMEOUT;
     return result;
 }
 
-void I2CBridge::processReadResponse(uint8_t status, uint8_t* data, uint8_t len) {
-    Result result;
-    result.success = (status == I2C_ERROR_NONE);
-    result.error_code = status;
-    result.data_len = len;
-    
-    if (len > 0 && len <= sizeof(result.data)) {
-        memcpy(result.data, data, len);
-    } else if (len > sizeof(result.data)) {
-        // Truncate if data is too large
-        memcpy(result.data, data, sizeof(result.data));
-        result.data_len = sizeof(result.data);
-        logger.warningf("I2CBridge: Truncated read response data from %d to %d bytes", len, result.data_len);
+I2CBridge::Handle I2CBridge::submitWriteSegment(uint8_t xfer_id, uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t offset, uint8_t len, uint16_t total, bool fixed_reg) {
+    char data_part[32 + I2C_TRANSFER_WRITE_SEGMENT * 2];
+    int written_len = snprintf(data_part, sizeof(data_part), "%c%X,%02X,%02X,%X,%X,%X,", CMD_I2C_WRITE_BLOCK, xfer_id, addr, reg,
+                               offset, total, fixed_reg ? I2C_TRANSFER_FIXED_REG : 0);
+    for (uint8_t i = 0; i < len; i++) {
+        written_len += snprintf(data_part + written_len, sizeof(data_part) - written_len, "%02X", data[offset + i]);
     }
-    
-    // Log the data being sent to the queue
-    if (result.data_len > 0) {
-        String hexData;
-        for (int i = 0; i < result.data_len; i++) {
-            if (i > 0) hexData += " ";
-            char hex[4];
-            sprintf(hex, "%02X", result.data[i]);
-            hexData += hex;
+    return submit(addr, data_part, _timeout_ms);
+}
+
+I2CBridge::TransferResult I2CBridge::writeBlock(uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t len, bool fixed_reg) {
+    TransferResult result = {false, I2C_ERROR_OTHER, 0};
+    if (_mutex == nullptr) {
+        return result;
+    }
+    if (!transfer_fits(reg, len, fixed_reg)) {
+        logger.warningf("I2CBridge: Block write of %u bytes at reg 0x%02X exceeds the I2C_TRANSFER_* limits", len, reg);
+        result.error_code = I2C_ERROR_BUF_LEN;
+        return result;
+    }
+    if (!nano_has_capability(PROTOCOL_CAP_I2C_TRANSFERS)) {
+        return result;
+    }
+
+    // Same credit scheme as writeChunked(), except the Nano writes every segment as it arrives
+    const uint8_t xfer_id = nextTransferId();
+    Handle window[I2C_WRITE_WINDOW];
+    uint8_t head = 0;
+    uint8_t in_flight = 0;
+    uint16_t offset = 0;
+    do {
+        while (offset < len && in_flight < I2C_WRITE_WINDOW) {
+            const uint8_t segment_len = (len - offset > I2C_TRANSFER_WRITE_SEGMENT) ? I2C_TRANSFER_WRITE_SEGMENT : len - offset;
+            window[(head + in_flight) % I2C_WRITE_WINDOW] = submitWriteSegment(xfer_id, addr, reg, data, offset, segment_len, len, fixed_reg);
+            offset += segment_len;
+            in_flight++;
         }
-#ifdef I2C_BRIDGE_DEBUG
-        logger.debugf("I2CBridge: Sending to queue - status: %d, data: %s", status, hexData.c_str());
-#endif
+
+        const Result ack = wait(window[head]);
+        head = (head + 1) % I2C_WRITE_WINDOW;
+        in_flight--;
+
+        const bool last = (offset == len && in_flight == 0);
+        if (ack.error_code != (last ? I2C_ERROR_NONE : I2C_ERROR_PENDING)) {
+            logger.warningf("I2CBridge: Block write to addr=0x%02X failed after %u of %u bytes, status=%d", addr, result.len, len, ack.error_code);
+            while (in_flight > 0) {
+                cancel(window[head]);
+                head = (head + 1) % I2C_WRITE_WINDOW;
+                in_flight--;
+            }
+            result.error_code = (ack.error_code == I2C_ERROR_NONE || ack.error_code == I2C_ERROR_PENDING) ? I2C_ERROR_OTHER : ack.error_code;
+            return result;
+        }
+        result.len = (len - result.len > I2C_TRANSFER_WRITE_SEGMENT) ? result.len + I2C_TRANSFER_WRITE_SEGMENT : len;
+    } while (in_flight > 0);
+
+    result.success = true;
+    result.error_code = I2C_ERROR_NONE;
+    return result;
+}
+
+bool I2CBridge::sendWatchCommand(uint8_t addr, const char* data_part) {
+    Result result = wait(submit(addr, data_part, _timeout_ms));
+    if (!result.success) {
+        logger.warningf("I2CBridge: %s rejected by the Nano, status=%d", data_part, result.error_code);
     }
-#ifdef I2C_BRIDGE_DEBUG
-    else {
-        logger.debugf("I2CBridge: Sending to queue - status: %d, no data", status);
+    return result.success;
+}
+
+int8_t I2CBridge::addWatch(const Watch& watch) {
+    if (!nano_has_capability(PROTOCOL_CAP_I2C_WATCH) || _mutex == nullptr) {
+        return -1;
     }
-#endif
-    
-    // Log I2C read response received from Nano
-    if (status != I2C_ERROR_NONE) {
-        logger.warningf("ESP32: Received I2C read error from Nano - status: %d, data_len: %d", status, len);
+    // Jobs registered before an ESP32 restart would push into the slots handed out below
+    if (!_watches_cleared) {
+        const char clear_all[] = { CMD_I2C_WATCH, '\0' };
+        if (!sendWatchCommand(0, clear_all)) {
+            return -1;
+        }
+        _watches_cleared = true;
     }
-    
-    // Send to queue for any waiting tasks
-    BaseType_t result_sent = xQueueSend(_response_queue, &result, 0);
-    if (result_sent != pdTRUE) {
-        logger.warning("I2CBridge: Failed to send response to queue");
+
+    int8_t id = -1;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (uint8_t i = 0; i < I2C_WATCH_SLOTS; i++) {
+        if (!_watches[i].used) {
+            id = i;
+            _watches[i].used = true;
+            _watches[i].fresh = false;
+            _watches[i].addr = watch.addr;
+            break;
+        }
     }
+    xSemaphoreGive(_mutex);
+    if (id < 0) {
+        logger.warningf("I2CBridge: No free watch slot for addr=0x%02X", watch.addr);
+        return -1;
+    }
+
+    char data_part[40];
+    snprintf(data_part, sizeof(data_part), "%c%X,%02X,%X,%02X,%02X,%02X,%02X,%X", CMD_I2C_WATCH, id,
+        watch.addr, watch.mode, watch.mask, watch.cond_reg, watch.reg, watch.len, watch.period_ms);
+    if (!sendWatchCommand(watch.addr, data_part)) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        _watches[id].used = false;
+        xSemaphoreGive(_mutex);
+        return -1;
+    }
+    return id;
 }
 
-void I2CBridge::processWriteResponse(uint8_t status) {
-    Result result;
-    result.success = (status == I2C_ERROR_NONE);
-    result.error_code = status;
-    result.data_len = 0;
-    
-    // Clear all data bytes to ensure clean state
-    memset(result.data, 0, sizeof(result.data));
+void I2CBridge::removeWatch(int8_t id) {
+    if (id < 0 || id >= I2C_WATCH_SLOTS || _mutex == nullptr) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _watches[id].used = false;
+    const uint8_t addr = _watches[id].addr;
+    xSemaphoreGive(_mutex);
+
+    char data_part[4];
+    snprintf(data_part, sizeof(data_part), "%c%X", CMD_I2C_WATCH, id);
+    sendWatchCommand(addr, data_part);
+}
+
+bool I2CBridge::takeWatchSample(int8_t id, WatchSample& sample) {
+    if (id < 0 || id >= I2C_WATCH_SLOTS || _mutex == nullptr) {
+        return false;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    WatchSlot& slot = _watches[id];
+    const bool fresh = slot.used && slot.fresh;
+    if (fresh) {
+        sample = slot.sample;
+        slot.fresh = false;
+    }
+    xSemaphoreGive(_mutex);
+    return fresh;
+}
+
+void I2CBridge::processWatchPush(uint8_t id, uint8_t status, const uint8_t* data, uint8_t len) {
+    if (_mutex == nullptr || id >= I2C_WATCH_SLOTS) {
+        return;
+    }
+    if (len > sizeof(WatchSample::data)) {
+        len = sizeof(WatchSample::data);
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    WatchSlot& slot = _watches[id];
+    if (slot.used) {
+        slot.sample.status = status;
+        slot.sample.data_len = len;
+        memcpy(slot.sample.data, data, len);
+        slot.sample.received_ms = millis();
+        slot.fresh = true;
+    }
+    const bool used = slot.used;
+    xSemaphoreGive(_mutex);
+
+    if (!used) {
+        logger.warningf("I2CBridge: Dropped push for unused watch %u", id);
+    } else if (status != I2C_ERROR_NONE) {
+        logger.warningf("ESP32: Received I2C watch error from Nano - watch: %u, status: %d", id, status);
+    }
+}
+
+I2CBridge::Pending* I2CBridge::find(uint8_t request_id, char response) {
+    // Untagged responses from tagging firmware belong to untracked commands
+    if (request_id == REQUEST_ID_NONE && nano_has_capability(PROTOCOL_CAP_REQUEST_IDS)) {
+        return nullptr;
+    }
+    Pending* match = nullptr;
+    for (uint8_t i = 0; i < I2C_PENDING_SLOTS; i++) {
+        Pending& pending = _pending[i];
+        if (!pending.used || pending.done || pending.response != response) {
+            continue;
+        }
+        if (request_id != REQUEST_ID_NONE) {
+            if (pending.request_id == request_id) {
+                return &pending;
+            }
+        } else if (match == nullptr || (int32_t)(pending.sequence - match->sequence) < 0) {
+            match = &pending;
+        }
+    }
+    return match;
+}
+
+void I2CBridge::finish(Pending* pending, uint8_t status) {
+    pending->done = true;
+    xSemaphoreGive(pending->done_sem);
+    const int64_t latency_us = esp_timer_get_time() - pending->submitted_us;
+    I2CBridgeStats::getInstance().record(pending->addr, pending->op, status, latency_us > 0 ? (uint32_t)latency_us : 0);
+}
+
+void I2CBridge::processScriptResponse(uint8_t request_id, const char* statuses, const uint8_t* data, uint8_t len) {
+    if (_mutex == nullptr) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Pending* pending = find(request_id, RSP_I2C_SCRIPT);
+    if (pending == nullptr) {
+        xSemaphoreGive(_mutex);
+        logger.warningf("I2CBridge: Dropped script response for unknown or cancelled request #%u", request_id);
+        return;
+    }
+
+    ScriptResult& result = pending->script;
+    memset(&result, 0, sizeof(result));
+    memset(result.status, I2C_ERROR_PENDING, sizeof(result.status));
+    result.success = true;
+    result.step_count = pending->script_steps;
+
+    uint8_t status_count = 0;
+    for (const char* c = statuses; *c && status_count < I2C_SCRIPT_MAX_STEPS; c++) {
+        const uint8_t status = (*c >= '0' && *c <= '9') ? *c - '0' : I2C_ERROR_OTHER;
+        result.status[status_count++] = status;
+        if (status != I2C_ERROR_NONE && result.success) {
+            result.success = false;
+            result.error_code = status;
+        }
+    }
+
+    // A script rejected before it ran is answered with a single status
+    if (status_count != pending->script_steps) {
+        memset(result.status, I2C_ERROR_PENDING, sizeof(result.status));
+        result.success = false;
+        if (result.error_code == I2C_ERROR_NONE) {
+            result.error_code = I2C_ERROR_OTHER;
+        }
+    } else {
+        uint8_t expected_len = 0;
+        for (uint8_t i = 0; i < pending->script_steps; i++) {
+            result.offset[i] = expected_len;
+            if (result.status[i] == I2C_ERROR_NONE) {
+                expected_len += pending->step_read[i];
+            }
+        }
+        if (len != expected_len) {
+            result.success = false;
+            result.error_code = I2C_ERROR_OTHER;
+        } else {
+            memcpy(result.data, data, len);
+            result.data_len = len;
+        }
+    }
+    finish(pending, result.error_code);
+    const bool success = result.success;
+    const uint8_t error_code = result.error_code;
+    xSemaphoreGive(_mutex);
+
+    if (!success) {
+        logger.warningf("ESP32: Received I2C script error from Nano - status: %d", error_code);
+    }
+}
+
+void I2CBridge::processSegment(uint8_t xfer_id, uint16_t offset, const uint8_t* data, uint8_t len) {
+    if (_mutex == nullptr) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Pending* pending = nullptr;
+    for (uint8_t i = 0; i < I2C_PENDING_SLOTS; i++) {
+        if (_pending[i].used && !_pending[i].done && _pending[i].is_transfer && _pending[i].xfer_id == xfer_id) {
+            pending = &_pending[i];
+            break;
+        }
+    }
+    bool gap = false;
+    uint16_t expected = 0;
+    if (pending != nullptr) {
+        TransferResult& transfer = pending->transfer;
+        // Segments arrive in order, anything else means one was lost on the link
+        expected = transfer.len;
+        gap = offset != expected || offset + len > pending->transfer_len;
+        if (gap) {
+            transfer.error_code = I2C_ERROR_OTHER;
+        } else if (transfer.error_code == I2C_ERROR_PENDING) {
+            memcpy(pending->transfer_out + offset, data, len);
+            transfer.len += len;
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    if (pending == nullptr) {
+        logger.warningf("I2CBridge: Dropped segment of unknown or cancelled transfer %u", xfer_id);
+    } else if (gap) {
+        logger.warningf("I2CBridge: Transfer %u got offset %u, expected %u", xfer_id, offset, expected);
+    }
+}
+
+void I2CBridge::processReadBlockResponse(uint8_t request_id, uint8_t status, uint16_t len) {
+    if (_mutex == nullptr) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Pending* pending = find(request_id, RSP_I2C_READ_BLOCK);
+    if (pending != nullptr) {
+        TransferResult& transfer = pending->transfer;
+        const bool complete = transfer.error_code == I2C_ERROR_PENDING && transfer.len == len;
+        if (status != I2C_ERROR_NONE) {
+            transfer.error_code = status;
+        } else if (!complete || len != pending->transfer_len) {
+            transfer.error_code = I2C_ERROR_OTHER;
+        } else {
+            transfer.error_code = I2C_ERROR_NONE;
+        }
+        transfer.success = (transfer.error_code == I2C_ERROR_NONE);
+        finish(pending, transfer.error_code);
+    }
+    xSemaphoreGive(_mutex);
+
+    if (pending == nullptr) {
+        logger.warningf("I2CBridge: Dropped block read response for unknown or cancelled request #%u", request_id);
+    } else if (status != I2C_ERROR_NONE) {
+        logger.warningf("ESP32: Received I2C block read error from Nano - status: %d, %u bytes sent", status, len);
+    }
+}
+
+void I2CBridge::processReadResponse(uint8_t request_id, uint8_t status, uint8_t* data, uint8_t len) {
+    if (_mutex == nullptr) {
+        return;
+    }
+    if (len > sizeof(Result::data)) {
+        logger.warningf("I2CBridge: Truncated read response data from %d to %d bytes", len, sizeof(Result::data));
+        len = sizeof(Result::data);
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Pending* pending = find(request_id, RSP_I2C_READ);
+    if (pending != nullptr) {
+        Result& result = pending->result;
+        result.success = (status == I2C_ERROR_NONE);
+        result.error_code = status;
+        result.data_len = len;
+        memcpy(result.data, data, len);
+        finish(pending, status);
+    }
+    xSemaphoreGive(_mutex);
+
+    if (pending == nullptr) {
+        logger.warningf("I2CBridge: Dropped read response for unknown or cancelled request #%u", request_id);
+    } else if (status != I2C_ERROR_NONE) {
+        logger.warningf("ESP32: Received I2C read error from Nano - status: %d, data_len: %d", status, len);
+    }
 #ifdef I2C_BRIDGE_DEBUG
-    logger.debugf("I2CBridge: Sending write response to queue - status: %d", status);
+    logger.debugf("I2CBridge: Read response for #%u - status: %d, %u bytes", request_id, status, len);
 #endif
-    
-    // Log I2C write response received from Nano
-    if (status != I2C_ERROR_NONE) {
-        logger.warningf("ESP32: Received I2C write error from Nano - status: %d", status);
+}
+
+void I2CBridge::processWriteResponse(uint8_t request_id, char response, uint8_t status) {
+    if (_mutex == nullptr) {
+        return;
     }
-    
-    // Send to queue for any waiting tasks
-    BaseType_t result_sent = xQueueSend(_response_queue, &result, 0);
-    if (result_sent != pdTRUE) {
-        logger.warning("I2CBridge: Failed to send write response to queue");
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Pending* pending = find(request_id, response);
+    if (pending != nullptr) {
+        Result& result = pending->result;
+        result.success = (status == I2C_ERROR_NONE);
+        result.error_code = status;
+        result.data_len = 0;
+        memset(result.data, 0, sizeof(result.data));
+        finish(pending, status);
     }
+    xSemaphoreGive(_mutex);
+
+    if (pending == nullptr) {
+        logger.warningf("I2CBridge: Dropped %c response for unknown or cancelled request #%u", response, request_id);
+    } else if (status != I2C_ERROR_NONE && status != I2C_ERROR_PENDING) {
+        logger.warningf("ESP32: Received I2C write error from Nano - status: %d", status);
+    }
+#ifdef I2C_BRIDGE_DEBUG
+    logger.debugf("I2CBridge: Write response for #%u - status: %d", request_id, status);
+#endif
 }
 
 // C-style functions for the HAL implementation
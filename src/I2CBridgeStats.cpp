@@ -0,0 +1,219 @@
+#include "I2CBridgeStats.h"
+
+static const char* const error_names[I2C_STATS_ERROR_CODES] = { "addr_nack", "data_nack", "other", "bus_timeout", "buf_len" };
+
+I2CBridgeStats::I2CBridgeStats() {
+    for (uint8_t i = 0; i < I2C_STATS_SLOTS; i++) {
+        _entries[i].key = 0;
+    }
+    reset();
+}
+
+I2CBridgeStats::Entry* I2CBridgeStats::entryFor(uint8_t addr, char op) {
+    const uint16_t key = ((uint16_t)addr << 8) | (uint8_t)op;
+    for (uint8_t i = 0; i < I2C_STATS_SLOTS; i++) {
+        Entry& entry = _entries[i];
+        uint16_t current = entry.key.load(std::memory_order_acquire);
+        if (current == 0) {
+            // Another task may claim the slot first, then it is checked again like any other
+            if (entry.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                return &entry;
+            }
+        }
+        if (current == key) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void I2CBridgeStats::record(uint8_t addr, char op, uint8_t status, uint32_t latency_us) {
+    Entry* entry = entryFor(addr, op);
+    if (entry == nullptr) {
+        return;
+    }
+    entry->count.fetch_add(1, std::memory_order_relaxed);
+    if (status != I2C_ERROR_NONE && status != I2C_ERROR_PENDING) {
+        const uint8_t index = (status <= I2C_STATS_ERROR_CODES) ? status - 1 : I2C_ERROR_OTHER - 1;
+        entry->errors[index].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    entry->latency_sum_us.fetch_add(latency_us, std::memory_order_relaxed);
+    entry->buckets[NanoLinkMetrics::bucketOf(latency_us)].fetch_add(1, std::memory_order_relaxed);
+    uint32_t min_us = entry->latency_min_us.load(std::memory_order_relaxed);
+    while (latency_us < min_us && !entry->latency_min_us.compare_exchange_weak(min_us, latency_us, std::memory_order_relaxed)) {
+    }
+    uint32_t max_us = entry->latency_max_us.load(std::memory_order_relaxed);
+    while (latency_us > max_us && !entry->latency_max_us.compare_exchange_weak(max_us, latency_us, std::memory_order_relaxed)) {
+    }
+}
+
+void I2CBridgeStats::countTimeout(uint8_t addr, char op) {
+    Entry* entry = entryFor(addr, op);
+    if (entry != nullptr) {
+        entry->timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void I2CBridgeStats::countRetry(uint8_t addr, char op) {
+    Entry* entry = entryFor(addr, op);
+    if (entry != nullptr) {
+        entry->retries.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Slots stay with their pair, a transaction completing meanwhile may survive in part
+void I2CBridgeStats::reset() {
+    for (uint8_t i = 0; i < I2C_STATS_SLOTS; i++) {
+        Entry& entry = _entries[i];
+        entry.count = 0;
+        entry.retries = 0;
+        entry.timeouts = 0;
+        for (uint8_t code = 0; code < I2C_STATS_ERROR_CODES; code++) {
+            entry.errors[code] = 0;
+        }
+        entry.latency_min_us = UINT32_MAX;
+        entry.latency_max_us = 0;
+        entry.latency_sum_us = 0;
+        for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+            entry.buckets[bucket] = 0;
+        }
+    }
+    _since = millis();
+}
+
+const char* I2CBridgeStats::opName(char op) {
+    switch (op) {
+        case CMD_I2C_READ:        return "read";
+        case CMD_I2C_WRITE:       return "write";
+        case CMD_I2C_WRITE_CHUNK: return "write_chunk";
+        case CMD_I2C_SCRIPT:      return "script";
+        case CMD_I2C_WATCH:       return "watch";
+        case CMD_I2C_READ_BLOCK:  return "read_block";
+        case CMD_I2C_WRITE_BLOCK: return "write_block";
+        default:                  return "other";
+    }
+}
+
+// Upper bound of the bucket holding the percentile, never above the slowest sample
+uint32_t I2CBridgeStats::percentileUs(const uint32_t* buckets, uint32_t count, uint32_t max_us, uint8_t percent) {
+    if (count == 0) {
+        return 0;
+    }
+    const uint32_t rank = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            const uint32_t upper = NanoLinkMetrics::bucketUpperUs(bucket);
+            return upper < max_us ? upper : max_us;
+        }
+    }
+    return max_us;
+}
+
+I2CBridgeStats::Summary I2CBridgeStats::summary() {
+    Summary summary = {};
+    uint32_t buckets[NANO_LATENCY_BUCKETS] = {0};
+    uint32_t latency_count = 0;
+    uint32_t max_us = 0;
+
+    // Bus time per address, summed over its operations
+    uint8_t addrs[I2C_STATS_SLOTS];
+    uint64_t busy_us[I2C_STATS_SLOTS];
+    uint8_t addr_count = 0;
+    uint64_t total_busy_us = 0;
+
+    for (uint8_t i = 0; i < I2C_STATS_SLOTS; i++) {
+        Entry& entry = _entries[i];
+        const uint16_t key = entry.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+        const uint32_t count = entry.count.load(std::memory_order_relaxed);
+        summary.transactions += count;
+        summary.timeouts += entry.timeouts.load(std::memory_order_relaxed);
+        summary.retries += entry.retries.load(std::memory_order_relaxed);
+        for (uint8_t code = 0; code < I2C_STATS_ERROR_CODES; code++) {
+            summary.errors += entry.errors[code].load(std::memory_order_relaxed);
+        }
+        for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+            const uint32_t samples = entry.buckets[bucket].load(std::memory_order_relaxed);
+            buckets[bucket] += samples;
+            latency_count += samples;
+        }
+        const uint32_t entry_max_us = entry.latency_max_us.load(std::memory_order_relaxed);
+        if (entry_max_us > max_us) {
+            max_us = entry_max_us;
+        }
+
+        const uint8_t addr = key >> 8;
+        const uint64_t sum_us = entry.latency_sum_us.load(std::memory_order_relaxed);
+        total_busy_us += sum_us;
+        uint8_t slot = 0;
+        while (slot < addr_count && addrs[slot] != addr) {
+            slot++;
+        }
+        if (slot == addr_count) {
+            addrs[addr_count] = addr;
+            busy_us[addr_count++] = 0;
+        }
+        busy_us[slot] += sum_us;
+    }
+
+    summary.latency_p99_us = percentileUs(buckets, latency_count, max_us, 99);
+    uint8_t busiest = 0;
+    for (uint8_t slot = 1; slot < addr_count; slot++) {
+        if (busy_us[slot] > busy_us[busiest]) {
+            busiest = slot;
+        }
+    }
+    if (total_busy_us > 0) {
+        summary.busiest_addr = addrs[busiest];
+        summary.busiest_percent = busy_us[busiest] * 100 / total_busy_us;
+    }
+    return summary;
+}
+
+void I2CBridgeStats::writeJson(String& out) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "{\"since_ms\":%lu,\"uptime_ms\":%lu,\"devices\":[", _since.load(), millis());
+    out += buffer;
+
+    bool first = true;
+    for (uint8_t i = 0; i < I2C_STATS_SLOTS; i++) {
+        Entry& entry = _entries[i];
+        const uint16_t key = entry.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+
+        // Counters may move while they are read, a transaction completing meanwhile shows up in part
+        uint32_t buckets[NANO_LATENCY_BUCKETS];
+        uint32_t latency_count = 0;
+        for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+            buckets[bucket] = entry.buckets[bucket].load(std::memory_order_relaxed);
+            latency_count += buckets[bucket];
+        }
+        const uint32_t min_us = entry.latency_min_us.load(std::memory_order_relaxed);
+        const uint32_t max_us = entry.latency_max_us.load(std::memory_order_relaxed);
+        const uint64_t sum_us = entry.latency_sum_us.load(std::memory_order_relaxed);
+        const uint32_t average_us = latency_count ? (uint32_t)(sum_us / latency_count) : 0;
+
+        snprintf(buffer, sizeof(buffer), "%s{\"addr\":\"0x%02X\",\"op\":\"%s\",\"count\":%lu,\"retries\":%lu,\"timeouts\":%lu,\"errors\":{",
+            first ? "" : ",", key >> 8, opName((char)(key & 0xFF)), (unsigned long)entry.count.load(std::memory_order_relaxed),
+            (unsigned long)entry.retries.load(std::memory_order_relaxed), (unsigned long)entry.timeouts.load(std::memory_order_relaxed));
+        out += buffer;
+        first = false;
+        for (uint8_t code = 0; code < I2C_STATS_ERROR_CODES; code++) {
+            snprintf(buffer, sizeof(buffer), "%s\"%s\":%lu", code ? "," : "", error_names[code],
+                (unsigned long)entry.errors[code].load(std::memory_order_relaxed));
+            out += buffer;
+        }
+        snprintf(buffer, sizeof(buffer), "},\"busy_ms\":%lu,\"latency\":{\"min_us\":%lu,\"avg_us\":%lu,\"max_us\":%lu,\"p99_us\":%lu}}",
+            (unsigned long)(sum_us / 1000), (unsigned long)(latency_count ? min_us : 0), (unsigned long)average_us,
+            (unsigned long)max_us, (unsigned long)percentileUs(buckets, latency_count, max_us, 99));
+        out += buffer;
+    }
+    out += "]}";
+}
@@ -0,0 +1,145 @@
+#include "I2CBus.h"
+#include <string.h>
+
+I2CBus::Script& I2CBus::Script::write(const uint8_t* data, uint8_t len) {
+    return add(I2C_SCRIPT_OP_WRITE, data, len, 0);
+}
+
+I2CBus::Script& I2CBus::Script::read(uint8_t len) {
+    return add(I2C_SCRIPT_OP_READ, nullptr, 0, len);
+}
+
+I2CBus::Script& I2CBus::Script::writeRead(const uint8_t* data, uint8_t write_len, uint8_t read_len) {
+    return add(I2C_SCRIPT_OP_WRITE_READ, data, write_len, read_len);
+}
+
+I2CBus::Script& I2CBus::Script::delayMs(uint8_t ms) {
+    return add(I2C_SCRIPT_OP_DELAY, nullptr, 0, ms);
+}
+
+I2CBus::Script& I2CBus::Script::add(char op, const uint8_t* data, uint8_t write_len, uint8_t read_len) {
+    const bool reads = (op == I2C_SCRIPT_OP_READ || op == I2C_SCRIPT_OP_WRITE_READ);
+    const bool writes = (op == I2C_SCRIPT_OP_WRITE || op == I2C_SCRIPT_OP_WRITE_READ);
+    // ",<op>" and every byte of the step as two hex digits, a read length counts as one byte
+    const uint8_t command_len = 2 + 2 * (write_len + (writes ? 0 : 1) + (op == I2C_SCRIPT_OP_WRITE_READ ? 1 : 0));
+
+    if (_step_count >= I2C_SCRIPT_MAX_STEPS ||
+        write_len > I2C_SCRIPT_MAX_WRITE || (writes && write_len == 0) ||
+        (reads && (read_len == 0 || read_len > I2C_SCRIPT_MAX_STEP_READ || _read_total + read_len > I2C_SCRIPT_MAX_READ)) ||
+        _command_len + command_len > I2C_SCRIPT_MAX_CMD_LEN) {
+        _valid = false;
+        return *this;
+    }
+
+    Step& step = _steps[_step_count++];
+    step.op = op;
+    step.write_len = write_len;
+    step.read_len = read_len;
+    if (write_len > 0) {
+        memcpy(step.write, data, write_len);
+    }
+    _command_len += command_len;
+    if (reads) {
+        _read_total += read_len;
+    } else if (op == I2C_SCRIPT_OP_DELAY) {
+        _delay_total_ms += read_len;
+    }
+    return *this;
+}
+
+I2CBus::ScriptResult I2CBus::rejectScript(const Script& script) {
+    ScriptResult result = {};
+    result.error_code = I2C_ERROR_BUF_LEN;
+    result.step_count = script._step_count;
+    memset(result.status, I2C_ERROR_PENDING, sizeof(result.status));
+    return result;
+}
+
+I2CBus::ScriptResult I2CBus::runScript(const Script& script) {
+    if (!script.valid()) {
+        return rejectScript(script);
+    }
+
+    ScriptResult result = {};
+    result.success = true;
+    result.step_count = script._step_count;
+    memset(result.status, I2C_ERROR_PENDING, sizeof(result.status));
+
+    for (uint8_t i = 0; i < script._step_count; i++) {
+        const Script::Step& step = script._steps[i];
+        result.offset[i] = result.data_len;
+
+        Result step_result = {true, I2C_ERROR_NONE, {0}, 0};
+        switch (step.op) {
+            case I2C_SCRIPT_OP_WRITE:
+                step_result = write(script._addr, step.write, step.write_len);
+                break;
+            case I2C_SCRIPT_OP_READ:
+                step_result = read(script._addr, step.read_len);
+                break;
+            case I2C_SCRIPT_OP_WRITE_READ:
+                step_result = writeRead(script._addr, step.write, step.write_len, step.read_len);
+                break;
+            case I2C_SCRIPT_OP_DELAY:
+                sleepMs(step.read_len);
+                break;
+        }
+
+        if (step_result.success && step.op != I2C_SCRIPT_OP_WRITE && step.op != I2C_SCRIPT_OP_DELAY &&
+            step_result.data_len != step.read_len) {
+            step_result.success = false;
+            step_result.error_code = I2C_ERROR_DATA_NACK;
+        }
+        result.status[i] = step_result.success ? I2C_ERROR_NONE : step_result.error_code;
+        if (!step_result.success) {
+            result.success = false;
+            result.error_code = step_result.error_code;
+            break;
+        }
+        memcpy(result.data + result.data_len, step_result.data, step_result.data_len);
+        result.data_len += step_result.data_len;
+    }
+    return result;
+}
+
+I2CBus::TransferResult I2CBus::readBlock(uint8_t addr, uint8_t reg, uint8_t* out, uint16_t len, bool fixed_reg) {
+    TransferResult result = {true, I2C_ERROR_NONE, 0};
+    if (!transferFits(reg, len, fixed_reg)) {
+        return {false, I2C_ERROR_BUF_LEN, 0};
+    }
+    while (result.len < len) {
+        const uint8_t segment_len = ((size_t)(len - result.len) > sizeof(Result::data)) ? sizeof(Result::data) : len - result.len;
+        const uint8_t segment_reg = fixed_reg ? reg : reg + result.len;
+        const Result segment = writeRead(addr, &segment_reg, 1, segment_len);
+        if (!segment.success || segment.data_len != segment_len) {
+            result.success = false;
+            result.error_code = segment.success ? I2C_ERROR_DATA_NACK : segment.error_code;
+            break;
+        }
+        memcpy(out + result.len, segment.data, segment_len);
+        result.len += segment_len;
+    }
+    return result;
+}
+
+I2CBus::TransferResult I2CBus::writeBlock(uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t len, bool fixed_reg) {
+    TransferResult result = {true, I2C_ERROR_NONE, 0};
+    if (!transferFits(reg, len, fixed_reg)) {
+        return {false, I2C_ERROR_BUF_LEN, 0};
+    }
+    // The register byte and as much data as the bridge takes in one write
+    uint8_t segment[I2C_WRITE_MAX_LEN];
+    while (result.len < len) {
+        const uint8_t segment_len = ((size_t)(len - result.len) > sizeof(segment) - 1) ? sizeof(segment) - 1 : len - result.len;
+        segment[0] = fixed_reg ? reg : reg + result.len;
+        memcpy(segment + 1, data + result.len, segment_len);
+        const Result written = write(addr, segment, segment_len + 1);
+        if (!written.success) {
+            result.success = false;
+            result.error_code = written.error_code;
+            break;
+        }
+        result.len += segment_len;
+    }
+    return result;
+}
@@ -0,0 +1,167 @@
+#include "I2CBuses.h"
+#include "I2CRegisterCache.h"
+#include "Logger.h"
+
+static const char* const device_names[I2C_DEVICE_COUNT] = { "ZMOD4510", "BMP280", "AHT20" };
+
+uint8_t I2CBuses::_direct_devices = 0;
+
+// --- I2CBridgeBus ---
+
+I2CBus::Result I2CBridgeBus::read(uint8_t addr, uint8_t len) {
+    return I2CBridge::readBytes(addr, len);
+}
+
+I2CBus::Result I2CBridgeBus::write(uint8_t addr, const uint8_t* data, uint8_t len) {
+    return I2CBridge::writeBytes(addr, data, len);
+}
+
+I2CBus::Result I2CBridgeBus::writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) {
+    return I2CBridge::writeReadBytes(addr, write_data, write_len, read_len);
+}
+
+I2CBus::ScriptResult I2CBridgeBus::runScript(const Script& script) {
+    if (script.valid() && !nano_has_capability(PROTOCOL_CAP_I2C_SCRIPTS)) {
+        return I2CBus::runScript(script);
+    }
+    return I2CBridge::runScript(script);
+}
+
+I2CBus::TransferResult I2CBridgeBus::readBlock(uint8_t addr, uint8_t reg, uint8_t* out, uint16_t len, bool fixed_reg) {
+    if (!nano_has_capability(PROTOCOL_CAP_I2C_TRANSFERS)) {
+        return I2CBus::readBlock(addr, reg, out, len, fixed_reg);
+    }
+    return I2CBridge::readBlock(addr, reg, out, len, fixed_reg);
+}
+
+I2CBus::TransferResult I2CBridgeBus::writeBlock(uint8_t addr, uint8_t reg, const uint8_t* data, uint16_t len, bool fixed_reg) {
+    if (!nano_has_capability(PROTOCOL_CAP_I2C_TRANSFERS)) {
+        return I2CBus::writeBlock(addr, reg, data, len, fixed_reg);
+    }
+    return I2CBridge::writeBlock(addr, reg, data, len, fixed_reg);
+}
+
+bool I2CBridgeBus::loadConstant(uint8_t addr, uint16_t reg, uint8_t* out, uint8_t len) {
+    return I2CRegisterCache::getInstance().load(addr, reg, out, len);
+}
+
+void I2CBridgeBus::storeConstant(uint8_t addr, uint16_t reg, const uint8_t* data, uint8_t len) {
+    I2CRegisterCache::getInstance().store(addr, reg, data, len);
+}
+
+int8_t I2CBridgeBus::addWatch(const Watch& watch) {
+    return I2CBridge::addWatch(watch);
+}
+
+void I2CBridgeBus::removeWatch(int8_t id) {
+    I2CBridge::removeWatch(id);
+}
+
+bool I2CBridgeBus::takeWatchSample(int8_t id, WatchSample& sample) {
+    return I2CBridge::takeWatchSample(id, sample);
+}
+
+void I2CBridgeBus::sleepMs(uint16_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// --- WireI2CBus ---
+
+bool WireI2CBus::begin() {
+    // Returns early when the touch controller or the ZMOD4510 HAL started it already
+    if (!_wire.begin(I2C_WIRE_SDA_PIN, I2C_WIRE_SCL_PIN, I2C_WIRE_FREQUENCY)) {
+        logger.error("WireI2CBus: Failed to start the ESP32 I2C controller");
+        return false;
+    }
+    _wire.setTimeOut(I2C_WIRE_TIMEOUT_MS);
+    return true;
+}
+
+uint8_t WireI2CBus::statusOf(uint8_t wire_error) {
+    switch (wire_error) {
+        case 0:  return I2C_ERROR_NONE;
+        case 1:  return I2C_ERROR_BUF_LEN;
+        case 2:  return I2C_ERROR_ADDR_NACK;
+        case 3:  return I2C_ERROR_DATA_NACK;
+        case 5:  return I2C_ERROR_TIMEOUT;
+        default: return I2C_ERROR_OTHER;
+    }
+}
+
+void WireI2CBus::requestInto(uint8_t addr, uint8_t len, Result& result) {
+    const uint8_t received = _wire.requestFrom(addr, len, (uint8_t)true);
+    if (received == 0) {
+        result = failed(I2C_ERROR_ADDR_NACK);
+        return;
+    }
+    result = {true, I2C_ERROR_NONE, {0}, 0};
+    while (_wire.available() && result.data_len < len) {
+        result.data[result.data_len++] = _wire.read();
+    }
+    if (result.data_len != len) {
+        result.success = false;
+        result.error_code = I2C_ERROR_DATA_NACK;
+    }
+}
+
+I2CBus::Result WireI2CBus::read(uint8_t addr, uint8_t len) {
+    if (len == 0 || len > sizeof(Result::data)) {
+        return failed(I2C_ERROR_BUF_LEN);
+    }
+    Result result;
+    requestInto(addr, len, result);
+    return result;
+}
+
+I2CBus::Result WireI2CBus::write(uint8_t addr, const uint8_t* data, uint8_t len) {
+    _wire.beginTransmission(addr);
+    if (len > 0 && _wire.write(data, len) != len) {
+        _wire.endTransmission();
+        return failed(I2C_ERROR_BUF_LEN);
+    }
+    const uint8_t status = statusOf(_wire.endTransmission());
+    return {status == I2C_ERROR_NONE, status, {0}, 0};
+}
+
+I2CBus::Result WireI2CBus::writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) {
+    if (write_len == 0) {
+        return read(addr, read_len);
+    }
+    if (read_len == 0 || read_len > sizeof(Result::data)) {
+        return failed(I2C_ERROR_BUF_LEN);
+    }
+    _wire.beginTransmission(addr);
+    _wire.write(write_data, write_len);
+    // No stop, the read follows with a repeated start
+    const uint8_t status = statusOf(_wire.endTransmission(false));
+    if (status != I2C_ERROR_NONE) {
+        return failed(status);
+    }
+    Result result;
+    requestInto(addr, read_len, result);
+    return result;
+}
+
+void WireI2CBus::sleepMs(uint16_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// --- I2CBuses ---
+
+void I2CBuses::begin(uint8_t direct_devices) {
+    _direct_devices = direct_devices & ((1 << I2C_DEVICE_COUNT) - 1);
+    if (_direct_devices != 0 && !WireI2CBus::getInstance().begin()) {
+        logger.error("I2CBuses: Sensors stay on the bridge");
+        _direct_devices = 0;
+    }
+    for (uint8_t device = 0; device < I2C_DEVICE_COUNT; device++) {
+        logger.infof("I2CBuses: %s on the %s bus", device_names[device], forDevice((I2CDevice)device).name());
+    }
+}
+
+I2CBus& I2CBuses::forDevice(I2CDevice device) {
+    if (device < I2C_DEVICE_COUNT && (_direct_devices & (1 << device))) {
+        return WireI2CBus::getInstance();
+    }
+    return I2CBridgeBus::getInstance();
+}
@@ -0,0 +1,104 @@
+#include "I2CRegisterCache.h"
+#include "Logger.h"
+
+const char* I2CRegisterCache::NVS_NAMESPACE = "i2c-cache";
+const char* I2CRegisterCache::KEY_ENTRIES = "entries";
+
+I2CRegisterCache::I2CRegisterCache() : _nvs_ready(false), _hits(0), _misses(0) {
+    _mutex = xSemaphoreCreateMutexStatic(&_mutexBuffer);
+    memset(_entries, 0, sizeof(_entries));
+}
+
+void I2CRegisterCache::begin() {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _nvs_ready = _preferences.begin(NVS_NAMESPACE, false);
+    if (!_nvs_ready) {
+        logger.error("I2CRegisterCache: Failed to open NVS, cached registers last until reboot");
+    } else if (_preferences.getBytesLength(KEY_ENTRIES) == sizeof(_entries)) {
+        // A blob of another size was written by firmware with a different Entry layout
+        _preferences.getBytes(KEY_ENTRIES, _entries, sizeof(_entries));
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < I2C_REGISTER_CACHE_ENTRIES; i++) {
+            if (_entries[i].used) {
+                count++;
+            }
+        }
+        logger.infof("I2CRegisterCache: %u register blocks restored from NVS", count);
+    }
+    xSemaphoreGive(_mutex);
+}
+
+I2CRegisterCache::Entry* I2CRegisterCache::find(uint8_t addr, uint16_t reg, uint8_t len) {
+    for (uint8_t i = 0; i < I2C_REGISTER_CACHE_ENTRIES; i++) {
+        Entry& entry = _entries[i];
+        if (entry.used && entry.addr == addr && entry.reg == reg && entry.len == len) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool I2CRegisterCache::load(uint8_t addr, uint16_t reg, uint8_t* out, uint8_t len) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const Entry* entry = find(addr, reg, len);
+    if (entry != nullptr) {
+        memcpy(out, entry->data, len);
+        _hits++;
+    } else {
+        _misses++;
+    }
+    xSemaphoreGive(_mutex);
+    return entry != nullptr;
+}
+
+void I2CRegisterCache::store(uint8_t addr, uint16_t reg, const uint8_t* data, uint8_t len) {
+    if (len == 0 || len > I2C_REGISTER_CACHE_MAX_LEN) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Entry* entry = find(addr, reg, len);
+    if (entry != nullptr && memcmp(entry->data, data, len) == 0) {
+        // Unchanged, spare the flash
+        xSemaphoreGive(_mutex);
+        return;
+    }
+    for (uint8_t i = 0; entry == nullptr && i < I2C_REGISTER_CACHE_ENTRIES; i++) {
+        if (!_entries[i].used) {
+            entry = &_entries[i];
+        }
+    }
+    if (entry == nullptr) {
+        logger.warningf("I2CRegisterCache: Table full, 0x%02X register 0x%X is not cached", addr, reg);
+    } else {
+        memset(entry, 0, sizeof(Entry));
+        entry->used = 1;
+        entry->addr = addr;
+        entry->reg = reg;
+        entry->len = len;
+        memcpy(entry->data, data, len);
+        persist();
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void I2CRegisterCache::invalidate(const char* reason) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    bool had_entries = false;
+    for (uint8_t i = 0; i < I2C_REGISTER_CACHE_ENTRIES; i++) {
+        had_entries |= (_entries[i].used != 0);
+    }
+    if (had_entries) {
+        memset(_entries, 0, sizeof(_entries));
+        if (_nvs_ready) {
+            _preferences.remove(KEY_ENTRIES);
+        }
+        logger.infof("I2CRegisterCache: Cleared, %s", reason);
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void I2CRegisterCache::persist() {
+    if (_nvs_ready && _preferences.putBytes(KEY_ENTRIES, _entries, sizeof(_entries)) != sizeof(_entries)) {
+        logger.warning("I2CRegisterCache: Failed to write NVS");
+    }
+}
@@ -0,0 +1,114 @@
+#include "MockI2CBus.h"
+#include <string.h>
+
+MockI2CBus::MockI2CBus() : _transactions(0), _slept_ms(0) {
+    memset(_devices, 0, sizeof(_devices));
+}
+
+bool MockI2CBus::addDevice(uint8_t addr) {
+    if (registers(addr) != nullptr) {
+        return true;
+    }
+    for (uint8_t i = 0; i < MOCK_I2C_DEVICES; i++) {
+        if (!_devices[i].used) {
+            memset(&_devices[i], 0, sizeof(Device));
+            _devices[i].used = true;
+            _devices[i].addr = addr;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t* MockI2CBus::registers(uint8_t addr) {
+    for (uint8_t i = 0; i < MOCK_I2C_DEVICES; i++) {
+        if (_devices[i].used && _devices[i].addr == addr) {
+            return _devices[i].regs;
+        }
+    }
+    return nullptr;
+}
+
+void MockI2CBus::failNext(uint8_t addr, uint8_t error_code, uint8_t count) {
+    for (uint8_t i = 0; i < MOCK_I2C_DEVICES; i++) {
+        if (_devices[i].used && _devices[i].addr == addr) {
+            _devices[i].fail_code = error_code;
+            _devices[i].fail_count = count;
+        }
+    }
+}
+
+void MockI2CBus::fixReadPointer(uint8_t addr, uint8_t reg) {
+    for (uint8_t i = 0; i < MOCK_I2C_DEVICES; i++) {
+        if (_devices[i].used && _devices[i].addr == addr) {
+            _devices[i].fixed_read = true;
+            _devices[i].read_reg = reg;
+        }
+    }
+}
+
+MockI2CBus::Device* MockI2CBus::begin(uint8_t addr, uint8_t& error) {
+    _transactions++;
+    error = I2C_ERROR_ADDR_NACK;
+    for (uint8_t i = 0; i < MOCK_I2C_DEVICES; i++) {
+        Device& device = _devices[i];
+        if (!device.used || device.addr != addr) {
+            continue;
+        }
+        if (device.fail_count > 0) {
+            device.fail_count--;
+            error = device.fail_code;
+            return nullptr;
+        }
+        error = I2C_ERROR_NONE;
+        return &device;
+    }
+    return nullptr;
+}
+
+void MockI2CBus::store(Device& device, const uint8_t* data, uint8_t len) {
+    if (len > 0) {
+        device.pointer = data[0];
+        for (uint8_t i = 1; i < len; i++) {
+            device.regs[device.pointer++] = data[i];
+        }
+    }
+}
+
+I2CBus::Result MockI2CBus::load(Device& device, uint8_t len) {
+    Result result = {true, I2C_ERROR_NONE, {0}, len};
+    for (uint8_t i = 0; i < len; i++) {
+        result.data[i] = device.regs[device.pointer++];
+    }
+    return result;
+}
+
+I2CBus::Result MockI2CBus::read(uint8_t addr, uint8_t len) {
+    return writeRead(addr, nullptr, 0, len);
+}
+
+I2CBus::Result MockI2CBus::write(uint8_t addr, const uint8_t* data, uint8_t len) {
+    uint8_t error;
+    Device* device = begin(addr, error);
+    if (device == nullptr) {
+        return failed(error);
+    }
+    store(*device, data, len);
+    return {true, I2C_ERROR_NONE, {0}, 0};
+}
+
+I2CBus::Result MockI2CBus::writeRead(uint8_t addr, const uint8_t* write_data, uint8_t write_len, uint8_t read_len) {
+    if (read_len > sizeof(Result::data)) {
+        return failed(I2C_ERROR_BUF_LEN);
+    }
+    uint8_t error;
+    Device* device = begin(addr, error);
+    if (device == nullptr) {
+        return failed(error);
+    }
+    store(*device, write_data, write_len);
+    if (device->fixed_read) {
+        device->pointer = device->read_reg;
+    }
+    return load(*device, read_len);
+}
@@ -0,0 +1,83 @@
+#include "NanoClockSync.h"
+
+// Nano timestamps are whole milliseconds, delays this close to the best one
+// are as good as the resolution allows
+#define NANO_CLOCK_DELAY_SLACK_US   2000
+#define NANO_CLOCK_MAX_DELAY_US     1000000 // Exchanges slower than this are dropped
+#define NANO_CLOCK_MIN_DRIFT_SPAN_MS 10000  // Samples must span this long to estimate drift
+
+void NanoClockSync::reset() {
+    _count = 0;
+    _head = 0;
+    _anchorLocalUs = 0;
+    _anchorNanoMs = 0;
+    _anchorDelayUs = 0;
+    _rate = 1.0;
+}
+
+void NanoClockSync::addSample(int64_t t1_us, uint32_t t2_ms, uint32_t t3_ms, int64_t t4_us) {
+    const int64_t round_trip_us = t4_us - t1_us;
+    const int64_t nano_busy_us = (int64_t)(int32_t)(t3_ms - t2_ms) * 1000;
+    if (round_trip_us < 0 || round_trip_us > NANO_CLOCK_MAX_DELAY_US || nano_busy_us < 0) {
+        return;
+    }
+    // Millisecond rounding on the Nano can make the difference negative
+    const int64_t delay_us = (round_trip_us > nano_busy_us) ? round_trip_us - nano_busy_us : 0;
+
+    Sample& sample = _samples[_head];
+    sample.local_us = t1_us + round_trip_us / 2;
+    sample.nano_ms = t2_ms + (t3_ms - t2_ms) / 2;
+    sample.delay_us = (uint32_t)delay_us;
+    _head = (_head + 1) % NANO_CLOCK_SYNC_SAMPLES;
+    if (_count < NANO_CLOCK_SYNC_SAMPLES) {
+        _count++;
+    }
+    update();
+}
+
+void NanoClockSync::update() {
+    const Sample* anchor = &_samples[0];
+    for (uint8_t i = 1; i < _count; i++) {
+        if (_samples[i].delay_us < anchor->delay_us) {
+            anchor = &_samples[i];
+        }
+    }
+    _anchorLocalUs = anchor->local_us;
+    _anchorNanoMs = anchor->nano_ms;
+    _anchorDelayUs = anchor->delay_us;
+
+    // Least squares slope through the anchor, Nano ms over ESP32 ms
+    double sum_xx = 0.0;
+    double sum_xy = 0.0;
+    double span_ms = 0.0;
+    for (uint8_t i = 0; i < _count; i++) {
+        const Sample& sample = _samples[i];
+        if (sample.delay_us > anchor->delay_us + NANO_CLOCK_DELAY_SLACK_US) {
+            continue;
+        }
+        const double x = (sample.local_us - anchor->local_us) / 1000.0;
+        const double y = (int32_t)(sample.nano_ms - anchor->nano_ms);
+        sum_xx += x * x;
+        sum_xy += x * y;
+        if (fabs(x) > span_ms) {
+            span_ms = fabs(x);
+        }
+    }
+    if (span_ms < NANO_CLOCK_MIN_DRIFT_SPAN_MS) {
+        return; // Keep the previous estimate
+    }
+
+    const double max_drift = NANO_CLOCK_MAX_DRIFT_PPM / 1e6;
+    _rate = constrain(sum_xy / sum_xx, 1.0 - max_drift, 1.0 + max_drift);
+}
+
+bool NanoClockSync::toLocalMillis(uint32_t nano_ms, unsigned long& local_ms) const {
+    if (_count == 0) {
+        return false;
+    }
+    // Relative to the anchor so millis() wrapping on the Nano does not matter
+    const int32_t nano_elapsed_ms = (int32_t)(nano_ms - _anchorNanoMs);
+    const int64_t local_us = _anchorLocalUs + (int64_t)(nano_elapsed_ms * 1000.0 / _rate);
+    local_ms = (unsigned long)(local_us / 1000);
+    return true;
+}
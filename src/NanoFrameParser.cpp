@@ -0,0 +1,167 @@
+#include "NanoFrameParser.h"
+#include <stdlib.h>
+
+NanoFrameParser::NanoFrameParser() {
+    reset();
+}
+
+void NanoFrameParser::reset() {
+    state = State::IDLE;
+    last_error = Error::NONE;
+    error_byte = 0;
+    ascii_len = 0;
+    ascii_data_len = 0;
+    ascii_buffer[0] = '\0';
+    last_comma = -1;
+    crc8 = 0;
+    crc8_at_last_comma = 0;
+    binary_len = 0;
+    binary_encoded_len = 0;
+    cobs_remaining = 0;
+    cobs_zero_pending = false;
+    crc16 = 0xFFFF;
+}
+
+const char* NanoFrameParser::errorToString(Error error) {
+    switch (error) {
+        case Error::NONE: return "None";
+        case Error::UNEXPECTED_CHAR: return "Invalid character received";
+        case Error::ASCII_OVERFLOW: return "Packet too long";
+        case Error::NO_CHECKSUM: return "Malformed packet (no checksum comma)";
+        case Error::CHECKSUM_MISMATCH: return "Checksum mismatch";
+        case Error::BINARY_OVERFLOW: return "Binary frame overflow";
+        case Error::COBS_MALFORMED: return "Malformed binary frame";
+        case Error::BINARY_TOO_SHORT: return "Binary frame too short";
+        case Error::CRC_MISMATCH: return "Binary frame CRC mismatch";
+        default: return "Unknown";
+    }
+}
+
+NanoFrameParser::Result NanoFrameParser::fail(Error error, uint8_t byte) {
+    last_error = error;
+    error_byte = byte;
+    // Skip the rest of a broken binary frame instead of reporting every byte
+    state = (state == State::BINARY) ? State::DISCARD : State::IDLE;
+    return Result::ERROR;
+}
+
+NanoFrameParser::Result NanoFrameParser::feed(uint8_t byte) {
+    if (byte == BINARY_FRAME_DELIMITER) {
+        if (state == State::BINARY && binary_encoded_len > 0) {
+            // Trailing delimiter
+            Result result = finishBinary();
+            state = State::IDLE;
+            return result;
+        }
+        // Leading delimiter, also aborts any partial ASCII packet
+        state = State::BINARY;
+        binary_len = 0;
+        binary_encoded_len = 0;
+        cobs_remaining = 0;
+        cobs_zero_pending = false;
+        crc16 = 0xFFFF;
+        return Result::NONE;
+    }
+
+    switch (state) {
+        case State::BINARY:
+            return feedBinary(byte);
+        case State::DISCARD:
+            return Result::NONE;
+        default:
+            break;
+    }
+
+    // Line endings are not part of ASCII packets
+    if (byte == '\r' || byte == '\n') {
+        return Result::NONE;
+    }
+
+    if (state == State::IDLE) {
+        if (byte != '<') {
+            return fail(Error::UNEXPECTED_CHAR, byte);
+        }
+        state = State::ASCII;
+        ascii_len = 0;
+        last_comma = -1;
+        crc8 = 0;
+        crc8_at_last_comma = 0;
+        return Result::NONE;
+    }
+
+    return feedAscii(byte);
+}
+
+NanoFrameParser::Result NanoFrameParser::feedAscii(uint8_t byte) {
+    if (byte == '>') {
+        ascii_buffer[ascii_len] = '\0';
+        if (ascii_len == 0) {
+            state = State::IDLE;
+            return Result::NONE;
+        }
+        if (last_comma < 0) {
+            return fail(Error::NO_CHECKSUM, byte);
+        }
+        uint8_t received_checksum = atoi(ascii_buffer + last_comma + 1);
+        if (received_checksum != crc8_at_last_comma) {
+            return fail(Error::CHECKSUM_MISMATCH, received_checksum);
+        }
+        ascii_buffer[last_comma] = '\0';
+        ascii_data_len = last_comma;
+        state = State::IDLE;
+        return Result::ASCII_FRAME;
+    }
+
+    if (ascii_len >= MAX_ASCII_LEN) {
+        return fail(Error::ASCII_OVERFLOW, byte);
+    }
+
+    if (byte == ',') {
+        crc8_at_last_comma = crc8;
+        last_comma = ascii_len;
+    }
+    crc8 = crc8_update(crc8, byte);
+    ascii_buffer[ascii_len++] = byte;
+    return Result::NONE;
+}
+
+NanoFrameParser::Result NanoFrameParser::feedBinary(uint8_t byte) {
+    binary_encoded_len++;
+
+    if (cobs_remaining == 0) {
+        // Code byte: closes the previous block and opens the next one
+        if (cobs_zero_pending) {
+            if (binary_len >= sizeof(binary_buffer)) {
+                return fail(Error::BINARY_OVERFLOW, byte);
+            }
+            if (binary_len >= 2) crc16 = crc16_update(crc16, binary_buffer[binary_len - 2]);
+            binary_buffer[binary_len++] = 0;
+        }
+        cobs_remaining = byte - 1;
+        cobs_zero_pending = (byte != 0xFF);
+        return Result::NONE;
+    }
+
+    if (binary_len >= sizeof(binary_buffer)) {
+        return fail(Error::BINARY_OVERFLOW, byte);
+    }
+    if (binary_len >= 2) crc16 = crc16_update(crc16, binary_buffer[binary_len - 2]);
+    binary_buffer[binary_len++] = byte;
+    cobs_remaining--;
+    return Result::NONE;
+}
+
+NanoFrameParser::Result NanoFrameParser::finishBinary() {
+    // The zero implied by the last block is the frame delimiter itself
+    if (cobs_remaining != 0) {
+        return fail(Error::COBS_MALFORMED, 0);
+    }
+    if (binary_len < BINARY_FRAME_HEADER_LEN + 2) {
+        return fail(Error::BINARY_TOO_SHORT, 0);
+    }
+    uint16_t received_crc = binary_buffer[binary_len - 2] | (binary_buffer[binary_len - 1] << 8);
+    if (received_crc != crc16) {
+        return fail(Error::CRC_MISMATCH, binary_buffer[0]);
+    }
+    return Result::BINARY_FRAME;
+}
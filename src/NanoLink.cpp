@@ -0,0 +1,210 @@
+#include "NanoLink.h"
+#include <esp_timer.h>
+#include "Logger.h"
+#include "NanoLinkMetrics.h"
+
+#ifdef SERIAL_OUT_DEBUG
+static_assert(NANO_UART_PORT != UART_NUM_0, "SERIAL_OUT_DEBUG writes to UART0, which is configured as the Nano link");
+#endif
+
+bool NanoLink::begin() {
+    if (_taskHandle != nullptr) {
+        return true;
+    }
+
+    const uart_config_t uart_config = {
+        .baud_rate = NANO_UART_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .rx_flow_ctrl_thresh = 0,
+    };
+
+    if (uart_driver_install(NANO_UART_PORT, NANO_UART_RX_BUFFER_SIZE, 0, NANO_UART_EVENT_QUEUE_LEN, &_uartEventQueue, 0) != ESP_OK) {
+        logger.error("NanoLink: Failed to install UART driver");
+        return false;
+    }
+    uart_param_config(NANO_UART_PORT, &uart_config);
+    uart_set_pin(NANO_UART_PORT, NANO_UART_TX_PIN, NANO_UART_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    uart_set_rx_full_threshold(NANO_UART_PORT, NANO_UART_RX_FIFO_FULL_THRESH);
+    uart_set_rx_timeout(NANO_UART_PORT, NANO_UART_RX_TIMEOUT_SYMBOLS);
+
+    // '>' ends every ASCII packet. Binary frames end with 0x00 and are
+    // picked up by the RX timeout once the line goes idle.
+    uart_enable_pattern_det_baud_intr(NANO_UART_PORT, ASCII_PACKET_END, 1, 9, 0, 0);
+    uart_pattern_queue_reset(NANO_UART_PORT, NANO_UART_EVENT_QUEUE_LEN);
+
+    for (uint8_t channel = 0; channel < PROTOCOL_CHANNEL_COUNT; channel++) {
+        if (_channelHandlers[channel] != nullptr) {
+            continue;
+        }
+        _frameQueues[channel] = xQueueCreate(NANO_FRAME_QUEUE_LEN, sizeof(NanoFrame));
+        if (_frameQueues[channel] == nullptr) {
+            logger.error("NanoLink: Failed to create frame queue");
+            return false;
+        }
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        taskFunction,
+        "NanoRxTask",
+        NANO_RX_TASK_STACK_SIZE,
+        this,
+        NANO_RX_TASK_PRIORITY,
+        &_taskHandle,
+        xPortGetCoreID()      // Core ID (use running core to avoid executing on WIFI core)
+    );
+    if (result != pdPASS) {
+        logger.error("NanoLink: Failed to create RX task");
+        _taskHandle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool NanoLink::receive(NanoFrame& frame) {
+    for (uint8_t channel = 0; channel < PROTOCOL_CHANNEL_COUNT; channel++) {
+        if (_frameQueues[channel] != nullptr && xQueueReceive(_frameQueues[channel], &frame, 0) == pdTRUE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void NanoLink::setChannelHandler(uint8_t channel, ChannelHandler handler) {
+    if (channel < PROTOCOL_CHANNEL_COUNT) {
+        _channelHandlers[channel] = handler;
+    }
+}
+
+void NanoLink::write(const uint8_t* data, size_t len) {
+    if (xSemaphoreTake(_writeMutex, portMAX_DELAY) == pdTRUE) {
+        uart_write_bytes(NANO_UART_PORT, reinterpret_cast<const char*>(data), len);
+        xSemaphoreGive(_writeMutex);
+    }
+}
+
+void NanoLink::setBaudRate(uint32_t baud) {
+    if (xSemaphoreTake(_writeMutex, portMAX_DELAY) == pdTRUE) {
+        uart_wait_tx_done(NANO_UART_PORT, pdMS_TO_TICKS(100));
+        uart_set_baudrate(NANO_UART_PORT, baud);
+        uart_flush_input(NANO_UART_PORT);
+        _baudRate = baud;
+        _parserResetPending = true;
+        xSemaphoreGive(_writeMutex);
+    }
+}
+
+void NanoLink::taskFunction(void* parameter) {
+    static_cast<NanoLink*>(parameter)->taskLoop();
+}
+
+void NanoLink::taskLoop() {
+    uart_event_t event;
+    for (;;) {
+        if (xQueueReceive(_uartEventQueue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        switch (event.type) {
+            case UART_PATTERN_DET:
+                // Everything buffered is read below, the positions are not needed
+                while (uart_pattern_pop_pos(NANO_UART_PORT) != -1) {}
+                drainRx();
+                break;
+            case UART_DATA:
+                drainRx();
+                break;
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                logger.warning("NanoLink: UART RX overflow, flushing input");
+                NanoLinkMetrics::getInstance().count(0, NanoLinkMetrics::FRAMING_ERRORS);
+                uart_flush_input(NANO_UART_PORT);
+                uart_pattern_queue_reset(NANO_UART_PORT, NANO_UART_EVENT_QUEUE_LEN);
+                xQueueReset(_uartEventQueue);
+                _parser.reset();
+                break;
+            case UART_FRAME_ERR:
+            case UART_PARITY_ERR:
+                _errorCount++;
+                NanoLinkMetrics::getInstance().count(0, NanoLinkMetrics::FRAMING_ERRORS);
+                logger.warningf("NanoLink: UART line error (%d)", event.type);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void NanoLink::drainRx() {
+    if (_parserResetPending) {
+        _parserResetPending = false;
+        _parser.reset();
+    }
+
+    uint8_t chunk[64];
+    size_t available = 0;
+    uart_get_buffered_data_len(NANO_UART_PORT, &available);
+
+    while (available > 0) {
+        int read_len = uart_read_bytes(NANO_UART_PORT, chunk, available < sizeof(chunk) ? available : sizeof(chunk), 0);
+        if (read_len <= 0) {
+            break;
+        }
+        for (int i = 0; i < read_len; i++) {
+            NanoFrameParser::Result result = _parser.feed(chunk[i]);
+            if (result != NanoFrameParser::Result::NONE) {
+                publishFrame(result);
+            }
+        }
+        available -= read_len;
+    }
+}
+
+void NanoLink::publishFrame(NanoFrameParser::Result result) {
+    if (result == NanoFrameParser::Result::ERROR) {
+        _errorCount++;
+        NanoLinkMetrics& metrics = NanoLinkMetrics::getInstance();
+        if (_parser.error() == NanoFrameParser::Error::CHECKSUM_MISMATCH) {
+            // The letter may be the corrupted byte, unknown ones land in the "other" slot
+            uint8_t request_id;
+            metrics.count(ascii_packet_split_request_id(_parser.asciiData(), &request_id)[0], NanoLinkMetrics::CRC_ERRORS);
+            logger.warningf("Checksum mismatch! Rcvd: %s", _parser.asciiData());
+        } else {
+            if (_parser.error() == NanoFrameParser::Error::CRC_MISMATCH) {
+                metrics.count(_parser.errorByte(), NanoLinkMetrics::CRC_ERRORS); // Error byte is the frame type
+            } else {
+                metrics.count(0, NanoLinkMetrics::FRAMING_ERRORS);
+            }
+            logger.warningf("%s (0x%02X)", NanoFrameParser::errorToString(_parser.error()), _parser.errorByte());
+        }
+        return;
+    }
+
+    NanoFrame frame;
+    frame.received_us = esp_timer_get_time();
+    if (result == NanoFrameParser::Result::ASCII_FRAME) {
+        frame.kind = NanoFrame::ASCII;
+        frame.type = 0;
+        const char* data = ascii_packet_split_request_id(_parser.asciiData(), &frame.request_id);
+        frame.length = _parser.asciiLength() - (data - _parser.asciiData());
+        memcpy(frame.data, data, frame.length + 1);
+    } else {
+        frame.kind = NanoFrame::BINARY;
+        frame.type = _parser.frameType();
+        frame.request_id = _parser.frameRequestId();
+        frame.length = _parser.payloadLength();
+        memcpy(frame.data, _parser.payload(), frame.length);
+    }
+
+    const char type = (frame.kind == NanoFrame::ASCII) ? frame.data[0] : frame.type;
+    frame.channel = protocol_channel_of(type);
+    NanoLinkMetrics::getInstance().count(type, NanoLinkMetrics::FRAMES);
+
+    if (_channelHandlers[frame.channel] != nullptr) {
+        _channelHandlers[frame.channel](frame);
+    } else if (xQueueSend(_frameQueues[frame.channel], &frame, 0) != pdTRUE) {
+        logger.warningf("NanoLink: Channel %u queue full, dropping frame", frame.channel);
+    }
+}
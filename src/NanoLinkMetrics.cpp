@@ -0,0 +1,211 @@
+#include "NanoLinkMetrics.h"
+
+static const char* const counter_names[NanoLinkMetrics::COUNTER_COUNT] = {
+#define X(name, json) json,
+    NANO_LINK_COUNTER_LIST
+#undef X
+};
+
+static const char* const channel_names[] = { "bridge", "event", "control", "telemetry" };
+static_assert(sizeof(channel_names) / sizeof(channel_names[0]) == PROTOCOL_CHANNEL_COUNT, "channel_names must cover every PROTOCOL_CHANNEL_*");
+
+static const uint8_t json_percentiles[] = { 50, 90, 99 };
+
+NanoLinkMetrics::NanoLinkMetrics() {
+    _mutex = xSemaphoreCreateMutexStatic(&_mutexBuffer);
+    memset(&_data, 0, sizeof(_data));
+    memset(&_snapshot, 0, sizeof(_snapshot));
+}
+
+uint8_t NanoLinkMetrics::slotOf(char type) {
+    return (type >= 'a' && type <= 'z') ? type - 'a' : NANO_METRICS_OTHER_SLOT;
+}
+
+uint8_t NanoLinkMetrics::bucketOf(uint32_t latency_us) {
+    if (latency_us < (1UL << NANO_LATENCY_MIN_SHIFT)) {
+        return 0;
+    }
+    const uint8_t msb = 31 - __builtin_clz(latency_us);
+    const uint8_t group = msb - NANO_LATENCY_MIN_SHIFT;
+    if (group >= NANO_LATENCY_GROUPS) {
+        return NANO_LATENCY_BUCKETS - 1;
+    }
+    const uint8_t sub = (latency_us >> (msb - NANO_LATENCY_SUB_BITS)) & ((1 << NANO_LATENCY_SUB_BITS) - 1);
+    return 1 + (group << NANO_LATENCY_SUB_BITS) + sub;
+}
+
+uint32_t NanoLinkMetrics::bucketUpperUs(uint8_t bucket) {
+    if (bucket == 0) {
+        return 1UL << NANO_LATENCY_MIN_SHIFT;
+    }
+    if (bucket >= NANO_LATENCY_BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    const uint8_t group = (bucket - 1) >> NANO_LATENCY_SUB_BITS;
+    const uint8_t sub = (bucket - 1) & ((1 << NANO_LATENCY_SUB_BITS) - 1);
+    const uint8_t msb = group + NANO_LATENCY_MIN_SHIFT;
+    return (uint32_t)((1 << NANO_LATENCY_SUB_BITS) + sub + 1) << (msb - NANO_LATENCY_SUB_BITS);
+}
+
+// Upper bound of the bucket holding the percentile, never above the slowest sample
+uint32_t NanoLinkMetrics::percentileUs(const Histogram& histogram, uint8_t percent) {
+    if (histogram.count == 0) {
+        return 0;
+    }
+    uint32_t rank = (uint32_t)(((uint64_t)histogram.count * percent + 99) / 100);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+        seen += histogram.buckets[bucket];
+        if (seen >= rank) {
+            const uint32_t upper = bucketUpperUs(bucket);
+            return upper < histogram.max_us ? upper : histogram.max_us;
+        }
+    }
+    return histogram.max_us;
+}
+
+void NanoLinkMetrics::count(char type, Counter counter, uint32_t amount) {
+    if (counter >= COUNTER_COUNT || amount == 0) {
+        return;
+    }
+    if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        _data.types[slotOf(type)].counters[counter] += amount;
+        xSemaphoreGive(_mutex);
+    }
+}
+
+void NanoLinkMetrics::recordLatency(char type, uint32_t latency_us) {
+    if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        TypeMetrics& metrics = _data.types[slotOf(type)];
+        metrics.latency_count++;
+        metrics.latency_sum_us += latency_us;
+        if (latency_us > metrics.latency_max_us) {
+            metrics.latency_max_us = latency_us;
+        }
+
+        Histogram& histogram = _data.latency[protocol_channel_of(type)];
+        histogram.buckets[bucketOf(latency_us)]++;
+        histogram.count++;
+        if (latency_us > histogram.max_us) {
+            histogram.max_us = latency_us;
+        }
+        xSemaphoreGive(_mutex);
+    }
+}
+
+void NanoLinkMetrics::reset() {
+    if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        memset(&_data, 0, sizeof(_data));
+        _data.since = millis();
+        xSemaphoreGive(_mutex);
+    }
+}
+
+// Copies under the lock so formatting does not hold up the RX task
+void NanoLinkMetrics::takeSnapshot() {
+    if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        memcpy(&_snapshot, &_data, sizeof(_snapshot));
+        xSemaphoreGive(_mutex);
+    }
+}
+
+NanoLinkMetrics::Summary NanoLinkMetrics::summary() {
+    takeSnapshot();
+
+    Summary summary = {};
+    for (uint8_t slot = 0; slot < NANO_METRICS_TYPE_SLOTS; slot++) {
+        const uint32_t* counters = _snapshot.types[slot].counters;
+        summary.frames += counters[FRAMES];
+        summary.errors += counters[CRC_ERRORS] + counters[FRAMING_ERRORS];
+        summary.timeouts += counters[TIMEOUTS];
+        summary.duplicates += counters[DUPLICATES];
+        summary.gaps += counters[GAPS];
+    }
+
+    // All channels merged into the first histogram of the snapshot
+    Histogram& merged = _snapshot.latency[0];
+    for (uint8_t channel = 1; channel < PROTOCOL_CHANNEL_COUNT; channel++) {
+        const Histogram& histogram = _snapshot.latency[channel];
+        for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+            merged.buckets[bucket] += histogram.buckets[bucket];
+        }
+        merged.count += histogram.count;
+        if (histogram.max_us > merged.max_us) {
+            merged.max_us = histogram.max_us;
+        }
+    }
+    summary.latency_p50_us = percentileUs(merged, 50);
+    summary.latency_p99_us = percentileUs(merged, 99);
+    summary.latency_max_us = merged.max_us;
+    return summary;
+}
+
+void NanoLinkMetrics::writeJson(String& out) {
+    takeSnapshot();
+
+    char buffer[96];
+    snprintf(buffer, sizeof(buffer), "{\"since_ms\":%lu,\"uptime_ms\":%lu,\"types\":{", _snapshot.since, millis());
+    out += buffer;
+
+    bool first = true;
+    for (uint8_t slot = 0; slot < NANO_METRICS_TYPE_SLOTS; slot++) {
+        const TypeMetrics& metrics = _snapshot.types[slot];
+        bool used = metrics.latency_count > 0;
+        for (uint8_t counter = 0; counter < COUNTER_COUNT; counter++) {
+            used |= metrics.counters[counter] > 0;
+        }
+        if (!used) {
+            continue;
+        }
+
+        if (slot == NANO_METRICS_OTHER_SLOT) {
+            snprintf(buffer, sizeof(buffer), "%s\"other\":{", first ? "" : ",");
+        } else {
+            snprintf(buffer, sizeof(buffer), "%s\"%c\":{", first ? "" : ",", 'a' + slot);
+        }
+        out += buffer;
+        first = false;
+        for (uint8_t counter = 0; counter < COUNTER_COUNT; counter++) {
+            snprintf(buffer, sizeof(buffer), "\"%s\":%lu,", counter_names[counter], (unsigned long)metrics.counters[counter]);
+            out += buffer;
+        }
+        const uint32_t average_us = metrics.latency_count ? (uint32_t)(metrics.latency_sum_us / metrics.latency_count) : 0;
+        snprintf(buffer, sizeof(buffer), "\"latency\":{\"count\":%lu,\"avg_us\":%lu,\"max_us\":%lu}}",
+            (unsigned long)metrics.latency_count, (unsigned long)average_us, (unsigned long)metrics.latency_max_us);
+        out += buffer;
+    }
+
+    out += "},\"latency\":{";
+    for (uint8_t channel = 0; channel < PROTOCOL_CHANNEL_COUNT; channel++) {
+        const Histogram& histogram = _snapshot.latency[channel];
+        snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"count\":%lu,\"max_us\":%lu",
+            channel ? "," : "", channel_names[channel], (unsigned long)histogram.count, (unsigned long)histogram.max_us);
+        out += buffer;
+        for (uint8_t i = 0; i < sizeof(json_percentiles); i++) {
+            snprintf(buffer, sizeof(buffer), ",\"p%u_us\":%lu", json_percentiles[i], (unsigned long)percentileUs(histogram, json_percentiles[i]));
+            out += buffer;
+        }
+
+        // Non-empty buckets only, as [upper bound in us, count]. The last one is open ended.
+        out += ",\"buckets\":[";
+        bool first_bucket = true;
+        for (uint8_t bucket = 0; bucket < NANO_LATENCY_BUCKETS; bucket++) {
+            if (histogram.buckets[bucket] == 0) {
+                continue;
+            }
+            const uint32_t upper = bucketUpperUs(bucket);
+            if (upper == UINT32_MAX) {
+                snprintf(buffer, sizeof(buffer), "%s[null,%lu]", first_bucket ? "" : ",", (unsigned long)histogram.buckets[bucket]);
+            } else {
+                snprintf(buffer, sizeof(buffer), "%s[%lu,%lu]", first_bucket ? "" : ",", (unsigned long)upper, (unsigned long)histogram.buckets[bucket]);
+            }
+            out += buffer;
+            first_bucket = false;
+        }
+        out += "]}";
+    }
+    out += "}}";
+}
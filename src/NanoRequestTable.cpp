@@ -0,0 +1,102 @@
+#include "NanoRequestTable.h"
+#include <esp_timer.h>
+#include "NanoCommands.h"
+
+NanoRequestTable::NanoRequestTable() : nextId(1) {
+    memset(used, 0, sizeof(used));
+    mutex = xSemaphoreCreateMutexStatic(&mutexBuffer);
+}
+
+uint8_t NanoRequestTable::add(char cmd, unsigned long timeout_ms) {
+    uint8_t id = REQUEST_ID_NONE;
+    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t i = 0; i < NANO_REQUEST_TABLE_SIZE; i++) {
+            if (!used[i]) {
+                id = nextId;
+                nextId = (nextId == 0xFF) ? 1 : nextId + 1;
+                entries[i].id = id;
+                entries[i].cmd = cmd;
+                entries[i].sent_time = millis();
+                entries[i].deadline = entries[i].sent_time + timeout_ms;
+                entries[i].sent_us = esp_timer_get_time();
+                used[i] = true;
+                break;
+            }
+        }
+        xSemaphoreGive(mutex);
+    }
+    return id;
+}
+
+bool NanoRequestTable::complete(uint8_t request_id, char response, Entry& out) {
+    bool found = false;
+    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+        int match = -1;
+        for (uint8_t i = 0; i < NANO_REQUEST_TABLE_SIZE; i++) {
+            if (!used[i]) continue;
+            if (request_id != REQUEST_ID_NONE) {
+                if (entries[i].id == request_id) {
+                    match = i;
+                    break;
+                }
+            } else if (protocol_response_for(entries[i].cmd) == response) {
+                // Oldest request for this letter
+                if (match < 0 || (long)(entries[i].sent_time - entries[match].sent_time) < 0) {
+                    match = i;
+                }
+            }
+        }
+        if (match >= 0) {
+            out = entries[match];
+            used[match] = false;
+            found = true;
+        }
+        xSemaphoreGive(mutex);
+    }
+    return found;
+}
+
+bool NanoRequestTable::popExpired(unsigned long now, Entry& out) {
+    bool found = false;
+    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t i = 0; i < NANO_REQUEST_TABLE_SIZE; i++) {
+            if (used[i] && (long)(now - entries[i].deadline) >= 0) {
+                out = entries[i];
+                used[i] = false;
+                found = true;
+                break;
+            }
+        }
+        xSemaphoreGive(mutex);
+    }
+    return found;
+}
+
+uint8_t NanoRequestTable::pendingCount() {
+    return countPending(true);
+}
+
+uint8_t NanoRequestTable::pendingLoopCount() {
+    return countPending(false);
+}
+
+uint8_t NanoRequestTable::countPending(bool include_bridge) {
+    uint8_t count = 0;
+    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t i = 0; i < NANO_REQUEST_TABLE_SIZE; i++) {
+            if (!used[i]) continue;
+            if (include_bridge || protocol_channel_of(protocol_response_for(entries[i].cmd)) != PROTOCOL_CHANNEL_BRIDGE) {
+                count++;
+            }
+        }
+        xSemaphoreGive(mutex);
+    }
+    return count;
+}
+
+void NanoRequestTable::clear() {
+    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+        memset(used, 0, sizeof(used));
+        xSemaphoreGive(mutex);
+    }
+}
@@ -2,6 +2,8 @@
 #include "Logger.h"
 #include "SerialMutex.h"
 #include "I2CBridge.h"
+#include "I2CBuses.h"
+#include "ConfigManager.h"
 
 SensorTask::SensorTask() 
     : latestZMOD4510Values(),
@@ -39,6 +41,12 @@ void SensorTask::init() {
     
     // Initialize I2CBridge
     I2CBridge::getInstance().begin();
+
+    // Ahead of the managers, their sensors take the bus when first constructed
+    {
+        ConfigManagerAccessor config;
+        I2CBuses::begin(config->getI2cDirectDevices());
+    }
     
     // Initialize managers (simple initialization that cannot fail)
     ZMOD4510Manager::getInstance().init();
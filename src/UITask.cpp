@@ -78,6 +78,10 @@ const UITask::UIUpdateFunc UITask::updateTable[UI_MSG_COUNT] = {
     [](IUIUpdater* u, const UIMessage& m) { u->update_scd30_forcecal(m.value.i); },
     // UI_LAST_PACKET_TIME
     [](IUIUpdater* u, const UIMessage& m) { u->update_last_packet_time(m.value.i); },
+    // UI_LINK_ERRORS
+    [](IUIUpdater* u, const UIMessage& m) { u->update_link_errors(m.value.i); },
+    // UI_LINK_LATENCY
+    [](IUIUpdater* u, const UIMessage& m) { u->update_link_latency(m.value.i); },
     // UI_RUNTIME_FREE_HEAP
     [](IUIUpdater* u, const UIMessage& m) { u->update_runtime_free_heap(m.value.i); },
     // UI_RUNTIME_UPTIME
@@ -292,6 +296,12 @@ void UITask::update_sgp41_test_value(uint16_t raw_value) {
 void UITask::update_last_packet_time(uint32_t seconds_since_packet) {
     queueSendOrWarn(UIMessage{UI_LAST_PACKET_TIME, static_cast<int>(seconds_since_packet)});
 }
+void UITask::update_link_errors(uint32_t errors) {
+    queueSendOrWarn(UIMessage{UI_LINK_ERRORS, static_cast<int>(errors)});
+}
+void UITask::update_link_latency(uint32_t p99_us) {
+    queueSendOrWarn(UIMessage{UI_LINK_LATENCY, static_cast<int>(p99_us)});
+}
 void UITask::update_runtime_free_heap(uint32_t free_heap) {
     queueSendOrWarn(UIMessage{UI_RUNTIME_FREE_HEAP, static_cast<int>(free_heap)});
 }
@@ -5,6 +5,8 @@
 #include "Logger.h"
 #include "ConfigManager.h"
 #include "HomeAssistantManager.h"
+#include "NanoLinkMetrics.h"
+#include "I2CBridgeStats.h"
 
 #include "webserver/WebServerConfigTabs.h"
 #include "webserver/WebServerConfigTabsExtra.h"
@@ -66,6 +68,9 @@ void WebServerManager::init(const char* firmware_version) {
     server.on("/config/climate", HTTP_GET, handleConfigClimate);
     server.on("/config/system", HTTP_GET, handleConfigSystem);
     server.on("/config/update", HTTP_POST, handleConfigUpdate);
+    server.on("/metrics", HTTP_GET, handleMetrics);
+    server.on("/metrics/i2c", HTTP_GET, handleI2cMetrics);
+    server.on("/metrics/reset", HTTP_POST, handleMetricsReset);
     
     server.on("/upload", HTTP_POST, []() {
         server.sendHeader("Connection", "close");
@@ -348,6 +353,11 @@ void WebServerManager::handleConfigUpdate() {
                 config->setInactivityTimerDelay(intValue);
                 server.send(200, "text/plain", "Inactivity timer delay updated successfully");
             }
+        } else if (section == "i2c") {
+            if (type == "direct_devices") {
+                config->setI2cDirectDevices(valueStr.toInt());
+                server.send(200, "text/plain", "I2C direct devices updated, reboot to apply");
+            }
         } else if (section == "mqtt") {
             if (type == "host") {
                 config->setMqttHost(valueStr.c_str());
@@ -525,3 +535,29 @@ void WebServerManager::handleNotFound(){
   server.send(404, "text/plain", "404: Not found");
   logger.warningf("HTTP 404 Not Found for request to: %s", server.uri().c_str());
 }
+
+// Nano link quality counters and latency histograms as JSON
+void WebServerManager::handleMetrics() {
+    String json;
+    json.reserve(2048);
+    NanoLinkMetrics::getInstance().writeJson(json);
+    server.sendHeader("Connection", "close");
+    server.send(200, "application/json", json);
+}
+
+// I2C bridge counters and latency per device address and operation as JSON
+void WebServerManager::handleI2cMetrics() {
+    String json;
+    json.reserve(2048);
+    I2CBridgeStats::getInstance().writeJson(json);
+    server.sendHeader("Connection", "close");
+    server.send(200, "application/json", json);
+}
+
+void WebServerManager::handleMetricsReset() {
+    NanoLinkMetrics::getInstance().reset();
+    I2CBridgeStats::getInstance().reset();
+    logger.info("Nano link and I2C bridge metrics reset via web interface");
+    server.sendHeader("Connection", "close");
+    server.send(200, "text/plain", "Link and I2C metrics reset");
+}
@@ -1,9 +1,10 @@
 #include "ZMOD4510Manager.h"
+#include "I2CBuses.h"
 #include "Logger.h"
 #include "SerialMutex.h"
 
 ZMOD4510Manager::ZMOD4510Manager()
-    : sensor(),
+    : sensor(I2CBuses::forDevice(I2C_DEVICE_ZMOD4510)),
       latestValues(),
       initialized_(false),
       healthy_(false),
@@ -1,12 +1,16 @@
 #include "ZMOD4510Sensor.h"
 #include "Logger.h"
 
-ZMOD4510Sensor::ZMOD4510Sensor() 
-    : state(STATE_IDLE), 
+#define ZMOD4510_ADDR_ERROR_EVENT 0xB7 // Read by zmod4xxx_check_error_event()
+
+ZMOD4510Sensor::ZMOD4510Sensor(I2CBus& bus) 
+    : bus(bus),
+      state(STATE_IDLE), 
       new_data_available(false),
       temperature_degc(-300), // Default to use on-chip temperature sensor
       humidity_pct(50),       // Default to 50% humidity
-      measurement_start_time(0)
+      measurement_start_time(0),
+      watch_id(-1)
 {
     memset(&latest_results, 0, sizeof(Results));
     latest_results.valid = false;
@@ -24,6 +28,7 @@ bool ZMOD4510Sensor::initHAL() {
         logger.errorf("ZMOD4510: HAL initialization failed with error %d", ret);
         return false;
     }
+    hal.handle = &bus; // Handed to the HAL's I2C functions
     
     dev.i2c_addr = ZMOD4510_I2C_ADDR;
     dev.pid = ZMOD4510_PID;
@@ -49,6 +54,11 @@ bool ZMOD4510Sensor::init() {
         logger.errorf("ZMOD4510: Algorithm initialization failed with error %d", ret);
         return false;
     }
+
+    bus.removeWatch(watch_id);
+    const I2CBus::Watch watch = { dev.i2c_addr, I2C_WATCH_BITS_CLEAR, STATUS_SEQUENCER_RUNNING_MASK, ZMOD4XXX_ADDR_STATUS,
+                                     dev.meas_conf->r.addr, dev.meas_conf->r.len, ZMOD4510_WATCH_PERIOD_MS };
+    watch_id = bus.addWatch(watch);
     
     logger.info("ZMOD4510: sensor initialized successfully");
     return true;
@@ -71,11 +81,15 @@ void ZMOD4510Sensor::startMeasurement() {
 
 void ZMOD4510Sensor::process() {
     switch (state) {
-        case STATE_IDLE:
+        case STATE_IDLE: {
+            // A push from before this measurement must not pass for its result
+            I2CBus::WatchSample stale;
+            bus.takeWatchSample(watch_id, stale);
             startMeasurement();
             state = STATE_MEASURING;
             measurement_start_time = millis();
             break;
+        }
 
         case STATE_MEASURING:
             // Check if measurement time has elapsed
@@ -130,7 +144,7 @@ int ZMOD4510Sensor::detect_and_configure() {
         return ret;
     }
     
-    ret = zmod4xxx_read_sensor_info(&dev);
+    ret = read_sensor_info();
     if (ret) {
         logger.errorf("ZMOD4510: Reading sensor info failed with error %d", ret);
         return ret;
@@ -147,7 +161,14 @@ int ZMOD4510Sensor::detect_and_configure() {
     }
 
     
-    ret = zmod4xxx_read_tracking_number(&dev, track_number);
+    if (bus.loadConstant(dev.i2c_addr, ZMOD4XXX_ADDR_TRACKING, track_number, ZMOD4XXX_LEN_TRACKING)) {
+        ret = ZMOD4XXX_OK;
+    } else {
+        ret = zmod4xxx_read_tracking_number(&dev, track_number);
+        if (!ret) {
+            bus.storeConstant(dev.i2c_addr, ZMOD4XXX_ADDR_TRACKING, track_number, ZMOD4XXX_LEN_TRACKING);
+        }
+    }
     if (ret) {
         logger.warningf("ZMOD4510: Reading tracking number failed with error %d", ret);
     } else {
@@ -180,14 +201,75 @@ int ZMOD4510Sensor::detect_and_configure() {
     return 0;
 }
 
+int ZMOD4510Sensor::read_sensor_info() {
+    uint8_t pid[ZMOD4XXX_LEN_PID];
+    const uint8_t prod_data_len = dev.meas_conf->prod_data_len;
+
+    // zmod4xxx_init() has seen the sensor answer, the cache stands in for the NVM readout
+    if (bus.loadConstant(dev.i2c_addr, ZMOD4XXX_ADDR_PID, pid, sizeof(pid)) &&
+        bus.loadConstant(dev.i2c_addr, ZMOD4XXX_ADDR_CONF, dev.config, ZMOD4XXX_LEN_CONF) &&
+        bus.loadConstant(dev.i2c_addr, ZMOD4XXX_ADDR_PROD_DATA, dev.prod_data, prod_data_len)) {
+        logger.debug("ZMOD4510: Sensor info from the register cache");
+        return ((pid[0] << 8) | pid[1]) == dev.pid ? ZMOD4XXX_OK : ERROR_SENSOR_UNSUPPORTED;
+    }
+
+    int ret = zmod4xxx_read_sensor_info(&dev);
+    if (ret) {
+        return ret;
+    }
+    pid[0] = dev.pid >> 8;
+    pid[1] = dev.pid & 0xFF;
+    bus.storeConstant(dev.i2c_addr, ZMOD4XXX_ADDR_PID, pid, sizeof(pid));
+    bus.storeConstant(dev.i2c_addr, ZMOD4XXX_ADDR_CONF, dev.config, ZMOD4XXX_LEN_CONF);
+    bus.storeConstant(dev.i2c_addr, ZMOD4XXX_ADDR_PROD_DATA, dev.prod_data, prod_data_len);
+    return ZMOD4XXX_OK;
+}
+
+bool ZMOD4510Sensor::take_pushed_result() {
+    I2CBus::WatchSample sample;
+    if (!bus.takeWatchSample(watch_id, sample)) {
+        return false;
+    }
+    if (sample.status != I2C_ERROR_NONE || sample.data_len != 1 + dev.meas_conf->r.len) {
+        logger.warningf("ZMOD4510: Pushed result unusable, status %d", sample.status);
+        return false;
+    }
+    zmod4xxx_status = sample.data[0];
+    memcpy(adc_result, sample.data + 1, dev.meas_conf->r.len);
+    return true;
+}
+
+// Status, ADC result and error event in one I2C script instead of three
+// bridge round trips. Mirrors zmod4xxx_read_status(), zmod4xxx_read_adc_result()
+// and zmod4xxx_check_error_event(). With a watch the Nano already pushed
+// status and ADC result when the sequencer stopped, only the error event
+// is left to read.
 void ZMOD4510Sensor::read_and_verify() {
     int ret;
-    
-    ret = zmod4xxx_read_status(&dev, &zmod4xxx_status);
-    if (ret) {
-        logger.errorf("ZMOD4510: Reading sensor status failed with error %d", ret);
+
+    if (take_pushed_result()) {
+        uint8_t reg = ZMOD4510_ADDR_ERROR_EVENT;
+        I2CBus::Result result = bus.writeRead(dev.i2c_addr, &reg, 1, 1);
+        ret = (result.success && result.data_len == 1) ? decode_error_event(result.data[0]) : ERROR_I2C;
+        if (ret) {
+            logger.errorf("ZMOD4510: Error event detected after reading ADC: %d", ret);
+            return;
+        }
+        logger.debug("ZMOD4510: ADC results pushed by the Nano");
         return;
     }
+
+    I2CBus::Script script(dev.i2c_addr);
+    script.readRegister(ZMOD4XXX_ADDR_STATUS, 1)
+          .readRegister(dev.meas_conf->r.addr, dev.meas_conf->r.len)
+          .readRegister(ZMOD4510_ADDR_ERROR_EVENT, 1);
+    I2CBus::ScriptResult result = bus.runScript(script);
+
+    if (result.status[0] != I2C_ERROR_NONE) {
+        logger.errorf("ZMOD4510: Reading sensor status failed with error %d", ERROR_I2C);
+        return;
+    }
+    zmod4xxx_status = *result.stepData(0);
     
     if (zmod4xxx_status & STATUS_SEQUENCER_RUNNING_MASK) {
         ret = zmod4xxx_check_error_event(&dev);
@@ -205,13 +287,13 @@ void ZMOD4510Sensor::read_and_verify() {
         return;
     }
     
-    ret = zmod4xxx_read_adc_result(&dev, adc_result);
-    if (ret) {
-        logger.errorf("ZMOD4510: Reading ADC results failed with error %d", ret);
+    if (result.status[1] != I2C_ERROR_NONE) {
+        logger.errorf("ZMOD4510: Reading ADC results failed with error %d", ERROR_I2C);
         return;
     }
+    memcpy(adc_result, result.stepData(1), dev.meas_conf->r.len);
     
-    ret = zmod4xxx_check_error_event(&dev);
+    ret = result.success ? decode_error_event(*result.stepData(2)) : ERROR_I2C;
     if (ret) {
         logger.errorf("ZMOD4510: Error event detected after reading ADC: %d", ret);
         return;
@@ -220,6 +302,16 @@ void ZMOD4510Sensor::read_and_verify() {
     logger.debug("ZMOD4510: ADC results read successfully");
 }
 
+int ZMOD4510Sensor::decode_error_event(uint8_t event) {
+    if (event & STATUS_POR_EVENT_MASK) {
+        return ERROR_POR_EVENT;
+    }
+    if (event & STATUS_ACCESS_CONFLICT_MASK) {
+        return ERROR_ACCESS_CONFLICT;
+    }
+    return ZMOD4XXX_OK;
+}
+
 void ZMOD4510Sensor::processResults() {
     algo_input.adc_result = adc_result;
     algo_input.humidity_pct = humidity_pct;
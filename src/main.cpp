@@ -3,6 +3,7 @@
 #include <WiFi.h>
 #include <math.h>
 #include <esp_system.h>
+#include <esp_timer.h>
 #include "secrets.h"
 #include "LGFX_ESP32_2432S022C.h"
 #include "CST820.h"
@@ -18,7 +19,13 @@
 #include "VOCGasIndexAlgorithm.h"
 #include "NOxGasIndexAlgorithm.h"
 #include "NanoCommands.h"
+#include "NanoLink.h"
+#include "NanoClockSync.h"
+#include "NanoLinkMetrics.h"
+#include "I2CBridgeStats.h"
+#include "protocol/Frames.h"
 #include "I2CBridge.h"
+#include "I2CRegisterCache.h"
 #include "GeigerCounter.h"
 #include "ZMOD4510Sensor.h"
 #include "SensorTask.h"
@@ -34,7 +41,6 @@ const int WIFI_CHECK_INTERVAL_MS = 10000;
 const int DEBUG_UPDATE_INTERVAL_MS = 5000;
 const int HEALTH_CHECK_INTERVAL_MS = 5000;  // Reduced from 30000 for faster reboot detection
 const int NANO_PACKET_TIMEOUT_MS = 7000;
-const int HEALTH_RESPONSE_TIMEOUT_MS = 500;
 const int SCD30_INFO_INTERVAL_MS = 20000;
 const int STACK_CHECK_INTERVAL_MS = 60000;
 const int SENSOR_QUERY_INTERVAL_MS = 2000;  // Query sensor data every 2 seconds
@@ -49,31 +55,54 @@ const int SENSOR_QUERY_INTERVAL_MS = 2000;  // Query sensor data every 2 seconds
 #define ARDUINO_ADC_MAX_VALUE       ((1 << ARDUINO_ADC_RESOLUTION_BITS) - 1)
 #define PPM_PER_ADC_UNIT (ARDUINO_SUPPLY_VOLTAGE / (ARDUINO_ADC_MAX_VALUE * CO_FEEDBACK_RESISTOR_OHMS * CO_SENSITIVITY_A_PPM))
 
-enum InitCommand { CMD_NONE, CMD_VERSION, CMD_HEALTH, CMD_SPS30_INFO, CMD_SCD30_INFO };
-InitCommand pending_init_commands[] = {CMD_VERSION, CMD_HEALTH, CMD_SPS30_INFO, CMD_SCD30_INFO, CMD_NONE};
+enum InitCommand { CMD_NONE, CMD_VERSION, CMD_HEALTH, CMD_SPS30_INFO, CMD_SCD30_INFO, CMD_STREAM };
+InitCommand pending_init_commands[] = {CMD_VERSION, CMD_HEALTH, CMD_SPS30_INFO, CMD_SCD30_INFO, CMD_STREAM, CMD_NONE};
+const int INIT_COMMAND_COUNT = sizeof(pending_init_commands) / sizeof(pending_init_commands[0]) - 1;
 bool init_sequence_active = false;
-int current_init_command_index = 0;
+int current_init_command_index = 0;     // Step waiting for its response
+int next_init_command_index = 0;        // Step to send next, ahead of current when pipelined
 unsigned long last_init_command_time = 0;
 const int INIT_COMMAND_TIMEOUT_MS = 100;
+const int INIT_PIPELINE_TIMEOUT_MS = 500;   // Whole pipelined batch, the Nano answers in order
+const int NANO_PIPELINE_DEPTH = 4;          // Tagged loop() commands in flight, bridge transactions have their own byte budget within the Nano's 128 byte RX buffer
 
 unsigned long last_wifi_check_time = 0;
 unsigned long last_health_check_time = 0;
 unsigned long last_debug_update_time = 0;
 unsigned long last_sensor_data_time = 0;
-unsigned long last_health_request_time = 0;
 unsigned long last_stack_check_time = 0;
 unsigned long last_sensor_query_time = 0;
 unsigned long nano_boot_millis = 0;
 unsigned long last_scd30_info_time = 0;
 bool is_sensor_module_connected = false;
-bool health_request_pending = false;
 static bool first_health_packet_received = false;
 static bool latest_first_time_flag = false;
 
-String serial_buffer = "";
-String last_nano_version = "";
+char last_nano_version[16] = "";
+uint16_t nano_capabilities = 0; // Capability bits reported in the Nano's RSP_VERSION
 uint16_t last_nano_ram = 0;
-unsigned long last_received_timestamp = 0; // Store last received timestamp for comparison
+bool sensor_stream_active = false;         // Nano pushes RSP_SENSORS, no polling needed
+bool sensor_sequence_valid = false;        // last_sensor_sequence holds a received value
+uint16_t last_sensor_sequence = 0;
+NanoSensorFrame sensor_snapshot;           // Last full sensor state, RSP_SENSORS_DELTA applies to it
+bool sensor_snapshot_valid = false;        // Cleared until the next keyframe when a delta cannot be applied
+NanoRequestTable nano_requests;            // Commands waiting for their response
+uint32_t nano_event_counts[NANO_EVENT_COUNT] = {0}; // RSP_EVENT reports since boot, by code
+volatile bool nano_bridge_frame_received = false; // Set by process_bridge_frame() on the RX task
+NanoClockSync nano_clock;                  // Maps RSP_SENSORS timestamps onto millis()
+unsigned long last_time_sync_time = 0;
+
+// Link speed negotiation, see LINK_* in protocol/Commands.h
+// BAUD_DRAINING holds loop() and the I2C bridge back until nothing is in flight.
+enum BaudNegotiation { BAUD_IDLE, BAUD_DRAINING, BAUD_REQUESTED, BAUD_SWITCHED, BAUD_VERIFYING };
+volatile BaudNegotiation baud_negotiation = BAUD_IDLE; // Read by I2CBridge from the sensor tasks
+unsigned long baud_switch_time = 0;
+bool baud_attempt_failed = false;          // Last attempt failed, retry after LINK_BAUD_RETRY_MS
+unsigned long baud_failure_time = 0;
+unsigned long baud_error_window_start = 0;
+uint32_t baud_error_window_count = 0;      // NanoLink::errorCount() when the window started
+const int LINK_BAUD_SETTLE_MS = 5;         // Lets the Nano reopen its UART before the ping
+const unsigned long LINK_BAUD_RETRY_MS = 600000;
 
 ConfigManager configManager;
 HomeAssistantManager haManager;
@@ -111,35 +140,83 @@ RollingAverage<float> geothermal_pump_amps_avg(100); // Average over 100 reading
 TaskHandle_t mainTaskHandle = nullptr;
 
 // =================== UTILITY FUNCTIONS ===================
-uint8_t calculate_checksum(const char* data_str) {
-    uint8_t crc = 0x00;
-    uint8_t polynomial = 0x07;
-    size_t length = strlen(data_str);
-    for (size_t i = 0; i < length; i++) {
-        crc ^= data_str[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc & 0x80) ? (crc << 1) ^ polynomial : (crc << 1);
+uint8_t send_packet_to_nano(const char* data_part, unsigned long timeout_ms) {
+    const char cmd = data_part[0];
+    uint8_t request_id = REQUEST_ID_NONE;
+    if (protocol_command_has_response(cmd)) {
+        request_id = nano_requests.add(cmd, timeout_ms);
+        if (request_id == REQUEST_ID_NONE) {
+            logger.warningf("Nano request table full, %c sent untracked", cmd);
         }
     }
-    return crc;
-}
 
-void send_command_to_nano(char cmd) {
-    char data_part[2] = {cmd, '\0'};
-    uint8_t checksum = calculate_checksum(data_part);
+    // Only firmware advertising request IDs understands the "#XX" tag
+    char tagged[ASCII_PACKET_MAX_LEN];
+    if (request_id != REQUEST_ID_NONE && (nano_capabilities & PROTOCOL_CAP_REQUEST_IDS)) {
+        snprintf(tagged, sizeof(tagged), "%c%02X%s", ASCII_REQUEST_ID_PREFIX, request_id, data_part);
+        data_part = tagged;
+    }
+
+    char packet[ASCII_PACKET_MAX_LEN];
+    size_t packet_len = ascii_packet_encode(data_part, packet, sizeof(packet));
+    if (packet_len == 0) {
+        logger.warningf("Packet for Nano too long, dropped: %s", data_part);
+        return REQUEST_ID_NONE;
+    }
 #ifdef SERIAL_PACKET_DEBUG
-    logger.debugf("Sending command to Nano: <%c,%d>", cmd, checksum);
+    logger.debugf("Sending command to Nano: %s", packet);
 #endif
-    
-    SerialMutex& serialMutex = SerialMutex::getInstance();
-    if (serialMutex.lock()) {
-        Serial.print('<');
-        Serial.print(cmd);
-        Serial.print(',');
-        Serial.print(checksum);
-        Serial.print('>');
-        serialMutex.unlock();
+
+    NanoLink::getInstance().write(reinterpret_cast<const uint8_t*>(packet), packet_len);
+    return request_id;
+}
+
+uint8_t send_frame_to_nano(char type, const uint8_t* payload, uint8_t payload_len, unsigned long timeout_ms) {
+    uint8_t request_id = REQUEST_ID_NONE;
+    if (protocol_command_has_response(type)) {
+        request_id = nano_requests.add(type, timeout_ms);
+        if (request_id == REQUEST_ID_NONE) {
+            logger.warningf("Nano request table full, %c sent untracked", type);
+        }
+    }
+
+    uint8_t frame[BINARY_FRAME_MAX_ENCODED_LEN + 2];
+    const size_t encoded_len = binary_frame_encode(type, request_id, payload, payload_len, frame + 1, sizeof(frame) - 2);
+    if (encoded_len == 0) {
+        logger.warningf("%c frame for Nano too long, dropped: %u bytes", type, payload_len);
+        return REQUEST_ID_NONE;
     }
+    frame[0] = BINARY_FRAME_DELIMITER;
+    frame[encoded_len + 1] = BINARY_FRAME_DELIMITER;
+
+    NanoLink::getInstance().write(frame, encoded_len + 2);
+    return request_id;
+}
+
+bool nano_has_capability(uint16_t capability) {
+    return (nano_capabilities & capability) != 0;
+}
+
+bool nano_link_accepts_bridge_traffic() {
+    return baud_negotiation == BAUD_IDLE;
+}
+
+// Tagged commands can be sent back to back, the Nano answers each one with
+// its ID. Older firmware gets one command per loop iteration.
+static bool nano_can_accept_command(bool command_sent_this_loop) {
+    // Nothing else goes out while the link changes speed
+    if (baud_negotiation != BAUD_IDLE) {
+        return false;
+    }
+    if (nano_capabilities & PROTOCOL_CAP_REQUEST_IDS) {
+        return nano_requests.pendingLoopCount() < NANO_PIPELINE_DEPTH;
+    }
+    return !command_sent_this_loop;
+}
+
+void send_command_to_nano(char cmd) {
+    char data_part[2] = {cmd, '\0'};
+    send_packet_to_nano(data_part);
     
     if (cmd == CMD_REBOOT) {
         logger.info("Reboot command sent. Marking sensor stack as disconnected.");
@@ -152,23 +229,34 @@ void send_command_to_nano(char cmd) {
     }
 }
 
+void send_command_to_nano_with_payload(char cmd, const char* payload) {
+    char data_part[16];
+    snprintf(data_part, sizeof(data_part), "%c%s", cmd, payload);
+    send_packet_to_nano(data_part);
+}
+
+void send_version_request() {
+    // Advertise our capabilities, the Nano answers with its own
+    char caps[5];
+    snprintf(caps, sizeof(caps), "%02X", PROTOCOL_CAP_BINARY_FRAMES | PROTOCOL_CAP_SENSOR_STREAM | PROTOCOL_CAP_REQUEST_IDS | PROTOCOL_CAP_BAUD_SWITCH | PROTOCOL_CAP_DELTA_FRAMES | PROTOCOL_CAP_CHUNKED_WRITES | PROTOCOL_CAP_BINARY_I2C);
+    send_command_to_nano_with_payload(CMD_GET_VERSION, caps);
+}
+
+void send_sensor_stream_request(unsigned long period_ms) {
+    char period[11];
+    snprintf(period, sizeof(period), "%lu", period_ms);
+    send_command_to_nano_with_payload(CMD_SENSOR_STREAM, period);
+}
+
+void send_baud_rate_request(unsigned long baud) {
+    char rate[11];
+    snprintf(rate, sizeof(rate), "%lu", baud);
+    send_command_to_nano_with_payload(CMD_SET_BAUD_RATE, rate);
+}
+
 void send_command_to_nano_with_param(char cmd, char param) {
     char data_part[3] = {cmd, param, '\0'};
-    uint8_t checksum = calculate_checksum(data_part);
-#ifdef SERIAL_PACKET_DEBUG
-    logger.debugf("Sending command to Nano: <%c%c,%d>", cmd, param, checksum);
-#endif
-
-    SerialMutex& serialMutex = SerialMutex::getInstance();
-    if (serialMutex.lock()) {
-        Serial.print('<');
-        Serial.print(cmd);
-        Serial.print(param);
-        Serial.print(',');
-        Serial.print(checksum);
-        Serial.print('>');
-        serialMutex.unlock();
-    }
+    send_packet_to_nano(data_part);
 }
 
 const char* nano_reset_cause_to_string(uint8_t code) {
@@ -181,6 +269,71 @@ const char* nano_reset_cause_to_string(uint8_t code) {
     }
 }
 
+// =================== NANO EVENTS ===================
+struct NanoEventInfo {
+    AppLogLevel level;
+    const char* message;
+};
+
+// Indexed by NANO_EVENT_* code
+static const NanoEventInfo nano_events[] = {
+    { APP_LOG_INFO,    "I2C bus recovery started" },
+    { APP_LOG_INFO,    "I2C bus recovery completed" },
+    { APP_LOG_ERROR,   "I2C bus is stuck, attempting manual recovery" },
+    { APP_LOG_ERROR,   "I2C recovery failed - SDA line still stuck low" },
+    { APP_LOG_INFO,    "I2C recovery failed - Manual STOP condition was not successful, bus is still busy" },
+    { APP_LOG_WARNING, "I2C bus stuck detected (0: periodic loop() check, 1: sensor read cycle)" },
+    { APP_LOG_ERROR,   "I2C recovery timeout, bus may be stuck" },
+    { APP_LOG_ERROR,   "SPS30 data ready error" },
+    { APP_LOG_ERROR,   "SPS30 measurement error" },
+    { APP_LOG_ERROR,   "SCD30 data ready error" },
+    { APP_LOG_ERROR,   "SCD30 measurement error" },
+    { APP_LOG_ERROR,   "SGP41 conditioning error" },
+    { APP_LOG_ERROR,   "SGP41 measurement error" },
+};
+static_assert(sizeof(nano_events) / sizeof(nano_events[0]) == NANO_EVENT_COUNT, "One entry per NANO_EVENT_* code");
+
+// Nano firmware before 1.10.0 reported events as "E,<text>"
+struct LegacyNanoEvent {
+    const char* text;
+    uint8_t code;
+    uint8_t param;
+};
+
+static const LegacyNanoEvent legacy_nano_events[] = {
+    { "I2C_RECOVER,1",                NANO_EVENT_I2C_RECOVER_START,    0 },
+    { "I2C_RECOVER,0",                NANO_EVENT_I2C_RECOVER_DONE,     0 },
+    { "I2C_RECOVER,2",                NANO_EVENT_I2C_RECOVER_MANUAL,   0 },
+    { "I2C_RECOVER,FAIL_SDA_LOW",     NANO_EVENT_I2C_RECOVER_SDA_LOW,  0 },
+    { "I2C_RECOVER,FAIL_BUS_BUSY",    NANO_EVENT_I2C_RECOVER_BUS_BUSY, 0 },
+    { "I2C_RECOVER,BUS_STUCK,0",      NANO_EVENT_I2C_BUS_STUCK,        0 },
+    { "I2C_RECOVER,BUS_STUCK,1",      NANO_EVENT_I2C_BUS_STUCK,        1 },
+    { "I2C_RECOVER,TIMEOUT",          NANO_EVENT_I2C_TIMEOUT,          0 },
+    { "SPS30_DATA_READY_ERROR,1",     NANO_EVENT_SPS30_DATA_READY,     1 },
+    { "SPS30_MEASUREMENT_ERROR,1",    NANO_EVENT_SPS30_MEASUREMENT,    1 },
+    { "SCD30_DATA_READY_ERROR,1",     NANO_EVENT_SCD30_DATA_READY,     1 },
+    { "SCD30_MEASUREMENT_ERROR,1",    NANO_EVENT_SCD30_MEASUREMENT,    1 },
+    { "SGP41_CONDITIONING_ERROR,1",   NANO_EVENT_SGP41_CONDITIONING,   1 },
+    { "SGP41_MEASUREMENT_ERROR,1",    NANO_EVENT_SGP41_MEASUREMENT,    1 },
+};
+
+void handle_nano_event(uint8_t code, uint16_t param) {
+    if (code >= NANO_EVENT_COUNT) {
+        logger.warningf("SensorStack: Unknown event 0x%02X, param 0x%X", code, param);
+        return;
+    }
+    nano_event_counts[code]++;
+    if (code == NANO_EVENT_I2C_RECOVER_START) {
+        // Clocking the bus free can leave a sensor reset or in a different state
+        I2CRegisterCache::getInstance().invalidate("Nano I2C bus recovery");
+    }
+
+    char message[160];
+    snprintf(message, sizeof(message), "SensorStack: %s (param 0x%X, %lu since boot)",
+        nano_events[code].message, param, (unsigned long)nano_event_counts[code]);
+    logger.log(nano_events[code].level, message);
+}
+
 void update_wifi_status() {
     UITask::getInstance().update_wifi_status(WiFi.status() == WL_CONNECTED, WiFi.RSSI());
     haManager.publishWiFiStatus(WiFi.status() == WL_CONNECTED, WiFi.RSSI(), WIFI_SSID, WiFi.localIP().toString().c_str());
@@ -188,225 +341,375 @@ void update_wifi_status() {
 
 
 
-// =================== PACKET PROCESSING ===================
-void process_packet(String packet) {
-    packet.trim();
-    if (!packet.startsWith("<") || !packet.endsWith(">")) {
-        logger.warningf("Malformed packet (no start/end markers): %s", packet.c_str());
-        return;
+// =================== INIT SEQUENCE ===================
+void restart_init_sequence() {
+    init_sequence_active = true;
+    current_init_command_index = 0;
+    next_init_command_index = 0;
+    last_init_command_time = 0;
+}
+
+// Called when a response answers an init step, steps complete in order
+void advance_init_sequence(InitCommand completed) {
+    if (init_sequence_active && pending_init_commands[current_init_command_index] == completed) {
+        current_init_command_index++;
     }
-    packet.remove(0, 1);
-    packet.remove(packet.length() - 1);
+}
 
-    int last_comma = packet.lastIndexOf(',');
-    if (last_comma == -1) {
-        logger.warningf("Malformed packet (no checksum comma): %s", packet.c_str());
-        return;
+// Older firmware cannot stream, keep polling it with CMD_GET_SENSORS
+static bool init_command_supported(InitCommand command) {
+    return command != CMD_STREAM || (nano_capabilities & PROTOCOL_CAP_SENSOR_STREAM);
+}
+
+static char init_command_letter(InitCommand command) {
+    switch (command) {
+        case CMD_VERSION: return CMD_GET_VERSION;
+        case CMD_HEALTH: return CMD_GET_HEALTH;
+        case CMD_SPS30_INFO: return CMD_GET_SPS30_INFO;
+        case CMD_SCD30_INFO: return CMD_GET_SCD30_INFO;
+        case CMD_STREAM: return CMD_SENSOR_STREAM;
+        default: return 0;
     }
+}
 
-    String data_part = packet.substring(0, last_comma);
-    uint8_t received_checksum = packet.substring(last_comma + 1).toInt();
-    if (calculate_checksum(data_part.c_str()) != received_checksum) {
-        logger.warningf("Checksum mismatch! Rcvd: %s", packet.c_str());
-        return;
+static void send_init_command(InitCommand command, unsigned long timeout_ms) {
+    char cmd_to_send = init_command_letter(command);
+    logger.infof("Sending init command %d/%d: %c", next_init_command_index + 1, INIT_COMMAND_COUNT, cmd_to_send);
+    if (command == CMD_VERSION) {
+        send_version_request();
+    } else if (command == CMD_STREAM) {
+        send_sensor_stream_request(SENSOR_QUERY_INTERVAL_MS);
+    } else {
+        char data_part[2] = {cmd_to_send, '\0'};
+        send_packet_to_nano(data_part, timeout_ms);
     }
+}
 
-#ifdef SERIAL_PACKET_DEBUG
-    // Log all received packets for debugging
-    logger.debugf("ESP32: Received packet from Nano: %s", packet.c_str());
-#endif
+// =================== LINK SPEED ===================
+static void reset_baud_error_window() {
+    baud_error_window_start = millis();
+    baud_error_window_count = NanoLink::getInstance().errorCount();
+}
 
-    // Special handling for I2C recovery events
-    if (data_part.startsWith("E,I2C_RECOVER")) {
-        if (data_part.endsWith(",TIMEOUT")) {
-            logger.error("SensorStack: I2C_RECOVER: I2C recovery timeout, bus may be stuck");
-        } else if (data_part.endsWith(",FAIL_SDA_LOW")) {
-            logger.error("SensorStack: I2C_RECOVER: I2C recovery failed - SDA line still stuck low");
-        } else if (data_part.endsWith(",FAIL_BUS_BUSY")) {
-            logger.info("SensorStack: I2C_RECOVER: I2C recovery failed - Manual STOP condition was not successful, bus is still busy");
-        } else if (data_part.endsWith(",BUS_STUCK,0")) {
-            logger.info("SensorStack: I2C_RECOVER: I2C bus stuck detection was triggered in period loop() check"); 
-        } else if (data_part.endsWith(",BUS_STUCK,1")) {
-            logger.error("SensorStack: I2C_RECOVER: I2C bus stuck detection was triggered in read_all_sensors()");
-        } else if (data_part.endsWith(",1")) {
-            logger.info("SensorStack: I2C_RECOVER: I2C bus recovery started");
-        } else if (data_part.endsWith(",2")) {
-            logger.error("SensorStack: I2C_RECOVER: I2C bus is stuck, attempting manual recovery");
-        } else if (data_part.endsWith(",0")) {
-            logger.info("SensorStack: I2C_RECOVER: I2C bus recovery completed");
-        } else {
-            logger.warningf("I2C_RECOVER: Unknown I2C recovery status: %s", data_part.c_str());
-        }
+// Drops the ESP32 side back to the default rate. The Nano does the same on
+// its own once it stops hearing valid commands.
+void revert_link_baud_rate(const char* reason) {
+    baud_negotiation = BAUD_IDLE;
+    if (NanoLink::getInstance().baudRate() != LINK_DEFAULT_BAUD) {
+        logger.warningf("Nano link back to %d baud: %s", LINK_DEFAULT_BAUD, reason);
+        NanoLink::getInstance().setBaudRate(LINK_DEFAULT_BAUD);
     }
-    // Special handling for sensor error events
-    else if (data_part.startsWith("E,SPS30_DATA_READY_ERROR")) {
-        logger.errorf("SensorStack: Failed! reports SPS30 data ready error");
-    }
-    else if (data_part.startsWith("E,SPS30_MEASUREMENT_ERROR")) {
-        logger.errorf("SensorStack: Failed! reports SPS30 measurement error");
+}
+
+static void link_baud_attempt_failed(const char* reason) {
+    revert_link_baud_rate(reason);
+    baud_attempt_failed = true;
+    baud_failure_time = millis();
+}
+
+// Raises the link speed once the Nano is idle, and falls back when the
+// fast link corrupts too many packets. New commands and bridge transactions
+// are held back first so the requests in flight answer or expire.
+void update_link_baud_rate() {
+    NanoLink& link = NanoLink::getInstance();
+    switch (baud_negotiation) {
+        case BAUD_IDLE:
+            if (link.baudRate() != LINK_DEFAULT_BAUD) {
+                if (link.errorCount() - baud_error_window_count > LINK_MAX_CRC_ERRORS) {
+                    // Best effort, the Nano falls back by itself if this gets corrupted too
+                    send_baud_rate_request(LINK_DEFAULT_BAUD);
+                    link_baud_attempt_failed("too many corrupted packets");
+                } else if (millis() - baud_error_window_start > LINK_CRC_ERROR_WINDOW_MS) {
+                    reset_baud_error_window();
+                }
+            } else if (is_sensor_module_connected && !init_sequence_active &&
+                       (nano_capabilities & PROTOCOL_CAP_BAUD_SWITCH) &&
+                       (!baud_attempt_failed || millis() - baud_failure_time > LINK_BAUD_RETRY_MS)) {
+                baud_negotiation = BAUD_DRAINING;
+            }
+            break;
+        case BAUD_DRAINING:
+            if (!is_sensor_module_connected || init_sequence_active) {
+                baud_negotiation = BAUD_IDLE;
+            } else if (nano_requests.pendingCount() == 0) {
+                logger.infof("Proposing %d baud to Sensor Stack", LINK_FAST_BAUD);
+                send_baud_rate_request(LINK_FAST_BAUD);
+                baud_negotiation = BAUD_REQUESTED;
+            }
+            break;
+        case BAUD_SWITCHED:
+            if (millis() - baud_switch_time >= LINK_BAUD_SETTLE_MS) {
+                send_command_to_nano(CMD_PING);
+                baud_negotiation = BAUD_VERIFYING;
+            }
+            break;
+        default:
+            // Waiting for RSP_BAUD_RATE or RSP_PING, or for them to expire
+            break;
     }
-    else if (data_part.startsWith("E,SCD30_DATA_READY_ERROR")) {
-        logger.errorf("SensorStack: Failed! reports SCD30 data ready error");
+}
+
+void link_baud_request_expired(char cmd) {
+    if ((cmd == CMD_SET_BAUD_RATE && baud_negotiation == BAUD_REQUESTED) ||
+        (cmd == CMD_PING && baud_negotiation == BAUD_VERIFYING)) {
+        link_baud_attempt_failed("no response from Sensor Stack");
     }
-    else if (data_part.startsWith("E,SCD30_MEASUREMENT_ERROR")) {
-        logger.errorf("SensorStack: Failed! reports SCD30 measurement error");
+}
+
+// =================== PACKET PROCESSING ===================
+// Matches a response against the request table. Tagged responses complete
+// their own request. Untagged ones complete the oldest request for that
+// letter, unless the Nano tags its responses: then they are unsolicited.
+// received_us is when the response was parsed, for the latency metrics.
+void complete_nano_request(uint8_t request_id, char response, int64_t received_us) {
+    if (request_id == REQUEST_ID_NONE && (nano_capabilities & PROTOCOL_CAP_REQUEST_IDS)) {
+        return;
     }
-    else if (data_part.startsWith("E,SGP41_CONDITIONING_ERROR")) {
-        logger.errorf("SensorStack: Failed! reports SGP41 conditioning error");
+
+    NanoRequestTable::Entry entry;
+    if (!nano_requests.complete(request_id, response, entry)) {
+        if (request_id != REQUEST_ID_NONE) {
+            logger.warningf("Response %c for unknown or expired request #%u", response, request_id);
+        }
+        return;
     }
-    else if (data_part.startsWith("E,SGP41_MEASUREMENT_ERROR")) {
-        logger.errorf("SensorStack: Failed! reports SGP41 measurement error");
+    if (protocol_response_for(entry.cmd) != response) {
+        logger.warningf("Request #%u (%c) answered with %c", entry.id, entry.cmd, response);
     }
+    const uint32_t latency_us = (received_us > entry.sent_us) ? (uint32_t)(received_us - entry.sent_us) : 0;
+    NanoLinkMetrics::getInstance().recordLatency(response, latency_us);
+#ifdef SERIAL_PACKET_DEBUG
+    logger.debugf("Request #%u (%c) completed in %lu us", entry.id, entry.cmd, (unsigned long)latency_us);
+#endif
+}
 
+void mark_valid_frame_received() {
     last_sensor_data_time = millis();
 
     // Mark connection as established when we receive any valid packet
     if (!is_sensor_module_connected) {
         is_sensor_module_connected = true;
         nano_boot_millis = millis();
-        last_received_timestamp = 0; // Reset timestamp on new connection
+        sensor_sequence_valid = false; // Sequence restarts with the new connection
+        sensor_snapshot_valid = false;
         logger.info("Sensor module connection established.");
     }
 
     UITask::getInstance().update_sensor_status(true);
     haManager.publishSensorConnectionStatus(true);
+}
 
-    char cmd = data_part.charAt(0);
-    String payload = data_part.substring(1);
-
-    switch (cmd) {
-        case RSP_SENSORS: {
-            char data_cstr[payload.length() + 1];
-            strcpy(data_cstr, payload.c_str());
-            char* token = strtok(data_cstr, ","); if (!token) return; unsigned long timestamp = atol(token);
-            token = strtok(NULL, ","); if (!token) return; uint16_t pressure_adc_raw = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; uint16_t pulse_count = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; float t = atof(token) / 10.0f;
-            token = strtok(NULL, ","); if (!token) return; float h = atof(token) / 10.0f;
-            token = strtok(NULL, ","); if (!token) return; float co2 = atof(token);
-            token = strtok(NULL, ","); if (!token) return; uint16_t voc_raw = atol(token);
-            token = strtok(NULL, ","); if (!token) return; uint16_t nox_raw = atol(token);
-            token = strtok(NULL, ","); if (!token) return; float amps = atof(token) / 100.0f;
-            token = strtok(NULL, ","); if (!token) return; float pm1 = atof(token) / 10.0f;
-            token = strtok(NULL, ","); if (!token) return; float pm25 = atof(token) / 10.0f;
-            token = strtok(NULL, ","); if (!token) return; float pm4 = atof(token) / 10.0f;
-            token = strtok(NULL, ","); if (!token) return; float pm10 = atof(token) / 10.0f;
-            token = strtok(NULL, ","); if (!token) return; float compressor_amps = atof(token) / 100.0f;
-            token = strtok(NULL, ","); if (!token) return; float geothermal_pump_amps = atof(token) / 100.0f;
-            token = strtok(NULL, ","); if (!token) return; bool liquid_level_sensor_state = (atoi(token) == 0); // GPIO at 0 == sensor triggered
-            token = strtok(NULL, ","); if (!token) return; uint16_t co_adc_raw = atoi(token);
+// has_sequence is false for ASCII frames from firmware predating sequence numbers
+void handle_sensor_frame(const NanoSensorFrame& frame, bool has_sequence) {
+    uint16_t pressure_adc_raw = frame.pressure_adc_raw;
+    uint16_t pulse_count = frame.pulse_count;
+    float t = frame.temperature_x10 / 10.0f;
+    float h = frame.humidity_x10 / 10.0f;
+    float co2 = frame.co2_ppm;
+    uint16_t voc_raw = frame.voc_raw;
+    uint16_t nox_raw = frame.nox_raw;
+    float amps = frame.fan_amps_x100 / 100.0f;
+    float pm1 = frame.pm1_x10 / 10.0f;
+    float pm25 = frame.pm25_x10 / 10.0f;
+    float pm4 = frame.pm4_x10 / 10.0f;
+    float pm10 = frame.pm10_x10 / 10.0f;
+    float compressor_amps = frame.compressor_amps_x100 / 100.0f;
+    float geothermal_pump_amps = frame.geothermal_pump_amps_x100 / 100.0f;
+    bool liquid_level_sensor_state = (frame.liquid_level_raw == 0); // GPIO at 0 == sensor triggered
+    uint16_t co_adc_raw = frame.co_adc_raw;
 #ifdef SERIAL_PACKET_DEBUG
-            // Debug log: decoded sensor packet with descriptive tags
-            logger.debugf(
-                "RSP_SENSORS decoded: "
-                "timestamp=%lu, pressure_adc_raw=%u, pulse_count=%u, temp=%.1f°C, hum=%.1f%%, co2=%.1fppm, "
-                "voc_raw=%u, nox_raw=%u, fan_amps=%.2fA, pm1=%.1f, pm2.5=%.1f, pm4=%.1f, pm10=%.1f, "
-                "compressor_amps=%.2fA, pump_amps=%.2fA, liquid_level=%s, co_adc_raw=%u",
-                timestamp, pressure_adc_raw, pulse_count, t, h, co2,
-                voc_raw, nox_raw, amps, pm1, pm25, pm4, pm10,
-                compressor_amps, geothermal_pump_amps, liquid_level_sensor_state ? "TRIGGERED" : "OK", co_adc_raw
-            );
+    // Debug log: decoded sensor packet with descriptive tags
+    logger.debugf(
+        "RSP_SENSORS decoded: "
+        "seq=%u, timestamp=%lu, pressure_adc_raw=%u, pulse_count=%u, temp=%.1f°C, hum=%.1f%%, co2=%.1fppm, "
+        "voc_raw=%u, nox_raw=%u, fan_amps=%.2fA, pm1=%.1f, pm2.5=%.1f, pm4=%.1f, pm10=%.1f, "
+        "compressor_amps=%.2fA, pump_amps=%.2fA, liquid_level=%s, co_adc_raw=%u",
+        frame.sequence, (unsigned long)frame.timestamp, pressure_adc_raw, pulse_count, t, h, co2,
+        voc_raw, nox_raw, amps, pm1, pm25, pm4, pm10,
+        compressor_amps, geothermal_pump_amps, liquid_level_sensor_state ? "TRIGGERED" : "OK", co_adc_raw
+    );
 #endif
-        
-            // Calculate pressure from raw ADC value (moved from Nano)
-            float voltage = static_cast<float>(pressure_adc_raw) * ARDUINO_SUPPLY_VOLTAGE / ARDUINO_ADC_MAX_VALUE ; 
-            float current_ma = (voltage / SHUNT_RESISTOR) * VOLTS_TO_MILLIVOLTS;
-            float diff_pressure_pa = (current_ma > 4.0f) ? (current_ma - 4.0f) * (300.0f / 16.0f) : 0.0f;
 
-            // Calculate CO concentration from raw ADC value (moved from Nano)
-            uint16_t co_ppm = static_cast<uint16_t>(co_adc_raw * PPM_PER_ADC_UNIT);
-            
-            // Check if timestamp is the same or too close to previous (duplicate or very recent data)
-            if (last_received_timestamp > 0) {
-                unsigned long timestamp_diff = timestamp - last_received_timestamp;
-                if (timestamp_diff == 0) {
-                    logger.warningf("Received duplicate sensor data: timestamp=%lu (same as previous)", timestamp);
-                    return; // Skip processing duplicate data
-                } else if (timestamp_diff < 1000) { // Less than 1 second apart
-                    logger.warningf("Received very recent sensor data: timestamp=%lu, diff=%lu ms (expected ~2000ms)", 
-                                   timestamp, timestamp_diff);
-                }
+    // Calculate pressure from raw ADC value (moved from Nano)
+    float voltage = static_cast<float>(pressure_adc_raw) * ARDUINO_SUPPLY_VOLTAGE / ARDUINO_ADC_MAX_VALUE ; 
+    float current_ma = (voltage / SHUNT_RESISTOR) * VOLTS_TO_MILLIVOLTS;
+    float diff_pressure_pa = (current_ma > 4.0f) ? (current_ma - 4.0f) * (300.0f / 16.0f) : 0.0f;
+
+    // Calculate CO concentration from raw ADC value (moved from Nano)
+    uint16_t co_ppm = static_cast<uint16_t>(co_adc_raw * PPM_PER_ADC_UNIT);
+    
+    // Detect duplicate and lost frames from the sequence number. 0 means the Nano restarted.
+    if (has_sequence) {
+        if (sensor_sequence_valid && frame.sequence != 0) {
+            uint16_t sequence_diff = frame.sequence - last_sensor_sequence;
+            if (sequence_diff == 0 || sequence_diff > 0x8000) {
+                NanoLinkMetrics::getInstance().count(RSP_SENSORS, NanoLinkMetrics::DUPLICATES);
+                logger.warningf("Received duplicate sensor data: seq=%u (last %u)", frame.sequence, last_sensor_sequence);
+                return; // Skip processing duplicate data
+            } else if (sequence_diff > 1) {
+                NanoLinkMetrics::getInstance().count(RSP_SENSORS, NanoLinkMetrics::GAPS, sequence_diff - 1);
+                logger.warningf("Missed %u sensor frame(s): seq %u -> %u", sequence_diff - 1, last_sensor_sequence, frame.sequence);
             }
-            
-            // Store the timestamp for next comparison
-            last_received_timestamp = timestamp;
-            
-            // Add the pulse count to the geiger counter object
-            geigerCounter.addSample(pulse_count);
-            int c = geigerCounter.getCPM();
-            
-            int32_t voc_index = voc_algorithm.process(voc_raw);
-            int32_t nox_index = nox_algorithm.process(nox_raw);
-            co2_avg.add(co2);
-            co_avg.add(co_ppm);
-            voc_avg.add(voc_index);
-            nox_avg.add(nox_index);
-            diff_pressure_avg.add(diff_pressure_pa);
-            pm1_avg.add(pm1);
-            pm25_avg.add(pm25);
-            pm4_avg.add(pm4);
-            pm10_avg.add(pm10);
-            compressor_amps_avg.add(compressor_amps);
-            geothermal_pump_amps_avg.add(geothermal_pump_amps);
-
-            bool is_pressure_high = false;
-            FanStatus fan_status;
-            {
-                // Limit scope to reduce mutex hold time
-                ConfigManagerAccessor config;
-                if (amps <= config->getFanOffCurrentThreshold()) {
-                    fan_status = FAN_STATUS_OFF;
-                } else if (amps < config->getFanOnCurrentThreshold() || amps > config->getFanHighCurrentThreshold()) {
-                    fan_status = FAN_STATUS_ALERT;
-                } else {
-                    fan_status = FAN_STATUS_NORMAL;
-                }
-                is_pressure_high = (diff_pressure_avg.getAverage() > config->getHighPressureThreshold());
+        }
+        last_sensor_sequence = frame.sequence;
+        sensor_sequence_valid = true;
+    }
+    
+    // When the Nano read its sensors, in our millis(). Link and loop latency
+    // would otherwise end up as jitter in every average, which weights
+    // samples by the time between them.
+    unsigned long sample_time = millis();
+    unsigned long nano_sample_time;
+    if (nano_clock.toLocalMillis(frame.timestamp, nano_sample_time) && (long)(sample_time - nano_sample_time) >= 0) {
+        sample_time = nano_sample_time;
+    }
+
+    // Add the pulse count to the geiger counter object
+    geigerCounter.addSample(pulse_count);
+    int c = geigerCounter.getCPM();
+    
+    int32_t voc_index = voc_algorithm.process(voc_raw);
+    int32_t nox_index = nox_algorithm.process(nox_raw);
+    co2_avg.add(co2, sample_time);
+    co_avg.add(co_ppm, sample_time);
+    voc_avg.add(voc_index, sample_time);
+    nox_avg.add(nox_index, sample_time);
+    diff_pressure_avg.add(diff_pressure_pa, sample_time);
+    pm1_avg.add(pm1, sample_time);
+    pm25_avg.add(pm25, sample_time);
+    pm4_avg.add(pm4, sample_time);
+    pm10_avg.add(pm10, sample_time);
+    compressor_amps_avg.add(compressor_amps, sample_time);
+    geothermal_pump_amps_avg.add(geothermal_pump_amps, sample_time);
+
+    bool is_pressure_high = false;
+    FanStatus fan_status;
+    {
+        // Limit scope to reduce mutex hold time
+        ConfigManagerAccessor config;
+        if (amps <= config->getFanOffCurrentThreshold()) {
+            fan_status = FAN_STATUS_OFF;
+        } else if (amps < config->getFanOnCurrentThreshold() || amps > config->getFanHighCurrentThreshold()) {
+            fan_status = FAN_STATUS_ALERT;
+        } else {
+            fan_status = FAN_STATUS_NORMAL;
+        }
+        is_pressure_high = (diff_pressure_avg.getAverage() > config->getHighPressureThreshold());
+    }
+    UITask::getInstance().update_high_pressure_status(is_pressure_high);
+    UITask::getInstance().update_pressure(diff_pressure_avg.getAverage());
+    
+    geigerCounter.checkAndLogHighRadiation();
+    float usv_h = geigerCounter.getDoseRate();
+    UITask::getInstance().update_geiger_reading(c, usv_h);
+
+    UITask::getInstance().update_temp_humi(t, h);
+    UITask::getInstance().update_fan_current(amps, fan_status);
+    UITask::getInstance().update_compressor_amps(compressor_amps_avg.getAverage());
+    UITask::getInstance().update_pump_amps(geothermal_pump_amps_avg.getAverage());
+    UITask::getInstance().update_co2(co2_avg.getAverage());
+    UITask::getInstance().update_voc(voc_avg.getAverage());
+    UITask::getInstance().update_nox(nox_avg.getAverage());
+    UITask::getInstance().update_pm_values(pm1_avg.getAverage(), pm25_avg.getAverage(), pm4_avg.getAverage(), pm10_avg.getAverage());
+    UITask::getInstance().update_co(co_avg.getAverage());
+
+    haManager.publishHighPressureStatus(is_pressure_high);
+    haManager.publishFanStatus(fan_status != FAN_STATUS_OFF);
+    haManager.publishSensorData(diff_pressure_avg.getAverage(), c, t, h, 
+        co2_avg.getAverage(), 
+        voc_avg.getAverage(), nox_avg.getAverage(), 
+        amps,
+        pm1_avg.getAverage(), pm25_avg.getAverage(), pm4_avg.getAverage(), pm10_avg.getAverage(),
+        compressor_amps_avg.getAverage(), geothermal_pump_amps_avg.getAverage(), liquid_level_sensor_state,
+        co_avg.getAverage());
+
+    sensorTask.setEnvironmentalData(t, h);
+}
+
+void process_binary_frame(uint8_t type, uint8_t request_id, const uint8_t* payload, size_t payload_len, int64_t received_us) {
+    mark_valid_frame_received();
+    complete_nano_request(request_id, type, received_us);
+
+    switch (type) {
+        case RSP_SENSORS: {
+            if (payload_len != sizeof(NanoSensorFrame)) {
+                logger.warningf("Binary RSP_SENSORS has wrong size: %u bytes (expected %u)", payload_len, sizeof(NanoSensorFrame));
+                return;
             }
-            UITask::getInstance().update_high_pressure_status(is_pressure_high);
-            UITask::getInstance().update_pressure(diff_pressure_avg.getAverage());
-            
-            geigerCounter.checkAndLogHighRadiation();
-            float usv_h = geigerCounter.getDoseRate();
-            UITask::getInstance().update_geiger_reading(c, usv_h);
-
-            UITask::getInstance().update_temp_humi(t, h);
-            UITask::getInstance().update_fan_current(amps, fan_status);
-            UITask::getInstance().update_compressor_amps(compressor_amps_avg.getAverage());
-            UITask::getInstance().update_pump_amps(geothermal_pump_amps_avg.getAverage());
-            UITask::getInstance().update_co2(co2_avg.getAverage());
-            UITask::getInstance().update_voc(voc_avg.getAverage());
-            UITask::getInstance().update_nox(nox_avg.getAverage());
-            UITask::getInstance().update_pm_values(pm1_avg.getAverage(), pm25_avg.getAverage(), pm4_avg.getAverage(), pm10_avg.getAverage());
-            UITask::getInstance().update_co(co_avg.getAverage());
-
-            haManager.publishHighPressureStatus(is_pressure_high);
-            haManager.publishFanStatus(fan_status != FAN_STATUS_OFF);
-            haManager.publishSensorData(diff_pressure_avg.getAverage(), c, t, h, 
-                co2_avg.getAverage(), 
-                voc_avg.getAverage(), nox_avg.getAverage(), 
-                amps,
-                pm1_avg.getAverage(), pm25_avg.getAverage(), pm4_avg.getAverage(), pm10_avg.getAverage(),
-                compressor_amps_avg.getAverage(), geothermal_pump_amps_avg.getAverage(), liquid_level_sensor_state,
-                co_avg.getAverage());
-
-            sensorTask.setEnvironmentalData(t, h);
+            // Keyframe, the following deltas apply to it
+            memcpy(&sensor_snapshot, payload, sizeof(sensor_snapshot));
+            sensor_snapshot_valid = true;
+            handle_sensor_frame(sensor_snapshot, true);
+            break;
+        }
+        case RSP_SENSORS_DELTA: {
+            if (!sensor_snapshot_valid) {
+                break; // Waiting for the next keyframe
+            }
+            if (!sensor_delta_apply(sensor_snapshot, payload, payload_len)) {
+                // Lost frame or corrupted delta, the next keyframe resynchronizes and counts the gap
+                logger.warningf("Sensor delta frame does not follow seq=%u, waiting for a keyframe", sensor_snapshot.sequence);
+                sensor_snapshot_valid = false;
+                break;
+            }
+            handle_sensor_frame(sensor_snapshot, true);
+            break;
+        }
+        default:
+            logger.warningf("Unknown binary frame type from Nano: 0x%02X", type);
+            break;
+    }
+}
+
+// data_part is the checksum-validated DATA of a "<DATA,CRC8>" packet, with the
+// request ID tag already stripped. It is NUL terminated and owned by the
+// caller, decoders tokenize it in place. received_us is esp_timer_get_time()
+// when its last byte was parsed.
+void process_packet(char* data_part, size_t data_len, uint8_t request_id, int64_t received_us) {
+#ifdef SERIAL_PACKET_DEBUG
+    // Log all received packets for debugging
+    logger.debugf("ESP32: Received packet from Nano: %s", data_part);
+#endif
+
+    mark_valid_frame_received();
+
+    char cmd = data_part[0];
+    char* payload = data_part + 1;
+    complete_nano_request(request_id, cmd, received_us);
+
+    switch (cmd) {
+        case RSP_SENSORS: {
+            // Layout from PROTOCOL_SENSORS_FIELDS, firmware predating sequence numbers omits the last field
+            NanoSensorFrame frame;
+            frame.sequence = 0;
+            uint8_t field_count = protocol_ascii_decode(payload, frame);
+            if (field_count < ProtocolMessage<NanoSensorFrame>::field_count - 1) return;
+            handle_sensor_frame(frame, field_count == ProtocolMessage<NanoSensorFrame>::field_count);
             break;
         }
         case RSP_VERSION: {
-            haManager.publishSensorStackVersion(payload.c_str());
-            last_nano_version = payload;
-            UITask::getInstance().update_fw_version(last_nano_version.c_str());
-            if (init_sequence_active && pending_init_commands[current_init_command_index] == CMD_VERSION) {
-                current_init_command_index++;
+            // Format: v<version>[,<capabilities_hex>]. Firmware predating capabilities omits the suffix.
+            uint16_t capabilities = 0;
+            char* caps_sep = strrchr(payload, ',');
+            if (caps_sep) {
+                *caps_sep = '\0';
+                capabilities = strtoul(caps_sep + 1, nullptr, 16);
+            }
+            if (capabilities != nano_capabilities) {
+                logger.infof("Sensor Stack capabilities: 0x%02X, telemetry format: %s",
+                    capabilities, (capabilities & PROTOCOL_CAP_BINARY_FRAMES) ? "binary" : "ASCII");
             }
+            nano_capabilities = capabilities;
+
+            haManager.publishSensorStackVersion(payload);
+            strlcpy(last_nano_version, payload, sizeof(last_nano_version));
+            UITask::getInstance().update_fw_version(last_nano_version);
+            advance_init_sequence(CMD_VERSION);
             break;
         }
         case RSP_HEALTH: {
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
             
-            char* token = strtok(payload_cstr, ","); 
+            char* token = strtok(payload, ","); 
             if (!token) return; 
             int first_time_flag = atoi(token);
             
@@ -418,8 +721,13 @@ void process_packet(String packet) {
             uint8_t nano_reset_cause = 0; 
             if (token) nano_reset_cause = atoi(token);
             const char* reset_cause_str = nano_reset_cause_to_string(nano_reset_cause);
+
+            // Longest sensor job since the last health response, firmware 1.17.0 and later
+            token = strtok(NULL, ",");
+            const bool has_bus_wait = (token != NULL);
+            const uint16_t nano_bus_wait_ms = has_bus_wait ? atoi(token) : 0;
 #ifdef SERIAL_PACKET_DEBUG
-            logger.debugf("Nano Health: FirstTimeFlag=%d, FreeRAM=%d bytes, ResetCause=%s", first_time_flag, nano_free_ram, reset_cause_str);
+            logger.debugf("Nano Health: FirstTimeFlag=%d, FreeRAM=%d bytes, ResetCause=%s, BusWait=%u ms", first_time_flag, nano_free_ram, reset_cause_str, nano_bus_wait_ms);
 #endif
             if (first_time_flag == 0 || !first_health_packet_received) {
                 logger.infof("Sensor Stack Health: Flag=%d, FreeRAM=%d bytes, ResetCause=%s", first_time_flag, nano_free_ram, reset_cause_str);
@@ -430,6 +738,9 @@ void process_packet(String packet) {
             }
             haManager.publishSensorStackFreeRam(nano_free_ram);
             haManager.publishNanoResetCause(reset_cause_str);
+            if (has_bus_wait) {
+                haManager.publishSensorStackBusWait(nano_bus_wait_ms);
+            }
             last_nano_ram = nano_free_ram;
 
             // Store first_time_flag for ZMOD4510 manager processing in main loop
@@ -440,48 +751,115 @@ void process_packet(String packet) {
                 nano_boot_millis = millis();
                 logger.warning("Nano reported first boot (or reboot). Uptime counter reset.");
                 haManager.resetSensorStackUptimePublishTime();
+                // A rebooted Nano is back to untagged ASCII frames without a stream, renegotiate
+                sensor_stream_active = false;
+                nano_capabilities = 0;
+                nano_clock.reset();
+                I2CRegisterCache::getInstance().invalidate("Sensor Stack rebooted");
+                revert_link_baud_rate("Sensor Stack rebooted");
+                if (!init_sequence_active) {
+                    restart_init_sequence();
+                }
             }
-            if (health_request_pending) {
-                health_request_pending = false;
+            advance_init_sequence(CMD_HEALTH);
+            break;
+        }
+        case RSP_SENSOR_STREAM: {
+            // Format: u<period_ms>
+            unsigned long period_ms = strtoul(payload, nullptr, 10);
+            sensor_stream_active = (period_ms > 0);
+            if (sensor_stream_active) {
+                logger.infof("Sensor Stack streaming sensor data every %lu ms", period_ms);
+            } else {
+                logger.info("Sensor Stack stream stopped, polling sensor data");
+            }
+            advance_init_sequence(CMD_STREAM);
+            break;
+        }
+        case RSP_BAUD_RATE: {
+            // Format: b<baud>, sent at the old rate. The Nano switches right after it.
+            unsigned long baud = strtoul(payload, nullptr, 10);
+            if (baud_negotiation != BAUD_REQUESTED) {
+                break;
             }
-            if (init_sequence_active && pending_init_commands[current_init_command_index] == CMD_HEALTH) {
-                current_init_command_index++;
+            if (baud == NanoLink::getInstance().baudRate()) {
+                logger.infof("Sensor Stack stays at %lu baud", baud);
+                baud_negotiation = BAUD_IDLE;
+                baud_attempt_failed = true;
+                baud_failure_time = millis();
+                break;
             }
+            NanoLink::getInstance().setBaudRate(baud);
+            baud_switch_time = millis();
+            baud_negotiation = BAUD_SWITCHED;
             break;
         }
-        case RSP_SPS30_INFO: {
-            // Format: p<ret_fw>,<fw_version_major>,<fw_version_minor>,<ret_fan_interval>,<fan_interval>,<ret_fan_days>,<fan_days>,<ret_status>,<status_reg>
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
-            char* token = strtok(payload_cstr, ","); if (!token) return; int ret_fw = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; int fw_version_major = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; int fw_version_minor = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; int ret_fan_interval = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; unsigned long fan_interval = strtoul(token, nullptr, 10);
-            token = strtok(NULL, ","); if (!token) return; int ret_fan_days = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; unsigned long fan_days = strtoul(token, nullptr, 10);
-            token = strtok(NULL, ","); if (!token) return; int ret_status = atoi(token);
-            token = strtok(NULL, ","); if (!token) return; unsigned long status_reg = strtoul(token, nullptr, 10);
-
-            logger.debugf("SPS30 Info: FwVersion(ret=%d): %u.%u, FanInterval(ret=%d): %lu, FanDays(ret=%d): %lu, StatusReg(ret=%d): 0x%lX",
-                ret_fw, fw_version_major, fw_version_minor,
-                ret_fan_interval, fan_interval,
-                ret_fan_days, fan_days,
-                ret_status, status_reg
-            );
-            UITask::getInstance().update_sps30_fan_interval(fan_interval);
-            UITask::getInstance().update_sps30_fan_days(fan_days);
-            if (init_sequence_active && pending_init_commands[current_init_command_index] == CMD_SPS30_INFO) {
-                current_init_command_index++;
+        case RSP_PING: {
+            if (baud_negotiation == BAUD_VERIFYING) {
+                baud_negotiation = BAUD_IDLE;
+                baud_attempt_failed = false;
+                reset_baud_error_window();
+                logger.infof("Nano link running at %lu baud", (unsigned long)NanoLink::getInstance().baudRate());
+            }
+            break;
+        }
+        case RSP_TIME_SYNC: {
+            // Format: z<t1>,<t2>,<t3>, t1 holds the low 32 bits of our send time in us
+            char* pos = payload;
+            uint32_t t1_low = strtoul(pos, &pos, 16);
+            if (*pos++ != ',') return;
+            uint32_t t2 = strtoul(pos, &pos, 16);
+            if (*pos++ != ',') return;
+            uint32_t t3 = strtoul(pos, nullptr, 16);
+            int64_t t1 = received_us - (uint32_t)((uint32_t)received_us - t1_low);
+            bool was_synchronized = nano_clock.isSynchronized();
+            nano_clock.addSample(t1, t2, t3, received_us);
+            if (!was_synchronized && nano_clock.isSynchronized()) {
+                logger.infof("Sensor Stack clock synchronized, round trip %lu us", (unsigned long)nano_clock.anchorDelayUs());
+            }
+#ifdef SERIAL_PACKET_DEBUG
+            logger.debugf("Nano clock: offset=%lld us, drift=%.1f ppm, delay=%lu us, samples=%u",
+                nano_clock.offsetUs(), nano_clock.driftPpm(), (unsigned long)nano_clock.anchorDelayUs(), nano_clock.sampleCount());
+#endif
+            break;
+        }
+        case RSP_EVENT: {
+            // Format: e<code hex>,<param hex>
+            char* param_sep = nullptr;
+            uint8_t code = strtoul(payload, &param_sep, 16);
+            uint16_t param = (*param_sep == ',') ? strtoul(param_sep + 1, nullptr, 16) : 0;
+            handle_nano_event(code, param);
+            break;
+        }
+        case RSP_LEGACY_EVENT: {
+            // Format: E,<text>
+            const char* text = (payload[0] == ',') ? payload + 1 : payload;
+            for (const LegacyNanoEvent& event : legacy_nano_events) {
+                if (strcmp(text, event.text) == 0) {
+                    handle_nano_event(event.code, event.param);
+                    return;
+                }
             }
+            logger.warningf("SensorStack: Unknown event: %s", data_part);
+            break;
+        }
+        case RSP_SPS30_INFO: {
+            // Layout from PROTOCOL_SPS30_INFO_FIELDS
+            Sps30InfoFrame info;
+            if (protocol_ascii_decode(payload, info) < ProtocolMessage<Sps30InfoFrame>::field_count) return;
+
+            char info_text[192];
+            protocol_debug_format(info, info_text, sizeof(info_text));
+            logger.debugf("SPS30 Info: %s", info_text);
+            UITask::getInstance().update_sps30_fan_interval(info.fan_interval);
+            UITask::getInstance().update_sps30_fan_days(info.fan_days);
+            advance_init_sequence(CMD_SPS30_INFO);
             break;
         }
         case RSP_SPS30_CLEAN: {
             // Format: c<ret_status>    
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
 
-            char* token = strtok(payload_cstr, ","); 
+            char* token = strtok(payload, ","); 
             if (!token) return; 
             int ret_status = atoi(token);
 
@@ -489,10 +867,8 @@ void process_packet(String packet) {
         }
         case RSP_SGP41_TEST: {
             // Format: g<ret_status>,<raw_value>
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
 
-            char* token = strtok(payload_cstr, ","); 
+            char* token = strtok(payload, ","); 
             if (!token) return; 
             int ret_status = atoi(token);
 
@@ -506,67 +882,28 @@ void process_packet(String packet) {
             break;
         }
         case RSP_SCD30_INFO: {
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
-
-            auto parse_hex_u16 = [](const char* token) -> uint16_t {
-                return static_cast<uint16_t>(strtol(token, nullptr, 16));
-            };
-
-            auto parse_hex_s16 = [](const char* token) -> int16_t {
-                return static_cast<int16_t>(static_cast<uint16_t>(strtol(token, nullptr, 16)));
-            };
-
-            char* token;
-
-            token = strtok(payload_cstr, ","); int16_t ret_interval = parse_hex_s16(token);
-            token = strtok(NULL, ",");        uint16_t measurement_interval = parse_hex_u16(token);
-            token = strtok(NULL, ",");        int16_t ret_auto_cal = parse_hex_s16(token);
-            token = strtok(NULL, ",");        uint16_t auto_calibration = parse_hex_u16(token);
-            token = strtok(NULL, ",");        int16_t ret_forced_cal = parse_hex_s16(token);
-            token = strtok(NULL, ",");        uint16_t forced_recalibration_value = parse_hex_u16(token);
-            token = strtok(NULL, ",");        int16_t ret_temp_offset = parse_hex_s16(token);
-            token = strtok(NULL, ",");        uint16_t temperature_offset = parse_hex_u16(token);
-            token = strtok(NULL, ",");        int16_t ret_altitude = parse_hex_s16(token);
-            token = strtok(NULL, ",");        uint16_t altitude_compensation = parse_hex_u16(token);
-            token = strtok(NULL, ",");        int16_t ret_firmware = parse_hex_s16(token);
-            token = strtok(NULL, ",");        uint8_t fw_major = parse_hex_u16(token);
-            token = strtok(NULL, ",");        uint8_t fw_minor = parse_hex_u16(token);
+            // Layout from PROTOCOL_SCD30_INFO_FIELDS
+            Scd30InfoFrame info;
+            if (protocol_ascii_decode(payload, info) < ProtocolMessage<Scd30InfoFrame>::field_count) return;
 
 #ifdef SERIAL_PACKET_DEBUG
-            logger.debugf(
-                "SCD30 Info: "
-                "MeasurementInterval(ret=%d): %u, "
-                "AutoCalibration(ret=%d): %s, "
-                "ForcedRecalibrationValue(ret=%d): %u, "
-                "TemperatureOffset(ret=%d): %u, "
-                "AltitudeCompensation(ret=%d): %u, "
-                "FwVersion(ret=%d): %u.%u",
-                ret_interval, measurement_interval,
-                ret_auto_cal, auto_calibration ? "ON" : "OFF",
-                ret_forced_cal, forced_recalibration_value,
-                ret_temp_offset, temperature_offset,
-                ret_altitude, altitude_compensation,
-                ret_firmware, fw_major, fw_minor
-            );
+            char info_text[320];
+            protocol_debug_format(info, info_text, sizeof(info_text));
+            logger.debugf("SCD30 Info: %s", info_text);
 #endif
             // Update the AutoCalibration switch state and Force Calibration value in Home Assistant and UI
-            haManager.updateScd30AutoCalState(auto_calibration != 0);
-            haManager.updateScd30ForceCalValue(forced_recalibration_value);
-            UITask::getInstance().update_scd30_autocal(auto_calibration != 0);
-            UITask::getInstance().update_scd30_forcecal(forced_recalibration_value);
+            haManager.updateScd30AutoCalState(info.auto_calibration != 0);
+            haManager.updateScd30ForceCalValue(info.forced_recalibration);
+            UITask::getInstance().update_scd30_autocal(info.auto_calibration != 0);
+            UITask::getInstance().update_scd30_forcecal(info.forced_recalibration);
 
-            if (init_sequence_active && pending_init_commands[current_init_command_index] == CMD_SCD30_INFO) {
-                current_init_command_index++;
-            }
+            advance_init_sequence(CMD_SCD30_INFO);
             break;
         }
         case RSP_SCD30_AUTOCAL: {
             // Format: t<set_result>,<read_result>,<actual_state>
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
 
-            char* token = strtok(payload_cstr, ","); 
+            char* token = strtok(payload, ","); 
             if (!token) return; 
             int set_result = strtol(token, nullptr, 16);
 
@@ -587,10 +924,8 @@ void process_packet(String packet) {
         }
         case RSP_SCD30_FORCECAL: {
             // Format: f<set_result>,<read_result>,<actual_value>
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
 
-            char* token = strtok(payload_cstr, ","); 
+            char* token = strtok(payload, ","); 
             if (!token) return; 
             int set_result = strtol(token, nullptr, 16);
 
@@ -609,18 +944,93 @@ void process_packet(String packet) {
             haManager.updateScd30ForceCalValue(actual_value);
             break;
         }
+        default:
+            logger.warningf("Unknown command from Nano: %c", cmd);
+            break;
+    }
+
+    if (init_sequence_active && pending_init_commands[current_init_command_index] == CMD_NONE) {
+        init_sequence_active = false;
+    }
+}
+
+// Binary bridge frames, layouts under "Binary Bridge Frames" in protocol/Frames.h
+static void process_binary_bridge_frame(char type, uint8_t request_id, uint8_t* payload, size_t payload_len) {
+    switch (type) {
+        case RSP_I2C_READ: {
+            if (payload_len < 1) return;
+            if (payload[0] != I2C_ERROR_NONE) {
+                logger.warningf("I2C read error: 0x%02X", payload[0]);
+            }
+            I2CBridge::getInstance().processReadResponse(request_id, payload[0], payload + 1, payload_len - 1);
+            break;
+        }
+        case RSP_I2C_WRITE: {
+            if (payload_len != 1) return;
+            if (payload[0] != I2C_ERROR_NONE) {
+                logger.warningf("I2C write error: 0x%02X", payload[0]);
+            }
+            I2CBridge::getInstance().processWriteResponse(request_id, type, payload[0]);
+            break;
+        }
+        case RSP_I2C_SCRIPT: {
+            // Statuses as the digits of the ASCII response
+            const uint8_t step_count = payload_len > 0 ? payload[0] : 0;
+            if (payload_len < 1u + step_count || step_count > I2C_SCRIPT_MAX_STEPS) return;
+            char statuses[I2C_SCRIPT_MAX_STEPS + 1];
+            for (uint8_t i = 0; i < step_count; i++) {
+                statuses[i] = '0' + payload[1 + i];
+            }
+            statuses[step_count] = '\0';
+            I2CBridge::getInstance().processScriptResponse(request_id, statuses, payload + 1 + step_count, payload_len - 1 - step_count);
+            break;
+        }
+        case RSP_I2C_WATCH_DATA: {
+            if (payload_len < 2) return;
+            I2CBridge::getInstance().processWatchPush(payload[0], payload[1], payload + 2, payload_len - 2);
+            break;
+        }
+        case RSP_I2C_SEGMENT: {
+            if (payload_len < 3) return;
+            I2CBridge::getInstance().processSegment(payload[0], payload[1] | (payload[2] << 8), payload + 3, payload_len - 3);
+            break;
+        }
+        default:
+            logger.warningf("Unknown binary bridge frame from Nano: 0x%02X", type);
+            break;
+    }
+}
+
+// PROTOCOL_CHANNEL_BRIDGE frames, called on the NanoLink RX task so the
+// waiting I2CBridge caller is woken without a trip through loop(). Only
+// touches thread-safe state, the rest is left to loop().
+void process_bridge_frame(NanoFrame& frame) {
+    char* data_part = frame.data;
+    char cmd = (frame.kind == NanoFrame::ASCII) ? data_part[0] : frame.type;
+    char* payload = data_part + 1;
+    nano_bridge_frame_received = true;
+    complete_nano_request(frame.request_id, cmd, frame.received_us);
+
+    if (frame.kind == NanoFrame::BINARY) {
+        process_binary_bridge_frame(cmd, frame.request_id, reinterpret_cast<uint8_t*>(frame.data), frame.length);
+        return;
+    }
+#ifdef SERIAL_PACKET_DEBUG
+    logger.debugf("ESP32: Received bridge packet from Nano: %s", data_part);
+#endif
+
+    switch (cmd) {
         case RSP_I2C_READ: {
             // Format: i<status_byte>,<num_bytes>[,<byte1>,<byte2>,...]
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
             
             // Parse status byte
-            char* token = strtok(payload_cstr, ","); 
+            char* save = nullptr;
+            char* token = strtok_r(payload, ",", &save); 
             if (!token) return; 
             uint8_t status = strtol(token, nullptr, 16);
             
             // Parse number of bytes
-            token = strtok(NULL, ","); 
+            token = strtok_r(NULL, ",", &save); 
             if (!token) return; 
             uint8_t num_bytes = strtol(token, nullptr, 16);
             
@@ -628,7 +1038,7 @@ void process_packet(String packet) {
             uint8_t data[32]; // Max 32 bytes
             uint8_t bytes_read = 0;
             
-            while ((token = strtok(NULL, ",")) != NULL && bytes_read < num_bytes) {
+            while ((token = strtok_r(NULL, ",", &save)) != NULL && bytes_read < num_bytes) {
                 data[bytes_read++] = strtol(token, nullptr, 16);
             }
             
@@ -638,28 +1048,18 @@ void process_packet(String packet) {
             
             if (status != I2C_ERROR_NONE) {
                 logger.warningf("I2C read error: 0x%02X", status);
-            } else {
-                // Log the received data bytes
-                String hexData;
-                for (int i = 0; i < bytes_read; i++) {
-                    if (i > 0) hexData += " ";
-                    char hex[4];
-                    sprintf(hex, "%02X", data[i]);
-                    hexData += hex;
-                }
             }
             
-            // Update the I2CBridge with the response and send to queue
-            I2CBridge::getInstance().processReadResponse(status, data, bytes_read);
+            // Completes the waiting I2CBridge transaction
+            I2CBridge::getInstance().processReadResponse(frame.request_id, status, data, bytes_read);
             break;
         }
         case RSP_I2C_WRITE: {
             // Format: w<status_byte>
-            char payload_cstr[payload.length() + 1];
-            strcpy(payload_cstr, payload.c_str());
             
             // Parse status byte
-            char* token = strtok(payload_cstr, ","); 
+            char* save = nullptr;
+            char* token = strtok_r(payload, ",", &save); 
             if (!token) return; 
             uint8_t status = strtol(token, nullptr, 16);
             
@@ -667,18 +1067,88 @@ void process_packet(String packet) {
                 logger.warningf("I2C write error: 0x%02X", status);
             }
             
-            // Update the I2CBridge with the response and send to queue
-            I2CBridge::getInstance().processWriteResponse(status);
+            // Completes the waiting I2CBridge transaction
+            I2CBridge::getInstance().processWriteResponse(frame.request_id, cmd, status);
+            break;
+        }
+        case RSP_I2C_WRITE_CHUNK:
+        case RSP_I2C_WATCH:
+        case RSP_I2C_WRITE_BLOCK: {
+            // Format: y<status_byte>, I2C_ERROR_PENDING acknowledges a staged chunk. j<status_byte> answers CMD_I2C_WATCH,
+            // o<status_byte> a block write segment.
+            uint8_t status = strtol(payload, nullptr, 16);
+            I2CBridge::getInstance().processWriteResponse(frame.request_id, cmd, status);
+            break;
+        }
+        case RSP_I2C_SCRIPT: {
+            // Format: q<status digit per step>,<read data as one hex string>
+            char* data_hex = strchr(payload, ',');
+            if (!data_hex) return;
+            *data_hex++ = '\0';
+
+            uint8_t data[I2C_SCRIPT_MAX_READ];
+            uint8_t len = 0;
+            while (len < sizeof(data) && isxdigit(data_hex[0]) && isxdigit(data_hex[1])) {
+                const char byte_hex[3] = { data_hex[0], data_hex[1], '\0' };
+                data[len++] = strtol(byte_hex, nullptr, 16);
+                data_hex += 2;
+            }
+            I2CBridge::getInstance().processScriptResponse(frame.request_id, payload, data, len);
+            break;
+        }
+        case RSP_I2C_WATCH_DATA: {
+            // Format: n<slot>,<status>,<read data as one hex string>
+            char* end = nullptr;
+            const uint8_t id = strtol(payload, &end, 16);
+            if (end == payload || *end != ',') return;
+            const char* p = end + 1;
+            const uint8_t status = strtol(p, &end, 16);
+            if (end == p || *end != ',') return;
+            const char* data_hex = end + 1;
+
+            uint8_t data[I2C_WATCH_MAX_LEN + 1];
+            uint8_t len = 0;
+            while (len < sizeof(data) && isxdigit(data_hex[0]) && isxdigit(data_hex[1])) {
+                const char byte_hex[3] = { data_hex[0], data_hex[1], '\0' };
+                data[len++] = strtol(byte_hex, nullptr, 16);
+                data_hex += 2;
+            }
+            I2CBridge::getInstance().processWatchPush(id, status, data, len);
+            break;
+        }
+        case RSP_I2C_SEGMENT: {
+            // Format: m<xfer>,<offset>,<read data as one hex string>
+            char* end = nullptr;
+            const uint8_t xfer_id = strtol(payload, &end, 16);
+            if (end == payload || *end != ',') return;
+            const char* p = end + 1;
+            const uint16_t offset = strtol(p, &end, 16);
+            if (end == p || *end != ',') return;
+            const char* data_hex = end + 1;
+
+            uint8_t data[I2C_TRANSFER_READ_SEGMENT];
+            uint8_t len = 0;
+            while (len < sizeof(data) && isxdigit(data_hex[0]) && isxdigit(data_hex[1])) {
+                const char byte_hex[3] = { data_hex[0], data_hex[1], '\0' };
+                data[len++] = strtol(byte_hex, nullptr, 16);
+                data_hex += 2;
+            }
+            I2CBridge::getInstance().processSegment(xfer_id, offset, data, len);
+            break;
+        }
+        case RSP_I2C_READ_BLOCK: {
+            // Format: l<xfer>,<status>,<bytes sent>
+            char* save = nullptr;
+            if (!strtok_r(payload, ",", &save)) return;
+            const char* status_token = strtok_r(NULL, ",", &save);
+            const char* len_token = strtok_r(NULL, ",", &save);
+            if (!status_token || !len_token) return;
+            I2CBridge::getInstance().processReadBlockResponse(frame.request_id, strtol(status_token, nullptr, 16), strtol(len_token, nullptr, 16));
             break;
         }
         default:
-            logger.warningf("Unknown command from Nano: %c", cmd);
             break;
     }
-
-    if (init_sequence_active && pending_init_commands[current_init_command_index] == CMD_NONE) {
-        init_sequence_active = false;
-    }
 }
 
 // =================== SETUP & LOOP ===================
@@ -700,12 +1170,15 @@ void setup_wifi() {
 }
 
 void setup() {
+#ifdef SERIAL_OUT_DEBUG
+    Serial.begin(CONSOLE_BAUD_RATE);
+#endif
     SerialMutex::getInstance().init();
     MainTaskEventNotifier::getInstance().setMainTaskHandle(xTaskGetCurrentTaskHandle());
     vTaskPrioritySet(NULL, tskIDLE_PRIORITY + 3); // above other tasks priorities
     logger.info("--- System Booting ---");
-    Serial.begin(19200);
-    //Serial.begin(115200);
+    NanoLink::getInstance().setChannelHandler(PROTOCOL_CHANNEL_BRIDGE, process_bridge_frame);
+    NanoLink::getInstance().begin();
     {
         // Limit scope to reduce mutex hold time
         ConfigManagerAccessor config;
@@ -728,18 +1201,17 @@ void setup() {
     otaManager.init();
 
     I2CBridge::begin();
+    I2CRegisterCache::getInstance().begin();
     
     sensorTask.init();
     
-    init_sequence_active = true;
-    current_init_command_index = 0;
+    restart_init_sequence();
     logger.info("Starting init sequence with Sensor Stack...");
 }
 
 
 void loop() {
     bool serial_command_sent_this_loop = false;
-    static bool valid_packet_start_received = false;
     
     haManager.loop();
     
@@ -771,74 +1243,89 @@ void loop() {
     
     logger.loop();
 
-    while (Serial.available() > 0) {
-        char incoming_char = Serial.read();
-        
-        // Skip carriage return and line feed characters
-        if (incoming_char == '\r' || incoming_char == '\n') {
-            continue;
-        }
-        
-        if (valid_packet_start_received == false && incoming_char == '<') {
-            serial_buffer = "";
-            valid_packet_start_received = true;
-        } else if (valid_packet_start_received && incoming_char == '>') {
-            if (serial_buffer.length() > 0) {
-                process_packet("<" + serial_buffer + ">");
-            }
-            serial_buffer = "";
-            valid_packet_start_received = false;
-            break;
-        } else if (valid_packet_start_received && serial_buffer.length() < 255) {
-            serial_buffer += incoming_char;
+    // Frames are parsed by the NanoLink RX task as they arrive, handle all of
+    // them. Bridge responses were already dispatched on that task.
+    if (nano_bridge_frame_received) {
+        nano_bridge_frame_received = false;
+        mark_valid_frame_received();
+    }
+    static NanoFrame nano_frame;
+    while (NanoLink::getInstance().receive(nano_frame)) {
+        if (nano_frame.kind == NanoFrame::ASCII) {
+            process_packet(nano_frame.data, nano_frame.length, nano_frame.request_id, nano_frame.received_us);
         } else {
-            logger.warningf("Invalid character received: %c", incoming_char);
-            serial_buffer = "";
-            valid_packet_start_received = false; // Reset state on invalid char
+            process_binary_frame(nano_frame.type, nano_frame.request_id, reinterpret_cast<const uint8_t*>(nano_frame.data), nano_frame.length, nano_frame.received_us);
         }
     }
 
+    NanoRequestTable::Entry expired;
+    while (nano_requests.popExpired(millis(), expired)) {
+        logger.warningf("No response to %c (request #%u) from Sensor Stack within %lu ms.",
+            expired.cmd, expired.id, expired.deadline - expired.sent_time);
+        NanoLinkMetrics::getInstance().count(protocol_response_for(expired.cmd), NanoLinkMetrics::TIMEOUTS);
+        link_baud_request_expired(expired.cmd);
+    }
+    update_link_baud_rate();
+
     if (millis() - last_wifi_check_time > WIFI_CHECK_INTERVAL_MS) {
         last_wifi_check_time = millis();
         update_wifi_status();
     }
 
-    if (!serial_command_sent_this_loop && is_sensor_module_connected && (millis() - last_health_check_time > HEALTH_CHECK_INTERVAL_MS)) {
+    if (nano_can_accept_command(serial_command_sent_this_loop) && is_sensor_module_connected && (millis() - last_health_check_time > HEALTH_CHECK_INTERVAL_MS)) {
         last_health_check_time = millis();
         send_command_to_nano(CMD_GET_HEALTH);
-        last_health_request_time = millis();
-        health_request_pending = true;
     }
 
-    if (health_request_pending && (millis() - last_health_request_time > HEALTH_RESPONSE_TIMEOUT_MS)) {
-        logger.warning("No response to CMD_GET_HEALTH from Sensor Stack within 500ms.");
-        health_request_pending = false;
-    }
-
-    // Handle init sequence - send commands even if sensor module not connected
+    // Handle init sequence - send commands even if sensor module not connected.
+    // Once the version response shows request ID support, the remaining steps
+    // go out back to back instead of one per response.
     if (init_sequence_active) {
+        while (pending_init_commands[current_init_command_index] != CMD_NONE &&
+               !init_command_supported(pending_init_commands[current_init_command_index])) {
+            current_init_command_index++;
+        }
+        if (next_init_command_index < current_init_command_index) {
+            next_init_command_index = current_init_command_index;
+        }
+
+        const bool pipelined = (nano_capabilities & PROTOCOL_CAP_REQUEST_IDS) != 0;
+        const unsigned long init_timeout_ms = pipelined ? INIT_PIPELINE_TIMEOUT_MS : INIT_COMMAND_TIMEOUT_MS;
         if (pending_init_commands[current_init_command_index] == CMD_NONE) {
             init_sequence_active = false;
             logger.info("Init sequence completed successfully.");
-        } else if ((millis() - last_init_command_time > INIT_COMMAND_TIMEOUT_MS) || (last_init_command_time == 0)) {
-            char cmd_to_send = 0;
-            switch (pending_init_commands[current_init_command_index]) {
-                case CMD_VERSION: cmd_to_send = CMD_GET_VERSION; break;
-                case CMD_HEALTH: cmd_to_send = CMD_GET_HEALTH; break;
-                case CMD_SPS30_INFO: cmd_to_send = CMD_GET_SPS30_INFO; break;
-                case CMD_SCD30_INFO: cmd_to_send = CMD_GET_SCD30_INFO; break;
+        } else {
+            if (last_init_command_time != 0 && millis() - last_init_command_time > init_timeout_ms) {
+                // Responses overdue, send again from the first unanswered step
+                next_init_command_index = current_init_command_index;
             }
-            if (cmd_to_send) {
-                logger.infof("Sending init command %d/%d: %c", current_init_command_index + 1, 4, cmd_to_send);
-                send_command_to_nano(cmd_to_send);
-                last_init_command_time = millis();
-                serial_command_sent_this_loop = true;
+            while (pending_init_commands[next_init_command_index] != CMD_NONE &&
+                   (pipelined || next_init_command_index == current_init_command_index) &&
+                   nano_can_accept_command(serial_command_sent_this_loop)) {
+                InitCommand command = pending_init_commands[next_init_command_index];
+                if (init_command_supported(command)) {
+                    send_init_command(command, init_timeout_ms);
+                    last_init_command_time = millis();
+                    serial_command_sent_this_loop = true;
+                }
+                next_init_command_index++;
             }
         }
     }
 
-    // Send sensor query every 2 seconds after init sequence is complete
-    if (!serial_command_sent_this_loop && is_sensor_module_connected && !init_sequence_active && 
+    // Clock exchange, faster until the estimator has a full set of samples
+    unsigned long time_sync_interval = (nano_clock.sampleCount() < NANO_CLOCK_SYNC_SAMPLES) ? NANO_CLOCK_SYNC_FAST_MS : NANO_CLOCK_SYNC_INTERVAL_MS;
+    if (nano_can_accept_command(serial_command_sent_this_loop) && is_sensor_module_connected && !init_sequence_active &&
+        nano_has_capability(PROTOCOL_CAP_TIME_SYNC) && (millis() - last_time_sync_time > time_sync_interval)) {
+        last_time_sync_time = millis();
+        char t1[9];
+        snprintf(t1, sizeof(t1), "%08lX", (unsigned long)(uint32_t)esp_timer_get_time());
+        send_command_to_nano_with_payload(CMD_TIME_SYNC, t1);
+        serial_command_sent_this_loop = true;
+    }
+
+    // Poll sensor data every 2 seconds after init sequence is complete, unless the Nano streams it
+    if (nano_can_accept_command(serial_command_sent_this_loop) && is_sensor_module_connected && !init_sequence_active && !sensor_stream_active &&
         (millis() - last_sensor_query_time > SENSOR_QUERY_INTERVAL_MS)) {
         last_sensor_query_time = millis();
         send_command_to_nano(CMD_GET_SENSORS);
@@ -850,6 +1337,11 @@ void loop() {
         uint32_t seconds_since_packet = (millis() - last_sensor_data_time) / 1000;
         uint32_t nano_current_uptime_seconds = is_sensor_module_connected ? (millis() - nano_boot_millis) / 1000 : 0;
         UITask::getInstance().update_last_packet_time(seconds_since_packet);
+        const NanoLinkMetrics::Summary link_metrics = NanoLinkMetrics::getInstance().summary();
+        UITask::getInstance().update_link_errors(link_metrics.errors + link_metrics.timeouts + link_metrics.gaps);
+        UITask::getInstance().update_link_latency(link_metrics.latency_p99_us);
+        haManager.publishNanoLinkMetrics(link_metrics);
+        haManager.publishI2cBridgeStats(I2CBridgeStats::getInstance().summary());
         haManager.publishSensorStackUptime(nano_current_uptime_seconds);
         haManager.publishEsp32FreeRam(ESP.getFreeHeap());
         haManager.publishEsp32Uptime(millis() / 1000);
@@ -879,20 +1371,24 @@ void loop() {
     if (millis() - last_sensor_data_time > NANO_PACKET_TIMEOUT_MS) {
         if (is_sensor_module_connected) {
             is_sensor_module_connected = false;
-            last_received_timestamp = 0; // Reset timestamp on disconnection
+            sensor_sequence_valid = false;
+            sensor_snapshot_valid = false;
+            sensor_stream_active = false;
+            nano_capabilities = 0;
             logger.warning("Sensor data timeout. Marking as disconnected.");
             UITask::getInstance().update_sensor_status(false);
             haManager.publishSensorConnectionStatus(false);
             haManager.setSensorStackVersionUnavailable();
             haManager.publishSensorStackUptime(0, true);
             UITask::getInstance().clearSensorReadings();
-            init_sequence_active = true;
-            current_init_command_index = 0;
+            nano_requests.clear();
+            revert_link_baud_rate("Sensor Stack disconnected");
+            restart_init_sequence();
             // Nano disconnected status will be handled in main loop
         }
     }
 
-    if (!serial_command_sent_this_loop && is_sensor_module_connected && (millis() - last_scd30_info_time > SCD30_INFO_INTERVAL_MS)) {
+    if (nano_can_accept_command(serial_command_sent_this_loop) && is_sensor_module_connected && (millis() - last_scd30_info_time > SCD30_INFO_INTERVAL_MS)) {
         last_scd30_info_time = millis();
         send_command_to_nano(CMD_GET_SCD30_INFO);
     }
@@ -993,7 +1489,7 @@ void loop() {
         logger.debugf("Main loop task remaining stack: %u bytes, free heap: %u bytes", remaining_stack, ESP.getFreeHeap());
     }
 
-    if (!serial_command_sent_this_loop) {
+    if (nano_can_accept_command(serial_command_sent_this_loop)) {
         MainTaskEventNotifier::getInstance().processOneEvent([&](MainTaskEventNotifier::EventBits event) {
             switch (event) {
                 case MainTaskEventNotifier::EVT_SCD30_AUTOCAL_ON:
@@ -106,6 +106,8 @@ void UI::update_sensorstack_ram(uint16_t v) { if (tileManager) tileManager->upda
 void UI::update_network_rssi(int8_t v) { if (tileManager) tileManager->update_network_rssi(v); }
 void UI::update_network_ha_conn(bool v) { if (tileManager) tileManager->update_network_ha_conn(v); update_ha_status(v); }
 void UI::update_last_packet_time(uint32_t v) { if (tileManager) tileManager->update_last_packet_time(v); }
+void UI::update_link_errors(uint32_t v) { if (tileManager) tileManager->update_link_errors(v); }
+void UI::update_link_latency(uint32_t v) { if (tileManager) tileManager->update_link_latency(v); }
 void UI::update_ssid(const char* ssid) { if (tileManager) tileManager->update_ssid(ssid); }
 void UI::update_ip(const char* ip) { if (tileManager) tileManager->update_ip(ip); }
 void UI::update_mac(const char* mac) { if (tileManager) tileManager->update_mac(mac); }
@@ -113,7 +113,28 @@ void UIRuntimeTile::update_sensor_status(bool connected) {
 }
 
 void UIRuntimeTile::update_last_packet_time(uint32_t seconds_since_packet) {
-    lv_label_set_text_fmt(pkt_label, "Pkt: %lu s", seconds_since_packet);
+    this->seconds_since_packet = seconds_since_packet;
+    refresh_packet_label();
+}
+
+void UIRuntimeTile::update_link_errors(uint32_t errors) {
+    link_errors = errors;
+    refresh_packet_label();
+}
+
+void UIRuntimeTile::update_link_latency(uint32_t p99_us) {
+    link_p99_us = p99_us;
+    refresh_packet_label();
+}
+
+void UIRuntimeTile::refresh_packet_label() {
+    if (!pkt_label) return;
+    if (link_errors == 0 && link_p99_us == 0) {
+        lv_label_set_text_fmt(pkt_label, "Pkt: %lu s", seconds_since_packet);
+    } else {
+        lv_label_set_text_fmt(pkt_label, "Pkt: %lu s, Err: %lu, p99: %lu ms",
+            seconds_since_packet, link_errors, (link_p99_us + 999) / 1000);
+    }
 }
 
 void UIRuntimeTile::high_pressure_blink_cb(lv_timer_t* timer) {
@@ -78,6 +78,8 @@ void UITileManager::update_network_rssi(int8_t v) { if (network_tile) network_ti
 void UITileManager::update_network_ha_conn(bool v) { if (network_tile) network_tile->update_network_ha_conn(v); }
 void UITileManager::update_sensor_status(bool v) { if (runtime_tile) runtime_tile->update_sensor_status(v); if (sensorstack_tile) sensorstack_tile->update_sensor_status(v); }
 void UITileManager::update_last_packet_time(uint32_t v) { if (runtime_tile) runtime_tile->update_last_packet_time(v); }
+void UITileManager::update_link_errors(uint32_t v) { if (runtime_tile) runtime_tile->update_link_errors(v); }
+void UITileManager::update_link_latency(uint32_t v) { if (runtime_tile) runtime_tile->update_link_latency(v); }
 void UITileManager::update_ssid(const char* ssid) { if (network_tile) network_tile->update_ssid(ssid); }
 void UITileManager::update_ip(const char* ip) { if (network_tile) network_tile->update_ip(ip); }
 void UITileManager::update_mac(const char* mac) { if (network_tile) network_tile->update_mac(mac); }
@@ -19,7 +19,7 @@
 #include <Wire.h>
 #include <stdio.h>
 #include "zmod4510/hal/arduino/arduino_hal.h"
-#include "I2CBridge.h"
+#include "I2CBus.h"
 #include "Logger.h"
 #include "SerialMutex.h"
 
@@ -58,28 +58,26 @@ _Delay ( uint32_t ms ) {
 
 static int
 _I2CRead ( void*  ifce, uint8_t  slAddr, uint8_t*  wrData, int  wrSize, uint8_t*  rdData, int  rdSize ) {
-  ( void) ifce;
+  // The I2CBus ZMOD4510Sensor::initHAL() put into Interface_t::handle
+  I2CBus& i2c = *static_cast<I2CBus*>(ifce);
+  I2CBus::Result result;
   
-  
-  if (wrSize > 0 && wrData != nullptr) {
-    String hexData;
-    for (int i = 0; i < wrSize; i++) {
-      if (i > 0) hexData += " ";
-      char hex[4];
-      sprintf(hex, "%02X", wrData[i]);
-      hexData += hex;
+  if (wrSize == 1 && rdSize > (int)sizeof(result.data)) {
+    // Register block longer than one bus read, segmented into rdData
+    I2CBus::TransferResult transfer = i2c.readBlock(slAddr, wrData[0], rdData, rdSize);
+    if (!transfer.success) {
+      logger.warningf("ZMOD4510: I2CRead block failed with error code: 0x%02X", transfer.error_code);
+      return HAL_SetError(transfer.error_code, aesArduino, _GetErrorString);
     }
+    return ecSuccess;
   }
   
-  I2CBridge& i2c = I2CBridge::getInstance();
-  I2CBridge::Result result;
-  
   if (wrSize > 0) {
     // Use write-then-read operation
-    result = i2c.writeReadBytes(slAddr, wrData, wrSize, rdSize);
+    result = i2c.writeRead(slAddr, wrData, wrSize, rdSize);
   } else {
     // Simple read operation
-    result = i2c.readBytes(slAddr, rdSize);
+    result = i2c.read(slAddr, rdSize);
   }
   
   if (!result.success) {
@@ -90,46 +88,26 @@ _I2CRead ( void*  ifce, uint8_t  slAddr, uint8_t*  wrData, int  wrSize, uint8_t*
   // Copy the data to the output buffer
   memcpy(rdData, result.data, result.data_len);
   
-  // Log the read data
-  String hexData;
-  for (int i = 0; i < result.data_len; i++) {
-    if (i > 0) hexData += " ";
-    char hex[4];
-    sprintf(hex, "%02X", result.data[i]);
-    hexData += hex;
-  }
-  
   return ecSuccess;
 }
 
 
 static int
 _I2CWrite( void*  ifce, uint8_t  slAddr, uint8_t*  wrData1, int  wrSize1, uint8_t*  wrData2, int  wrSize2 ) {
-  ( void) ifce;  
-  // Log the write data buffers
-  if (wrSize1 > 0 && wrData1 != nullptr) {
-    String hexData;
-    for (int i = 0; i < wrSize1; i++) {
-      if (i > 0) hexData += " ";
-      char hex[4];
-      sprintf(hex, "%02X", wrData1[i]);
-      hexData += hex;
-    }
-  }
+  I2CBus& i2c = *static_cast<I2CBus*>(ifce);
+  I2CBus::Result result;
   
-  if (wrSize2 > 0 && wrData2 != nullptr) {
-    String hexData;
-    for (int i = 0; i < wrSize2; i++) {
-      if (i > 0) hexData += " ";
-      char hex[4];
-      sprintf(hex, "%02X", wrData2[i]);
-      hexData += hex;
+  if (wrSize1 == 1 && wrSize1 + wrSize2 > I2C_WRITE_MAX_LEN) {
+    // Register block longer than one bridge write, sent in segments
+    I2CBus::TransferResult transfer = i2c.writeBlock(slAddr, wrData1[0], wrData2, wrSize2);
+    if (!transfer.success) {
+      int returnValue = HAL_SetError(transfer.error_code, aesArduino, _GetErrorString);
+      logger.warningf("ZMOD4510: I2CWrite block failed with error code: 0x%02X   returnValue: %d", transfer.error_code, returnValue);
+      return returnValue;
     }
+    return ecSuccess;
   }
   
-  I2CBridge& i2c = I2CBridge::getInstance();
-  I2CBridge::Result result;
-  
   // Combine the two data buffers if needed
   if (wrSize1 > 0 && wrSize2 > 0) {
     uint8_t combinedData[64]; // Assuming max 64 bytes total
@@ -143,17 +121,17 @@ _I2CWrite( void*  ifce, uint8_t  slAddr, uint8_t*  wrData1, int  wrSize1, uint8_
     memcpy(combinedData + wrSize1, wrData2, wrSize2);
     
     // Write the combined data
-    result = i2c.writeBytes(slAddr, combinedData, wrSize1 + wrSize2);
+    result = i2c.write(slAddr, combinedData, wrSize1 + wrSize2);
   } else if (wrSize1 > 0) {
     // Just write the first buffer
-    result = i2c.writeBytes(slAddr, wrData1, wrSize1);
+    result = i2c.write(slAddr, wrData1, wrSize1);
   } else if (wrSize2 > 0) {
     // Just write the second buffer
-    result = i2c.writeBytes(slAddr, wrData2, wrSize2);
+    result = i2c.write(slAddr, wrData2, wrSize2);
   } else {
     // No data to write, just send address
     uint8_t dummy = 0;
-    result = i2c.writeBytes(slAddr, &dummy, 0);
+    result = i2c.write(slAddr, &dummy, 0);
   }
   
   if (!result.success) {
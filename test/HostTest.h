@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Minimal test runner for the host builds in this directory. Every
+// TEST_CASE registers itself, host_test_run() runs them in order and
+// returns the process exit code for ctest.
+
+struct HostTestCase {
+    const char* name;
+    void (*fn)();
+    HostTestCase* next;
+};
+
+struct HostTestState {
+    HostTestCase* first;
+    HostTestCase* last;
+    int failures;
+};
+
+static inline HostTestState& host_test_state() {
+    static HostTestState state = { nullptr, nullptr, 0 };
+    return state;
+}
+
+struct HostTestRegistrar {
+    HostTestCase test_case;
+    HostTestRegistrar(const char* name, void (*fn)()) {
+        test_case.name = name;
+        test_case.fn = fn;
+        test_case.next = nullptr;
+        HostTestState& state = host_test_state();
+        if (state.last) state.last->next = &test_case;
+        else state.first = &test_case;
+        state.last = &test_case;
+    }
+};
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static HostTestRegistrar name##_registrar(#name, name); \
+    static void name()
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            host_test_state().failures++; \
+        } \
+    } while (0)
+
+// Integer comparison that prints both sides
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const long long host_test_a = (long long)(actual); \
+        const long long host_test_e = (long long)(expected); \
+        if (host_test_a != host_test_e) { \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                    __FILE__, __LINE__, #actual, #expected, host_test_a, host_test_e); \
+            host_test_state().failures++; \
+        } \
+    } while (0)
+
+#define CHECK_STR(actual, expected) \
+    do { \
+        const char* host_test_a = (actual); \
+        const char* host_test_e = (expected); \
+        if (strcmp(host_test_a, host_test_e) != 0) { \
+            fprintf(stderr, "%s:%d: CHECK_STR(%s) failed: \"%s\" != \"%s\"\n", \
+                    __FILE__, __LINE__, #actual, host_test_a, host_test_e); \
+            host_test_state().failures++; \
+        } \
+    } while (0)
+
+#define CHECK_MEM(actual, expected, len) \
+    CHECK(memcmp((actual), (expected), (len)) == 0)
+
+// Runs every registered case, or only the ones whose name contains filter
+static inline int host_test_run(const char* filter = nullptr) {
+    HostTestState& state = host_test_state();
+    int run = 0;
+    for (HostTestCase* test_case = state.first; test_case; test_case = test_case->next) {
+        if (filter && !strstr(test_case->name, filter)) continue;
+        const int failures_before = state.failures;
+        test_case->fn();
+        printf("%s %s\n", state.failures == failures_before ? "[ OK ]" : "[FAIL]", test_case->name);
+        run++;
+    }
+    printf("%d cases, %d failed checks\n", run, state.failures);
+    return state.failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#define HOST_TEST_MAIN() \
+    int main(int argc, char** argv) { return host_test_run(argc > 1 ? argv[1] : nullptr); }
@@ -0,0 +1,256 @@
+// Encode and decode cost and wire time of I2C bridge transactions as ASCII
+// hex packets and as binary frames (PROTOCOL_CAP_BINARY_I2C), for
+// CMD_I2C_READ and CMD_I2C_WRITE with 1, 6 and 32 data bytes. Each
+// transaction is the tagged request and its response, formatted the way
+// I2CBridge and the Nano firmware do it. Both ends receive through
+// NanoFrameParser, then parse the fields with strtol() (ASCII) or take the
+// bytes as they are (binary). ASCII writes use the single W packet, the
+// chunked form only adds packets.
+
+#include <chrono>
+#include "HostTest.h"
+#include "NanoFrameParser.h"
+
+namespace {
+
+const unsigned ITERATIONS = 100000;
+const uint8_t ADDR = 0x44;
+const uint8_t REQUEST_ID = 0x2A;
+
+struct LinkBytes {
+    uint8_t bytes[ASCII_PACKET_MAX_LEN];
+    size_t len;
+};
+
+// Both return the bytes on the wire, 0 if the packet does not fit
+size_t ascii_wire(const char* data_part, LinkBytes& wire) {
+    char tagged[ASCII_PACKET_MAX_LEN + ASCII_REQUEST_ID_LEN];
+    const int tagged_len = snprintf(tagged, sizeof(tagged), "%c%02X%s", ASCII_REQUEST_ID_PREFIX, REQUEST_ID, data_part);
+    if (tagged_len < 0 || (size_t)tagged_len >= sizeof(tagged)) {
+        wire.len = 0;
+        return 0;
+    }
+    wire.len = ascii_packet_encode(tagged, reinterpret_cast<char*>(wire.bytes), sizeof(wire.bytes));
+    return wire.len;
+}
+
+size_t binary_wire(char type, const uint8_t* payload, size_t payload_len, LinkBytes& wire) {
+    wire.bytes[0] = BINARY_FRAME_DELIMITER;
+    const size_t encoded_len = binary_frame_encode(type, REQUEST_ID, payload, payload_len, wire.bytes + 1, sizeof(wire.bytes) - 2);
+    if (encoded_len == 0) {
+        wire.len = 0;
+        return 0;
+    }
+    wire.bytes[encoded_len + 1] = BINARY_FRAME_DELIMITER;
+    wire.len = encoded_len + 2;
+    return wire.len;
+}
+
+// Appends ",XX" per byte like format_write_request() and send_i2c_read_response()
+void append_hex(char* out, size_t size, const uint8_t* data, uint8_t len) {
+    size_t pos = strlen(out);
+    for (uint8_t i = 0; i < len && pos < size; i++) {
+        pos += snprintf(out + pos, size - pos, ",%02X", data[i]);
+    }
+}
+
+// Feeds the wire bytes to a receiver, true once a whole frame came out
+bool receive(NanoFrameParser& parser, const LinkBytes& wire) {
+    NanoFrameParser::Result result = NanoFrameParser::Result::NONE;
+    for (size_t i = 0; i < wire.len; i++) {
+        result = parser.feed(wire.bytes[i]);
+    }
+    return result == NanoFrameParser::Result::ASCII_FRAME || result == NanoFrameParser::Result::BINARY_FRAME;
+}
+
+// strtol() over "XX,XX,...", as the Nano reads CMD_I2C_WRITE
+uint8_t parse_hex_fields(char* p, uint8_t* out, uint8_t max_len) {
+    uint8_t count = 0;
+    char* end;
+    while (count < max_len) {
+        if (*p == ',') p++;
+        const long value = strtol(p, &end, 16);
+        if (end == p) break;
+        out[count++] = (uint8_t)value;
+        p = end;
+    }
+    return count;
+}
+
+struct Transaction {
+    LinkBytes request;
+    LinkBytes response;
+};
+
+// One direction each way, the decoders' results are checked against data
+struct Codec {
+    virtual ~Codec() {}
+    virtual void encodeRead(const uint8_t* data, uint8_t len, Transaction& out) = 0;
+    virtual void encodeWrite(const uint8_t* data, uint8_t len, Transaction& out) = 0;
+    virtual uint8_t decodeRead(NanoFrameParser& nano, NanoFrameParser& esp32, const Transaction& in, uint8_t* data) = 0;
+    virtual uint8_t decodeWrite(NanoFrameParser& nano, NanoFrameParser& esp32, const Transaction& in, uint8_t* data) = 0;
+};
+
+struct AsciiCodec : Codec {
+    void encodeRead(const uint8_t* data, uint8_t len, Transaction& out) override {
+        char data_part[ASCII_PACKET_MAX_LEN];
+        snprintf(data_part, sizeof(data_part), "%c%02X,%02X", CMD_I2C_READ, ADDR, len);
+        ascii_wire(data_part, out.request);
+        snprintf(data_part, sizeof(data_part), "%c%02X,%02X", RSP_I2C_READ, I2C_ERROR_NONE, len);
+        append_hex(data_part, sizeof(data_part), data, len);
+        ascii_wire(data_part, out.response);
+    }
+
+    void encodeWrite(const uint8_t* data, uint8_t len, Transaction& out) override {
+        char data_part[ASCII_PACKET_MAX_LEN];
+        snprintf(data_part, sizeof(data_part), "%c%02X,%02X", CMD_I2C_WRITE, ADDR, len);
+        append_hex(data_part, sizeof(data_part), data, len);
+        ascii_wire(data_part, out.request);
+        snprintf(data_part, sizeof(data_part), "%c%02X", RSP_I2C_WRITE, I2C_ERROR_NONE);
+        ascii_wire(data_part, out.response);
+    }
+
+    uint8_t decodeRead(NanoFrameParser& nano, NanoFrameParser& esp32, const Transaction& in, uint8_t* data) override {
+        if (!receive(nano, in.request)) return 0;
+        uint8_t request_id;
+        char* fields = const_cast<char*>(ascii_packet_split_request_id(nano.asciiData(), &request_id));
+        uint8_t header[2];
+        if (parse_hex_fields(fields + 1, header, 2) != 2 || header[0] != ADDR) return 0;
+
+        if (!receive(esp32, in.response)) return 0;
+        fields = const_cast<char*>(ascii_packet_split_request_id(esp32.asciiData(), &request_id));
+        // As process_packet() splits RSP_I2C_READ
+        char* save = nullptr;
+        char* token = strtok_r(fields + 1, ",", &save);
+        if (!token || strtol(token, nullptr, 16) != I2C_ERROR_NONE) return 0;
+        token = strtok_r(NULL, ",", &save);
+        if (!token) return 0;
+        const uint8_t num_bytes = strtol(token, nullptr, 16);
+        uint8_t bytes_read = 0;
+        while (bytes_read < num_bytes && (token = strtok_r(NULL, ",", &save)) != NULL) {
+            data[bytes_read++] = strtol(token, nullptr, 16);
+        }
+        return bytes_read == header[1] ? bytes_read : 0;
+    }
+
+    uint8_t decodeWrite(NanoFrameParser& nano, NanoFrameParser& esp32, const Transaction& in, uint8_t* data) override {
+        if (!receive(nano, in.request)) return 0;
+        uint8_t request_id;
+        char* fields = const_cast<char*>(ascii_packet_split_request_id(nano.asciiData(), &request_id));
+        uint8_t written[2 + 32];
+        const uint8_t count = parse_hex_fields(fields + 1, written, sizeof(written));
+        if (count < 2 || written[0] != ADDR || written[1] != count - 2) return 0;
+        memcpy(data, written + 2, count - 2);
+
+        if (!receive(esp32, in.response)) return 0;
+        fields = const_cast<char*>(ascii_packet_split_request_id(esp32.asciiData(), &request_id));
+        return strtol(fields + 1, nullptr, 16) == I2C_ERROR_NONE ? count - 2 : 0;
+    }
+};
+
+struct BinaryCodec : Codec {
+    void encodeRead(const uint8_t* data, uint8_t len, Transaction& out) override {
+        const uint8_t request[2] = { ADDR, len };
+        binary_wire(CMD_I2C_READ, request, sizeof(request), out.request);
+        uint8_t response[1 + 32];
+        response[0] = I2C_ERROR_NONE;
+        memcpy(response + 1, data, len);
+        binary_wire(RSP_I2C_READ, response, len + 1, out.response);
+    }
+
+    void encodeWrite(const uint8_t* data, uint8_t len, Transaction& out) override {
+        uint8_t request[1 + I2C_WRITE_MAX_LEN];
+        request[0] = ADDR;
+        memcpy(request + 1, data, len);
+        binary_wire(CMD_I2C_WRITE, request, len + 1, out.request);
+        const uint8_t status = I2C_ERROR_NONE;
+        binary_wire(RSP_I2C_WRITE, &status, 1, out.response);
+    }
+
+    uint8_t decodeRead(NanoFrameParser& nano, NanoFrameParser& esp32, const Transaction& in, uint8_t* data) override {
+        if (!receive(nano, in.request) || nano.payloadLength() != 2 || nano.payload()[0] != ADDR) return 0;
+        const uint8_t len = nano.payload()[1];
+        if (!receive(esp32, in.response) || esp32.payloadLength() != len + 1u || esp32.payload()[0] != I2C_ERROR_NONE) return 0;
+        memcpy(data, esp32.payload() + 1, len);
+        return len;
+    }
+
+    uint8_t decodeWrite(NanoFrameParser& nano, NanoFrameParser& esp32, const Transaction& in, uint8_t* data) override {
+        if (!receive(nano, in.request) || nano.payloadLength() < 1 || nano.payload()[0] != ADDR) return 0;
+        const uint8_t len = nano.payloadLength() - 1;
+        memcpy(data, nano.payload() + 1, len);
+        if (!receive(esp32, in.response) || esp32.payloadLength() != 1 || esp32.payload()[0] != I2C_ERROR_NONE) return 0;
+        return len;
+    }
+};
+
+struct Result {
+    size_t wire_bytes;
+    double ns;      // Encode and decode of request and response
+    bool intact;
+};
+
+Result bench(Codec& codec, bool write, const uint8_t* data, uint8_t len) {
+    NanoFrameParser nano;
+    NanoFrameParser esp32;
+    Result result = { 0, 0, true };
+    Transaction transaction;
+    uint8_t decoded[32];
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        if (write) {
+            codec.encodeWrite(data, len, transaction);
+            result.intact &= codec.decodeWrite(nano, esp32, transaction, decoded) == len;
+        } else {
+            codec.encodeRead(data, len, transaction);
+            result.intact &= codec.decodeRead(nano, esp32, transaction, decoded) == len;
+        }
+    }
+    result.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+    result.intact &= memcmp(decoded, data, len) == 0;
+    result.wire_bytes = transaction.request.len + transaction.response.len;
+    return result;
+}
+
+// 8N1, ten bit times per byte
+double wire_us(size_t bytes, unsigned long baud) {
+    return bytes * 10 * 1e6 / baud;
+}
+
+} // namespace
+
+TEST_CASE(ascii_versus_binary) {
+    static const uint8_t sizes[] = { 1, 6, 32 };
+    uint8_t data[32];
+    for (uint8_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(0xA5 + i * 37);
+
+    AsciiCodec ascii;
+    BinaryCodec binary;
+    printf("%u transactions each, request and response; wire time at %lu / %lu baud\n",
+           ITERATIONS, (unsigned long)LINK_DEFAULT_BAUD, (unsigned long)LINK_FAST_BAUD);
+    printf("%-9s %4s  %-6s %6s %10s %10s %10s\n", "", "len", "", "wire", "codec ns", "us slow", "us fast");
+    for (int op = 0; op < 2; op++) {
+        const bool write = op == 1;
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            const uint8_t len = sizes[i];
+            const Result a = bench(ascii, write, data, len);
+            const Result b = bench(binary, write, data, len);
+            const char* name = write ? "I2C_WRITE" : "I2C_READ";
+            printf("%-9s %4u  %-6s %6zu %10.0f %10.0f %10.1f\n", name, len, "ASCII", a.wire_bytes, a.ns,
+                   wire_us(a.wire_bytes, LINK_DEFAULT_BAUD) + a.ns / 1000, wire_us(a.wire_bytes, LINK_FAST_BAUD) + a.ns / 1000);
+            printf("%-9s %4u  %-6s %6zu %10.0f %10.0f %10.1f\n", "", len, "binary", b.wire_bytes, b.ns,
+                   wire_us(b.wire_bytes, LINK_DEFAULT_BAUD) + b.ns / 1000, wire_us(b.wire_bytes, LINK_FAST_BAUD) + b.ns / 1000);
+
+            CHECK(a.intact);
+            CHECK(b.intact);
+            // Hex costs three characters per data byte, the frame one plus
+            // header, CRC-16, COBS code byte and delimiters on each side
+            const size_t payload_bytes = write ? (1 + len) + 1 : 2 + (1 + len);
+            CHECK_EQ(b.wire_bytes, payload_bytes + 2 * (BINARY_FRAME_HEADER_LEN + 2 + 1 + 2));
+            CHECK(b.wire_bytes < a.wire_bytes);
+        }
+    }
+}
+
+HOST_TEST_MAIN()
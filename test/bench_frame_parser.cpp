@@ -0,0 +1,269 @@
+// Pushes a mix of ASCII and binary Nano traffic through
+// NanoFrameParser and through the String based receive path it replaced,
+// counting heap allocations with a replaced operator new and timing both.
+// Fails if the parser path allocates at all.
+
+#include <Arduino.h>
+#include <chrono>
+#include <new>
+#include "HostTest.h"
+#include "NanoFrameParser.h"
+
+static unsigned long allocation_count = 0;
+
+void* operator new(size_t size) {
+    allocation_count++;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+
+namespace {
+
+struct Traffic {
+    uint8_t bytes[16384];
+    size_t len;
+    unsigned ascii_frames;
+    unsigned binary_frames;
+};
+
+void append(Traffic& traffic, const void* data, size_t len) {
+    memcpy(traffic.bytes + traffic.len, data, len);
+    traffic.len += len;
+}
+
+void append_ascii(Traffic& traffic, const char* data) {
+    char packet[ASCII_PACKET_MAX_LEN];
+    const size_t len = ascii_packet_encode(data, packet, sizeof(packet));
+    append(traffic, packet, len);
+    append(traffic, "\r\n", 2);
+    traffic.ascii_frames++;
+}
+
+void append_binary(Traffic& traffic, uint8_t type, uint8_t request_id, const void* payload, size_t len) {
+    uint8_t frame[BINARY_FRAME_MAX_ENCODED_LEN + 2];
+    frame[0] = BINARY_FRAME_DELIMITER;
+    const size_t encoded_len = binary_frame_encode(type, request_id, payload, len, frame + 1, sizeof(frame) - 2);
+    frame[encoded_len + 1] = BINARY_FRAME_DELIMITER;
+    append(traffic, frame, encoded_len + 2);
+    traffic.binary_frames++;
+}
+
+// One minute of the ESP32 RX line with a 1 s sensor stream: keyframes and
+// deltas, the same readings as ASCII packets, a ZMOD4510 status poll and
+// result read per second and a health response every 10 s
+void build_traffic(Traffic& traffic) {
+    traffic.len = 0;
+    traffic.ascii_frames = 0;
+    traffic.binary_frames = 0;
+
+    NanoSensorFrame previous;
+    memset(&previous, 0, sizeof(previous));
+    uint8_t request_id = 1;
+    for (unsigned second = 0; second < 60; second++) {
+        NanoSensorFrame frame = previous;
+        frame.timestamp = 1000000 + second * 1000;
+        frame.sequence = (uint16_t)second;
+        frame.pressure_adc_raw = (uint16_t)(512 + second % 3);
+        frame.fan_amps_x100 = (uint16_t)(345 + second % 5);
+        frame.co2_ppm = (uint16_t)(800 + second / 10);
+        frame.temperature_x10 = 215;
+        frame.humidity_x10 = 455;
+
+        if (second % SENSOR_KEYFRAME_INTERVAL == 0) {
+            append_binary(traffic, RSP_SENSORS, REQUEST_ID_NONE, &frame, sizeof(frame));
+        } else {
+            uint8_t delta[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+            const size_t len = sensor_delta_encode(previous, frame, delta, sizeof(delta));
+            append_binary(traffic, RSP_SENSORS_DELTA, REQUEST_ID_NONE, delta, len);
+        }
+        previous = frame;
+
+        // Every read as ASCII too, as a Nano without binary frames sends it
+        char data[ASCII_PACKET_MAX_LEN];
+        protocol_ascii_encode(frame, data, sizeof(data));
+        append_ascii(traffic, data);
+
+        // ZMOD4510 status poll and result read, binary and ASCII
+        const uint8_t status[] = { I2C_ERROR_NONE, 0x80 };
+        append_binary(traffic, RSP_I2C_READ, request_id++, status, sizeof(status));
+        snprintf(data, sizeof(data), "#%02X%c%u,%s", request_id++, RSP_I2C_READ, I2C_ERROR_NONE,
+                 "0A1B2C3D4E5F60718293A4B5C6D7E8F90A1B2C3D4E5F6071");
+        append_ascii(traffic, data);
+
+        if (second % 10 == 0) {
+            snprintf(data, sizeof(data), "#%02X%c%lu,%u,%u,%u", request_id++, RSP_HEALTH, 86400UL + second, 1234U, 0U, 3U);
+            append_ascii(traffic, data);
+        }
+    }
+}
+
+// --- The receive path before NanoFrameParser, as it was in src/main.cpp ---
+
+struct LegacyReceiver {
+    String serial_buffer;
+    bool valid_packet_start_received = false;
+    uint8_t binary_frame_buffer[BINARY_FRAME_MAX_ENCODED_LEN];
+    size_t binary_frame_len = 0;
+    bool binary_frame_active = false;
+    unsigned frames = 0;
+    unsigned long checksum = 0;
+
+    void process_binary_frame(const uint8_t* encoded, size_t encoded_len) {
+        uint8_t frame[BINARY_FRAME_MAX_RAW_LEN];
+        const size_t frame_len = cobs_decode(encoded, encoded_len, frame, sizeof(frame));
+        if (frame_len < 3) return;
+        const uint16_t received_crc = frame[frame_len - 2] | (frame[frame_len - 1] << 8);
+        if (crc16_calculate(frame, frame_len - 2) != received_crc) return;
+        frames++;
+        checksum += frame[0] + frame_len;
+    }
+
+    void process_packet(String packet) {
+        packet.trim();
+        if (!packet.startsWith("<") || !packet.endsWith(">")) return;
+        packet.remove(0, 1);
+        packet.remove(packet.length() - 1);
+
+        const int last_comma = packet.lastIndexOf(',');
+        if (last_comma == -1) return;
+
+        String data_part = packet.substring(0, last_comma);
+        const uint8_t received_checksum = packet.substring(last_comma + 1).toInt();
+        if (crc8_calculate(data_part.c_str()) != received_checksum) return;
+
+        // Every decoder started from the payload as its own String
+        const char cmd = data_part.charAt(0);
+        String payload = data_part.substring(1);
+        if (cmd == RSP_SENSORS) {
+            char data_cstr[ASCII_PACKET_MAX_LEN];
+            strcpy(data_cstr, payload.c_str());
+            NanoSensorFrame frame;
+            protocol_ascii_decode(data_cstr, frame);
+            checksum += frame.co2_ppm;
+        }
+        frames++;
+        checksum += (uint8_t)cmd + data_part.length();
+    }
+
+    void feed(char incoming_char) {
+        if (incoming_char == BINARY_FRAME_DELIMITER) {
+            if (binary_frame_len > 0) {
+                process_binary_frame(binary_frame_buffer, binary_frame_len);
+                binary_frame_len = 0;
+                binary_frame_active = false;
+                return;
+            }
+            binary_frame_active = true;
+            valid_packet_start_received = false;
+            return;
+        }
+        if (binary_frame_active) {
+            if (binary_frame_len < sizeof(binary_frame_buffer)) {
+                binary_frame_buffer[binary_frame_len++] = incoming_char;
+            } else {
+                binary_frame_len = 0;
+                binary_frame_active = false;
+            }
+            return;
+        }
+        if (incoming_char == '\r' || incoming_char == '\n') return;
+
+        if (!valid_packet_start_received && incoming_char == '<') {
+            serial_buffer = "";
+            valid_packet_start_received = true;
+        } else if (valid_packet_start_received && incoming_char == '>') {
+            if (serial_buffer.length() > 0) {
+                process_packet("<" + serial_buffer + ">");
+            }
+            serial_buffer = "";
+            valid_packet_start_received = false;
+        } else if (valid_packet_start_received && serial_buffer.length() < 255) {
+            serial_buffer += incoming_char;
+        } else {
+            serial_buffer = "";
+            valid_packet_start_received = false;
+        }
+    }
+};
+
+// --- The current path ---
+
+struct ParserReceiver {
+    NanoFrameParser parser;
+    unsigned frames = 0;
+    unsigned long checksum = 0;
+
+    void feed(uint8_t byte) {
+        switch (parser.feed(byte)) {
+            case NanoFrameParser::Result::ASCII_FRAME: {
+                char* data = parser.asciiData();
+                if (data[0] == RSP_SENSORS) {
+                    NanoSensorFrame frame;
+                    protocol_ascii_decode(data + 1, frame);
+                    checksum += frame.co2_ppm;
+                }
+                frames++;
+                checksum += (uint8_t)data[0] + parser.asciiLength();
+                break;
+            }
+            case NanoFrameParser::Result::BINARY_FRAME:
+                frames++;
+                checksum += parser.frameType() + parser.payloadLength() + BINARY_FRAME_HEADER_LEN + 2;
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+const unsigned ROUNDS = 200;
+
+template<typename Receiver>
+void run(const char* name, const Traffic& traffic, unsigned long* allocations, unsigned* frames) {
+    Receiver* receiver = new Receiver();
+    const unsigned long allocations_before = allocation_count;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < traffic.len; i++) {
+            receiver->feed((char)traffic.bytes[i]);
+        }
+    }
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    *allocations = allocation_count - allocations_before;
+    *frames = receiver->frames;
+    const double total_bytes = (double)traffic.len * ROUNDS;
+    printf("%-14s %8u frames  %8lu allocations  %6.2f alloc/frame  %7.1f ns/frame  %6.1f ns/byte\n",
+           name, receiver->frames, *allocations, (double)*allocations / receiver->frames,
+           elapsed_ns / receiver->frames, elapsed_ns / total_bytes);
+    delete receiver;
+}
+
+} // namespace
+
+TEST_CASE(parser_allocations_vs_string_path) {
+    static Traffic traffic;
+    build_traffic(traffic);
+    printf("%u ASCII packets and %u binary frames, %zu bytes per round, %u rounds\n",
+           traffic.ascii_frames, traffic.binary_frames, traffic.len, ROUNDS);
+
+    unsigned long legacy_allocations = 0;
+    unsigned legacy_frames = 0;
+    run<LegacyReceiver>("String path", traffic, &legacy_allocations, &legacy_frames);
+    unsigned long parser_allocations = 0;
+    unsigned parser_frames = 0;
+    run<ParserReceiver>("FrameParser", traffic, &parser_allocations, &parser_frames);
+
+    const unsigned expected_frames = (traffic.ascii_frames + traffic.binary_frames) * ROUNDS;
+    CHECK_EQ(legacy_frames, expected_frames);
+    CHECK_EQ(parser_frames, expected_frames);
+    CHECK_EQ(parser_allocations, 0);
+    CHECK(legacy_allocations > expected_frames);
+}
+
+HOST_TEST_MAIN()
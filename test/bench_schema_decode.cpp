@@ -0,0 +1,138 @@
+// Decode throughput of the sensor and info messages in each wire format:
+// Schema.h ASCII decoders after the CRC-8 check, binary keyframes and delta
+// frames with 1, 4 and all fields changed after the COBS/CRC-16 decode.
+
+#include <chrono>
+#include "HostTest.h"
+#include "protocol/Frames.h"
+
+namespace {
+
+const unsigned ITERATIONS = 200000;
+
+NanoSensorFrame sample_frame() {
+    NanoSensorFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.timestamp = 3600000;
+    frame.pressure_adc_raw = 512;
+    frame.temperature_x10 = 215;
+    frame.humidity_x10 = 455;
+    frame.co2_ppm = 812;
+    frame.voc_raw = 30000;
+    frame.nox_raw = 15000;
+    frame.fan_amps_x100 = 345;
+    frame.pm25_x10 = 25;
+    frame.compressor_amps_x100 = 1200;
+    frame.co_adc_raw = 88;
+    frame.sequence = 100;
+    return frame;
+}
+
+struct Result {
+    double ns_per_frame;
+    double wire_bytes;
+};
+
+void report(const char* name, const Result& result) {
+    printf("%-24s %5.0f wire bytes  %7.1f ns/frame  %8.2f Mframes/s  %7.1f MB/s\n", name, result.wire_bytes,
+           result.ns_per_frame, 1000.0 / result.ns_per_frame, result.wire_bytes * 1000.0 / result.ns_per_frame);
+}
+
+template<typename Message>
+Result bench_ascii(const Message& message, unsigned long* checksum) {
+    char data[ASCII_PACKET_MAX_LEN];
+    protocol_ascii_encode(message, data, sizeof(data));
+    char packet[ASCII_PACKET_MAX_LEN];
+    const size_t packet_len = ascii_packet_encode(data, packet, sizeof(packet));
+    const uint8_t crc = crc8_calculate(data);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        if (crc8_calculate(data) != crc) continue;
+        Message decoded;
+        *checksum += protocol_ascii_decode(data + 1, decoded);
+        *checksum += *reinterpret_cast<const uint8_t*>(&decoded);
+    }
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    Result result = { elapsed_ns / ITERATIONS, (double)packet_len };
+    return result;
+}
+
+Result bench_binary(uint8_t type, const uint8_t* payload, size_t payload_len, const NanoSensorFrame& previous, unsigned long* checksum) {
+    uint8_t encoded[BINARY_FRAME_MAX_ENCODED_LEN];
+    const size_t encoded_len = binary_frame_encode(type, REQUEST_ID_NONE, payload, payload_len, encoded, sizeof(encoded));
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        uint8_t frame[BINARY_FRAME_MAX_ENCODED_LEN];
+        memcpy(frame, encoded, encoded_len);
+        const size_t len = binary_frame_decode(frame, encoded_len);
+        if (len == 0) continue;
+        NanoSensorFrame snapshot = previous;
+        if (type == RSP_SENSORS) {
+            memcpy(&snapshot, frame + BINARY_FRAME_HEADER_LEN, sizeof(snapshot));
+        } else if (!sensor_delta_apply(snapshot, frame + BINARY_FRAME_HEADER_LEN, len - BINARY_FRAME_HEADER_LEN)) {
+            continue;
+        }
+        *checksum += snapshot.co2_ppm + snapshot.sequence;
+    }
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    Result result = { elapsed_ns / ITERATIONS, (double)encoded_len + 2 };
+    return result;
+}
+
+Result bench_delta(const NanoSensorFrame& previous, uint8_t changed_fields, unsigned long* checksum) {
+    NanoSensorFrame current = previous;
+    current.sequence++;
+    current.timestamp += 1000;
+    uint8_t changed = 0;
+    for (size_t i = 0; i < SENSOR_DELTA_FIELD_COUNT && changed < changed_fields; i++) {
+        if (!NANO_SENSOR_DELTA_FIELDS[i].in_bitmap) continue;
+        reinterpret_cast<uint8_t*>(&current)[NANO_SENSOR_DELTA_FIELDS[i].offset] ^= 0x11;
+        changed++;
+    }
+    uint8_t delta[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+    const size_t len = sensor_delta_encode(previous, current, delta, sizeof(delta));
+    return bench_binary(RSP_SENSORS_DELTA, delta, len, previous, checksum);
+}
+
+} // namespace
+
+TEST_CASE(decode_throughput) {
+    unsigned long checksum = 0;
+    const NanoSensorFrame frame = sample_frame();
+
+    Sps30InfoFrame sps30;
+    memset(&sps30, 0, sizeof(sps30));
+    sps30.fw_major = 2;
+    sps30.fan_interval = 604800;
+    sps30.fan_days = 7;
+    Scd30InfoFrame scd30;
+    memset(&scd30, 0, sizeof(scd30));
+    scd30.measurement_interval = 2;
+    scd30.forced_recalibration = 400;
+    scd30.altitude_compensation = 120;
+
+    printf("%u decodes each\n", ITERATIONS);
+    const Result ascii_sensors = bench_ascii(frame, &checksum);
+    report("ASCII RSP_SENSORS", ascii_sensors);
+    report("ASCII RSP_SPS30_INFO", bench_ascii(sps30, &checksum));
+    report("ASCII RSP_SCD30_INFO", bench_ascii(scd30, &checksum));
+
+    const Result keyframe = bench_binary(RSP_SENSORS, reinterpret_cast<const uint8_t*>(&frame), sizeof(frame), frame, &checksum);
+    report("Binary keyframe", keyframe);
+    const Result delta_one = bench_delta(frame, 1, &checksum);
+    report("Delta, 1 field", delta_one);
+    report("Delta, 4 fields", bench_delta(frame, 4, &checksum));
+    const Result delta_all = bench_delta(frame, SENSOR_DELTA_FIELD_COUNT, &checksum);
+    report("Delta, all fields", delta_all);
+
+    CHECK(checksum != 0);
+    // Wire sizes are part of the format, the timings only get printed
+    CHECK_EQ(keyframe.wire_bytes, sizeof(NanoSensorFrame) + BINARY_FRAME_HEADER_LEN + 2 + 1 + 2);
+    CHECK(delta_one.wire_bytes < keyframe.wire_bytes);
+    CHECK(delta_all.wire_bytes >= keyframe.wire_bytes);
+    CHECK(ascii_sensors.wire_bytes > keyframe.wire_bytes);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,344 @@
+// I2CBridge::readBlock() and writeBlock() against a simulated Nano that
+// answers CMD_I2C_READ_BLOCK with RSP_I2C_SEGMENT frames and a closing
+// RSP_I2C_READ_BLOCK, and acks each CMD_I2C_WRITE_BLOCK segment. Covers
+// the transfer_fits() limits, lost and reordered segments, the final
+// length check, and prints the link throughput per transfer size with
+// wire time at LINK_FAST_BAUD and bus time at 400 kHz. The simulated Nano
+// answers one command at a time, so the write numbers leave out the
+// overlap the I2C_WRITE_WINDOW credits buy on the real link.
+
+#include <Arduino.h>
+#include <deque>
+#include <string>
+#include "HostLogger.h"
+#include "HostTest.h"
+#include "I2CBridge.h"
+
+namespace {
+
+const uint8_t DEVICE_ADDR = 0x6A;
+const uint32_t WIRE_US_PER_BYTE = 10 * 1000000UL / LINK_FAST_BAUD;
+const uint32_t BUS_US_PER_BYTE = 9 * 1000000UL / 400000;
+
+struct SentCommand {
+    std::string data_part;
+    uint8_t request_id;
+};
+
+// What the simulated Nano does wrong on the next transfer
+struct Faults {
+    int drop_segment;       // Index of a read segment that never arrives, -1 for none
+    int swap_segment;       // Index of a read segment sent after the one following it
+    int bytes_sent_delta;   // Added to the byte count of RSP_I2C_READ_BLOCK
+    uint8_t read_status;    // Status of RSP_I2C_READ_BLOCK
+    int nack_write_segment; // Index of a write segment answered with I2C_ERROR_DATA_NACK
+};
+
+struct Responder {
+    std::deque<SentCommand> sent;
+    uint8_t next_request_id;
+    uint8_t registers[256];
+    std::string fifo;       // Bytes written to or read from a fixed register
+    Faults faults;
+    unsigned segments_sent;
+    unsigned write_segments;
+
+    void reset() {
+        sent.clear();
+        for (unsigned i = 0; i < sizeof(registers); i++) registers[i] = (uint8_t)(i * 7 + 3);
+        fifo.clear();
+        faults = { -1, -1, 0, I2C_ERROR_NONE, -1 };
+        segments_sent = 0;
+        write_segments = 0;
+    }
+};
+
+Responder responder;
+
+void wire_time(size_t data_part_len) {
+    host_clock_advance_us((uint64_t)(data_part_len + I2C_PACKET_OVERHEAD) * WIRE_US_PER_BYTE);
+}
+
+void bus_time(size_t bytes) {
+    host_clock_advance_us((uint64_t)(bytes + 2) * BUS_US_PER_BYTE); // Address and register byte
+}
+
+void send_segment(uint8_t xfer_id, uint16_t offset, const uint8_t* data, uint8_t len) {
+    wire_time(8 + len * 2); // m<xfer>,<offset>,<hex>
+    I2CBridge::processSegment(xfer_id, offset, data, len);
+}
+
+// L<xfer>,<addr>,<reg>,<total>,<flags>
+void answer_read_block(const SentCommand& command) {
+    unsigned xfer_id, addr, reg, total, flags;
+    CHECK_EQ(sscanf(command.data_part.c_str() + 1, "%X,%X,%X,%X,%X", &xfer_id, &addr, &reg, &total, &flags), 5);
+    CHECK_EQ(addr, DEVICE_ADDR);
+    const bool fixed_reg = flags & I2C_TRANSFER_FIXED_REG;
+
+    uint8_t data[I2C_TRANSFER_MAX_LEN];
+    for (unsigned i = 0; i < total; i++) {
+        data[i] = fixed_reg ? (uint8_t)(0xA0 + i) : responder.registers[(reg + i) & 0xFF];
+    }
+    bus_time(total);
+
+    const unsigned segments = (total + I2C_TRANSFER_READ_SEGMENT - 1) / I2C_TRANSFER_READ_SEGMENT;
+    for (unsigned i = 0; i < segments; i++) {
+        unsigned index = i;
+        if ((int)i == responder.faults.swap_segment && i + 1 < segments) {
+            index = i + 1;
+        } else if (i > 0 && (int)i - 1 == responder.faults.swap_segment) {
+            index = i - 1;
+        }
+        if ((int)index == responder.faults.drop_segment) continue;
+        const uint16_t offset = index * I2C_TRANSFER_READ_SEGMENT;
+        const uint8_t len = (total - offset > I2C_TRANSFER_READ_SEGMENT) ? I2C_TRANSFER_READ_SEGMENT : total - offset;
+        send_segment((uint8_t)xfer_id, offset, data + offset, len);
+        responder.segments_sent++;
+    }
+
+    wire_time(8); // l<xfer>,<status>,<bytes sent>
+    I2CBridge::processReadBlockResponse(command.request_id, responder.faults.read_status, (uint16_t)(total + responder.faults.bytes_sent_delta));
+}
+
+// O<xfer>,<addr>,<reg>,<offset>,<total>,<flags>,<bytes as one hex string>
+void answer_write_block(const SentCommand& command) {
+    unsigned xfer_id, addr, reg, offset, total, flags;
+    int hex_start = 0;
+    CHECK_EQ(sscanf(command.data_part.c_str() + 1, "%X,%X,%X,%X,%X,%X,%n", &xfer_id, &addr, &reg, &offset, &total, &flags, &hex_start), 6);
+    CHECK_EQ(addr, DEVICE_ADDR);
+    const char* hex = command.data_part.c_str() + 1 + hex_start;
+    const size_t len = strlen(hex) / 2;
+    CHECK(len > 0 && len <= I2C_TRANSFER_WRITE_SEGMENT);
+    bus_time(len);
+
+    const unsigned index = responder.write_segments++;
+    uint8_t status = (offset + len == total) ? I2C_ERROR_NONE : I2C_ERROR_PENDING;
+    if ((int)index == responder.faults.nack_write_segment) {
+        status = I2C_ERROR_DATA_NACK;
+    } else {
+        for (size_t i = 0; i < len; i++) {
+            unsigned value;
+            sscanf(hex + i * 2, "%2X", &value);
+            if (flags & I2C_TRANSFER_FIXED_REG) {
+                responder.fifo.push_back((char)value);
+            } else {
+                responder.registers[(reg + offset + i) & 0xFF] = (uint8_t)value;
+            }
+        }
+    }
+    wire_time(2); // o<status>
+    I2CBridge::processWriteResponse(command.request_id, RSP_I2C_WRITE_BLOCK, status);
+}
+
+// Plays the Nano while the bridge waits: answers the oldest command
+bool answer_next_command(void*) {
+    if (responder.sent.empty()) {
+        return false;
+    }
+    const SentCommand command = responder.sent.front();
+    responder.sent.pop_front();
+    wire_time(command.data_part.size());
+    switch (command.data_part[0]) {
+        case CMD_I2C_READ_BLOCK: answer_read_block(command); break;
+        case CMD_I2C_WRITE_BLOCK: answer_write_block(command); break;
+        default: CHECK(!"unexpected command"); break;
+    }
+    return true;
+}
+
+void start() {
+    static bool started = false;
+    if (!started) {
+        I2CBridge::begin();
+        host_set_block_hook(answer_next_command, nullptr);
+        started = true;
+    }
+    responder.reset();
+}
+
+unsigned frames_sent = 0;
+uint16_t extra_capabilities = 0; // Bridge encodings a test switches on
+
+} // namespace
+
+// --- What the rest of the firmware provides, see NanoCommands.h ---
+
+uint8_t send_packet_to_nano(const char* data_part, unsigned long) {
+    SentCommand command;
+    command.data_part = data_part;
+    command.request_id = ++responder.next_request_id;
+    if (command.request_id == REQUEST_ID_NONE) {
+        command.request_id = ++responder.next_request_id;
+    }
+    responder.sent.push_back(command);
+    return command.request_id;
+}
+
+uint8_t send_frame_to_nano(char, const uint8_t*, uint8_t, unsigned long) {
+    frames_sent++;
+    return REQUEST_ID_NONE; // The block commands are ASCII only
+}
+
+bool nano_has_capability(uint16_t capability) {
+    return (capability & (PROTOCOL_CAP_I2C_TRANSFERS | PROTOCOL_CAP_REQUEST_IDS | extra_capabilities)) == capability;
+}
+
+bool nano_link_accepts_bridge_traffic() {
+    return true;
+}
+
+TEST_CASE(transfer_limits) {
+    start();
+    uint8_t buffer[I2C_TRANSFER_MAX_LEN + 1];
+
+    // Without I2C_TRANSFER_FIXED_REG the block must end at register 0xFF
+    CHECK(I2CBridge::readBlock(DEVICE_ADDR, 0xF0, buffer, 16).success);
+    I2CBridge::TransferResult result = I2CBridge::readBlock(DEVICE_ADDR, 0xF0, buffer, 17);
+    CHECK(!result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_BUF_LEN);
+    result = I2CBridge::writeBlock(DEVICE_ADDR, 0xFF, buffer, 2);
+    CHECK_EQ(result.error_code, I2C_ERROR_BUF_LEN);
+    CHECK(I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, 256).success);
+
+    // A FIFO register takes up to I2C_TRANSFER_MAX_LEN
+    CHECK(I2CBridge::readBlock(DEVICE_ADDR, 0xF0, buffer, 100, true).success);
+    CHECK(I2CBridge::readBlock(DEVICE_ADDR, 0xF0, buffer, I2C_TRANSFER_MAX_LEN, true).success);
+    result = I2CBridge::readBlock(DEVICE_ADDR, 0xF0, buffer, I2C_TRANSFER_MAX_LEN + 1, true);
+    CHECK_EQ(result.error_code, I2C_ERROR_BUF_LEN);
+    CHECK_EQ(I2CBridge::readBlock(DEVICE_ADDR, 0x10, buffer, 0).error_code, I2C_ERROR_BUF_LEN);
+
+    // Rejected transfers never reach the link
+    CHECK(responder.sent.empty());
+}
+
+TEST_CASE(single_write_limit_for_every_encoding) {
+    start();
+    uint8_t data[I2C_WRITE_MAX_LEN + 1] = {0};
+    const uint16_t encodings[] = { 0, PROTOCOL_CAP_CHUNKED_WRITES, PROTOCOL_CAP_BINARY_I2C };
+    for (size_t i = 0; i < sizeof(encodings) / sizeof(encodings[0]); i++) {
+        extra_capabilities = encodings[i];
+        CHECK(!I2CBridge::submitWrite(DEVICE_ADDR, data, sizeof(data)).valid());
+        CHECK_EQ(I2CBridge::writeBytes(DEVICE_ADDR, data, sizeof(data)).error_code, I2C_ERROR_BUF_LEN);
+    }
+    extra_capabilities = 0;
+    CHECK(responder.sent.empty());
+    CHECK_EQ(frames_sent, 0);
+}
+
+TEST_CASE(read_block_segments) {
+    start();
+    uint8_t buffer[200];
+    memset(buffer, 0, sizeof(buffer));
+    const I2CBridge::TransferResult result = I2CBridge::readBlock(DEVICE_ADDR, 0x20, buffer, sizeof(buffer));
+    CHECK(result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_NONE);
+    CHECK_EQ(result.len, sizeof(buffer));
+    CHECK_EQ(responder.segments_sent, (sizeof(buffer) + I2C_TRANSFER_READ_SEGMENT - 1) / I2C_TRANSFER_READ_SEGMENT);
+    CHECK_MEM(buffer, responder.registers + 0x20, sizeof(buffer));
+}
+
+TEST_CASE(out_of_order_segment_fails_the_transfer) {
+    start();
+    responder.faults.swap_segment = 1;
+    uint8_t buffer[128];
+    const unsigned long warnings_before = host_log_count(APP_LOG_WARNING);
+    const I2CBridge::TransferResult result = I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, sizeof(buffer));
+    CHECK(!result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_OTHER);
+    CHECK_EQ(result.len, 1 * I2C_TRANSFER_READ_SEGMENT); // Nothing copied past the gap
+    // Both swapped segments land off the expected offset
+    CHECK_EQ(host_log_count(APP_LOG_WARNING) - warnings_before, 2);
+}
+
+TEST_CASE(lost_segment_fails_the_transfer) {
+    start();
+    responder.faults.drop_segment = 0;
+    uint8_t buffer[64];
+    const I2CBridge::TransferResult result = I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, sizeof(buffer));
+    CHECK(!result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_OTHER);
+    CHECK_EQ(result.len, 0);
+}
+
+TEST_CASE(final_length_check) {
+    uint8_t buffer[96];
+
+    // The last segment is lost but the Nano reports every byte sent
+    start();
+    responder.faults.drop_segment = 2;
+    I2CBridge::TransferResult result = I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, sizeof(buffer));
+    CHECK(!result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_OTHER);
+    CHECK_EQ(result.len, 2 * I2C_TRANSFER_READ_SEGMENT);
+
+    // Every segment arrived but the byte counts disagree
+    start();
+    responder.faults.bytes_sent_delta = -1;
+    result = I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, sizeof(buffer));
+    CHECK(!result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_OTHER);
+    CHECK_EQ(result.len, sizeof(buffer));
+
+    // A bus error on the Nano is reported as is
+    start();
+    responder.faults.read_status = I2C_ERROR_DATA_NACK;
+    responder.faults.bytes_sent_delta = -(int)sizeof(buffer) + I2C_TRANSFER_READ_SEGMENT;
+    responder.faults.drop_segment = 1;
+    result = I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, sizeof(buffer));
+    CHECK_EQ(result.error_code, I2C_ERROR_DATA_NACK);
+}
+
+TEST_CASE(write_block_segments) {
+    start();
+    uint8_t data[100];
+    for (unsigned i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(0x55 ^ i);
+    I2CBridge::TransferResult result = I2CBridge::writeBlock(DEVICE_ADDR, 0x40, data, sizeof(data));
+    CHECK(result.success);
+    CHECK_EQ(result.len, sizeof(data));
+    CHECK_EQ(responder.write_segments, (sizeof(data) + I2C_TRANSFER_WRITE_SEGMENT - 1) / I2C_TRANSFER_WRITE_SEGMENT);
+    CHECK_MEM(responder.registers + 0x40, data, sizeof(data));
+
+    start();
+    result = I2CBridge::writeBlock(DEVICE_ADDR, 0x40, data, 30, true);
+    CHECK(result.success);
+    CHECK_EQ(responder.fifo.size(), 30);
+    CHECK_MEM(responder.fifo.data(), data, 30);
+
+    // A NACK stops the transfer, segments still in the window are dropped
+    start();
+    responder.faults.nack_write_segment = 2;
+    result = I2CBridge::writeBlock(DEVICE_ADDR, 0x40, data, sizeof(data));
+    CHECK(!result.success);
+    CHECK_EQ(result.error_code, I2C_ERROR_DATA_NACK);
+    CHECK_EQ(result.len, 2 * I2C_TRANSFER_WRITE_SEGMENT);
+    CHECK(responder.write_segments < (sizeof(data) + I2C_TRANSFER_WRITE_SEGMENT - 1) / I2C_TRANSFER_WRITE_SEGMENT);
+}
+
+TEST_CASE(throughput_per_transfer_size) {
+    static const uint16_t sizes[] = { 8, 32, 64, 128, 256, 512 };
+    uint8_t buffer[I2C_TRANSFER_MAX_LEN];
+    memset(buffer, 0x3C, sizeof(buffer));
+    double previous_read = 0;
+
+    printf("%6s %12s %12s  (link %lu baud, bus 400 kHz)\n", "bytes", "read B/s", "write B/s", (unsigned long)LINK_FAST_BAUD);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        const uint16_t len = sizes[i];
+        const bool fixed_reg = len > 256;
+        start();
+        uint64_t start_us = host_clock_us();
+        CHECK(I2CBridge::readBlock(DEVICE_ADDR, 0x00, buffer, len, fixed_reg).success);
+        const double read_rate = len * 1e6 / (double)(host_clock_us() - start_us);
+
+        start();
+        start_us = host_clock_us();
+        CHECK(I2CBridge::writeBlock(DEVICE_ADDR, 0x00, buffer, len, fixed_reg).success);
+        const double write_rate = len * 1e6 / (double)(host_clock_us() - start_us);
+
+        printf("%6u %12.0f %12.0f\n", len, read_rate, write_rate);
+        // Per-transfer overhead is spread over more bytes
+        CHECK(read_rate > previous_read);
+        previous_read = read_rate;
+    }
+}
+
+HOST_TEST_MAIN()
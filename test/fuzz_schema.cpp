@@ -0,0 +1,258 @@
+// Fuzz target for the decode side of the protocol: the Schema.h ASCII
+// decoders, delta sensor frames and binary frames. Anything the decoders
+// accept has to survive a roundtrip through the matching encoder.
+//
+// Built as a libFuzzer target when the compiler supports -fsanitize=fuzzer,
+// otherwise (and always for ctest) with a random-input driver that mixes
+// raw bytes with mutated valid messages, including delta frames with
+// arbitrary field bitmaps. Run it under the address and UB sanitizers.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "protocol/Frames.h"
+
+namespace {
+
+void fuzz_fail(const char* what) {
+    fprintf(stderr, "fuzz_schema: %s\n", what);
+    abort();
+}
+
+template<typename Message>
+void check_ascii_message(const uint8_t* data, size_t size) {
+    char fields[ASCII_PACKET_MAX_LEN + 1];
+    if (size > ASCII_PACKET_MAX_LEN) size = ASCII_PACKET_MAX_LEN;
+    memcpy(fields, data, size);
+    fields[size] = '\0';
+
+    Message decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    const uint8_t count = protocol_ascii_decode(fields, decoded);
+    if (count > ProtocolMessage<Message>::field_count) fuzz_fail("decoded more fields than the schema has");
+
+    char text[64];
+    const size_t text_len = protocol_debug_format(decoded, text, sizeof(text));
+    if (text_len >= sizeof(text) || text[text_len] != '\0') fuzz_fail("debug text not terminated");
+
+    if (count != ProtocolMessage<Message>::field_count) return;
+    char packet[ASCII_PACKET_MAX_LEN];
+    const size_t len = protocol_ascii_encode(decoded, packet, sizeof(packet));
+    if (len == 0) fuzz_fail("decoded message does not encode");
+    if (packet[0] != ProtocolMessage<Message>::response_letter) fuzz_fail("wrong response letter");
+
+    Message again;
+    memset(&again, 0, sizeof(again));
+    if (protocol_ascii_decode(packet + 1, again) != count) fuzz_fail("re-encoded message lost fields");
+    if (memcmp(&again, &decoded, sizeof(decoded)) != 0) fuzz_fail("ASCII roundtrip changed a value");
+}
+
+NanoSensorFrame fuzz_snapshot() {
+    NanoSensorFrame snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.timestamp = 0xFFFF0000;  // Elapsed time wraps it
+    snapshot.co2_ppm = 800;
+    snapshot.sequence = 0x1234;
+    return snapshot;
+}
+
+// The first byte picks whether the payload is made to follow the snapshot,
+// so the bitmap and field paths are reached and not just the sequence check
+void check_delta(const uint8_t* data, size_t size) {
+    if (size == 0) return;
+    const bool follow = data[0] & 1;
+    uint8_t payload[128];
+    size_t len = size - 1;
+    if (len > sizeof(payload)) len = sizeof(payload);
+    memcpy(payload, data + 1, len);
+
+    const NanoSensorFrame original = fuzz_snapshot();
+    if (follow && len >= 2) {
+        payload[0] = (uint8_t)(original.sequence + 1);
+        payload[1] = (uint8_t)((original.sequence + 1) >> 8);
+    }
+
+    NanoSensorFrame snapshot = original;
+    if (!sensor_delta_apply(snapshot, payload, len)) {
+        if (memcmp(&snapshot, &original, sizeof(original)) != 0) fuzz_fail("rejected delta changed the snapshot");
+        return;
+    }
+    if (snapshot.sequence != (uint16_t)(original.sequence + 1)) fuzz_fail("applied delta out of sequence");
+
+    // The encoder may flag fewer fields, the result has to be the same
+    uint8_t encoded[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+    const size_t encoded_len = sensor_delta_encode(original, snapshot, encoded, sizeof(encoded));
+    if (encoded_len == 0) fuzz_fail("applied delta does not encode");
+    if (encoded_len > len) fuzz_fail("re-encoded delta is longer than the input");
+    NanoSensorFrame again = original;
+    if (!sensor_delta_apply(again, encoded, encoded_len)) fuzz_fail("re-encoded delta rejected");
+    if (memcmp(&again, &snapshot, sizeof(snapshot)) != 0) fuzz_fail("delta roundtrip changed the frame");
+}
+
+void check_binary_frame(const uint8_t* data, size_t size) {
+    uint8_t frame[300];
+    if (size > sizeof(frame)) size = sizeof(frame);
+    memcpy(frame, data, size);
+    const size_t len = binary_frame_decode(frame, size);
+    if (len == 0) return;
+    if (len < BINARY_FRAME_HEADER_LEN || len + 2 > size) fuzz_fail("decoded frame length out of range");
+
+    uint8_t encoded[300];
+    const size_t encoded_len = binary_frame_encode(frame[0], frame[1], frame + BINARY_FRAME_HEADER_LEN,
+                                                   len - BINARY_FRAME_HEADER_LEN, encoded, sizeof(encoded));
+    if (encoded_len == 0) fuzz_fail("decoded frame does not encode");
+    for (size_t i = 0; i < encoded_len; i++) {
+        if (encoded[i] == BINARY_FRAME_DELIMITER) fuzz_fail("encoded frame contains a delimiter");
+    }
+    if (binary_frame_decode(encoded, encoded_len) != len) fuzz_fail("binary roundtrip changed the length");
+    if (memcmp(encoded, frame, len) != 0) fuzz_fail("binary roundtrip changed the data");
+
+    // A keyframe or delta payload goes on to the sensor decoders
+    if (frame[0] == RSP_SENSORS && len - BINARY_FRAME_HEADER_LEN == sizeof(NanoSensorFrame)) {
+        NanoSensorFrame keyframe;
+        memcpy(&keyframe, frame + BINARY_FRAME_HEADER_LEN, sizeof(keyframe));
+        char packet[ASCII_PACKET_MAX_LEN];
+        if (protocol_ascii_encode(keyframe, packet, sizeof(packet)) == 0) fuzz_fail("keyframe does not print");
+    } else if (frame[0] == RSP_SENSORS_DELTA) {
+        NanoSensorFrame snapshot = fuzz_snapshot();
+        sensor_delta_apply(snapshot, frame + BINARY_FRAME_HEADER_LEN, len - BINARY_FRAME_HEADER_LEN);
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) return 0;
+    switch (data[0] % 5) {
+        case 0: check_ascii_message<NanoSensorFrame>(data + 1, size - 1); break;
+        case 1: check_ascii_message<Sps30InfoFrame>(data + 1, size - 1); break;
+        case 2: check_ascii_message<Scd30InfoFrame>(data + 1, size - 1); break;
+        case 3: check_delta(data + 1, size - 1); break;
+        default: check_binary_frame(data + 1, size - 1); break;
+    }
+    return 0;
+}
+
+#ifndef FUZZ_WITH_LIBFUZZER
+
+// --- Random-input driver ---
+
+namespace {
+
+uint32_t rng_state = 0x9E3779B9;
+
+uint32_t next_random() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+size_t random_bytes(uint8_t* out, size_t max_len) {
+    const size_t len = next_random() % max_len;
+    for (size_t i = 0; i < len; i++) out[i] = (uint8_t)next_random();
+    return len;
+}
+
+// A valid ASCII message with a few characters replaced by digits, signs,
+// commas or anything else
+size_t mutated_ascii(uint8_t* out, size_t out_size) {
+    static const char alphabet[] = "0123456789ABCDEFabcdefx-+, \t";
+    char text[ASCII_PACKET_MAX_LEN];
+    size_t len = 0;
+    for (uint8_t field = 0; field < 20 && len + 12 < sizeof(text); field++) {
+        if (field) text[len++] = ',';
+        switch (next_random() % 4) {
+            case 0: len += snprintf(text + len, sizeof(text) - len, "%u", (unsigned)next_random()); break;
+            case 1: len += snprintf(text + len, sizeof(text) - len, "%d", (int)next_random() % 70000); break;
+            case 2: len += snprintf(text + len, sizeof(text) - len, "%X", (unsigned)next_random()); break;
+            default: len += snprintf(text + len, sizeof(text) - len, "%u", (unsigned)(next_random() % 300)); break;
+        }
+    }
+    const uint8_t mutations = next_random() % 4;
+    for (uint8_t i = 0; i < mutations && len > 0; i++) {
+        text[next_random() % len] = alphabet[next_random() % (sizeof(alphabet) - 1)];
+    }
+    if (len + 1 > out_size) len = out_size - 1;
+    out[0] = (uint8_t)(next_random() % 3);
+    memcpy(out + 1, text, len);
+    return len + 1;
+}
+
+// A delta with an arbitrary 16-bit field bitmap, including bits past the
+// last field, and a payload length that matches the flagged fields or
+// misses it by a few bytes
+size_t random_delta(uint8_t* out, size_t out_size) {
+    const uint16_t bitmap = (uint16_t)next_random();
+    size_t fields_len = 0;
+    uint8_t bit = 0;
+    for (size_t i = 0; i < SENSOR_DELTA_FIELD_COUNT; i++) {
+        if (!NANO_SENSOR_DELTA_FIELDS[i].in_bitmap) continue;
+        if (bitmap & (1U << bit)) fields_len += NANO_SENSOR_DELTA_FIELDS[i].size;
+        bit++;
+    }
+    long len = (long)(SENSOR_DELTA_HEADER_LEN + fields_len);
+    if (next_random() % 4 == 0) len += (long)(next_random() % 7) - 3;
+    if (len < 0) len = 0;
+    if ((size_t)len + 2 > out_size) len = out_size - 2;
+
+    out[0] = 3;
+    out[1] = (next_random() % 8) != 0;  // Mostly follow the snapshot
+    uint8_t* payload = out + 2;
+    for (long i = 0; i < len; i++) payload[i] = (uint8_t)next_random();
+    if (len >= SENSOR_DELTA_HEADER_LEN) {
+        payload[4] = bitmap & 0xFF;
+        payload[5] = bitmap >> 8;
+    }
+    return (size_t)len + 2;
+}
+
+// An encoded keyframe or delta frame, sometimes with a byte flipped
+size_t random_binary_frame(uint8_t* out, size_t out_size) {
+    uint8_t delta[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame) + 8];
+    size_t payload_len;
+    uint8_t type;
+    if (next_random() % 2) {
+        type = RSP_SENSORS;
+        payload_len = sizeof(NanoSensorFrame);
+        for (size_t i = 0; i < payload_len; i++) delta[i] = (uint8_t)next_random();
+    } else {
+        type = RSP_SENSORS_DELTA;
+        uint8_t scratch[sizeof(delta) + 2];
+        payload_len = random_delta(scratch, sizeof(scratch)) - 2;
+        memcpy(delta, scratch + 2, payload_len);
+        const uint16_t sequence = fuzz_snapshot().sequence + 1;
+        if (payload_len >= 2) {
+            delta[0] = sequence & 0xFF;
+            delta[1] = sequence >> 8;
+        }
+    }
+    out[0] = 4;
+    const size_t encoded_len = binary_frame_encode(type, (uint8_t)next_random(), delta, payload_len, out + 1, out_size - 1);
+    if (encoded_len > 0 && next_random() % 4 == 0) {
+        out[1 + next_random() % encoded_len] ^= (uint8_t)(1 << (next_random() % 8));
+    }
+    return encoded_len + 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const unsigned long iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    if (argc > 2) rng_state = (uint32_t)strtoul(argv[2], nullptr, 0);
+
+    uint8_t input[320];
+    for (unsigned long i = 0; i < iterations; i++) {
+        size_t len;
+        switch (next_random() % 4) {
+            case 0: len = random_bytes(input, sizeof(input)); break;
+            case 1: len = mutated_ascii(input, sizeof(input)); break;
+            case 2: len = random_delta(input, sizeof(input)); break;
+            default: len = random_binary_frame(input, sizeof(input)); break;
+        }
+        LLVMFuzzerTestOneInput(input, len);
+    }
+    printf("fuzz_schema: %lu inputs, no failures\n", iterations);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,347 @@
+// NanoLink per-channel routing with interleaved sensor stream and bridge
+// traffic. Frames arrive chunk by chunk at 500 kbaud wire time while the
+// main loop is busy and does not drain the queues, the way a slow
+// loop() pass or a web request leaves them. Bridge responses must reach
+// their handler as soon as their last byte is parsed, whatever is queued.
+// A simulated Nano then measures request to response latency with and
+// without a sensor stream, and with and without its stream deferral rule.
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+#include "HostLogger.h"
+#include "HostTest.h"
+#include "NanoLink.h"
+#include "NanoLinkMetrics.h"
+
+namespace {
+
+const uint32_t WIRE_US_PER_BYTE = 10 * 1000000UL / LINK_FAST_BAUD;
+
+struct HandledFrame {
+    NanoFrame frame;
+    uint64_t handled_us;
+};
+
+std::vector<HandledFrame> bridge_frames;
+
+void record_bridge_frame(NanoFrame& frame) {
+    HandledFrame handled;
+    handled.frame = frame;
+    handled.handled_us = host_clock_us();
+    bridge_frames.push_back(handled);
+}
+
+NanoLink& link() {
+    static bool started = false;
+    NanoLink& instance = NanoLink::getInstance();
+    if (!started) {
+        // As in setup()
+        instance.setChannelHandler(PROTOCOL_CHANNEL_BRIDGE, record_bridge_frame);
+        instance.begin();
+        started = true;
+    }
+    return instance;
+}
+
+struct WireFrame {
+    uint8_t bytes[ASCII_PACKET_MAX_LEN + BINARY_FRAME_MAX_ENCODED_LEN];
+    size_t len;
+};
+
+WireFrame ascii_frame(uint8_t request_id, const char* data) {
+    char tagged[ASCII_PACKET_MAX_LEN];
+    if (request_id != REQUEST_ID_NONE) {
+        snprintf(tagged, sizeof(tagged), "#%02X%s", request_id, data);
+    } else {
+        snprintf(tagged, sizeof(tagged), "%s", data);
+    }
+    WireFrame wire;
+    wire.len = ascii_packet_encode(tagged, reinterpret_cast<char*>(wire.bytes), sizeof(wire.bytes));
+    return wire;
+}
+
+WireFrame binary_frame(uint8_t type, uint8_t request_id, const void* payload, size_t payload_len) {
+    WireFrame wire;
+    wire.bytes[0] = BINARY_FRAME_DELIMITER;
+    const size_t encoded_len = binary_frame_encode(type, request_id, payload, payload_len, wire.bytes + 1, sizeof(wire.bytes) - 2);
+    wire.bytes[encoded_len + 1] = BINARY_FRAME_DELIMITER;
+    wire.len = encoded_len + 2;
+    return wire;
+}
+
+WireFrame sensor_frame(uint16_t sequence) {
+    NanoSensorFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.timestamp = 1000UL * sequence;
+    frame.sequence = sequence;
+    frame.co2_ppm = (uint16_t)(800 + sequence);
+    return binary_frame(RSP_SENSORS, REQUEST_ID_NONE, &frame, sizeof(frame));
+}
+
+// Plays the frame onto the wire, then lets the RX task run as the UART
+// pattern or idle timeout interrupt would wake it. Returns when its last
+// byte arrived.
+uint64_t deliver(const WireFrame& wire) {
+    host_clock_advance_us((uint64_t)wire.len * WIRE_US_PER_BYTE);
+    const uint64_t arrived_us = host_clock_us();
+    host_uart_receive(NANO_UART_PORT, wire.bytes, wire.len);
+    host_run_task("NanoRxTask");
+    return arrived_us;
+}
+
+void drain(NanoLink& nano_link) {
+    NanoFrame frame;
+    while (nano_link.receive(frame)) {}
+    bridge_frames.clear();
+}
+
+// --- Request to response latency with the Nano's stream scheduling ---
+// The Nano is modelled as loop() passes every NANO_LOOP_US: a received
+// command is answered in the pass that sees it, then a due sensor frame is
+// queued if protocol_telemetry_may_start() lets it (or always, to show what
+// the rule prevents). Sensor reads take no time here. Nano TX bytes leave
+// one by one at the link baud, each frame is handed to the RX task as its
+// last byte arrives, and the ESP32 main loop drains the queues.
+
+const uint32_t NANO_LOOP_US = 500;
+const uint32_t SIM_STEP_US = 10;
+const unsigned LATENCY_REQUESTS = 40;
+
+enum StreamMode { STREAM_OFF, STREAM_DEFERRED, STREAM_UNDEFERRED };
+
+struct LatencyStats {
+    uint64_t total_us;
+    uint64_t max_us;
+    unsigned count;
+    uint64_t mean() const { return count ? total_us / count : 0; }
+};
+
+struct NanoTx {
+    std::deque<WireFrame> frames;
+    uint64_t front_done_us;   // When the last byte of frames.front() is on the ESP32 side
+    uint32_t byte_us;
+
+    void queue(const WireFrame& wire, uint64_t now_us) {
+        if (frames.empty()) front_done_us = now_us + (uint64_t)wire.len * byte_us;
+        frames.push_back(wire);
+    }
+    // Hands over what finished by now
+    void run(NanoLink& nano_link, uint64_t now_us) {
+        while (!frames.empty() && front_done_us <= now_us) {
+            host_uart_receive(NANO_UART_PORT, frames.front().bytes, frames.front().len);
+            host_run_task("NanoRxTask");
+            NanoFrame frame;
+            while (nano_link.receive(frame)) {}
+            frames.pop_front();
+            if (!frames.empty()) front_done_us += (uint64_t)frames.front().len * byte_us;
+        }
+    }
+};
+
+LatencyStats measure_latency(unsigned long baud, StreamMode mode) {
+    NanoLink& nano_link = link();
+    drain(nano_link);
+    NanoTx tx;
+    tx.byte_us = (uint32_t)(10 * 1000000UL / baud);
+
+    const WireFrame command = ascii_frame(0x10, "I44,02");
+    const uint32_t frame_us = (uint32_t)sensor_frame(0).len * tx.byte_us;
+    // The stream takes about 40% of the link
+    const uint32_t period_ms = (frame_us * 5 / 2 + 999) / 1000;
+
+    LatencyStats stats = { 0, 0, 0 };
+    uint64_t last_stream_ms = millis();
+    uint64_t next_loop_us = host_clock_us();
+    uint64_t request_us = host_clock_us() + 1000;
+    bool answered = false;
+    uint16_t sequence = 0;
+    for (unsigned i = 0; i < LATENCY_REQUESTS; ) {
+        host_clock_advance_us(SIM_STEP_US);
+        const uint64_t now_us = host_clock_us();
+        tx.run(nano_link, now_us);
+
+        if (!bridge_frames.empty()) {
+            const uint64_t latency_us = bridge_frames.back().handled_us - request_us;
+            stats.total_us += latency_us;
+            if (latency_us > stats.max_us) stats.max_us = latency_us;
+            stats.count++;
+            bridge_frames.clear();
+            // The next request lands at another point of the stream period
+            request_us = now_us + 1000 + (i * 7919UL) % (period_ms * 1000);
+            answered = false;
+            i++;
+            continue;
+        }
+
+        if (now_us < next_loop_us) continue;
+        next_loop_us += NANO_LOOP_US;
+
+        // Bytes of the command on the Nano's side so far
+        const bool started = now_us >= request_us;
+        const bool complete = now_us >= request_us + (uint64_t)command.len * tx.byte_us;
+        if (complete && !answered) {
+            tx.queue(ascii_frame((uint8_t)(0x10 + i), "i0,2,80,01"), now_us);
+            answered = true;
+        }
+        const bool rx_busy = started && !complete;
+
+        const uint32_t now_ms = millis();
+        if (mode != STREAM_OFF && now_ms - last_stream_ms >= period_ms) {
+            const uint32_t overdue_ms = (uint32_t)(now_ms - last_stream_ms - period_ms);
+            if (mode == STREAM_UNDEFERRED || protocol_telemetry_may_start(rx_busy, !tx.frames.empty(), overdue_ms)) {
+                last_stream_ms = now_ms;
+                tx.queue(sensor_frame(sequence++), now_us);
+            }
+        }
+    }
+    drain(nano_link);
+    return stats;
+}
+
+} // namespace
+
+TEST_CASE(bridge_responses_bypass_backlogged_stream) {
+    NanoLink& nano_link = link();
+    drain(nano_link);
+
+    // 12 stream frames with a bridge response after every third, more
+    // than the telemetry queue holds
+    std::vector<uint64_t> bridge_arrivals;
+    std::vector<uint8_t> bridge_ids;
+    uint8_t request_id = 0x20;
+    const unsigned long warnings_before = host_log_count(APP_LOG_WARNING);
+    for (uint16_t sequence = 0; sequence < 12; sequence++) {
+        deliver(sensor_frame(sequence));
+        if (sequence % 3 == 2) {
+            const uint8_t read_payload[] = { I2C_ERROR_NONE, 0x80, 0x01 };
+            const WireFrame response = (sequence % 2) ?
+                binary_frame(RSP_I2C_READ, request_id, read_payload, sizeof(read_payload)) :
+                ascii_frame(request_id, "i0,2,80,01");
+            bridge_ids.push_back(request_id++);
+            bridge_arrivals.push_back(deliver(response));
+        }
+    }
+
+    // The telemetry queue overflowed on the way
+    CHECK_EQ(host_log_count(APP_LOG_WARNING) - warnings_before, 12 - NANO_FRAME_QUEUE_LEN);
+    CHECK_EQ(bridge_frames.size(), bridge_ids.size());
+    for (size_t i = 0; i < bridge_frames.size() && i < bridge_ids.size(); i++) {
+        const NanoFrame& frame = bridge_frames[i].frame;
+        CHECK_EQ(frame.channel, PROTOCOL_CHANNEL_BRIDGE);
+        CHECK_EQ(frame.request_id, bridge_ids[i]);
+        const char type = frame.kind == NanoFrame::ASCII ? frame.data[0] : (char)frame.type;
+        CHECK_EQ(type, RSP_I2C_READ);
+        // Handled in the same pass that parsed its last byte
+        CHECK_EQ(bridge_frames[i].handled_us, bridge_arrivals[i]);
+        CHECK_EQ(frame.received_us, (int64_t)bridge_arrivals[i]);
+    }
+
+    // The loop catches up: the stream frames that fit the queue are still there, in order
+    NanoFrame frame;
+    uint16_t expected_sequence = 0;
+    unsigned telemetry = 0;
+    while (nano_link.receive(frame)) {
+        CHECK_EQ(frame.channel, PROTOCOL_CHANNEL_TELEMETRY);
+        NanoSensorFrame sensors;
+        memcpy(&sensors, frame.data, sizeof(sensors));
+        CHECK_EQ(sensors.sequence, expected_sequence++);
+        telemetry++;
+    }
+    CHECK_EQ(telemetry, NANO_FRAME_QUEUE_LEN);
+    drain(nano_link);
+}
+
+TEST_CASE(bridge_response_in_the_same_chunk_as_stream_frames) {
+    NanoLink& nano_link = link();
+    drain(nano_link);
+
+    // One UART read holding a burst: stream frames around a bridge response
+    // and a corrupted stream frame ahead of it
+    WireFrame burst;
+    burst.len = 0;
+    const WireFrame parts[] = {
+        sensor_frame(100),
+        sensor_frame(101),
+        ascii_frame(0x31, "w0"),
+        sensor_frame(102),
+    };
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        memcpy(burst.bytes + burst.len, parts[i].bytes, parts[i].len);
+        burst.len += parts[i].len;
+        if (i == 1) {
+            burst.bytes[burst.len - 4] ^= 0x40; // CRC-16 mismatch
+        }
+    }
+    const uint32_t errors_before = nano_link.errorCount();
+    const uint64_t arrived_us = deliver(burst);
+
+    CHECK_EQ(nano_link.errorCount(), errors_before + 1);
+    CHECK_EQ(bridge_frames.size(), 1);
+    if (!bridge_frames.empty()) {
+        CHECK_EQ(bridge_frames[0].frame.request_id, 0x31);
+        CHECK_STR(bridge_frames[0].frame.data, "w0");
+        CHECK_EQ(bridge_frames[0].handled_us, arrived_us);
+    }
+    drain(nano_link);
+}
+
+TEST_CASE(queued_channels_drain_in_priority_order) {
+    NanoLink& nano_link = link();
+    drain(nano_link);
+
+    char event[16];
+    snprintf(event, sizeof(event), "%c%X,%X", RSP_EVENT, NANO_EVENT_I2C_TIMEOUT, 0);
+    deliver(sensor_frame(7));
+    deliver(ascii_frame(0x40, "h3600,1234,0,2"));
+    deliver(ascii_frame(REQUEST_ID_NONE, event));
+    deliver(sensor_frame(8));
+
+    NanoFrame frame;
+    CHECK(nano_link.receive(frame));
+    CHECK_EQ(frame.channel, PROTOCOL_CHANNEL_EVENT);
+    CHECK(nano_link.receive(frame));
+    CHECK_EQ(frame.channel, PROTOCOL_CHANNEL_CONTROL);
+    CHECK_EQ(frame.request_id, 0x40);
+    CHECK(nano_link.receive(frame));
+    CHECK_EQ(frame.channel, PROTOCOL_CHANNEL_TELEMETRY);
+    CHECK(nano_link.receive(frame));
+    CHECK_EQ(frame.channel, PROTOCOL_CHANNEL_TELEMETRY);
+    CHECK(!nano_link.receive(frame));
+    CHECK(bridge_frames.empty());
+}
+
+TEST_CASE(stream_frames_defer_to_commands) {
+    // Due and nothing else going on
+    CHECK(protocol_telemetry_may_start(false, false, 0));
+    // A command coming in, or responses still leaving
+    CHECK(!protocol_telemetry_may_start(true, false, 0));
+    CHECK(!protocol_telemetry_may_start(false, true, 0));
+    CHECK(!protocol_telemetry_may_start(true, true, SENSOR_STREAM_MAX_DEFER_MS - 1));
+    // Busy traffic delays the stream, it does not stop it
+    CHECK(protocol_telemetry_may_start(true, true, SENSOR_STREAM_MAX_DEFER_MS));
+}
+
+TEST_CASE(bridge_latency_under_stream_load) {
+    const unsigned long bauds[] = { LINK_DEFAULT_BAUD, LINK_FAST_BAUD };
+    printf("Bridge request to response latency, %u requests, stream at about 40%% of the link\n", LATENCY_REQUESTS);
+    printf("%8s  %-22s %10s %10s\n", "baud", "stream", "mean us", "max us");
+    for (size_t i = 0; i < sizeof(bauds) / sizeof(bauds[0]); i++) {
+        const LatencyStats idle = measure_latency(bauds[i], STREAM_OFF);
+        const LatencyStats deferred = measure_latency(bauds[i], STREAM_DEFERRED);
+        const LatencyStats undeferred = measure_latency(bauds[i], STREAM_UNDEFERRED);
+        printf("%8lu  %-22s %10llu %10llu\n", bauds[i], "off", (unsigned long long)idle.mean(), (unsigned long long)idle.max_us);
+        printf("%8lu  %-22s %10llu %10llu\n", bauds[i], "deferred", (unsigned long long)deferred.mean(), (unsigned long long)deferred.max_us);
+        printf("%8lu  %-22s %10llu %10llu\n", bauds[i], "always when due", (unsigned long long)undeferred.mean(), (unsigned long long)undeferred.max_us);
+
+        CHECK_EQ(idle.count, LATENCY_REQUESTS);
+        CHECK_EQ(deferred.count, LATENCY_REQUESTS);
+        // At worst a response waits for the one frame that started before
+        // the command arrived
+        const uint64_t frame_us = (uint64_t)sensor_frame(0).len * (10 * 1000000UL / bauds[i]);
+        CHECK(deferred.max_us <= idle.max_us + frame_us);
+        CHECK(deferred.mean() < undeferred.mean());
+    }
+}
+
+HOST_TEST_MAIN()
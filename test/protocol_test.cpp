@@ -0,0 +1,443 @@
+// Roundtrip tests for the shared protocol headers in include/protocol.
+
+#include "HostTest.h"
+#include "protocol/Frames.h"
+
+namespace {
+
+uint8_t crc8_reference(const uint8_t* data, size_t len) {
+    uint8_t crc = 0x00;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ PROTOCOL_CRC8_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint16_t crc16_reference(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Strips the delimiters a frame would have on the wire, as NanoFrameParser does
+size_t frame_roundtrip(uint8_t type, uint8_t request_id, const uint8_t* payload, size_t payload_len,
+                       uint8_t* decoded, size_t decoded_size) {
+    uint8_t encoded[300];
+    const size_t encoded_len = binary_frame_encode(type, request_id, payload, payload_len, encoded, sizeof(encoded));
+    if (encoded_len == 0 || encoded_len > decoded_size) return 0;
+    for (size_t i = 0; i < encoded_len; i++) {
+        if (encoded[i] == BINARY_FRAME_DELIMITER) return 0;
+    }
+    memcpy(decoded, encoded, encoded_len);
+    return binary_frame_decode(decoded, encoded_len);
+}
+
+NanoSensorFrame sample_frame() {
+    NanoSensorFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.timestamp = 123456;
+    frame.pressure_adc_raw = 512;
+    frame.pulse_count = 7;
+    frame.temperature_x10 = -125;
+    frame.humidity_x10 = 455;
+    frame.co2_ppm = 812;
+    frame.voc_raw = 30000;
+    frame.nox_raw = 15000;
+    frame.fan_amps_x100 = 345;
+    frame.pm1_x10 = 12;
+    frame.pm25_x10 = 25;
+    frame.pm4_x10 = 40;
+    frame.pm10_x10 = 100;
+    frame.compressor_amps_x100 = 1200;
+    frame.geothermal_pump_amps_x100 = 410;
+    frame.liquid_level_raw = 1;
+    frame.co_adc_raw = 88;
+    frame.sequence = 41;
+    return frame;
+}
+
+} // namespace
+
+// --- CRC ---
+
+TEST_CASE(crc8_check_value) {
+    CHECK_EQ(crc8_calculate("123456789"), 0xF4);
+    CHECK_EQ(crc8_calculate(""), 0x00);
+}
+
+TEST_CASE(crc8_table_matches_bitwise) {
+    for (unsigned value = 0; value < 256; value++) {
+        const uint8_t byte = (uint8_t)value;
+        CHECK_EQ(crc8_update(0, byte), crc8_reference(&byte, 1));
+    }
+    const char* packet = "s123456,512,7,-125,455,812";
+    CHECK_EQ(crc8_calculate(packet), crc8_reference(reinterpret_cast<const uint8_t*>(packet), strlen(packet)));
+}
+
+TEST_CASE(crc16_check_value) {
+    const char* check = "123456789";
+    CHECK_EQ(crc16_calculate(reinterpret_cast<const uint8_t*>(check), 9), 0x29B1);
+    CHECK_EQ(crc16_calculate(nullptr, 0), 0xFFFF);
+}
+
+TEST_CASE(crc16_matches_bitwise) {
+    uint8_t data[256];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 37 + 11);
+    for (size_t len = 0; len <= sizeof(data); len += 17) {
+        CHECK_EQ(crc16_calculate(data, len), crc16_reference(data, len));
+    }
+}
+
+// --- ASCII Packets ---
+
+TEST_CASE(ascii_packet_roundtrip) {
+    char packet[ASCII_PACKET_MAX_LEN];
+    const size_t len = ascii_packet_encode("#1AH", packet, sizeof(packet));
+    char expected[32];
+    snprintf(expected, sizeof(expected), "<#1AH,%u>", crc8_calculate("#1AH"));
+    CHECK_EQ(len, strlen(expected));
+    CHECK_STR(packet, expected);
+
+    // Through a volatile so the compiler does not flag the truncation it can see
+    volatile size_t too_small = 6;
+    CHECK_EQ(ascii_packet_encode("#1AH", packet, too_small), 0);
+}
+
+TEST_CASE(ascii_request_id_split) {
+    uint8_t id = 0xAA;
+    CHECK_STR(ascii_packet_split_request_id("#1Ah1,2", &id), "h1,2");
+    CHECK_EQ(id, 0x1A);
+    CHECK_STR(ascii_packet_split_request_id("#ffS", &id), "S");
+    CHECK_EQ(id, 0xFF);
+    CHECK_STR(ascii_packet_split_request_id("s1,2", &id), "s1,2");
+    CHECK_EQ(id, REQUEST_ID_NONE);
+    // Not hex, left to the command decoder
+    CHECK_STR(ascii_packet_split_request_id("#G1x", &id), "#G1x");
+    CHECK_EQ(id, REQUEST_ID_NONE);
+}
+
+// --- COBS / Binary Frames ---
+
+TEST_CASE(binary_frame_roundtrip_all_lengths) {
+    uint8_t payload[BINARY_FRAME_MAX_RAW_LEN];
+    for (size_t len = 0; len + BINARY_FRAME_HEADER_LEN + 2 <= BINARY_FRAME_MAX_RAW_LEN; len++) {
+        // Zeros at varying positions exercise every COBS code length
+        for (size_t i = 0; i < len; i++) payload[i] = (i % (len % 7 + 1) == 0) ? 0 : (uint8_t)(i + 1);
+        uint8_t decoded[BINARY_FRAME_MAX_ENCODED_LEN + 2];
+        const size_t decoded_len = frame_roundtrip(RSP_I2C_READ, 0x42, payload, len, decoded, sizeof(decoded));
+        CHECK_EQ(decoded_len, BINARY_FRAME_HEADER_LEN + len);
+        CHECK_EQ(decoded[0], RSP_I2C_READ);
+        CHECK_EQ(decoded[1], 0x42);
+        CHECK_MEM(decoded + BINARY_FRAME_HEADER_LEN, payload, len);
+    }
+}
+
+TEST_CASE(binary_frame_long_runs_without_zero) {
+    // 0xFF code blocks: more than 254 non-zero bytes are not possible in one frame
+    uint8_t payload[240];
+    memset(payload, 0x5A, sizeof(payload));
+    uint8_t decoded[300];
+    const size_t decoded_len = frame_roundtrip(CMD_I2C_WRITE, 0x01, payload, sizeof(payload), decoded, sizeof(decoded));
+    CHECK_EQ(decoded_len, BINARY_FRAME_HEADER_LEN + sizeof(payload));
+    CHECK_MEM(decoded + BINARY_FRAME_HEADER_LEN, payload, sizeof(payload));
+}
+
+TEST_CASE(binary_frame_encode_in_place) {
+    // Callers build the payload at BINARY_FRAME_PAYLOAD_OFFSET to skip a copy
+    uint8_t frame[BINARY_FRAME_MAX_ENCODED_LEN];
+    const uint8_t payload[] = { 0x76, 0x00, 0xF7, 0x00, 0x06 };
+    memcpy(frame + BINARY_FRAME_PAYLOAD_OFFSET, payload, sizeof(payload));
+    const size_t encoded_len = binary_frame_encode(CMD_I2C_READ, 0x07, frame + BINARY_FRAME_PAYLOAD_OFFSET,
+                                                   sizeof(payload), frame, sizeof(frame));
+    CHECK(encoded_len > 0);
+    CHECK_EQ(binary_frame_decode(frame, encoded_len), BINARY_FRAME_HEADER_LEN + sizeof(payload));
+    CHECK_MEM(frame + BINARY_FRAME_HEADER_LEN, payload, sizeof(payload));
+}
+
+TEST_CASE(binary_frame_rejects_corruption) {
+    const uint8_t payload[] = { 1, 2, 0, 4, 5, 0, 0, 8 };
+    uint8_t encoded[64];
+    const size_t encoded_len = binary_frame_encode(RSP_SENSORS, REQUEST_ID_NONE, payload, sizeof(payload), encoded, sizeof(encoded));
+    CHECK(encoded_len > 0);
+    for (size_t pos = 0; pos < encoded_len; pos++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            uint8_t corrupted[64];
+            memcpy(corrupted, encoded, encoded_len);
+            corrupted[pos] ^= (uint8_t)(1 << bit);
+            CHECK_EQ(binary_frame_decode(corrupted, encoded_len), 0);
+        }
+    }
+    // Truncated frames
+    for (size_t len = 0; len < encoded_len; len++) {
+        uint8_t truncated[64];
+        memcpy(truncated, encoded, encoded_len);
+        CHECK_EQ(binary_frame_decode(truncated, len), 0);
+    }
+}
+
+TEST_CASE(binary_frame_size_limits) {
+    uint8_t payload[260] = { 0 };
+    uint8_t out[300];
+    CHECK_EQ(binary_frame_encode(RSP_SENSORS, 0, payload, 250, out, sizeof(out)), 0);
+    CHECK_EQ(binary_frame_encode(RSP_SENSORS, 0, payload, 10, out, 14), 0);
+    CHECK_EQ(binary_frame_encode(RSP_SENSORS, 0, payload, 10, out, 15), 15);
+}
+
+TEST_CASE(cobs_decode_rejects_malformed) {
+    uint8_t out[16];
+    const uint8_t zero_code[] = { 0x02, 0x11, 0x00, 0x22 };
+    CHECK_EQ(cobs_decode(zero_code, sizeof(zero_code), out, sizeof(out)), 0);
+    const uint8_t overrun[] = { 0x05, 0x11, 0x22 };
+    CHECK_EQ(cobs_decode(overrun, sizeof(overrun), out, sizeof(out)), 0);
+    const uint8_t valid[] = { 0x03, 0x11, 0x22, 0x02, 0x33 };
+    CHECK_EQ(cobs_decode(valid, sizeof(valid), out, sizeof(out)), 4);
+    const uint8_t expected[] = { 0x11, 0x22, 0x00, 0x33 };
+    CHECK_MEM(out, expected, sizeof(expected));
+    CHECK_EQ(cobs_decode(valid, sizeof(valid), out, 3), 0);
+}
+
+// --- Delta Sensor Frames ---
+
+TEST_CASE(delta_frame_roundtrip) {
+    NanoSensorFrame previous = sample_frame();
+    NanoSensorFrame current = previous;
+    current.sequence++;
+    current.timestamp += 5000;
+    current.co2_ppm = 815;
+    current.liquid_level_raw = 0;
+    current.co_adc_raw = 91;
+
+    uint8_t payload[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+    const size_t len = sensor_delta_encode(previous, current, payload, sizeof(payload));
+    CHECK_EQ(len, SENSOR_DELTA_HEADER_LEN + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t));
+
+    NanoSensorFrame snapshot = previous;
+    CHECK(sensor_delta_apply(snapshot, payload, len));
+    CHECK_MEM(&snapshot, &current, sizeof(current));
+
+    // Unchanged frame: header only
+    NanoSensorFrame next = current;
+    next.sequence++;
+    next.timestamp += 500;
+    CHECK_EQ(sensor_delta_encode(current, next, payload, sizeof(payload)), SENSOR_DELTA_HEADER_LEN);
+    CHECK(sensor_delta_apply(snapshot, payload, SENSOR_DELTA_HEADER_LEN));
+    CHECK_MEM(&snapshot, &next, sizeof(next));
+}
+
+TEST_CASE(delta_frame_every_field) {
+    const NanoSensorFrame previous = sample_frame();
+    uint8_t bit = 0;
+    for (size_t i = 0; i < SENSOR_DELTA_FIELD_COUNT; i++) {
+        const SensorDeltaField& field = NANO_SENSOR_DELTA_FIELDS[i];
+        if (!field.in_bitmap) continue;
+        NanoSensorFrame current = previous;
+        current.sequence++;
+        reinterpret_cast<uint8_t*>(&current)[field.offset] ^= 0x5A;
+
+        uint8_t payload[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+        const size_t len = sensor_delta_encode(previous, current, payload, sizeof(payload));
+        CHECK_EQ(len, SENSOR_DELTA_HEADER_LEN + field.size);
+        CHECK_EQ(payload[4] | (payload[5] << 8), 1 << bit);
+
+        NanoSensorFrame snapshot = previous;
+        CHECK(sensor_delta_apply(snapshot, payload, len));
+        CHECK_MEM(&snapshot, &current, sizeof(current));
+        bit++;
+    }
+    CHECK_EQ(bit, SENSOR_DELTA_FIELD_COUNT - 2);
+}
+
+TEST_CASE(delta_frame_needs_keyframe) {
+    const NanoSensorFrame previous = sample_frame();
+    NanoSensorFrame current = previous;
+    uint8_t payload[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+
+    current.sequence = previous.sequence + 2;
+    CHECK_EQ(sensor_delta_encode(previous, current, payload, sizeof(payload)), 0);
+
+    current.sequence = previous.sequence + 1;
+    current.timestamp = previous.timestamp + 0x10000;
+    CHECK_EQ(sensor_delta_encode(previous, current, payload, sizeof(payload)), 0);
+
+    current.timestamp = previous.timestamp + 0xFFFF;
+    CHECK_EQ(sensor_delta_encode(previous, current, payload, sizeof(payload) - 1), 0);
+    CHECK_EQ(sensor_delta_encode(previous, current, payload, sizeof(payload)), SENSOR_DELTA_HEADER_LEN);
+
+    // Sequence wraps from 0xFFFF to 0
+    NanoSensorFrame wrapped_prev = previous;
+    wrapped_prev.sequence = 0xFFFF;
+    NanoSensorFrame wrapped = wrapped_prev;
+    wrapped.sequence = 0;
+    CHECK_EQ(sensor_delta_encode(wrapped_prev, wrapped, payload, sizeof(payload)), SENSOR_DELTA_HEADER_LEN);
+    CHECK(sensor_delta_apply(wrapped_prev, payload, SENSOR_DELTA_HEADER_LEN));
+    CHECK_EQ(wrapped_prev.sequence, 0);
+}
+
+TEST_CASE(delta_frame_apply_rejects_malformed) {
+    const NanoSensorFrame previous = sample_frame();
+    NanoSensorFrame current = previous;
+    current.sequence++;
+    current.co2_ppm = 900;
+    uint8_t payload[SENSOR_DELTA_HEADER_LEN + sizeof(NanoSensorFrame)];
+    const size_t len = sensor_delta_encode(previous, current, payload, sizeof(payload));
+
+    NanoSensorFrame snapshot = previous;
+    CHECK(!sensor_delta_apply(snapshot, payload, SENSOR_DELTA_HEADER_LEN - 1));
+    CHECK(!sensor_delta_apply(snapshot, payload, len - 1));
+    uint8_t longer[sizeof(payload) + 1];
+    memcpy(longer, payload, len);
+    longer[len] = 0;
+    CHECK(!sensor_delta_apply(snapshot, longer, len + 1));
+
+    // Bits past the last field
+    uint8_t extra_bit[sizeof(payload)];
+    memcpy(extra_bit, payload, len);
+    extra_bit[5] |= 0x80;
+    CHECK(!sensor_delta_apply(snapshot, extra_bit, len));
+
+    // Does not follow the snapshot
+    NanoSensorFrame stale = previous;
+    stale.sequence += 5;
+    CHECK(!sensor_delta_apply(stale, payload, len));
+    CHECK_MEM(&snapshot, &previous, sizeof(previous));
+}
+
+// --- Schema ---
+
+TEST_CASE(schema_sensor_frame_ascii_roundtrip) {
+    const NanoSensorFrame frame = sample_frame();
+    char packet[ASCII_PACKET_MAX_LEN];
+    const size_t len = protocol_ascii_encode(frame, packet, sizeof(packet));
+    CHECK(len > 0);
+    CHECK_EQ(packet[0], RSP_SENSORS);
+    CHECK_STR(packet, "s123456,512,7,-125,455,812,30000,15000,345,12,25,40,100,1200,410,1,88,41");
+
+    NanoSensorFrame decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    CHECK_EQ(protocol_ascii_decode(packet + 1, decoded), ProtocolMessage<NanoSensorFrame>::field_count);
+    CHECK_MEM(&decoded, &frame, sizeof(frame));
+
+    // Every length that cannot hold the packet is refused
+    for (size_t size = 0; size <= len; size++) {
+        CHECK_EQ(protocol_ascii_encode(frame, packet, size), 0);
+    }
+}
+
+TEST_CASE(schema_missing_trailing_fields) {
+    // Firmware before the sequence field
+    char fields[] = "123456,512,7,-125,455,812,30000,15000,345,12,25,40,100,1200,410,1,88";
+    NanoSensorFrame decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    CHECK_EQ(protocol_ascii_decode(fields, decoded), ProtocolMessage<NanoSensorFrame>::field_count - 1);
+    CHECK_EQ(decoded.co_adc_raw, 88);
+    CHECK_EQ(decoded.sequence, 0);
+}
+
+TEST_CASE(schema_sps30_ascii_roundtrip) {
+    Sps30InfoFrame info;
+    info.ret_fw = 0;
+    info.fw_major = 2;
+    info.fw_minor = 3;
+    info.ret_fan_interval = -1;
+    info.fan_interval = 604800;
+    info.ret_fan_days = 0;
+    info.fan_days = 7;
+    info.ret_status = 0;
+    info.status_reg = 0x00200010;
+
+    char packet[ASCII_PACKET_MAX_LEN];
+    CHECK(protocol_ascii_encode(info, packet, sizeof(packet)) > 0);
+    CHECK_STR(packet, "p0,2,3,-1,604800,0,7,0,2097168");
+    Sps30InfoFrame decoded = Sps30InfoFrame();
+    CHECK_EQ(protocol_ascii_decode(packet + 1, decoded), ProtocolMessage<Sps30InfoFrame>::field_count);
+    CHECK_EQ(decoded.ret_fan_interval, -1);
+    CHECK_EQ(decoded.fan_interval, 604800);
+    CHECK_EQ(decoded.status_reg, 0x00200010);
+}
+
+TEST_CASE(schema_scd30_hex_roundtrip) {
+    Scd30InfoFrame info;
+    info.ret_interval = 0;
+    info.measurement_interval = 2;
+    info.ret_auto_cal = -1;
+    info.auto_calibration = 1;
+    info.ret_forced_cal = 0;
+    info.forced_recalibration = 400;
+    info.ret_temp_offset = 0;
+    info.temperature_offset = 0xFFFF;
+    info.ret_altitude = 0;
+    info.altitude_compensation = 120;
+    info.ret_firmware = 0;
+    info.fw_major = 3;
+    info.fw_minor = 0x42;
+
+    char packet[ASCII_PACKET_MAX_LEN];
+    CHECK(protocol_ascii_encode(info, packet, sizeof(packet)) > 0);
+    CHECK_STR(packet, "d0,2,FFFF,1,0,190,0,FFFF,0,78,0,3,42");
+    Scd30InfoFrame decoded = Scd30InfoFrame();
+    CHECK_EQ(protocol_ascii_decode(packet + 1, decoded), ProtocolMessage<Scd30InfoFrame>::field_count);
+    CHECK_EQ(decoded.ret_auto_cal, -1);
+    CHECK_EQ(decoded.forced_recalibration, 400);
+    CHECK_EQ(decoded.temperature_offset, 0xFFFF);
+    CHECK_EQ(decoded.fw_minor, 0x42);
+
+    // Older firmware printed empty fields, they are skipped
+    char legacy[] = "0,2,,1";
+    Scd30InfoFrame partial = Scd30InfoFrame();
+    CHECK_EQ(protocol_ascii_decode(legacy, partial), 3);
+    CHECK_EQ(partial.ret_auto_cal, 1);
+}
+
+TEST_CASE(schema_debug_format) {
+    Sps30InfoFrame info;
+    memset(&info, 0, sizeof(info));
+    info.fw_major = 2;
+    info.ret_status = -3;
+    char text[256];
+    CHECK(protocol_debug_format(info, text, sizeof(text)) > 0);
+    CHECK_STR(text, "ret_fw=0, fw_major=2, fw_minor=0, ret_fan_interval=0, fan_interval=0, "
+                    "ret_fan_days=0, fan_days=0, ret_status=-3, status_reg=0");
+
+    Scd30InfoFrame scd;
+    memset(&scd, 0, sizeof(scd));
+    scd.measurement_interval = 0x1F;
+    CHECK(protocol_debug_format(scd, text, sizeof(text)) > 0);
+    CHECK(strstr(text, "measurement_interval=0x1F, ") != nullptr);
+
+    // Truncated output stays terminated
+    char small[16];
+    CHECK_EQ(protocol_debug_format(info, small, sizeof(small)), sizeof(small) - 1);
+    CHECK_EQ(small[sizeof(small) - 1], '\0');
+}
+
+// --- Channels ---
+
+TEST_CASE(channels_and_responses) {
+    CHECK_EQ(protocol_response_for(CMD_I2C_READ), RSP_I2C_READ);
+    CHECK_EQ(protocol_response_for(CMD_GET_SENSORS), RSP_SENSORS);
+    CHECK_EQ(protocol_response_for(RSP_SENSORS), RSP_SENSORS);
+    CHECK(!protocol_command_has_response(CMD_REBOOT));
+    CHECK(protocol_command_has_response(CMD_I2C_WRITE_BLOCK));
+
+    const char bridge[] = { RSP_I2C_READ, RSP_I2C_WRITE, RSP_I2C_WRITE_CHUNK, RSP_I2C_SCRIPT, RSP_I2C_WATCH,
+                            RSP_I2C_WATCH_DATA, RSP_I2C_READ_BLOCK, RSP_I2C_SEGMENT, RSP_I2C_WRITE_BLOCK };
+    for (size_t i = 0; i < sizeof(bridge); i++) {
+        CHECK_EQ(protocol_channel_of(bridge[i]), PROTOCOL_CHANNEL_BRIDGE);
+    }
+    CHECK_EQ(protocol_channel_of(RSP_EVENT), PROTOCOL_CHANNEL_EVENT);
+    CHECK_EQ(protocol_channel_of(RSP_LEGACY_EVENT), PROTOCOL_CHANNEL_EVENT);
+    CHECK_EQ(protocol_channel_of(RSP_SENSORS), PROTOCOL_CHANNEL_TELEMETRY);
+    CHECK_EQ(protocol_channel_of(RSP_SENSORS_DELTA), PROTOCOL_CHANNEL_TELEMETRY);
+    CHECK_EQ(protocol_channel_of(RSP_HEALTH), PROTOCOL_CHANNEL_CONTROL);
+    CHECK_EQ(protocol_channel_of(RSP_TIME_SYNC), PROTOCOL_CHANNEL_CONTROL);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,73 @@
+// NanoRequestTable matching, expiry and the per-origin pending counts that
+// gate loop() commands and the baud switch.
+
+#include <Arduino.h>
+#include "HostTest.h"
+#include "NanoRequestTable.h"
+
+TEST_CASE(loop_count_ignores_bridge_requests) {
+    NanoRequestTable table;
+    for (uint8_t i = 0; i < 8; i++) {
+        CHECK(table.add(i % 2 ? CMD_I2C_READ : CMD_I2C_WRITE_BLOCK) != REQUEST_ID_NONE);
+    }
+    CHECK_EQ(table.pendingCount(), 8);
+    CHECK_EQ(table.pendingLoopCount(), 0);
+
+    const uint8_t health_id = table.add(CMD_GET_HEALTH);
+    table.add(CMD_TIME_SYNC);
+    CHECK_EQ(table.pendingCount(), 10);
+    CHECK_EQ(table.pendingLoopCount(), 2);
+
+    NanoRequestTable::Entry entry;
+    CHECK(table.complete(health_id, RSP_HEALTH, entry));
+    CHECK_EQ(entry.cmd, CMD_GET_HEALTH);
+    CHECK_EQ(table.pendingLoopCount(), 1);
+}
+
+TEST_CASE(tagged_and_untagged_completion) {
+    NanoRequestTable table;
+    host_clock_advance_ms(10);
+    const uint8_t first = table.add(CMD_GET_SCD30_INFO);
+    host_clock_advance_ms(10);
+    const uint8_t second = table.add(CMD_GET_SCD30_INFO);
+    CHECK(first != second);
+
+    // Untagged responses complete the oldest request for their letter
+    NanoRequestTable::Entry entry;
+    CHECK(table.complete(REQUEST_ID_NONE, RSP_SCD30_INFO, entry));
+    CHECK_EQ(entry.id, first);
+    CHECK(!table.complete(REQUEST_ID_NONE, RSP_HEALTH, entry));
+    CHECK(table.complete(second, RSP_SCD30_INFO, entry));
+    CHECK(!table.complete(second, RSP_SCD30_INFO, entry));
+    CHECK_EQ(table.pendingCount(), 0);
+}
+
+TEST_CASE(expired_requests_drain) {
+    NanoRequestTable table;
+    table.add(CMD_I2C_READ_BLOCK, 2000);
+    table.add(CMD_GET_HEALTH, 100);
+    NanoRequestTable::Entry entry;
+    CHECK(!table.popExpired(millis(), entry));
+
+    host_clock_advance_ms(100);
+    CHECK(table.popExpired(millis(), entry));
+    CHECK_EQ(entry.cmd, CMD_GET_HEALTH);
+    CHECK_EQ(table.pendingLoopCount(), 0);
+    CHECK_EQ(table.pendingCount(), 1);
+
+    host_clock_advance_ms(1900);
+    CHECK(table.popExpired(millis(), entry));
+    CHECK_EQ(table.pendingCount(), 0);
+}
+
+TEST_CASE(table_full) {
+    NanoRequestTable table;
+    for (uint8_t i = 0; i < NANO_REQUEST_TABLE_SIZE; i++) {
+        CHECK(table.add(CMD_I2C_READ) != REQUEST_ID_NONE);
+    }
+    CHECK_EQ(table.add(CMD_GET_HEALTH), REQUEST_ID_NONE);
+    table.clear();
+    CHECK_EQ(table.pendingCount(), 0);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,71 @@
+// RollingAverage ordering, time weighting and the window around the
+// millis() rollover.
+
+#include <Arduino.h>
+#include "HostTest.h"
+#include "RollingAverage.h"
+
+TEST_CASE(plain_mean_without_time_span) {
+    RollingAverage<float> average(8);
+    CHECK(average.isEmpty());
+    average.add(10.0f, 5000);
+    CHECK_EQ(average.getAverage(), 10);
+    average.add(20.0f, 5000);
+    CHECK_EQ(average.getAverage(), 15);
+}
+
+TEST_CASE(burst_after_gap_is_weighted_by_time) {
+    RollingAverage<float> average(64);
+    // 10 minutes at 100, one sample a minute
+    for (unsigned long minute = 0; minute <= 10; minute++) {
+        average.add(100.0f, minute * 60000UL);
+    }
+    // A burst of 20 samples at 200 within one second
+    for (unsigned long i = 1; i <= 20; i++) {
+        average.add(200.0f, 600000UL + i * 50);
+    }
+    // The burst covers a second of the window, the plain mean would be 164.5
+    const float mean = average.getAverage();
+    CHECK(mean > 100.0f && mean < 101.0f);
+}
+
+TEST_CASE(late_sample_lands_in_order) {
+    RollingAverage<uint16_t> average(8);
+    average.add(100, 1000);
+    average.add(300, 3000);
+    average.add(200, 2000); // Mapped time before the previous sample
+    CHECK_EQ(average.getAverage(), 200);
+
+    // The newest value stays the one with the latest timestamp
+    RollingAverage<uint16_t> latest(1);
+    latest.add(300, 3000);
+    latest.add(100, 1000);
+    CHECK_EQ(latest.getAverage(), 300);
+}
+
+TEST_CASE(full_buffer_drops_the_oldest) {
+    RollingAverage<uint16_t> average(3);
+    average.add(100, 1000);
+    average.add(100, 2000);
+    average.add(100, 3000);
+    average.add(500, 500);  // Older than everything kept
+    CHECK_EQ(average.getAverage(), 100);
+    average.add(400, 4000);
+    CHECK_EQ(average.getAverage(), 175);
+}
+
+TEST_CASE(window_across_millis_rollover) {
+    RollingAverage<float> average(16);
+    const unsigned long start = 0xFFFFFFFFUL - 10 * 60000UL;
+    average.add(50.0f, start);
+    average.add(50.0f, start + 60000UL);
+    // 20 minutes later millis() has wrapped, both old samples are still in the window
+    average.add(50.0f, start + 20 * 60000UL);
+    CHECK_EQ(average.getAverage(), 50);
+    // 31 minutes after the first sample it falls out of the window
+    average.add(110.0f, start + 31 * 60000UL);
+    CHECK(!average.isEmpty());
+    CHECK_EQ(average.getAverage(), (50.0f * 19 + 80.0f * 11) / 30);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,249 @@
+// BMP280Sensor, AHT20 and the ZMOD4510 HAL with the zmod4xxx API running
+// against MockI2CBus register maps, the way I2CBuses hands the drivers a
+// bus on the device.
+
+#include <Arduino.h>
+#include "HostTest.h"
+#include "AHT20.h"
+#include "BMP280Sensor.h"
+#include "MockI2CBus.h"
+#include "zmod4510/zmod4xxx.h"
+#include "zmod4510/hal/hal.h"
+#include "zmod4510/hal/zmod4xxx_hal.h"
+#include "zmod4510/algos/zmod4510_config_no2_o3.h"
+
+namespace {
+
+const uint8_t BMP280_ADDR = 0x77;
+
+// Calibration, raw readings and results of the BMP280 datasheet example
+const uint16_t DATASHEET_CALIB[12] = { 27504, 26435, (uint16_t)-1000, 36477, (uint16_t)-10685, 3024, 2855, 140,
+                                       (uint16_t)-7, 15500, (uint16_t)-14600, 6000 };
+const uint32_t DATASHEET_ADC_T = 519888;
+const uint32_t DATASHEET_ADC_P = 415148;
+
+void add_bmp280(MockI2CBus& bus) {
+    bus.addDevice(BMP280_ADDR);
+    uint8_t* regs = bus.registers(BMP280_ADDR);
+    regs[BMP280_REG_ID] = BMx280MI::BMP280_ID;
+    for (uint8_t i = 0; i < 12; i++) {
+        regs[BMP280_REG_CALIB + 2 * i] = DATASHEET_CALIB[i] & 0xFF;
+        regs[BMP280_REG_CALIB + 2 * i + 1] = DATASHEET_CALIB[i] >> 8;
+    }
+    const uint32_t press = DATASHEET_ADC_P << 4;
+    const uint32_t temp = DATASHEET_ADC_T << 4;
+    const uint8_t data[] = { (uint8_t)(press >> 16), (uint8_t)(press >> 8), (uint8_t)press,
+                             (uint8_t)(temp >> 16), (uint8_t)(temp >> 8), (uint8_t)temp };
+    memcpy(regs + 0xF7, data, sizeof(data));
+}
+
+uint8_t aht20_crc(const uint8_t* data, uint8_t len) {
+    uint8_t crc = AHT20_CRC8_INIT;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ AHT20_CRC8_POLYNOMIAL : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Status, 20 bit humidity and temperature and the CRC, as every read returns them
+void set_aht20_reading(MockI2CBus& bus, uint8_t status, float humidity, float temperature) {
+    const uint32_t hum = (uint32_t)(humidity / 100 * 1048576);
+    const uint32_t temp = (uint32_t)((temperature + 50) / 200 * 1048576);
+    uint8_t* regs = bus.registers(AHT20_DEFAULT_ADDRESS);
+    regs[0] = status;
+    regs[1] = hum >> 12;
+    regs[2] = hum >> 4;
+    regs[3] = ((hum & 0x0F) << 4) | (temp >> 16);
+    regs[4] = temp >> 8;
+    regs[5] = temp;
+    regs[6] = aht20_crc(regs, 6);
+}
+
+// The public getStatus(), the driver has a private one that reads the chip
+uint8_t aht20_error(const AHT20& sensor) {
+    return sensor.getStatus();
+}
+
+} // namespace
+
+TEST_CASE(bmp280_datasheet_example) {
+    MockI2CBus bus;
+    add_bmp280(bus);
+    BMP280Sensor sensor(bus, BMP280_ADDR);
+    CHECK(sensor.begin());
+    // ID and calibration in one script, not 27 single register reads
+    CHECK(bus.transactions() < 20);
+
+    // x16 oversampling for both, normal mode, 4 s standby with the x16 filter
+    const uint8_t* regs = bus.registers(BMP280_ADDR);
+    CHECK_EQ(regs[0xF4], 0xB7);
+    CHECK_EQ(regs[0xF5], 0xF0);
+
+    const uint32_t before = bus.transactions();
+    CHECK(sensor.startMeasurement());
+    CHECK(sensor.hasValue());
+    // Mode check and status, temperature and pressure in one data window read
+    CHECK_EQ(bus.transactions() - before, 2);
+    const BMP280Sensor::SensorData data = sensor.getData();
+    CHECK(data.valid);
+    CHECK(fabs(data.pressure_pa - 100653.27f) < 1.0f);
+    CHECK(fabs(data.temperature_degc - 25.08f) < 0.01f);
+}
+
+TEST_CASE(bmp280_busy_and_missing) {
+    MockI2CBus bus;
+    add_bmp280(bus);
+    BMP280Sensor sensor(bus, BMP280_ADDR);
+    CHECK(sensor.begin());
+
+    bus.registers(BMP280_ADDR)[BMP280_REG_DATA] = 0x08; // Measuring
+    CHECK(!sensor.hasValue());
+    bus.registers(BMP280_ADDR)[BMP280_REG_DATA] = 0x00;
+
+    // A failed window read falls back to register reads
+    bus.failNext(BMP280_ADDR, I2C_ERROR_DATA_NACK);
+    CHECK(sensor.hasValue());
+    CHECK(fabs(sensor.getPressure() - 100653.27f) < 1.0f);
+
+    MockI2CBus empty_bus;
+    BMP280Sensor missing(empty_bus, BMP280_ADDR);
+    CHECK(!missing.begin());
+
+    bus.registers(BMP280_ADDR)[BMP280_REG_ID] = 0x60; // BME280
+    BMP280Sensor wrong_chip(bus, BMP280_ADDR);
+    CHECK(!wrong_chip.begin());
+}
+
+TEST_CASE(aht20_measurement) {
+    MockI2CBus bus;
+    bus.addDevice(AHT20_DEFAULT_ADDRESS);
+    bus.fixReadPointer(AHT20_DEFAULT_ADDRESS, 0);
+    set_aht20_reading(bus, AHT20_STATUS_CAL, 50.0f, 25.0f);
+
+    AHT20 sensor(bus);
+    CHECK(sensor.init());
+    // The status byte already has the calibrated bit, no calibration command
+    const uint8_t* regs = bus.registers(AHT20_DEFAULT_ADDRESS);
+    CHECK_EQ(regs[AHT20_REG_CALIBRATE], 0x00);
+
+    CHECK(sensor.triggerMeasurement());
+    CHECK_EQ(regs[AHT20_REG_MEASURE], 0x33);
+    CHECK(sensor.newData());
+    float temperature = 0;
+    float humidity = 0;
+    CHECK(sensor.getTemperature(temperature));
+    CHECK(sensor.getHumidity(humidity));
+    CHECK(fabs(temperature - 25.0f) < 0.01f);
+    CHECK(fabs(humidity - 50.0f) < 0.01f);
+    CHECK(sensor.isHealthy());
+}
+
+TEST_CASE(aht20_busy_crc_and_calibration) {
+    MockI2CBus bus;
+    bus.addDevice(AHT20_DEFAULT_ADDRESS);
+    bus.fixReadPointer(AHT20_DEFAULT_ADDRESS, 0);
+    set_aht20_reading(bus, AHT20_STATUS_CAL, 40.0f, 20.0f);
+    AHT20 sensor(bus);
+    CHECK(sensor.init());
+    CHECK(sensor.triggerMeasurement());
+
+    set_aht20_reading(bus, AHT20_STATUS_CAL | AHT20_STATUS_BUSY, 40.0f, 20.0f);
+    CHECK(!sensor.newData());
+    CHECK_EQ(aht20_error(sensor), AHT20_BUSY_ERROR);
+
+    set_aht20_reading(bus, AHT20_STATUS_CAL, 40.0f, 20.0f);
+    bus.registers(AHT20_DEFAULT_ADDRESS)[6] ^= 0x01;
+    CHECK(!sensor.newData());
+    CHECK_EQ(aht20_error(sensor), AHT20_DATA_ERROR); // newData() reports every failed read as a data error
+    float humidity = 0;
+    CHECK(!sensor.getHumidity(humidity));
+
+    // The calibration bit never comes up
+    MockI2CBus uncalibrated_bus;
+    uncalibrated_bus.addDevice(AHT20_DEFAULT_ADDRESS);
+    uncalibrated_bus.fixReadPointer(AHT20_DEFAULT_ADDRESS, 0);
+    AHT20 uncalibrated(uncalibrated_bus);
+    CHECK(!uncalibrated.init());
+    CHECK(!uncalibrated.isHealthy());
+    CHECK_EQ(uncalibrated_bus.registers(AHT20_DEFAULT_ADDRESS)[AHT20_REG_CALIBRATE], 0x08);
+}
+
+TEST_CASE(zmod4510_hal_init_sequence) {
+    MockI2CBus bus;
+    bus.addDevice(ZMOD4510_I2C_ADDR);
+    uint8_t* regs = bus.registers(ZMOD4510_I2C_ADDR);
+    regs[ZMOD4XXX_ADDR_PID] = ZMOD4510_PID >> 8;
+    regs[ZMOD4XXX_ADDR_PID + 1] = ZMOD4510_PID & 0xFF;
+    const uint8_t config[ZMOD4XXX_LEN_CONF] = { 0x10, 0x20, 0x30, 0x40, 0x50, 0x60 };
+    memcpy(regs + ZMOD4XXX_ADDR_CONF, config, sizeof(config));
+    regs[0x97] = 0x12; // Init results, mox_lr and mox_er
+    regs[0x98] = 0x34;
+    regs[0x99] = 0x56;
+    regs[0x9A] = 0x78;
+
+    // As ZMOD4510Sensor::initHAL() and detect_and_configure() set it up
+    Interface_t hal = {};
+    CHECK_EQ(HAL_Init(&hal), ecSuccess);
+    hal.handle = &bus;
+    uint8_t prod_data[ZMOD4510_PROD_DATA_LEN];
+    zmod4xxx_dev_t dev = {};
+    dev.i2c_addr = ZMOD4510_I2C_ADDR;
+    dev.pid = ZMOD4510_PID;
+    dev.init_conf = &zmod_no2_o3_sensor_cfg[INIT];
+    dev.meas_conf = &zmod_no2_o3_sensor_cfg[MEASUREMENT];
+    dev.prod_data = prod_data;
+
+    CHECK_EQ(zmod4xxx_init(&dev, &hal), ZMOD4XXX_OK);
+    CHECK_EQ(zmod4xxx_read_sensor_info(&dev), ZMOD4XXX_OK);
+    CHECK_MEM(dev.config, config, sizeof(config));
+    CHECK_EQ(zmod4xxx_init_sensor(&dev), ZMOD4XXX_OK);
+    CHECK_EQ(dev.mox_lr, 0x1234);
+    CHECK_EQ(dev.mox_er, 0x5678);
+    CHECK_EQ(zmod4xxx_init_measurement(&dev), ZMOD4XXX_OK);
+
+    // The 32 byte sequencer table went out in one write
+    const zmod4xxx_conf& measurement = zmod_no2_o3_sensor_cfg[MEASUREMENT];
+    CHECK_MEM(regs + measurement.s.addr, measurement.s.data_buf, measurement.s.len);
+    CHECK_MEM(regs + measurement.d.addr, measurement.d.data_buf, measurement.d.len);
+
+    // A NACK from the sensor reaches the API as an I2C error
+    bus.failNext(ZMOD4510_I2C_ADDR, I2C_ERROR_DATA_NACK);
+    uint8_t status = 0;
+    CHECK_EQ(zmod4xxx_read_status(&dev, &status), ERROR_I2C);
+
+    // Wrong product ID
+    regs[ZMOD4XXX_ADDR_PID] = 0;
+    CHECK_EQ(zmod4xxx_read_sensor_info(&dev), ERROR_SENSOR_UNSUPPORTED);
+
+    MockI2CBus empty_bus;
+    hal.handle = &empty_bus;
+    CHECK_EQ(zmod4xxx_init(&dev, &hal), ERROR_I2C);
+}
+
+TEST_CASE(zmod4510_hal_block_transfers) {
+    MockI2CBus bus;
+    bus.addDevice(ZMOD4510_I2C_ADDR);
+    Interface_t hal = {};
+    HAL_Init(&hal);
+    hal.handle = &bus;
+
+    // Longer than one bus read or one bridge write, the HAL segments them
+    uint8_t reg = 0x40;
+    uint8_t data[60];
+    for (uint8_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 3 + 1);
+    CHECK_EQ(hal.i2cWrite(hal.handle, ZMOD4510_I2C_ADDR, &reg, 1, data, sizeof(data)), ecSuccess);
+    CHECK_MEM(bus.registers(ZMOD4510_I2C_ADDR) + reg, data, sizeof(data));
+
+    uint8_t read_back[sizeof(data)];
+    memset(read_back, 0, sizeof(read_back));
+    CHECK_EQ(hal.i2cRead(hal.handle, ZMOD4510_I2C_ADDR, &reg, 1, read_back, sizeof(read_back)), ecSuccess);
+    CHECK_MEM(read_back, data, sizeof(data));
+
+    bus.failNext(ZMOD4510_I2C_ADDR, I2C_ERROR_DATA_NACK);
+    CHECK(hal.i2cRead(hal.handle, ZMOD4510_I2C_ADDR, &reg, 1, read_back, sizeof(read_back)) != ecSuccess);
+}
+
+HOST_TEST_MAIN()
@@ -0,0 +1,159 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core the tested sources use.
+// Time is a fake clock that only moves when a test advances it or when
+// code calls delay(), so timeouts are deterministic.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+
+typedef uint8_t byte;
+
+inline uint64_t& host_clock_us() {
+    static uint64_t now_us = 0;
+    return now_us;
+}
+
+inline void host_clock_advance_us(uint64_t us) { host_clock_us() += us; }
+inline void host_clock_advance_ms(unsigned long ms) { host_clock_us() += (uint64_t)ms * 1000; }
+
+inline unsigned long millis() { return (unsigned long)(host_clock_us() / 1000); }
+inline unsigned long micros() { return (unsigned long)host_clock_us(); }
+inline void delay(unsigned long ms) { host_clock_advance_ms(ms); }
+inline void delayMicroseconds(unsigned int us) { host_clock_advance_us(us); }
+static inline void yield() {}
+
+template<typename T, typename L, typename H>
+static inline T constrain(T value, L low, H high) {
+    return value < low ? (T)low : (value > high ? (T)high : value);
+}
+
+// As in the ESP32 core
+using std::min;
+using std::max;
+
+// Same allocation behaviour as the ESP32 core's WString: up to 11
+// characters live in the object, longer strings own a heap buffer sized to
+// fit exactly, so every growth past that reallocates. Heap buffers come
+// from new[] so tests can count them by replacing operator new[].
+class String {
+public:
+    String() { init(); }
+    String(const char* str) { init(); assign(str, strlen(str)); }
+    String(const char* str, size_t len) { init(); assign(str, len); }
+    String(const String& other) { init(); assign(other.c_str(), other.len); }
+    explicit String(char c) { init(); assign(&c, 1); }
+    explicit String(int value) { init(); char text[16]; snprintf(text, sizeof(text), "%d", value); assign(text, strlen(text)); }
+    explicit String(unsigned int value) { init(); char text[16]; snprintf(text, sizeof(text), "%u", value); assign(text, strlen(text)); }
+    explicit String(long value) { init(); char text[24]; snprintf(text, sizeof(text), "%ld", value); assign(text, strlen(text)); }
+    explicit String(unsigned long value) { init(); char text[24]; snprintf(text, sizeof(text), "%lu", value); assign(text, strlen(text)); }
+    String(double value, unsigned int decimals = 2) { init(); char text[32]; snprintf(text, sizeof(text), "%.*f", decimals, value); assign(text, strlen(text)); }
+    ~String() { if (heap) delete[] heap; }
+
+    String& operator=(const String& other) { if (this != &other) assign(other.c_str(), other.len); return *this; }
+    String& operator=(const char* str) { assign(str, strlen(str)); return *this; }
+
+    bool reserve(size_t size) {
+        if (size <= capacity()) return true;
+        char* buffer = new char[size + 1];
+        memcpy(buffer, c_str(), len + 1);
+        if (heap) delete[] heap;
+        heap = buffer;
+        heap_capacity = size;
+        return true;
+    }
+
+    String& concat(const char* str, size_t add_len) {
+        reserve(len + add_len);
+        memcpy(data() + len, str, add_len);
+        len += add_len;
+        data()[len] = '\0';
+        return *this;
+    }
+    String& operator+=(const String& other) { return concat(other.c_str(), other.len); }
+    String& operator+=(const char* str) { return concat(str, strlen(str)); }
+    String& operator+=(char c) { return concat(&c, 1); }
+
+    friend String operator+(const String& lhs, const String& rhs) { String result(lhs); result += rhs; return result; }
+    friend String operator+(const String& lhs, const char* rhs) { String result(lhs); result += rhs; return result; }
+    friend String operator+(const char* lhs, const String& rhs) { String result(lhs); result += rhs; return result; }
+    friend String operator+(const String& lhs, char rhs) { String result(lhs); result += rhs; return result; }
+
+    bool operator==(const String& other) const { return len == other.len && strcmp(c_str(), other.c_str()) == 0; }
+    bool operator==(const char* str) const { return strcmp(c_str(), str) == 0; }
+    bool operator!=(const String& other) const { return !(*this == other); }
+
+    const char* c_str() const { return heap ? heap : inline_buffer; }
+    size_t length() const { return len; }
+    char charAt(size_t index) const { return index < len ? c_str()[index] : '\0'; }
+    char operator[](size_t index) const { return charAt(index); }
+
+    bool startsWith(const char* prefix) const { return strncmp(c_str(), prefix, strlen(prefix)) == 0; }
+    bool endsWith(const char* suffix) const {
+        const size_t suffix_len = strlen(suffix);
+        return len >= suffix_len && strcmp(c_str() + len - suffix_len, suffix) == 0;
+    }
+    int indexOf(char c, size_t from = 0) const {
+        if (from >= len) return -1;
+        const char* found = strchr(c_str() + from, c);
+        return found ? (int)(found - c_str()) : -1;
+    }
+    int lastIndexOf(char c) const {
+        const char* found = strrchr(c_str(), c);
+        return found ? (int)(found - c_str()) : -1;
+    }
+    String substring(size_t from) const { return substring(from, len); }
+    String substring(size_t from, size_t to) const {
+        if (to > len) to = len;
+        if (from >= to) return String();
+        return String(c_str() + from, to - from);
+    }
+    void remove(size_t index) { if (index < len) { len = index; data()[len] = '\0'; } }
+    void remove(size_t index, size_t count) {
+        if (index >= len) return;
+        if (count > len - index) count = len - index;
+        memmove(data() + index, data() + index + count, len - index - count + 1);
+        len -= count;
+    }
+    void trim() {
+        size_t start = 0;
+        while (start < len && isspace((unsigned char)c_str()[start])) start++;
+        size_t end = len;
+        while (end > start && isspace((unsigned char)c_str()[end - 1])) end--;
+        memmove(data(), c_str() + start, end - start);
+        len = end - start;
+        data()[len] = '\0';
+    }
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return (float)atof(c_str()); }
+
+private:
+    static const size_t INLINE_CAPACITY = 11;
+
+    void init() { heap = nullptr; heap_capacity = 0; len = 0; inline_buffer[0] = '\0'; }
+    size_t capacity() const { return heap ? heap_capacity : INLINE_CAPACITY; }
+    char* data() { return heap ? heap : inline_buffer; }
+    void assign(const char* str, size_t str_len) {
+        len = 0;
+        reserve(str_len);
+        memmove(data(), str, str_len);
+        len = str_len;
+        data()[len] = '\0';
+    }
+
+    char* heap;
+    size_t heap_capacity;
+    size_t len;
+    char inline_buffer[INLINE_CAPACITY + 1];
+};
+
+// The ESP32 core pulls these in too
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
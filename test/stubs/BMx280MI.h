@@ -0,0 +1,121 @@
+#pragma once
+
+// Host stand-in for the BMx280MI library (bitbucket-christandlg/BMx280MI)
+// with the parts BMP280Sensor uses: the same public calls and virtual
+// register accessors, register layout and the floating point compensation
+// from the BMP280 datasheet. BMP280 only, no BME280 humidity.
+
+#include <Arduino.h>
+
+class BMx280MI {
+public:
+    static const uint8_t BMP280_ID = 0x58;
+
+    static const uint8_t OSRS_P_x16 = 0x05;
+    static const uint8_t OSRS_T_x16 = 0x05;
+    static const uint8_t FILTER_x16 = 0x04;
+    static const uint8_t T_SB_7 = 0x07;
+    static const uint8_t BMx280_MODE_SLEEP = 0x00;
+    static const uint8_t BMx280_MODE_FORCED = 0x01;
+    static const uint8_t BMx280_MODE_NORMAL = 0x03;
+
+    BMx280MI() : temperature_(NAN), pressure_(NAN) { memset(dig_, 0, sizeof(dig_)); }
+    virtual ~BMx280MI() {}
+
+    bool begin() {
+        if (!beginInterface() || readRegister(REG_ID) != BMP280_ID) {
+            return false;
+        }
+        // Little endian, one register at a time like the library
+        for (uint8_t i = 0; i < 12; i++) {
+            dig_[i] = readRegister(REG_CALIB + 2 * i) | (readRegister(REG_CALIB + 2 * i + 1) << 8);
+        }
+        return true;
+    }
+
+    bool measure() {
+        if ((readRegister(REG_CTRL_MEAS) & 0x03) == BMx280_MODE_NORMAL) {
+            return true;
+        }
+        writeBits(REG_CTRL_MEAS, 0x03, 0, BMx280_MODE_FORCED);
+        return true;
+    }
+
+    bool hasValue() {
+        if (readRegister(REG_STATUS) & STATUS_MEASURING) {
+            return false;
+        }
+        const int32_t adc_T = readRegisterBurst(REG_TEMP, 3) >> 4;
+        const int32_t adc_P = readRegisterBurst(REG_PRESS, 3) >> 4;
+
+        // dig_T1 and dig_P1 are unsigned, the rest signed
+        const uint16_t T1 = dig_[0];
+        const int16_t T2 = (int16_t)dig_[1];
+        const int16_t T3 = (int16_t)dig_[2];
+        const double var1_t = (adc_T / 16384.0 - T1 / 1024.0) * T2;
+        const double delta = adc_T / 131072.0 - T1 / 8192.0;
+        const double t_fine = var1_t + delta * delta * T3;
+        temperature_ = t_fine / 5120.0;
+
+        int16_t P[10];
+        for (uint8_t i = 2; i <= 9; i++) {
+            P[i] = (int16_t)dig_[i + 2];
+        }
+        double var1 = t_fine / 2.0 - 64000.0;
+        double var2 = var1 * var1 * P[6] / 32768.0;
+        var2 = var2 + var1 * P[5] * 2.0;
+        var2 = var2 / 4.0 + P[4] * 65536.0;
+        var1 = (P[3] * var1 * var1 / 524288.0 + P[2] * var1) / 524288.0;
+        var1 = (1.0 + var1 / 32768.0) * dig_[3];
+        if (var1 == 0.0) {
+            pressure_ = NAN;
+            return true;
+        }
+        double p = 1048576.0 - adc_P;
+        p = (p - var2 / 4096.0) * 6250.0 / var1;
+        var1 = P[9] * p * p / 2147483648.0;
+        var2 = p * P[8] / 32768.0;
+        pressure_ = p + (var1 + var2 + P[7]) / 16.0;
+        return true;
+    }
+
+    float getPressure() { return (float)pressure_; }
+    float getTemperature() { return (float)temperature_; }
+
+    bool resetToDefaults() {
+        writeRegister(REG_RESET, RESET_VALUE);
+        return true;
+    }
+    void writeOversamplingPressure(uint8_t value) { writeBits(REG_CTRL_MEAS, 0x07, 2, value); }
+    void writeOversamplingTemperature(uint8_t value) { writeBits(REG_CTRL_MEAS, 0x07, 5, value); }
+    void writePowerMode(uint8_t value) { writeBits(REG_CTRL_MEAS, 0x03, 0, value); }
+    void writeFilterSetting(uint8_t value) { writeBits(REG_CONFIG, 0x07, 2, value); }
+    void writeStandbyTime(uint8_t value) { writeBits(REG_CONFIG, 0x07, 5, value); }
+
+protected:
+    virtual bool beginInterface() = 0;
+    virtual uint8_t readRegister(uint8_t reg) = 0;
+    virtual uint32_t readRegisterBurst(uint8_t reg, uint8_t length) = 0;
+    virtual void writeRegister(uint8_t reg, uint8_t data) = 0;
+
+private:
+    static const uint8_t REG_CALIB = 0x88;
+    static const uint8_t REG_ID = 0xD0;
+    static const uint8_t REG_RESET = 0xE0;
+    static const uint8_t REG_STATUS = 0xF3;
+    static const uint8_t REG_CTRL_MEAS = 0xF4;
+    static const uint8_t REG_CONFIG = 0xF5;
+    static const uint8_t REG_PRESS = 0xF7;
+    static const uint8_t REG_TEMP = 0xFA;
+    static const uint8_t RESET_VALUE = 0xB6;
+    static const uint8_t STATUS_MEASURING = 0x08;
+
+    uint16_t dig_[12];  // dig_T1 .. dig_T3, dig_P1 .. dig_P9
+    double temperature_;
+    double pressure_;
+
+    void writeBits(uint8_t reg, uint8_t mask, uint8_t shift, uint8_t value) {
+        const uint8_t current = readRegister(reg);
+        writeRegister(reg, (current & ~(mask << shift)) | ((value & mask) << shift));
+    }
+};
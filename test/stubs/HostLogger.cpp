@@ -0,0 +1,62 @@
+// Host implementation of the Logger declared in include/Logger.h. Messages
+// go to stderr when HOST_TEST_LOG is set in the environment, otherwise
+// they are only counted.
+
+#include "HostLogger.h"
+#include <stdarg.h>
+
+Logger logger;
+
+static unsigned long host_log_counts[APP_LOG_ERROR + 1];
+
+unsigned long host_log_count(AppLogLevel level) {
+    return host_log_counts[level];
+}
+
+Logger::Logger() {}
+
+void Logger::init(HAMqtt* mqtt) {
+    _mqtt = mqtt;
+}
+
+void Logger::loop() {}
+
+void Logger::setLogLevel(AppLogLevel level) {
+    _currentLogLevel.store(level);
+}
+
+AppLogLevel Logger::getLogLevel() const {
+    return _currentLogLevel.load();
+}
+
+void Logger::log(AppLogLevel level, const char* message) {
+    host_log_counts[level]++;
+    if (getenv("HOST_TEST_LOG")) {
+        fprintf(stderr, "[%s] %s\n", _getLogLevelString(level), message);
+    }
+}
+
+const char* Logger::_getLogLevelString(AppLogLevel level) {
+    switch (level) {
+        case APP_LOG_DEBUG: return "DEBUG";
+        case APP_LOG_INFO: return "INFO";
+        case APP_LOG_WARNING: return "WARNING";
+        case APP_LOG_ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+#define HOST_LOGGER_FORMAT(name, level) \
+    void Logger::name(const char* format, ...) { \
+        char message[MAX_MESSAGE_LENGTH + 1]; \
+        va_list args; \
+        va_start(args, format); \
+        vsnprintf(message, sizeof(message), format, args); \
+        va_end(args); \
+        log(level, message); \
+    }
+
+HOST_LOGGER_FORMAT(debugf, APP_LOG_DEBUG)
+HOST_LOGGER_FORMAT(infof, APP_LOG_INFO)
+HOST_LOGGER_FORMAT(warningf, APP_LOG_WARNING)
+HOST_LOGGER_FORMAT(errorf, APP_LOG_ERROR)
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Logger.h"
+
+// Messages logged at level since the start of the test, see HostLogger.cpp
+unsigned long host_log_count(AppLogLevel level);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Host builds talk to devices through MockI2CBus, drivers only start the bus
+class TwoWire {
+public:
+    bool begin() { return true; }
+};
+
+inline TwoWire Wire;
@@ -0,0 +1,158 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF UART driver. Each port is a byte queue:
+// host_uart_receive() plays the wire into RX and posts the events the
+// driver would, uart_write_bytes() collects TX for the test to inspect.
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <deque>
+#include <vector>
+
+typedef int esp_err_t;
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+typedef int uart_port_t;
+#define UART_NUM_0   0
+#define UART_NUM_1   1
+#define UART_NUM_2   2
+#define UART_NUM_MAX 3
+#define UART_PIN_NO_CHANGE (-1)
+
+typedef enum { UART_DATA_5_BITS, UART_DATA_6_BITS, UART_DATA_7_BITS, UART_DATA_8_BITS } uart_word_length_t;
+typedef enum { UART_PARITY_DISABLE, UART_PARITY_EVEN = 2, UART_PARITY_ODD } uart_parity_t;
+typedef enum { UART_STOP_BITS_1 = 1, UART_STOP_BITS_1_5, UART_STOP_BITS_2 } uart_stop_bits_t;
+typedef enum { UART_HW_FLOWCTRL_DISABLE, UART_HW_FLOWCTRL_RTS, UART_HW_FLOWCTRL_CTS, UART_HW_FLOWCTRL_CTS_RTS } uart_hw_flowcontrol_t;
+
+typedef struct {
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+} uart_config_t;
+
+typedef enum {
+    UART_DATA,
+    UART_BREAK,
+    UART_BUFFER_FULL,
+    UART_FIFO_OVF,
+    UART_FRAME_ERR,
+    UART_PARITY_ERR,
+    UART_DATA_BREAK,
+    UART_PATTERN_DET,
+    UART_EVENT_MAX
+} uart_event_type_t;
+
+typedef struct {
+    uart_event_type_t type;
+    size_t size;
+    bool timeout_flag;
+} uart_event_t;
+
+struct HostUart {
+    bool installed;
+    int baud_rate;
+    QueueHandle_t event_queue;
+    char pattern_char;
+    int pattern_positions;
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+};
+
+inline HostUart& host_uart(uart_port_t port) {
+    static HostUart uarts[UART_NUM_MAX];
+    return uarts[port];
+}
+
+// Bytes arriving from the wire: queued for uart_read_bytes() with a
+// UART_DATA event, or UART_PATTERN_DET when they hold the pattern character
+inline void host_uart_receive(uart_port_t port, const void* data, size_t len) {
+    HostUart& uart = host_uart(port);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    bool pattern = false;
+    for (size_t i = 0; i < len; i++) {
+        uart.rx.push_back(bytes[i]);
+        if (uart.pattern_char && bytes[i] == (uint8_t)uart.pattern_char) {
+            uart.pattern_positions++;
+            pattern = true;
+        }
+    }
+    uart_event_t event = { pattern ? UART_PATTERN_DET : UART_DATA, len, !pattern };
+    xQueueSend(uart.event_queue, &event, 0);
+}
+
+inline void host_uart_event(uart_port_t port, uart_event_type_t type) {
+    uart_event_t event = { type, 0, false };
+    xQueueSend(host_uart(port).event_queue, &event, 0);
+}
+
+inline esp_err_t uart_driver_install(uart_port_t port, int, int, int queue_size, QueueHandle_t* queue, int) {
+    HostUart& uart = host_uart(port);
+    uart.installed = true;
+    uart.event_queue = xQueueCreate(queue_size, sizeof(uart_event_t));
+    if (queue) *queue = uart.event_queue;
+    return ESP_OK;
+}
+
+inline esp_err_t uart_param_config(uart_port_t port, const uart_config_t* config) {
+    host_uart(port).baud_rate = config->baud_rate;
+    return ESP_OK;
+}
+
+inline esp_err_t uart_set_pin(uart_port_t, int, int, int, int) { return ESP_OK; }
+inline esp_err_t uart_set_rx_full_threshold(uart_port_t, int) { return ESP_OK; }
+inline esp_err_t uart_set_rx_timeout(uart_port_t, uint8_t) { return ESP_OK; }
+
+inline esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t port, char pattern_chr, uint8_t, int, int, int) {
+    host_uart(port).pattern_char = pattern_chr;
+    return ESP_OK;
+}
+
+inline esp_err_t uart_pattern_queue_reset(uart_port_t port, int) {
+    host_uart(port).pattern_positions = 0;
+    return ESP_OK;
+}
+
+inline int uart_pattern_pop_pos(uart_port_t port) {
+    HostUart& uart = host_uart(port);
+    if (uart.pattern_positions == 0) return -1;
+    uart.pattern_positions--;
+    return 0;
+}
+
+inline int uart_write_bytes(uart_port_t port, const void* data, size_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    host_uart(port).tx.insert(host_uart(port).tx.end(), bytes, bytes + len);
+    return (int)len;
+}
+
+inline esp_err_t uart_wait_tx_done(uart_port_t, TickType_t) { return ESP_OK; }
+
+inline esp_err_t uart_set_baudrate(uart_port_t port, uint32_t baud_rate) {
+    host_uart(port).baud_rate = (int)baud_rate;
+    return ESP_OK;
+}
+
+inline esp_err_t uart_flush_input(uart_port_t port) {
+    host_uart(port).rx.clear();
+    return ESP_OK;
+}
+
+inline esp_err_t uart_get_buffered_data_len(uart_port_t port, size_t* size) {
+    *size = host_uart(port).rx.size();
+    return ESP_OK;
+}
+
+inline int uart_read_bytes(uart_port_t port, void* buffer, uint32_t length, TickType_t) {
+    HostUart& uart = host_uart(port);
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    uint32_t read = 0;
+    while (read < length && !uart.rx.empty()) {
+        out[read++] = uart.rx.front();
+        uart.rx.pop_front();
+    }
+    return (int)read;
+}
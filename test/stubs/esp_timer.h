@@ -0,0 +1,6 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Microseconds of the fake Arduino clock
+inline int64_t esp_timer_get_time() { return (int64_t)host_clock_us(); }
@@ -0,0 +1,73 @@
+#pragma once
+
+// Single-threaded host stand-in for the FreeRTOS API the firmware uses.
+// Ticks are milliseconds of the fake Arduino clock. A call that would
+// block first runs the hook a test installed with host_set_block_hook(),
+// which plays the other tasks (a responder, the RX task, ...) and returns
+// false once it has nothing left to do. The call then times out at once by
+// advancing the clock, or throws HostBlockedForever for portMAX_DELAY.
+
+#include <Arduino.h>
+#include <stdexcept>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define errQUEUE_FULL 0
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY 0x7FFFFFFF
+#define tskIDLE_PRIORITY 0
+
+struct HostBlockedForever : std::runtime_error {
+    HostBlockedForever() : std::runtime_error("blocked forever with nothing left to wake it") {}
+};
+
+typedef bool (*HostBlockHook)(void* context);
+
+struct HostBlockState {
+    HostBlockHook hook;
+    void* context;
+};
+
+inline HostBlockState& host_block_state() {
+    static HostBlockState state = { nullptr, nullptr };
+    return state;
+}
+
+inline void host_set_block_hook(HostBlockHook hook, void* context) {
+    host_block_state().hook = hook;
+    host_block_state().context = context;
+}
+
+// Waits up to ticks for ready() to become true
+template<typename Ready>
+inline bool host_block_until(TickType_t ticks, Ready ready) {
+    const unsigned long start = millis();
+    while (!ready()) {
+        if (ticks != portMAX_DELAY && millis() - start >= ticks) {
+            return false;
+        }
+        HostBlockState& state = host_block_state();
+        if (ticks == 0) {
+            return false;
+        }
+        if (state.hook == nullptr || !state.hook(state.context)) {
+            if (ready()) break;
+            if (ticks == portMAX_DELAY) {
+                throw HostBlockedForever();
+            }
+            const unsigned long waited = millis() - start;
+            if (waited < ticks) host_clock_advance_ms(ticks - waited);
+            return false;
+        }
+    }
+    return true;
+}
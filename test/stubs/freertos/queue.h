@@ -0,0 +1,51 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include <deque>
+#include <vector>
+
+struct HostQueue {
+    size_t item_size;
+    UBaseType_t length;
+    std::deque<std::vector<uint8_t> > items;
+};
+
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    HostQueue* queue = new HostQueue();
+    queue->item_size = item_size;
+    queue->length = length;
+    return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    if (!host_block_until(ticks, [queue]() { return queue->items.size() < queue->length; })) {
+        return errQUEUE_FULL;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->item_size));
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    return xQueueSend(queue, item, ticks);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    if (!host_block_until(ticks, [queue]() { return !queue->items.empty(); })) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->item_size);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t queue) {
+    queue->items.clear();
+    return pdPASS;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    return (UBaseType_t)queue->items.size();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+// Mutexes and binary semaphores as counters. A mutex that is still held
+// when taken again means the test called back into code under a lock,
+// which a real second task would wait out, so that throws.
+
+struct HostSemaphore {
+    UBaseType_t count;
+    UBaseType_t max_count;
+    bool is_mutex;
+};
+
+typedef HostSemaphore StaticSemaphore_t;
+typedef HostSemaphore* SemaphoreHandle_t;
+
+struct HostMutexReentered : std::logic_error {
+    HostMutexReentered() : std::logic_error("mutex taken while held") {}
+};
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer) {
+    buffer->count = 1;
+    buffer->max_count = 1;
+    buffer->is_mutex = true;
+    return buffer;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return xSemaphoreCreateMutexStatic(new HostSemaphore());
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* buffer) {
+    buffer->count = 0;
+    buffer->max_count = 1;
+    buffer->is_mutex = false;
+    return buffer;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return xSemaphoreCreateBinaryStatic(new HostSemaphore());
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial) {
+    HostSemaphore* semaphore = new HostSemaphore();
+    semaphore->count = initial;
+    semaphore->max_count = max_count;
+    semaphore->is_mutex = false;
+    return semaphore;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    if (semaphore->is_mutex) {
+        if (semaphore->count == 0) throw HostMutexReentered();
+        semaphore->count = 0;
+        return pdTRUE;
+    }
+    if (!host_block_until(ticks, [semaphore]() { return semaphore->count > 0; })) {
+        return pdFALSE;
+    }
+    semaphore->count--;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (semaphore->count >= semaphore->max_count) return pdFALSE;
+    semaphore->count++;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    return xSemaphoreTake(semaphore, ticks);
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    return xSemaphoreGive(semaphore);
+}
+
+inline UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+    return semaphore->count;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t) {}
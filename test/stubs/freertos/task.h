@@ -0,0 +1,54 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include <string>
+#include <vector>
+
+// Created tasks are only recorded. A test runs one with host_run_task(),
+// its loop ends when it blocks with nothing left to wake it.
+
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+
+struct HostTask {
+    std::string name;
+    TaskFunction_t function;
+    void* parameter;
+};
+
+inline std::vector<HostTask>& host_tasks() {
+    static std::vector<HostTask> tasks;
+    return tasks;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t, void* parameter,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    host_tasks().push_back(HostTask{ name, function, parameter });
+    if (handle) *handle = reinterpret_cast<TaskHandle_t>(host_tasks().size());
+    return pdPASS;
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stack, void* parameter,
+                              UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(function, name, stack, parameter, priority, handle, tskNO_AFFINITY);
+}
+
+// Runs the named task until it blocks for good. Returns false if there is no such task.
+inline bool host_run_task(const char* name) {
+    for (size_t i = 0; i < host_tasks().size(); i++) {
+        if (host_tasks()[i].name == name) {
+            try {
+                host_tasks()[i].function(host_tasks()[i].parameter);
+            } catch (const HostBlockedForever&) {
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void vTaskDelay(TickType_t ticks) { host_clock_advance_ms(ticks); }
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+inline BaseType_t xPortGetCoreID() { return 1; }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+inline void vTaskDelete(TaskHandle_t) {}
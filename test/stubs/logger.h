@@ -0,0 +1,4 @@
+#pragma once
+
+// The vendor ZMOD4510 sources include it in lower case
+#include "Logger.h"